@@ -61,6 +61,8 @@ add_library(imgui STATIC IMPORTED GLOBAL)
 set_target_properties(imgui PROPERTIES
     IMPORTED_LOCATION "$ENV{CONDA_PREFIX}/lib/libimgui.a"
     INTERFACE_INCLUDE_DIRECTORIES "$ENV{CONDA_PREFIX}/include/imgui"
+    # Must match the package build: makes the current ImGui context thread-local.
+    INTERFACE_COMPILE_DEFINITIONS [=[IMGUI_USER_CONFIG="goggles_imconfig.h"]=]
 )
 target_link_libraries(imgui INTERFACE SDL3::SDL3 Vulkan::Vulkan)
 
@@ -0,0 +1,9 @@
+// Dear ImGui build configuration shared by libimgui and every Goggles target that includes it.
+#pragma once
+
+struct ImGuiContext;
+
+// The current context is per thread. ImGui::MemAlloc reports every allocation to the current
+// context, so font atlases built on JobSystem workers must not see the UI thread's context.
+inline thread_local ImGuiContext* GogglesImGuiContext = nullptr;
+#define GImGui GogglesImGuiContext
@@ -3,14 +3,13 @@ set -euo pipefail
 
 ROOT_DIR=$(git rev-parse --show-toplevel)
 BUILD_DIR="$ROOT_DIR/build/debug"
-TOOL="$BUILD_DIR/tests/goggles_shader_batch_report"
-OUTPUT="$ROOT_DIR/build/shader_test_results.json"
+TOOL="$BUILD_DIR/tests/preset_validator/goggles_preset_validator"
 
 if [[ ! -x "$TOOL" ]]; then
     pixi run build -p debug
 fi
 
-ARGS=(--output "$OUTPUT")
+ARGS=(--shader-dir "$ROOT_DIR/shaders/retroarch" --verbose)
 if [[ $# -ge 1 ]]; then
     ARGS+=(--category "$1")
 fi
@@ -1,5 +1,7 @@
 #include "application.hpp"
 
+#include "control_server.hpp"
+
 #include <SDL3/SDL.h>
 #include <algorithm>
 #include <chrono>
@@ -20,7 +22,10 @@
 #include <unordered_set>
 #include <util/config.hpp>
 #include <util/drm_fourcc.hpp>
+#include <util/frame_export.hpp>
 #include <util/logging.hpp>
+#include <util/metrics.hpp>
+#include <util/metrics_exporter.hpp>
 #include <util/paths.hpp>
 #include <utility>
 #include <vector>
@@ -31,6 +36,22 @@ namespace goggles::app {
 // Helper Functions
 // =============================================================================
 
+static auto usable_surface_frame(const std::optional<util::ExternalImageFrame>& frame)
+    -> const util::ExternalImageFrame* {
+    if (!frame) {
+        return nullptr;
+    }
+    if (frame->image.format == vk::Format::eUndefined) {
+        GOGGLES_LOG_DEBUG("Skipping surface frame with unsupported DRM format");
+        return nullptr;
+    }
+    if (frame->image.modifier == util::DRM_FORMAT_MOD_INVALID) {
+        GOGGLES_LOG_DEBUG("Skipping surface frame with invalid DMA-BUF modifier");
+        return nullptr;
+    }
+    return frame->image.handle ? &frame.value() : nullptr;
+}
+
 static auto scan_presets(const std::filesystem::path& dir) -> std::vector<std::filesystem::path> {
     std::vector<std::filesystem::path> presets;
     std::error_code ec;
@@ -93,18 +114,63 @@ auto Application::init_sdl() -> Result<void> {
     return Result<void>{};
 }
 
+void Application::init_metrics_exporter(const Config& config, const util::AppDirs& app_dirs) {
+    if (!config.metrics.enabled) {
+        return;
+    }
+    // Relative socket paths resolve against the runtime dir; absolute paths are kept as-is.
+    auto exporter_result =
+        util::MetricsExporter::create(util::runtime_path(app_dirs, config.metrics.socket));
+    if (!exporter_result) {
+        GOGGLES_LOG_WARN("Metrics exporter disabled: {}", exporter_result.error().message);
+        return;
+    }
+    m_metrics_exporter = std::move(exporter_result.value());
+}
+
+void Application::init_control_server(const Config& config, const util::AppDirs& app_dirs) {
+    if (!config.control.enabled) {
+        return;
+    }
+    auto server_result = ControlServer::create(util::runtime_path(app_dirs, config.control.socket));
+    if (!server_result) {
+        GOGGLES_LOG_WARN("Control socket disabled: {}", server_result.error().message);
+        return;
+    }
+    m_control_server = std::move(server_result.value());
+}
+
+void Application::init_frame_export(const Config& config, const util::AppDirs& app_dirs) {
+    if (!config.frame_export.enabled) {
+        return;
+    }
+    auto server_result = util::FrameExportServer::create(
+        util::runtime_path(app_dirs, config.frame_export.socket));
+    if (!server_result) {
+        GOGGLES_LOG_WARN("Frame export disabled: {}", server_result.error().message);
+        return;
+    }
+    m_frame_export_server = std::move(server_result.value());
+    m_vulkan_backend->set_frame_export(m_frame_export_server.get(), config.frame_export.ring_size,
+                                       config.frame_export.force_memfd);
+}
+
 auto Application::init_vulkan_backend(const Config& config, const util::AppDirs& app_dirs)
     -> Result<void> {
     render::RenderSettings render_settings{
         .scale_mode = config.render.scale_mode,
         .integer_scale = config.render.integer_scale,
         .target_fps = m_target_fps,
+        .present_policy = config.render.present_policy,
+        .refresh_range = {.min_hz = config.render.vrr_min_hz, .max_hz = config.render.vrr_max_hz},
         .gpu_selector = config.render.gpu_selector,
         .source_width = config.render.source_width,
         .source_height = config.render.source_height,
+        .internal_shader_dir = util::resource_path(app_dirs, "shaders/internal"),
     };
 
     GOGGLES_LOG_INFO("Scale mode: {}", to_string(config.render.scale_mode));
+    GOGGLES_LOG_INFO("Present policy: {}", to_string(config.render.present_policy));
 
     m_vulkan_backend = GOGGLES_MUST(
         render::VulkanBackend::create(m_window, config.render.enable_validation,
@@ -121,6 +187,8 @@ auto Application::init_imgui_layer(const util::AppDirs& app_dirs) -> Result<void
         .device = m_vulkan_backend->vulkan_context().device,
         .queue_family = m_vulkan_backend->vulkan_context().graphics_queue_family,
         .queue = m_vulkan_backend->vulkan_context().graphics_queue,
+        .transfer_queue_family = m_vulkan_backend->vulkan_context().transfer_queue_family,
+        .transfer_queue = m_vulkan_backend->vulkan_context().transfer_queue,
         .swapchain_format = m_vulkan_backend->render_output().swapchain_format,
         .image_count = m_vulkan_backend->render_output().image_count(),
     };
@@ -129,6 +197,9 @@ auto Application::init_imgui_layer(const util::AppDirs& app_dirs) -> Result<void
     m_imgui_layer->set_target_fps(m_target_fps);
     m_imgui_layer->set_target_fps_change_callback(
         [this](uint32_t target_fps) { set_target_fps(target_fps); });
+    m_imgui_layer->set_present_policy(m_vulkan_backend->get_present_policy());
+    m_imgui_layer->set_present_policy_change_callback(
+        [this](PresentPolicy policy) { set_present_policy(policy); });
     GOGGLES_LOG_INFO("ImGui layer initialized");
     return Result<void>{};
 }
@@ -149,8 +220,7 @@ auto Application::init_shader_system(const Config& config, const util::AppDirs&
 
     m_imgui_layer->set_parameter_change_callback(
         [&backend = *m_vulkan_backend](goggles::fc::FilterControlId control_id, float value) {
-            static_cast<void>(
-                backend.filter_chain_controller().set_filter_control_value(control_id, value));
+            backend.filter_chain_controller().queue_filter_control_value(control_id, value);
         });
     m_imgui_layer->set_parameter_reset_callback(
         [&backend = *m_vulkan_backend, layer = m_imgui_layer.get()]() {
@@ -163,8 +233,7 @@ auto Application::init_shader_system(const Config& config, const util::AppDirs&
         });
     m_imgui_layer->set_prechain_parameter_callback(
         [&backend = *m_vulkan_backend](goggles::fc::FilterControlId control_id, float value) {
-            static_cast<void>(
-                backend.filter_chain_controller().set_filter_control_value(control_id, value));
+            backend.filter_chain_controller().queue_filter_control_value(control_id, value);
         });
     m_imgui_layer->set_prechain_scale_mode_callback([this](ScaleMode mode, uint32_t integer_scale) {
         m_vulkan_backend->set_scale_mode(mode);
@@ -182,16 +251,28 @@ auto Application::init_shader_system(const Config& config, const util::AppDirs&
     return Result<void>{};
 }
 
-auto Application::init_compositor_server(const util::AppDirs& app_dirs) -> Result<void> {
+auto Application::init_compositor_server(const util::AppDirs& app_dirs,
+                                         const TargetLauncher& launch_target) -> Result<void> {
     GOGGLES_LOG_INFO("Initializing compositor server...");
     auto cursor_env_result = configure_cursor_theme_env(app_dirs);
     if (!cursor_env_result) {
         GOGGLES_LOG_WARN("Cursor theme setup failed: {}", cursor_env_result.error().message);
     }
-    m_compositor_server = GOGGLES_MUST(compositor::CompositorServer::create());
+    auto on_socket_ready = [&](compositor::CompositorServer& server) {
+        if (launch_target) {
+            launch_target(server.x11_display(), server.wayland_display(), gpu_uuid());
+        }
+    };
+    m_compositor_server = GOGGLES_MUST(compositor::CompositorServer::create(on_socket_ready));
     GOGGLES_LOG_INFO("Compositor server: DISPLAY={} WAYLAND_DISPLAY={}",
                      m_compositor_server->x11_display(), m_compositor_server->wayland_display());
     set_target_fps(m_target_fps);
+    m_compositor_server->set_present_buffer_count(m_present_buffers);
+    update_vrr_pacing();
+    m_compositor_server->set_cursor_plane(m_cursor_plane);
+    if (m_cursor_plane == CursorPlane::overlay) {
+        m_imgui_layer->set_cursor_images(m_compositor_server->cursor_images());
+    }
 
     m_imgui_layer->set_surface_select_callback(
         [app_ptr = this, compositor = m_compositor_server.get()](uint32_t surface_id) {
@@ -202,46 +283,80 @@ auto Application::init_compositor_server(const util::AppDirs& app_dirs) -> Resul
         set_surface_filter_enabled(surface_id, enabled);
         request_surface_resize(surface_id, !compute_surface_filter_chain_enabled(surface_id));
     });
+    m_imgui_layer->set_surface_interpolation_toggle_callback(
+        [this](uint32_t surface_id, bool enabled) {
+            set_surface_interpolation_enabled(surface_id, enabled);
+        });
+    m_imgui_layer->set_surface_tearing_toggle_callback([this](uint32_t surface_id, bool allow) {
+        set_surface_allow_tearing(surface_id, allow);
+    });
     return Result<void>{};
 }
 
-auto Application::init_compositor_server_headless(const util::AppDirs& app_dirs) -> Result<void> {
+auto Application::init_compositor_server_headless(const util::AppDirs& app_dirs,
+                                                  const TargetLauncher& launch_target)
+    -> Result<void> {
     GOGGLES_LOG_INFO("Initializing compositor server (headless)...");
     auto cursor_env_result = configure_cursor_theme_env(app_dirs);
     if (!cursor_env_result) {
         GOGGLES_LOG_WARN("Cursor theme setup failed: {}", cursor_env_result.error().message);
     }
-    m_compositor_server = GOGGLES_MUST(compositor::CompositorServer::create());
+    auto on_socket_ready = [&](compositor::CompositorServer& server) {
+        // Before the target app is launched, so its very first frame is already stepped.
+        server.set_target_fps(m_target_fps);
+        server.set_lockstep(m_lockstep);
+        if (launch_target) {
+            launch_target(server.x11_display(), server.wayland_display(), gpu_uuid());
+        }
+    };
+    m_compositor_server = GOGGLES_MUST(compositor::CompositorServer::create(on_socket_ready));
     GOGGLES_LOG_INFO("Compositor server (headless): DISPLAY={} WAYLAND_DISPLAY={}",
                      m_compositor_server->x11_display(), m_compositor_server->wayland_display());
     set_target_fps(m_target_fps);
+    m_compositor_server->set_present_buffer_count(m_present_buffers);
     // No imgui callbacks in headless mode.
     return Result<void>{};
 }
 
-auto Application::create(const Config& config, const util::AppDirs& app_dirs)
-    -> ResultPtr<Application> {
+auto Application::create(const Config& config, const util::AppDirs& app_dirs,
+                         const TargetLauncher& launch_target) -> ResultPtr<Application> {
     auto app = std::unique_ptr<Application>(new Application());
     app->m_target_fps = config.render.target_fps;
+    app->m_capture_all_surfaces = config.render.capture_all_surfaces;
+    app->m_cursor_plane = config.render.cursor_plane;
+    app->m_present_buffers = config.render.present_buffers;
+    app->m_default_allow_tearing = config.render.allow_tearing;
+    app->m_default_frame_interpolation = config.render.frame_interpolation;
 
+    app->init_metrics_exporter(config, app_dirs);
     GOGGLES_MUST(app->init_sdl());
     GOGGLES_MUST(app->init_vulkan_backend(config, app_dirs));
+    app->init_frame_export(config, app_dirs);
     GOGGLES_MUST(app->init_imgui_layer(app_dirs));
     GOGGLES_MUST(app->init_shader_system(config, app_dirs));
-    GOGGLES_MUST(app->init_compositor_server(app_dirs));
+    GOGGLES_MUST(app->init_compositor_server(app_dirs, launch_target));
+    app->init_control_server(config, app_dirs);
 
     return {std::move(app)};
 }
 
-auto Application::create_headless(const Config& config, const util::AppDirs& app_dirs)
-    -> ResultPtr<Application> {
+auto Application::create_headless(const Config& config, const util::AppDirs& app_dirs,
+                                  const TargetLauncher& launch_target) -> ResultPtr<Application> {
+    if (config.render.lockstep && config.render.target_fps == 0) {
+        return make_error<std::unique_ptr<Application>>(
+            ErrorCode::invalid_config, "Lockstep needs a non-zero target FPS for its clock");
+    }
+
     auto app = std::unique_ptr<Application>(new Application());
     app->m_target_fps = config.render.target_fps;
+    app->m_lockstep = config.render.lockstep;
+    app->init_metrics_exporter(config, app_dirs);
 
     render::RenderSettings render_settings{
         .scale_mode = config.render.scale_mode,
         .integer_scale = config.render.integer_scale,
         .target_fps = app->m_target_fps,
+        .present_policy = config.render.present_policy,
         .gpu_selector = config.render.gpu_selector,
         .source_width = config.render.source_width,
         .source_height = config.render.source_height,
@@ -251,8 +366,10 @@ auto Application::create_headless(const Config& config, const util::AppDirs& app
         config.render.enable_validation, util::cache_path(app_dirs, "shaders"), render_settings));
 
     app->m_vulkan_backend->load_shader_preset(config.shader.preset);
+    app->init_frame_export(config, app_dirs);
 
-    GOGGLES_MUST(app->init_compositor_server_headless(app_dirs));
+    GOGGLES_MUST(app->init_compositor_server_headless(app_dirs, launch_target));
+    app->init_control_server(config, app_dirs);
 
     return {std::move(app)};
 }
@@ -263,9 +380,12 @@ Application::~Application() {
 
 void Application::shutdown() {
     // Destroy in reverse order of creation
+    m_control_server.reset();
     m_imgui_layer.reset();
     m_compositor_server.reset();
     m_vulkan_backend.reset();
+    m_frame_export_server.reset();
+    m_metrics_exporter.reset();
 
     if (m_window != nullptr) {
         SDL_DestroyWindow(m_window);
@@ -301,6 +421,49 @@ auto Application::run_headless(const HeadlessRunContext& ctx) -> Result<void> {
         return make_error<void>(ErrorCode::invalid_config, "frames must be greater than 0");
     }
 
+    if (m_lockstep) {
+        GOGGLES_LOG_INFO("Lockstep: one target frame per rendered frame at a virtual {} FPS",
+                         m_target_fps);
+    }
+
+    std::unique_ptr<util::VideoRecorder> recorder;
+    if (!ctx.record_path.empty()) {
+        const auto extent = m_vulkan_backend->render_output().target_extent();
+        const util::VideoRecorder::Options options{
+            .width = extent.width,
+            .height = extent.height,
+            .fps = m_target_fps,
+            .format = ctx.record_format,
+            .backpressure = ctx.record_backpressure,
+        };
+        recorder = GOGGLES_TRY(util::VideoRecorder::create(ctx.record_path, options));
+        m_vulkan_backend->set_video_recorder(recorder.get());
+    }
+
+    auto frames_result = render_headless_frames(ctx);
+
+    if (recorder) {
+        // Keep what was captured even when the run is cut short.
+        m_vulkan_backend->flush_recording();
+        m_vulkan_backend->set_video_recorder(nullptr);
+        auto finish_result = recorder->finish();
+        if (!finish_result && frames_result) {
+            return finish_result;
+        }
+    }
+    if (!frames_result) {
+        return frames_result;
+    }
+
+    if (!ctx.output.empty()) {
+        GOGGLES_LOG_INFO("Capturing final frame to PNG...");
+        GOGGLES_TRY(m_vulkan_backend->readback_to_png(ctx.output));
+    }
+
+    return Result<void>{};
+}
+
+auto Application::render_headless_frames(const HeadlessRunContext& ctx) -> Result<void> {
     uint32_t delivered_frames = 0;
     uint64_t last_frame_number = 0;
 
@@ -348,16 +511,23 @@ auto Application::run_headless(const HeadlessRunContext& ctx) -> Result<void> {
         last_frame_number = m_surface_frame->frame_number;
 
         if (!m_surface_frame->image.handle) {
+            m_compositor_server->release_lockstep_frame();
             continue;
         }
         if (m_surface_frame->image.format == vk::Format::eUndefined) {
+            m_compositor_server->release_lockstep_frame();
             continue;
         }
         if (m_surface_frame->image.modifier == util::DRM_FORMAT_MOD_INVALID) {
+            m_compositor_server->release_lockstep_frame();
             continue;
         }
 
+        apply_control_commands();
         auto render_result = m_vulkan_backend->render(&m_surface_frame.value(), nullptr);
+        // The frame is consumed once submitted; let the target app produce the next one.
+        m_compositor_server->release_lockstep_frame();
+        forward_present_feedback();
         if (!render_result) {
             GOGGLES_LOG_ERROR("Headless render failed: {}", render_result.error().message);
             continue;
@@ -367,9 +537,6 @@ auto Application::run_headless(const HeadlessRunContext& ctx) -> Result<void> {
         GOGGLES_LOG_DEBUG("Headless frame {}/{} delivered", delivered_frames, ctx.frames);
     }
 
-    GOGGLES_LOG_INFO("Capturing final frame to PNG...");
-    GOGGLES_TRY(m_vulkan_backend->readback_to_png(ctx.output));
-
     return Result<void>{};
 }
 
@@ -511,9 +678,15 @@ void Application::sync_surface_filters(std::vector<compositor::SurfaceInfo>& sur
         if (it == m_surface_state.end()) {
             SurfaceRuntimeState state{};
             state.filter_enabled = default_filter_enabled;
+            state.interpolation_enabled = m_default_frame_interpolation;
             it = m_surface_state.emplace(surface.id, state).first;
+            if (m_default_allow_tearing) {
+                set_surface_allow_tearing(surface.id, true);
+            }
         }
         surface.filter_chain_enabled = it->second.filter_enabled;
+        surface.frame_interpolation_enabled = it->second.interpolation_enabled;
+        surface.allow_tearing = it->second.allow_tearing;
         if (surface.width > 0 && surface.height > 0) {
             if (!it->second.has_resize_state || !it->second.resize.maximized) {
                 it->second.restore_width = static_cast<uint32_t>(surface.width);
@@ -560,21 +733,24 @@ auto Application::compute_surface_filter_chain_enabled(uint32_t surface_id) cons
 }
 
 auto Application::compute_stage_policy() const -> Application::StagePolicy {
+    return compute_surface_stage_policy(m_active_surface_id);
+}
+
+auto Application::compute_surface_stage_policy(uint32_t surface_id) const
+    -> Application::StagePolicy {
     const bool global_filter_enabled = compute_global_filter_chain_enabled();
-    bool surface_filter_enabled = false;
-    if (m_active_surface_id != 0) {
-        auto it = m_surface_state.find(m_active_surface_id);
-        if (it != m_surface_state.end()) {
-            surface_filter_enabled = it->second.filter_enabled;
-        }
-    }
+    const bool surface_filter_enabled = surface_id != 0 && is_surface_filter_enabled(surface_id);
     const bool prechain_enabled = global_filter_enabled && surface_filter_enabled;
 
     const bool effect_checkbox_enabled = !m_imgui_layer || m_imgui_layer->state().shader_enabled;
 
+    auto state = m_surface_state.find(surface_id);
+
     Application::StagePolicy policy{};
     policy.prechain_enabled = prechain_enabled;
     policy.effect_stage_enabled = prechain_enabled && effect_checkbox_enabled;
+    policy.frame_interpolation = surface_id != 0 && state != m_surface_state.end() &&
+                                 state->second.interpolation_enabled;
     return policy;
 }
 
@@ -594,6 +770,23 @@ auto Application::is_surface_filter_enabled(uint32_t surface_id) const -> bool {
     return it != m_surface_state.end() ? it->second.filter_enabled : false;
 }
 
+void Application::set_surface_interpolation_enabled(uint32_t surface_id, bool enabled) {
+    auto it = m_surface_state.find(surface_id);
+    if (it == m_surface_state.end()) {
+        return;
+    }
+    it->second.interpolation_enabled = enabled;
+}
+
+void Application::set_surface_allow_tearing(uint32_t surface_id, bool allow) {
+    auto it = m_surface_state.find(surface_id);
+    if (it == m_surface_state.end() || !m_compositor_server) {
+        return;
+    }
+    it->second.allow_tearing = allow;
+    m_compositor_server->set_surface_allow_tearing(surface_id, allow);
+}
+
 void Application::request_surface_resize(uint32_t surface_id, bool maximize) {
     if (!m_compositor_server || surface_id == 0) {
         return;
@@ -647,10 +840,66 @@ void Application::update_surface_resize_for_surfaces(
     }
 }
 
+void Application::update_output_mode(const std::vector<compositor::SurfaceInfo>& surfaces) {
+    // Dynamic scaling asks the input target to render at the prechain resolution, so the
+    // chain's first pass samples it 1:1 instead of downscaling a full-size frame.
+    compositor::OutputMode mode{};
+    const auto extent = m_vulkan_backend->render_output().swapchain_extent;
+    const auto prechain =
+        m_vulkan_backend->filter_chain_controller().current_prechain_resolution();
+    const auto target = std::find_if(surfaces.begin(), surfaces.end(),
+                                     [](const auto& surface) { return surface.is_input_target; });
+    if (m_vulkan_backend->get_scale_mode() == ScaleMode::dynamic && prechain.width > 0 &&
+        prechain.height > 0 && target != surfaces.end() && !target->is_xwayland &&
+        compute_global_filter_chain_enabled() && is_surface_filter_enabled(target->id)) {
+        // Clients that left their size to us are sized to the viewer.
+        const auto logical_width =
+            target->width > 0 ? static_cast<uint32_t>(target->width) : extent.width;
+        const auto logical_height =
+            target->height > 0 ? static_cast<uint32_t>(target->height) : extent.height;
+        if (logical_width > 0 && logical_height > 0) {
+            mode.width = prechain.width;
+            mode.height = prechain.height;
+            mode.scale = std::min(static_cast<double>(prechain.width) / logical_width,
+                                  static_cast<double>(prechain.height) / logical_height);
+        }
+    }
+    if (mode == m_output_mode) {
+        return;
+    }
+    m_output_mode = mode;
+    m_compositor_server->set_output_mode(mode);
+}
+
+void Application::update_capture_surfaces(const std::vector<compositor::SurfaceInfo>& surfaces) {
+    if (!m_capture_all_surfaces || !m_compositor_server) {
+        return;
+    }
+
+    std::vector<uint32_t> surface_ids;
+    for (const auto& surface : surfaces) {
+        if (surface.id != m_active_surface_id && is_surface_filter_enabled(surface.id) &&
+            surface_ids.size() + 1 < render::backend_internal::SurfaceCompositor::MAX_SURFACES) {
+            surface_ids.push_back(surface.id);
+        }
+    }
+    if (surface_ids == m_capture_surface_ids) {
+        return;
+    }
+
+    for (auto& [surface_id, state] : m_surface_state) {
+        if (std::ranges::find(surface_ids, surface_id) == surface_ids.end()) {
+            state.frame.reset();
+        }
+    }
+    m_capture_surface_ids = surface_ids;
+    m_compositor_server->set_capture_surfaces(std::move(surface_ids));
+}
+
 void Application::handle_swapchain_changes() {
     m_skip_frame = false;
 
-    if (m_pending_format != 0 || m_window_resized || m_vulkan_backend->needs_resize()) {
+    if (m_window_resized || m_vulkan_backend->needs_resize()) {
         GOGGLES_PROFILE_SCOPE("SwapchainRebuild");
         m_vulkan_backend->wait_all_frames();
         m_window_resized = false;
@@ -668,19 +917,11 @@ void Application::handle_swapchain_changes() {
             return;
         }
 
-        auto fmt = vk::Format::eUndefined;
-        if (m_pending_format != 0) {
-            fmt = static_cast<vk::Format>(m_pending_format);
-            m_pending_format = 0;
-        }
-
         auto result = m_vulkan_backend->recreate_swapchain(static_cast<uint32_t>(width),
-                                                           static_cast<uint32_t>(height), fmt);
+                                                           static_cast<uint32_t>(height));
         if (result) {
-            if (fmt != vk::Format::eUndefined) {
-                m_imgui_layer->rebuild_for_format(
-                    m_vulkan_backend->render_output().swapchain_format);
-            }
+            // No-op unless the surface stopped offering the display format.
+            m_imgui_layer->rebuild_for_format(m_vulkan_backend->render_output().swapchain_format);
         } else {
             GOGGLES_LOG_ERROR("Swapchain rebuild failed: {}", result.error().message);
         }
@@ -698,16 +939,84 @@ void Application::update_frame_sources() {
         if (surface_frame) {
             m_surface_frame = std::move(*surface_frame);
         }
+        m_vulkan_backend->set_async_presentation(m_compositor_server->async_presentation());
+
+        for (uint32_t surface_id : m_capture_surface_ids) {
+            auto it = m_surface_state.find(surface_id);
+            if (it == m_surface_state.end()) {
+                continue;
+            }
+            auto& frame = it->second.frame;
+            auto export_frame =
+                m_compositor_server->get_surface_frame(surface_id, frame ? frame->frame_number : 0);
+            if (export_frame) {
+                frame = std::move(*export_frame);
+            }
+        }
     }
+}
 
-    if (m_surface_frame) {
-        if (m_surface_frame->image.format != vk::Format::eUndefined) {
-            auto target_format =
-                render::VulkanBackend::get_matching_swapchain_format(m_surface_frame->image.format);
-            if (target_format != m_vulkan_backend->render_output().swapchain_format) {
-                m_pending_format = static_cast<uint32_t>(m_surface_frame->image.format);
-                m_skip_frame = true;
+void Application::apply_control_commands() {
+    if (m_skip_frame || !m_control_server) {
+        return;
+    }
+    ControlBatch batch;
+    if (m_control_server->drain(batch) == 0) {
+        return;
+    }
+    GOGGLES_PROFILE_FUNCTION();
+
+    auto& controller = m_vulkan_backend->filter_chain_controller();
+    if (batch.preset_path) {
+        if (auto result = m_vulkan_backend->reload_shader_preset(*batch.preset_path); !result) {
+            GOGGLES_LOG_ERROR("Control: failed to load preset '{}': {}",
+                              batch.preset_path->string(), result.error().message);
+        }
+    }
+    if (batch.reset_params) {
+        controller.reset_filter_controls();
+    }
+    if (!batch.params.empty()) {
+        const auto controls = controller.list_filter_controls();
+        std::unordered_map<std::string_view, goggles::fc::FilterControlId> ids_by_name;
+        ids_by_name.reserve(controls.size());
+        for (const auto& control : controls) {
+            ids_by_name.try_emplace(control.name, control.control_id);
+        }
+        for (const auto& [name, value] : batch.params) {
+            const auto it = ids_by_name.find(name);
+            if (it == ids_by_name.end()) {
+                GOGGLES_LOG_WARN("Control: unknown filter control '{}'", name);
+                continue;
             }
+            controller.queue_filter_control_value(it->second, value);
+        }
+        // Apply now so the UI refresh below reads the new values; the chain uploads them once
+        // when the frame is recorded.
+        controller.flush_filter_control_updates();
+    }
+    if (batch.target_fps) {
+        set_target_fps(*batch.target_fps);
+    }
+    if (batch.prechain_resolution) {
+        m_vulkan_backend->set_prechain_resolution(batch.prechain_resolution->width,
+                                                  batch.prechain_resolution->height);
+    }
+    if (batch.surface_id && m_compositor_server) {
+        m_compositor_server->set_input_target(*batch.surface_id);
+        m_surface_frame.reset();
+    }
+
+    if (m_imgui_layer) {
+        if (batch.reset_params || !batch.params.empty()) {
+            update_ui_parameters(*m_vulkan_backend, *m_imgui_layer);
+            m_imgui_layer->set_prechain_parameters(
+                controller.list_filter_controls(goggles::fc::FilterControlStage::prechain));
+        }
+        if (batch.prechain_resolution) {
+            m_imgui_layer->set_prechain_state(controller.current_prechain_resolution(),
+                                              m_vulkan_backend->get_scale_mode(),
+                                              m_vulkan_backend->get_integer_scale());
         }
     }
 }
@@ -730,16 +1039,30 @@ void Application::sync_ui_state() {
             }
         }
     }
+    // A hidden overlay only needs the state that drives the session; display-only snapshots
+    // and chain-swap refreshes wait until it is shown again.
+    const bool ui_visible = m_imgui_layer->is_globally_visible();
     if (m_compositor_server) {
         auto surfaces = m_compositor_server->get_surfaces();
         sync_surface_filters(surfaces);
         update_surface_resize_for_surfaces(surfaces);
-        m_imgui_layer->set_surfaces(std::move(surfaces));
-        m_imgui_layer->set_runtime_metrics(m_compositor_server->get_runtime_metrics_snapshot());
+        update_capture_surfaces(surfaces);
+        update_output_mode(surfaces);
+        if (ui_visible) {
+            m_imgui_layer->set_surfaces(std::move(surfaces));
+            m_imgui_layer->set_runtime_metrics(
+                m_compositor_server->get_runtime_metrics_snapshot());
+        }
     }
 
     sync_prechain_ui();
 
+    if (!ui_visible) {
+        return;
+    }
+    m_imgui_layer->set_gpu_timing(m_vulkan_backend->gpu_timing());
+    m_imgui_layer->set_gpu_memory(m_vulkan_backend->gpu_memory());
+
     if (m_vulkan_backend->filter_chain_controller().consume_chain_swapped()) {
         m_imgui_layer->state().current_preset =
             m_vulkan_backend->filter_chain_controller().current_preset_path();
@@ -757,17 +1080,7 @@ void Application::render_frame() {
         return;
     }
 
-    const util::ExternalImageFrame* source_frame = nullptr;
-
-    if (m_surface_frame) {
-        if (m_surface_frame->image.format == vk::Format::eUndefined) {
-            GOGGLES_LOG_DEBUG("Skipping surface frame with unsupported DRM format");
-        } else if (m_surface_frame->image.modifier == util::DRM_FORMAT_MOD_INVALID) {
-            GOGGLES_LOG_DEBUG("Skipping surface frame with invalid DMA-BUF modifier");
-        } else if (m_surface_frame->image.handle) {
-            source_frame = &m_surface_frame.value();
-        }
-    }
+    const util::ExternalImageFrame* source_frame = usable_surface_frame(m_surface_frame);
 
     if (source_frame) {
         GOGGLES_PROFILE_VALUE("goggles_source_frame",
@@ -775,14 +1088,57 @@ void Application::render_frame() {
     }
 
     auto policy = compute_stage_policy();
+    m_vulkan_backend->set_active_surface(m_active_surface_id);
     m_vulkan_backend->set_filter_chain_policy(
         {.prechain_enabled = policy.prechain_enabled,
-         .effect_stage_enabled = policy.effect_stage_enabled});
+         .effect_stage_enabled = policy.effect_stage_enabled,
+         .frame_interpolation = policy.frame_interpolation});
+    if (skip_presented_frame(source_frame)) {
+        return;
+    }
+
+    render::VulkanBackend::UiRenderCallback ui_callback;
+    if (m_imgui_layer->is_globally_visible()) {
+        ui_callback = [this](vk::CommandBuffer cmd, vk::ImageView view, vk::Extent2D extent) {
+            m_imgui_layer->end_frame();
+            m_imgui_layer->record(cmd, view, extent);
+        };
+    } else if (m_cursor_plane == CursorPlane::overlay && source_frame) {
+        // The compositor hides the app cursor while the UI is up, so the two never share a pass.
+        ui_callback = [this, source_frame](vk::CommandBuffer cmd, vk::ImageView view,
+                                           vk::Extent2D extent) {
+            if (auto cursor = cursor_overlay(*source_frame, extent)) {
+                m_imgui_layer->record_cursor(cmd, view, extent, *cursor);
+            }
+        };
+    }
+    if (!m_capture_surface_ids.empty()) {
+        GOGGLES_PROFILE_SCOPE("RenderSurfaces");
+        std::vector<render::SurfaceSource> sources;
+        sources.reserve(m_capture_surface_ids.size() + 1);
+        sources.push_back({.surface_id = m_active_surface_id,
+                           .frame = source_frame,
+                           .policy = {.prechain_enabled = policy.prechain_enabled,
+                                      .effect_stage_enabled = policy.effect_stage_enabled,
+                                      .frame_interpolation = policy.frame_interpolation}});
+        for (uint32_t surface_id : m_capture_surface_ids) {
+            auto it = m_surface_state.find(surface_id);
+            const auto surface_policy = compute_surface_stage_policy(surface_id);
+            sources.push_back(
+                {.surface_id = surface_id,
+                 .frame = it != m_surface_state.end() ? usable_surface_frame(it->second.frame)
+                                                      : nullptr,
+                 .policy = {.prechain_enabled = surface_policy.prechain_enabled,
+                            .effect_stage_enabled = surface_policy.effect_stage_enabled,
+                            .frame_interpolation = surface_policy.frame_interpolation}});
+        }
+        auto render_result = m_vulkan_backend->render_surfaces(sources, ui_callback);
+        if (!render_result) {
+            GOGGLES_LOG_ERROR("Multi-surface render failed: {}", render_result.error().message);
+        }
+        return;
+    }
 
-    auto ui_callback = [this](vk::CommandBuffer cmd, vk::ImageView view, vk::Extent2D extent) {
-        m_imgui_layer->end_frame();
-        m_imgui_layer->record(cmd, view, extent);
-    };
     [[maybe_unused]] const char* scope_name = source_frame ? "RenderFrame" : "RenderClear";
     [[maybe_unused]] const char* error_label = source_frame ? "Render" : "Clear";
     GOGGLES_PROFILE_SCOPE("Render");
@@ -793,11 +1149,119 @@ void Application::render_frame() {
     }
 }
 
+auto Application::skip_presented_frame(const util::ExternalImageFrame* source_frame) -> bool {
+    const bool ui_visible = m_imgui_layer->is_globally_visible();
+    std::optional<ui::CursorOverlay> cursor;
+    if (source_frame && !ui_visible && m_cursor_plane == CursorPlane::overlay) {
+        cursor = cursor_overlay(*source_frame, m_vulkan_backend->render_output().target_extent());
+    }
+    // VRR repeats are presented on purpose to keep the display inside its refresh window.
+    const bool skip = source_frame && m_capture_surface_ids.empty() && !ui_visible &&
+                      !m_presented_ui && cursor == m_presented_cursor &&
+                      m_vulkan_backend->get_present_policy() != PresentPolicy::vrr &&
+                      m_vulkan_backend->is_frame_presented(*source_frame);
+    m_presented_ui = ui_visible;
+    m_presented_cursor = cursor;
+    if (!skip) {
+        return false;
+    }
+
+    GOGGLES_PROFILE_SCOPE("SkipPresentedFrame");
+    util::Metrics::increment(util::MetricCounter::frames_skipped);
+    if (m_compositor_server) {
+        // About one refresh at 240 Hz, so input and cursor updates stay as prompt as presenting.
+        constexpr auto IDLE_WAIT = std::chrono::milliseconds(4);
+        static_cast<void>(m_compositor_server->wait_for_presented_frame(
+            source_frame->frame_number, std::chrono::steady_clock::now() + IDLE_WAIT));
+    }
+    return true;
+}
+
+auto Application::cursor_overlay(const util::ExternalImageFrame& frame, vk::Extent2D extent) const
+    -> std::optional<ui::CursorOverlay> {
+    const auto state = m_compositor_server->get_cursor_state();
+    if (!state.visible || frame.image.width == 0 || frame.image.height == 0) {
+        return std::nullopt;
+    }
+
+    // The input target is always the first tile in multi-surface mode.
+    vk::Rect2D cell{{0, 0}, extent};
+    if (!m_capture_surface_ids.empty()) {
+        cell = render::backend_internal::compute_surface_tiles(
+            extent, static_cast<uint32_t>(m_capture_surface_ids.size() + 1))[0];
+    }
+    const auto rect = compute_scaled_rect(
+        m_vulkan_backend->get_scale_mode(), m_vulkan_backend->get_integer_scale(),
+        frame.image.width, frame.image.height, cell.extent.width, cell.extent.height);
+    const float scale_x = rect.width / static_cast<float>(frame.image.width);
+    const float scale_y = rect.height / static_cast<float>(frame.image.height);
+    const auto image_scale = static_cast<float>(state.scale);
+    return ui::CursorOverlay{
+        .x = static_cast<float>(cell.offset.x) + rect.x + (static_cast<float>(state.x) * scale_x),
+        .y = static_cast<float>(cell.offset.y) + rect.y + (static_cast<float>(state.y) * scale_y),
+        .scale_x = scale_x * image_scale,
+        .scale_y = scale_y * image_scale,
+        .image_index = state.image_index,
+    };
+}
+
 void Application::tick_frame() {
     handle_swapchain_changes();
     update_frame_sources();
+    apply_control_commands();
+    if (!vrr_frame_due()) {
+        return;
+    }
     sync_ui_state();
     render_frame();
+    forward_present_feedback();
+}
+
+auto Application::vrr_frame_due() -> bool {
+    if (m_skip_frame || !m_compositor_server ||
+        m_vulkan_backend->get_present_policy() != PresentPolicy::vrr ||
+        m_compositor_server->async_presentation()) {
+        return true;
+    }
+
+    using Clock = util::VrrPacer::Clock;
+    const auto now = Clock::now();
+    const uint64_t frame_number = m_surface_frame ? m_surface_frame->frame_number : 0;
+    const bool new_frame = frame_number != m_vrr_source_frame_number;
+    if (new_frame) {
+        m_vrr_source_frame_number = frame_number;
+        m_vrr_pacer.on_source_frame(now);
+    }
+
+    // New frames go out as they arrive and the overlay redraws at the display's max refresh.
+    // Past the deadline the last frame is repeated to keep the display inside its VRR window.
+    const auto deadline = m_vrr_pacer.repeat_deadline();
+    if (new_frame || m_imgui_layer->is_globally_visible() || now >= deadline) {
+        m_vrr_pacer.on_present(now);
+        return true;
+    }
+    // Either way the next tick picks up the frame after handling pending events.
+    static_cast<void>(m_compositor_server->wait_for_presented_frame(frame_number, deadline));
+    return false;
+}
+
+void Application::update_vrr_pacing() {
+    if (!m_compositor_server) {
+        return;
+    }
+    const bool vrr = m_vulkan_backend->get_present_policy() == PresentPolicy::vrr;
+    m_vrr_pacer.set_range(m_vulkan_backend->refresh_range());
+    m_vrr_pacer.reset();
+    m_compositor_server->set_vrr_pacing(vrr ? std::optional(m_vulkan_backend->refresh_range())
+                                            : std::nullopt);
+}
+
+void Application::forward_present_feedback() {
+    for (const auto& feedback : m_vulkan_backend->take_present_feedback()) {
+        if (m_compositor_server) {
+            m_compositor_server->report_present_feedback(feedback);
+        }
+    }
 }
 
 // =============================================================================
@@ -812,6 +1276,10 @@ auto Application::wayland_display() const -> std::string {
     return m_compositor_server ? m_compositor_server->wayland_display() : "";
 }
 
+auto Application::xwayland_ready() const -> std::shared_future<bool> {
+    return m_compositor_server ? m_compositor_server->xwayland_ready() : std::shared_future<bool>{};
+}
+
 auto Application::target_fps() const -> uint32_t {
     return m_target_fps;
 }
@@ -829,6 +1297,16 @@ void Application::set_target_fps(uint32_t target_fps) {
     }
 }
 
+void Application::set_present_policy(PresentPolicy policy) {
+    if (m_imgui_layer) {
+        m_imgui_layer->set_present_policy(policy);
+    }
+    if (m_vulkan_backend) {
+        m_vulkan_backend->set_present_policy(policy);
+        update_vrr_pacing();
+    }
+}
+
 auto Application::gpu_index() const -> uint32_t {
     return m_vulkan_backend->vulkan_context().gpu_index;
 }
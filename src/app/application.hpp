@@ -3,6 +3,8 @@
 #include <compositor/compositor_server.hpp>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <goggles/error.hpp>
 #include <memory>
 #include <optional>
@@ -12,6 +14,8 @@
 #include <util/config.hpp>
 #include <util/external_image.hpp>
 #include <util/paths.hpp>
+#include <util/video_recorder.hpp>
+#include <util/vrr_pacing.hpp>
 
 struct SDL_Window;
 union SDL_Event;
@@ -26,15 +30,31 @@ class VulkanBackend;
 
 namespace ui {
 class ImGuiLayer;
+struct CursorOverlay;
+}
+
+namespace util {
+class FrameExportServer;
+class MetricsExporter;
 }
 
 namespace app {
 
+class ControlServer;
+
 class Application {
 public:
-    [[nodiscard]] static auto create(const Config& config, const util::AppDirs& app_dirs)
+    /// Launches the target app against the given displays. Called once from compositor start-up,
+    /// as soon as its sockets exist and before its backend and output setup.
+    using TargetLauncher = std::function<void(const std::string& x11_display,
+                                              const std::string& wayland_display,
+                                              const std::string& gpu_uuid)>;
+
+    [[nodiscard]] static auto create(const Config& config, const util::AppDirs& app_dirs,
+                                     const TargetLauncher& launch_target = {})
         -> ResultPtr<Application>;
-    [[nodiscard]] static auto create_headless(const Config& config, const util::AppDirs& app_dirs)
+    [[nodiscard]] static auto create_headless(const Config& config, const util::AppDirs& app_dirs,
+                                              const TargetLauncher& launch_target = {})
         -> ResultPtr<Application>;
 
     ~Application();
@@ -52,6 +72,10 @@ public:
         std::filesystem::path output;
         int signal_fd;
         pid_t child_pid;
+        /// Recording of every rendered frame; empty disables recording.
+        std::filesystem::path record_path;
+        util::RecordBackpressure record_backpressure = util::RecordBackpressure::block;
+        util::RecordFormat record_format = util::RecordFormat::y4m;
     };
     [[nodiscard]] auto run_headless(const HeadlessRunContext& ctx) -> Result<void>;
     void process_event();
@@ -60,50 +84,83 @@ public:
     [[nodiscard]] auto is_running() const -> bool { return m_running; }
     [[nodiscard]] auto x11_display() const -> std::string;
     [[nodiscard]] auto wayland_display() const -> std::string;
+    /// See `CompositorServer::xwayland_ready()`.
+    [[nodiscard]] auto xwayland_ready() const -> std::shared_future<bool>;
     [[nodiscard]] auto target_fps() const -> uint32_t;
     void set_target_fps(uint32_t target_fps);
+    void set_present_policy(PresentPolicy policy);
     [[nodiscard]] auto gpu_index() const -> uint32_t;
     [[nodiscard]] auto gpu_uuid() const -> std::string;
 
 private:
+    [[nodiscard]] auto render_headless_frames(const HeadlessRunContext& ctx) -> Result<void>;
     Application() = default;
 
     void forward_input_event(const SDL_Event& event);
     [[nodiscard]] auto init_sdl() -> Result<void>;
+    void init_metrics_exporter(const Config& config, const util::AppDirs& app_dirs);
+    void init_control_server(const Config& config, const util::AppDirs& app_dirs);
+    void init_frame_export(const Config& config, const util::AppDirs& app_dirs);
     [[nodiscard]] auto init_vulkan_backend(const Config& config, const util::AppDirs& app_dirs)
         -> Result<void>;
     [[nodiscard]] auto init_imgui_layer(const util::AppDirs& app_dirs) -> Result<void>;
     [[nodiscard]] auto init_shader_system(const Config& config, const util::AppDirs& app_dirs)
         -> Result<void>;
-    [[nodiscard]] auto init_compositor_server(const util::AppDirs& app_dirs) -> Result<void>;
-    [[nodiscard]] auto init_compositor_server_headless(const util::AppDirs& app_dirs)
+    [[nodiscard]] auto init_compositor_server(const util::AppDirs& app_dirs,
+                                              const TargetLauncher& launch_target)
+        -> Result<void>;
+    [[nodiscard]] auto init_compositor_server_headless(const util::AppDirs& app_dirs,
+                                                       const TargetLauncher& launch_target)
         -> Result<void>;
     void handle_swapchain_changes();
     void update_frame_sources();
+    void apply_control_commands();
+    /// Under the `vrr` policy, renders only for a new source frame or a due repeat; otherwise
+    /// waits for one until the repeat deadline and returns false to go back to event handling.
+    [[nodiscard]] auto vrr_frame_due() -> bool;
+    void update_vrr_pacing();
     void sync_ui_state();
     void render_frame();
+    /// True when the last present already shows `source_frame` with the same overlay, so the
+    /// frame is skipped; waits briefly for a new source frame before returning.
+    [[nodiscard]] auto skip_presented_frame(const util::ExternalImageFrame* source_frame) -> bool;
+    /// Viewer placement of the app cursor over `frame`, or nothing when it is not shown.
+    [[nodiscard]] auto cursor_overlay(const util::ExternalImageFrame& frame,
+                                      vk::Extent2D extent) const
+        -> std::optional<ui::CursorOverlay>;
     void update_pointer_lock_mirror();
     void update_cursor_visibility();
     void update_mouse_grab();
     void sync_prechain_ui();
+    /// Hands completed viewer presents to the compositor for client presentation feedback.
+    void forward_present_feedback();
     void sync_surface_filters(std::vector<compositor::SurfaceInfo>& surfaces);
     void update_surface_resize_for_surfaces(const std::vector<compositor::SurfaceInfo>& surfaces);
+    void update_capture_surfaces(const std::vector<compositor::SurfaceInfo>& surfaces);
+    void update_output_mode(const std::vector<compositor::SurfaceInfo>& surfaces);
     [[nodiscard]] auto compute_global_filter_chain_enabled() const -> bool;
     [[nodiscard]] auto compute_surface_filter_chain_enabled(uint32_t surface_id) const -> bool;
     struct StagePolicy {
         bool prechain_enabled = true;
         bool effect_stage_enabled = true;
+        bool frame_interpolation = false;
     };
     [[nodiscard]] auto compute_stage_policy() const -> StagePolicy;
+    [[nodiscard]] auto compute_surface_stage_policy(uint32_t surface_id) const -> StagePolicy;
     void request_surface_resize(uint32_t surface_id, bool maximize);
     void set_surface_filter_enabled(uint32_t surface_id, bool enabled);
     [[nodiscard]] auto is_surface_filter_enabled(uint32_t surface_id) const -> bool;
+    void set_surface_interpolation_enabled(uint32_t surface_id, bool enabled);
+    void set_surface_allow_tearing(uint32_t surface_id, bool allow);
 
     SDL_Window* m_window = nullptr;
     bool m_sdl_initialized = false;
     std::unique_ptr<render::VulkanBackend> m_vulkan_backend;
     std::unique_ptr<ui::ImGuiLayer> m_imgui_layer;
     std::unique_ptr<compositor::CompositorServer> m_compositor_server;
+    std::unique_ptr<util::MetricsExporter> m_metrics_exporter;
+    std::unique_ptr<ControlServer> m_control_server;
+    std::unique_ptr<util::FrameExportServer> m_frame_export_server;
     std::optional<util::ExternalImageFrame> m_surface_frame;
 
     struct SurfaceResizeState {
@@ -113,15 +170,37 @@ private:
     };
     struct SurfaceRuntimeState {
         bool filter_enabled = false;
+        bool interpolation_enabled = false;
+        bool allow_tearing = false;
         SurfaceResizeState resize;
         bool has_resize_state = false;
         uint32_t restore_width = 0;
         uint32_t restore_height = 0;
         bool has_restore_size = false;
+        // Latest export while the surface is captured alongside the input target.
+        std::optional<util::ExternalImageFrame> frame;
     };
     std::unordered_map<uint32_t, SurfaceRuntimeState> m_surface_state;
+    // Non-target surfaces registered with the compositor for multi-surface capture.
+    std::vector<uint32_t> m_capture_surface_ids;
+    bool m_capture_all_surfaces = false;
+    CursorPlane m_cursor_plane = CursorPlane::overlay;
+    uint32_t m_present_buffers = 3;
+    // Initial tearing toggle of newly seen surfaces.
+    bool m_default_allow_tearing = false;
+    // Initial frame interpolation toggle of newly seen surfaces.
+    bool m_default_frame_interpolation = false;
+    util::VrrPacer m_vrr_pacer;
+    // Source frame the VRR pacer last saw arrive.
+    uint64_t m_vrr_source_frame_number = 0;
+    // Overlay drawn into the last single-surface present.
+    bool m_presented_ui = true;
+    std::optional<ui::CursorOverlay> m_presented_cursor;
+    compositor::OutputMode m_output_mode;
     uint32_t m_active_surface_id = 0;
     uint32_t m_target_fps = 60;
+    // Headless frames are stepped by the compositor's virtual clock; see `set_lockstep()`.
+    bool m_lockstep = false;
 
     bool m_running = true;
     bool m_window_resized = false;
@@ -129,7 +208,6 @@ private:
     bool m_cursor_visible = true;
     bool m_mouse_grabbed = false;
     bool m_skip_frame = false;
-    uint32_t m_pending_format = 0;
 };
 
 } // namespace app
@@ -40,11 +40,43 @@ auto register_options(CLI::App& app, CliOptions& options) -> void {
         ->check(CLI::Range(1u, 16384u));
     app.add_option("--target-fps", options.target_fps, "Override render target FPS (0 = uncapped)")
         ->check(CLI::Range(0u, 1000u));
+    const auto on_present_policy = [&options](const std::string& value) {
+        options.present_policy = parse_present_policy(value);
+    };
+    app.add_option_function<std::string>("--present-policy", on_present_policy,
+                                         "Override present policy "
+                                         "(low_latency, smooth, adaptive, vrr)")
+        ->check(CLI::IsMember({"low_latency", "smooth", "adaptive", "vrr"}));
     app.add_flag("--headless", options.headless, "Run without a window (headless mode)");
+    app.add_flag("--metrics", options.metrics,
+                 "Serve OpenMetrics on a Unix socket in the runtime directory");
+    app.add_flag("--control", options.control,
+                 "Accept JSON-lines control commands on a Unix socket in the runtime directory");
     app.add_option("--frames", options.frames,
                    "Number of compositor frames to capture (headless mode)")
         ->check(CLI::Range(1u, 100000u));
     app.add_option("--output", options.output_path, "Output PNG file path (headless mode)");
+    app.add_option("--record", options.record_path,
+                   "Record every rendered frame to a video file (headless mode)");
+    const auto on_record_format = [&options](const std::string& value) {
+        options.record_format = util::parse_record_format(value);
+    };
+    app.add_option_function<std::string>("--record-format", on_record_format,
+                                         "Recording format: y4m (lossy BT.601 YUV4MPEG2) or "
+                                         "rgba (lossless raw RGBA8 plus a .index.csv of frame "
+                                         "timestamps); defaults to rgba with "
+                                         "--lockstep, y4m otherwise")
+        ->check(CLI::IsMember({"y4m", "rgba"}));
+    const auto on_record_policy = [&options](const std::string& value) {
+        options.record_backpressure =
+            util::parse_record_backpressure(value).value_or(util::RecordBackpressure::block);
+    };
+    app.add_option_function<std::string>("--record-policy", on_record_policy,
+                                         "When the recorder falls behind (block, drop)")
+        ->check(CLI::IsMember({"block", "drop"}));
+    app.add_flag("--lockstep", options.lockstep,
+                 "Step the target app one frame per rendered frame on a virtual clock "
+                 "(headless mode)");
 }
 
 [[nodiscard]] auto validate_default_mode(int argc, bool has_separator, const CliOptions& options)
@@ -74,6 +106,7 @@ auto parse_cli(int argc, char** argv) -> CliResult {
     app.set_version_flag("--version,-v", GOGGLES_PROJECT_NAME " v" GOGGLES_VERSION);
     app.footer(R"(Usage:
   goggles --headless --frames N --output <path.png> [options] -- <app> [app_args...]
+  goggles --headless --frames N --record <path> [options] -- <app> [app_args...]
   goggles [options] -- <app> [app_args...]
 
 Notes:
@@ -117,11 +150,14 @@ Notes:
             return make_error<CliParseOutcome>(ErrorCode::parse_error,
                                                "--headless requires --frames");
         }
-        if (options.output_path.empty()) {
+        if (options.output_path.empty() && options.record_path.empty()) {
             return make_error<CliParseOutcome>(ErrorCode::parse_error,
-                                               "--headless requires --output");
+                                               "--headless requires --output or --record");
         }
         // Headless mode also requires an app command (validated by default mode below).
+    } else if (options.lockstep) {
+        return make_error<CliParseOutcome>(ErrorCode::parse_error,
+                                           "--lockstep requires --headless");
     }
 
     auto validation_result = validate_default_mode(argc, has_separator, options);
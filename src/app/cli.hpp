@@ -5,6 +5,8 @@
 #include <goggles/error.hpp>
 #include <optional>
 #include <string>
+#include <util/present_policy.hpp>
+#include <util/video_recorder.hpp>
 #include <vector>
 
 namespace goggles::app {
@@ -16,9 +18,17 @@ struct CliOptions {
     uint32_t app_width = 0;
     uint32_t app_height = 0;
     std::optional<uint32_t> target_fps;
+    std::optional<PresentPolicy> present_policy;
     bool headless = false;
+    bool metrics = false;
+    bool control = false;
     uint32_t frames = 0;
     std::filesystem::path output_path;
+    std::filesystem::path record_path;
+    util::RecordBackpressure record_backpressure = util::RecordBackpressure::block;
+    /// Unset picks `rgba` under `--lockstep` (bit-exact golden captures) and `y4m` otherwise.
+    std::optional<util::RecordFormat> record_format;
+    bool lockstep = false;
     std::vector<std::string> app_command;
 };
 
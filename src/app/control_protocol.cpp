@@ -0,0 +1,274 @@
+#include "control_protocol.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <variant>
+
+namespace goggles::app {
+
+namespace {
+
+using JsonScalar = std::variant<std::monostate, bool, double, std::string>;
+
+/// Reads the flat JSON subset used by the control protocol: one object of scalars, plus a
+/// single nested object of numbers for `params`. Arrays are rejected.
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view text) : m_text(text) {}
+
+    [[nodiscard]] auto parse_request(std::unordered_map<std::string, JsonScalar>& fields,
+                                     std::vector<ControlParam>& params) -> Result<void> {
+        GOGGLES_TRY(expect('{'));
+        if (!consume('}')) {
+            do {
+                auto key = GOGGLES_TRY(parse_string());
+                GOGGLES_TRY(expect(':'));
+                if (key == "params") {
+                    GOGGLES_TRY(parse_params(params));
+                } else {
+                    fields[std::move(key)] = GOGGLES_TRY(parse_scalar());
+                }
+            } while (consume(','));
+            GOGGLES_TRY(expect('}'));
+        }
+        skip_whitespace();
+        if (m_pos != m_text.size()) {
+            return error<void>("trailing characters after request object");
+        }
+        return {};
+    }
+
+private:
+    template <typename T>
+    [[nodiscard]] auto error(std::string_view message) const -> Result<T> {
+        return make_error<T>(ErrorCode::parse_error, "Control request: " + std::string(message) +
+                                                         " at offset " + std::to_string(m_pos));
+    }
+
+    void skip_whitespace() {
+        while (m_pos < m_text.size() &&
+               (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\r')) {
+            ++m_pos;
+        }
+    }
+
+    [[nodiscard]] auto consume(char c) -> bool {
+        skip_whitespace();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] auto expect(char c) -> Result<void> {
+        if (!consume(c)) {
+            return error<void>(std::string("expected '") + c + "'");
+        }
+        return {};
+    }
+
+    [[nodiscard]] auto parse_params(std::vector<ControlParam>& params) -> Result<void> {
+        GOGGLES_TRY(expect('{'));
+        if (consume('}')) {
+            return {};
+        }
+        do {
+            auto name = GOGGLES_TRY(parse_string());
+            GOGGLES_TRY(expect(':'));
+            const auto value = GOGGLES_TRY(parse_number());
+            if (!std::isfinite(value)) {
+                return error<void>("parameter value is not finite");
+            }
+            params.push_back({.name = std::move(name), .value = static_cast<float>(value)});
+        } while (consume(','));
+        return expect('}');
+    }
+
+    [[nodiscard]] auto parse_scalar() -> Result<JsonScalar> {
+        skip_whitespace();
+        if (m_pos >= m_text.size()) {
+            return error<JsonScalar>("unexpected end of request");
+        }
+        const char c = m_text[m_pos];
+        if (c == '"') {
+            return JsonScalar{GOGGLES_TRY(parse_string())};
+        }
+        if (c == 't' || c == 'f' || c == 'n') {
+            for (const auto& [literal, value] :
+                 {std::pair<std::string_view, JsonScalar>{"true", true},
+                  std::pair<std::string_view, JsonScalar>{"false", false},
+                  std::pair<std::string_view, JsonScalar>{"null", std::monostate{}}}) {
+                if (m_text.substr(m_pos).starts_with(literal)) {
+                    m_pos += literal.size();
+                    return value;
+                }
+            }
+            return error<JsonScalar>("invalid literal");
+        }
+        if (c == '{' || c == '[') {
+            return error<JsonScalar>("nested values are only supported for 'params'");
+        }
+        return JsonScalar{GOGGLES_TRY(parse_number())};
+    }
+
+    [[nodiscard]] auto parse_number() -> Result<double> {
+        skip_whitespace();
+        const auto begin = m_pos;
+        while (m_pos < m_text.size() &&
+               std::string_view("+-.0123456789eE").find(m_text[m_pos]) != std::string_view::npos) {
+            ++m_pos;
+        }
+        double value = 0.0;
+        const auto* first = m_text.data() + begin;
+        const auto* last = m_text.data() + m_pos;
+        const auto [ptr, ec] = std::from_chars(first, last, value);
+        if (begin == m_pos || ec != std::errc{} || ptr != last) {
+            m_pos = begin;
+            return error<double>("expected a number");
+        }
+        return value;
+    }
+
+    [[nodiscard]] auto parse_string() -> Result<std::string> {
+        GOGGLES_TRY(expect('"'));
+        std::string out;
+        while (m_pos < m_text.size()) {
+            const char c = m_text[m_pos++];
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (m_pos >= m_text.size()) {
+                break;
+            }
+            switch (const char escaped = m_text[m_pos++]; escaped) {
+            case '"':
+            case '\\':
+            case '/':
+                out.push_back(escaped);
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            default:
+                return error<std::string>("unsupported string escape");
+            }
+        }
+        return error<std::string>("unterminated string");
+    }
+
+    std::string_view m_text;
+    size_t m_pos = 0;
+};
+
+template <typename T>
+[[nodiscard]] auto required_field(const std::unordered_map<std::string, JsonScalar>& fields,
+                                  const std::string& name) -> Result<T> {
+    const auto it = fields.find(name);
+    if (it == fields.end()) {
+        return make_error<T>(ErrorCode::parse_error, "Control request: missing '" + name + "'");
+    }
+    const auto* value = std::get_if<T>(&it->second);
+    if (value == nullptr) {
+        return make_error<T>(ErrorCode::parse_error,
+                             "Control request: '" + name + "' has the wrong type");
+    }
+    return *value;
+}
+
+[[nodiscard]] auto required_uint(const std::unordered_map<std::string, JsonScalar>& fields,
+                                 const std::string& name) -> Result<uint32_t> {
+    const auto value = GOGGLES_TRY(required_field<double>(fields, name));
+    if (value < 0.0 || value > static_cast<double>(std::numeric_limits<uint32_t>::max()) ||
+        std::trunc(value) != value) {
+        return make_error<uint32_t>(ErrorCode::parse_error, "Control request: '" + name +
+                                                                "' must be an unsigned integer");
+    }
+    return static_cast<uint32_t>(value);
+}
+
+} // namespace
+
+auto parse_control_command(std::string_view line) -> Result<ControlCommand> {
+    std::unordered_map<std::string, JsonScalar> fields;
+    ControlCommand command;
+    GOGGLES_TRY(JsonReader(line).parse_request(fields, command.params));
+
+    const auto cmd = GOGGLES_TRY(required_field<std::string>(fields, "cmd"));
+    if (cmd == "set_params") {
+        command.type = ControlCommandType::set_params;
+    } else if (cmd == "reset_params") {
+        command.type = ControlCommandType::reset_params;
+    } else if (cmd == "load_preset") {
+        command.type = ControlCommandType::load_preset;
+        command.preset_path = GOGGLES_TRY(required_field<std::string>(fields, "path"));
+        if (command.preset_path.empty()) {
+            return make_error<ControlCommand>(ErrorCode::parse_error,
+                                              "Control request: 'path' must not be empty");
+        }
+    } else if (cmd == "set_target_fps") {
+        command.type = ControlCommandType::set_target_fps;
+        command.target_fps = GOGGLES_TRY(required_uint(fields, "fps"));
+    } else if (cmd == "set_prechain_resolution") {
+        command.type = ControlCommandType::set_prechain_resolution;
+        command.width = GOGGLES_TRY(required_uint(fields, "width"));
+        command.height = GOGGLES_TRY(required_uint(fields, "height"));
+    } else if (cmd == "select_surface") {
+        command.type = ControlCommandType::select_surface;
+        command.surface_id = GOGGLES_TRY(required_uint(fields, "id"));
+    } else {
+        return make_error<ControlCommand>(ErrorCode::parse_error,
+                                          "Control request: unknown cmd '" + cmd + "'");
+    }
+
+    if (command.type != ControlCommandType::set_params && !command.params.empty()) {
+        return make_error<ControlCommand>(ErrorCode::parse_error,
+                                          "Control request: 'params' is only valid for set_params");
+    }
+    return command;
+}
+
+void ControlBatch::merge(ControlCommand command) {
+    switch (command.type) {
+    case ControlCommandType::set_params:
+        for (auto& param : command.params) {
+            params.insert_or_assign(std::move(param.name), param.value);
+        }
+        break;
+    case ControlCommandType::reset_params:
+        reset_params = true;
+        params.clear();
+        break;
+    case ControlCommandType::load_preset:
+        preset_path = std::move(command.preset_path);
+        break;
+    case ControlCommandType::set_target_fps:
+        target_fps = command.target_fps;
+        break;
+    case ControlCommandType::set_prechain_resolution:
+        prechain_resolution = Resolution{.width = command.width, .height = command.height};
+        break;
+    case ControlCommandType::select_surface:
+        surface_id = command.surface_id;
+        break;
+    }
+}
+
+auto ControlBatch::empty() const -> bool {
+    return !reset_params && params.empty() && !preset_path && !target_fps &&
+           !prechain_resolution && !surface_id;
+}
+
+} // namespace goggles::app
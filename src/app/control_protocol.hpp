@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <goggles/error.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace goggles::app {
+
+enum class ControlCommandType : std::uint8_t {
+    set_params,
+    reset_params,
+    load_preset,
+    set_target_fps,
+    set_prechain_resolution,
+    select_surface,
+};
+
+struct ControlParam {
+    std::string name;
+    float value = 0.0F;
+};
+
+/// @brief One JSON-lines request received on the control socket.
+///
+/// Only the fields relevant to `type` are populated.
+struct ControlCommand {
+    ControlCommandType type = ControlCommandType::set_params;
+    std::vector<ControlParam> params;
+    std::filesystem::path preset_path;
+    uint32_t target_fps = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t surface_id = 0;
+};
+
+/// @brief Parses one control request line.
+///
+/// Accepted shapes (one JSON object per line):
+/// - `{"cmd":"set_params","params":{"<control name>":<number>,...}}`
+/// - `{"cmd":"reset_params"}`
+/// - `{"cmd":"load_preset","path":"<preset.slangp>"}`
+/// - `{"cmd":"set_target_fps","fps":<uint>}`
+/// - `{"cmd":"set_prechain_resolution","width":<uint>,"height":<uint>}`
+/// - `{"cmd":"select_surface","id":<uint>}`
+[[nodiscard]] auto parse_control_command(std::string_view line) -> Result<ControlCommand>;
+
+/// @brief Commands coalesced between two frame boundaries; later values win.
+///
+/// A `reset_params` discards parameter values queued before it, so the reset is applied first
+/// and later `set_params` values land on top of the defaults.
+struct ControlBatch {
+    struct Resolution {
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    bool reset_params = false;
+    std::unordered_map<std::string, float> params;
+    std::optional<std::filesystem::path> preset_path;
+    std::optional<uint32_t> target_fps;
+    std::optional<Resolution> prechain_resolution;
+    std::optional<uint32_t> surface_id;
+
+    void merge(ControlCommand command);
+    [[nodiscard]] auto empty() const -> bool;
+};
+
+} // namespace goggles::app
@@ -0,0 +1,179 @@
+#include "control_server.hpp"
+
+#include <array>
+#include <cerrno>
+#include <goggles/profiling.hpp>
+#include <poll.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <util/logging.hpp>
+#include <util/unix_socket.hpp>
+#include <vector>
+
+namespace goggles::app {
+
+namespace {
+
+constexpr int K_POLL_INTERVAL_MS = 200;
+
+struct ControlClient {
+    util::UniqueFd fd;
+    std::string pending;
+};
+
+auto escape_json(std::string_view text) -> std::string {
+    std::string out;
+    out.reserve(text.size());
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out.push_back(' ');
+        } else {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+void send_reply(int fd, std::string_view reply) {
+    while (!reply.empty()) {
+        const auto sent = ::send(fd, reply.data(), reply.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // A client that stops reading replies loses them; it never blocks the server.
+            return;
+        }
+        reply.remove_prefix(static_cast<size_t>(sent));
+    }
+}
+
+} // namespace
+
+auto ControlServer::create(const std::filesystem::path& socket_path) -> ResultPtr<ControlServer> {
+    GOGGLES_PROFILE_FUNCTION();
+
+    auto listen_fd = GOGGLES_TRY(util::listen_unix_socket(socket_path));
+
+    auto server = std::unique_ptr<ControlServer>(new ControlServer());
+    server->m_socket_path = socket_path;
+    server->m_listen_fd = std::move(listen_fd);
+    server->m_thread = std::jthread(
+        [self = server.get()](const std::stop_token& stop_token) { self->serve(stop_token); });
+
+    GOGGLES_LOG_INFO("Control socket listening on {}", socket_path.string());
+    return {std::move(server)};
+}
+
+ControlServer::~ControlServer() {
+    if (m_thread.joinable()) {
+        m_thread.request_stop();
+        m_thread.join();
+    }
+    m_listen_fd = util::UniqueFd{};
+    if (!m_socket_path.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(m_socket_path, ec);
+    }
+}
+
+auto ControlServer::drain(ControlBatch& batch) -> size_t {
+    size_t drained = 0;
+    while (auto command = m_queue.try_pop()) {
+        batch.merge(std::move(*command));
+        ++drained;
+    }
+    return drained;
+}
+
+void ControlServer::serve(const std::stop_token& stop_token) {
+    std::vector<ControlClient> clients;
+    std::vector<pollfd> pfds;
+    std::array<char, 4096> buffer{};
+
+    auto handle_line = [this](int fd, std::string_view line) {
+        if (line.empty()) {
+            return;
+        }
+        auto command = parse_control_command(line);
+        if (!command) {
+            send_reply(fd, "{\"ok\":false,\"error\":\"" + escape_json(command.error().message) +
+                               "\"}\n");
+            return;
+        }
+        if (!m_queue.try_push(std::move(*command))) {
+            send_reply(fd, R"({"ok":false,"error":"control queue full"})"
+                           "\n");
+            return;
+        }
+        send_reply(fd, "{\"ok\":true}\n");
+    };
+
+    while (!stop_token.stop_requested()) {
+        pfds.clear();
+        pfds.push_back({.fd = m_listen_fd.get(), .events = POLLIN, .revents = 0});
+        for (const auto& client : clients) {
+            pfds.push_back({.fd = client.fd.get(), .events = POLLIN, .revents = 0});
+        }
+        if (::poll(pfds.data(), pfds.size(), K_POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        GOGGLES_PROFILE_SCOPE("ControlServerPoll");
+
+        // Client slots map to pfds[1..]; walk backwards so erasing keeps indices valid.
+        for (size_t i = clients.size(); i-- > 0;) {
+            auto& client = clients[i];
+            const auto revents = pfds[i + 1].revents;
+            if (revents == 0) {
+                continue;
+            }
+
+            bool keep = (revents & (POLLERR | POLLNVAL)) == 0;
+            if ((revents & (POLLIN | POLLHUP)) != 0) {
+                const auto received =
+                    ::recv(client.fd.get(), buffer.data(), buffer.size(), MSG_DONTWAIT);
+                if (received > 0) {
+                    client.pending.append(buffer.data(), static_cast<size_t>(received));
+                } else if (received == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    keep = false;
+                }
+            }
+
+            size_t line_start = 0;
+            for (auto newline = client.pending.find('\n', line_start);
+                 newline != std::string::npos;
+                 newline = client.pending.find('\n', line_start)) {
+                handle_line(client.fd.get(), std::string_view(client.pending)
+                                                 .substr(line_start, newline - line_start));
+                line_start = newline + 1;
+            }
+            client.pending.erase(0, line_start);
+            if (client.pending.size() > MAX_LINE_BYTES) {
+                send_reply(client.fd.get(), R"({"ok":false,"error":"request line too long"})"
+                                            "\n");
+                keep = false;
+            }
+
+            if (!keep) {
+                clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+
+        if ((pfds[0].revents & POLLIN) != 0) {
+            util::UniqueFd client{
+                ::accept4(m_listen_fd.get(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)};
+            if (client && clients.size() < MAX_CLIENTS) {
+                clients.push_back({.fd = std::move(client), .pending = {}});
+            } else if (client) {
+                GOGGLES_LOG_WARN("Control socket client rejected: {} clients already connected",
+                                 MAX_CLIENTS);
+            }
+        }
+    }
+}
+
+} // namespace goggles::app
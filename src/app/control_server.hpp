@@ -0,0 +1,56 @@
+#pragma once
+
+#include "control_protocol.hpp"
+
+#include <filesystem>
+#include <goggles/error.hpp>
+#include <stop_token>
+#include <thread>
+#include <util/queues.hpp>
+#include <util/unique_fd.hpp>
+
+namespace goggles::app {
+
+/// @brief Accepts JSON-lines control requests on a Unix domain socket.
+///
+/// Requests are parsed on the server thread and handed to the main loop through an
+/// `util::SPSCQueue`; each line is answered with `{"ok":true}` once queued or
+/// `{"ok":false,"error":"..."}` if it was rejected. The main loop drains the queue once per
+/// frame, so a burst of parameter changes lands in one batch.
+class ControlServer {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+    static constexpr size_t MAX_CLIENTS = 8;
+    static constexpr size_t MAX_LINE_BYTES = 64 * 1024;
+
+    /// Binds `socket_path`, replacing a stale socket file, and starts the server thread.
+    [[nodiscard]] static auto create(const std::filesystem::path& socket_path)
+        -> ResultPtr<ControlServer>;
+
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+    ControlServer(ControlServer&&) = delete;
+    ControlServer& operator=(ControlServer&&) = delete;
+
+    /// Moves every queued command into `batch`. Call from the main thread at a frame boundary.
+    /// @return Number of commands drained.
+    auto drain(ControlBatch& batch) -> size_t;
+
+    [[nodiscard]] auto socket_path() const -> const std::filesystem::path& {
+        return m_socket_path;
+    }
+
+private:
+    ControlServer() = default;
+
+    void serve(const std::stop_token& stop_token);
+
+    std::filesystem::path m_socket_path;
+    util::UniqueFd m_listen_fd;
+    util::SPSCQueue<ControlCommand> m_queue{QUEUE_CAPACITY};
+    std::jthread m_thread;
+};
+
+} // namespace goggles::app
@@ -11,6 +11,7 @@
 #include <cstring>
 #include <exception>
 #include <filesystem>
+#include <future>
 #include <goggles/error.hpp>
 #include <goggles/profiling.hpp>
 #include <optional>
@@ -188,6 +189,19 @@ static auto terminate_child(pid_t pid) -> void {
     GOGGLES_LOG_ERROR("Target app did not exit after SIGKILL (pid={})", pid);
 }
 
+/// Reports a failed Xwayland start once it is known, without blocking; a valid `ready` is reset
+/// after it resolves. Wayland-native targets are unaffected, so this only warns.
+static auto check_xwayland_ready(std::shared_future<bool>& ready) -> void {
+    if (!ready.valid() ||
+        ready.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    if (!ready.get()) {
+        GOGGLES_LOG_WARN("XWayland did not start; X11 target apps cannot connect");
+    }
+    ready = {};
+}
+
 static auto push_quit_event() -> void {
     SDL_Event quit{};
     quit.type = SDL_EVENT_QUIT;
@@ -345,13 +359,20 @@ static auto apply_log_file(const goggles::Config& config, const std::filesystem:
 static auto log_config_summary(const goggles::Config& config) -> void {
     GOGGLES_LOG_DEBUG("Configuration loaded:");
     GOGGLES_LOG_DEBUG("  Render vsync: {}", config.render.vsync);
+    GOGGLES_LOG_DEBUG("  Render present_policy: {}", to_string(config.render.present_policy));
+    GOGGLES_LOG_DEBUG("  Render VRR range: {}-{} Hz", config.render.vrr_min_hz,
+                      config.render.vrr_max_hz);
     GOGGLES_LOG_DEBUG("  Render target_fps: {}", config.render.target_fps);
+    GOGGLES_LOG_DEBUG("  Render allow_tearing: {}", config.render.allow_tearing);
+    GOGGLES_LOG_DEBUG("  Render frame_interpolation: {}", config.render.frame_interpolation);
     GOGGLES_LOG_DEBUG("  Render enable_validation: {}", config.render.enable_validation);
     GOGGLES_LOG_DEBUG("  Render scale_mode: {}", to_string(config.render.scale_mode));
     GOGGLES_LOG_DEBUG("  Render integer_scale: {}", config.render.integer_scale);
     GOGGLES_LOG_DEBUG("  Render gpu_selector: {}",
                       config.render.gpu_selector.empty() ? "<auto>" : config.render.gpu_selector);
     GOGGLES_LOG_DEBUG("  Log level: {}", config.logging.level);
+    GOGGLES_LOG_DEBUG("  Metrics enabled: {}", config.metrics.enabled);
+    GOGGLES_LOG_DEBUG("  Control socket enabled: {}", config.control.enabled);
 }
 
 [[nodiscard]] static auto create_signal_fd() -> goggles::Result<goggles::util::UniqueFd> {
@@ -375,19 +396,8 @@ static auto log_config_summary(const goggles::Config& config) -> void {
 }
 
 static auto run_headless_mode(goggles::app::Application& app,
-                              const goggles::app::CliOptions& cli_opts,
+                              const goggles::app::CliOptions& cli_opts, pid_t child_pid,
                               goggles::util::UniqueFd signal_fd) -> int {
-    const auto x11_display = app.x11_display();
-    const auto wayland_display = app.wayland_display();
-
-    auto spawn_result = spawn_target_app(cli_opts.app_command, x11_display, wayland_display,
-                                         cli_opts.app_width, cli_opts.app_height, app.gpu_uuid());
-    if (!spawn_result) {
-        GOGGLES_LOG_CRITICAL("Failed to launch target app: {} ({})", spawn_result.error().message,
-                             goggles::error_code_name(spawn_result.error().code));
-        return EXIT_FAILURE;
-    }
-    pid_t child_pid = spawn_result.value();
     GOGGLES_LOG_INFO("Launched target app in headless mode (pid={})", child_pid);
 
     auto headless_result = app.run_headless({
@@ -395,11 +405,19 @@ static auto run_headless_mode(goggles::app::Application& app,
         .output = cli_opts.output_path,
         .signal_fd = signal_fd.get(),
         .child_pid = child_pid,
+        .record_path = cli_opts.record_path,
+        .record_backpressure = cli_opts.record_backpressure,
+        .record_format = cli_opts.record_format.value_or(
+            cli_opts.lockstep ? goggles::util::RecordFormat::rgba
+                              : goggles::util::RecordFormat::y4m),
     });
 
     terminate_child(child_pid);
 
     if (!headless_result) {
+        // A dead Xwayland is the usual reason an X11 target never produced a frame.
+        auto xwayland_ready = app.xwayland_ready();
+        check_xwayland_ready(xwayland_ready);
         GOGGLES_LOG_ERROR("Headless run failed: {} ({})", headless_result.error().message,
                           goggles::error_code_name(headless_result.error().code));
         return EXIT_FAILURE;
@@ -409,23 +427,12 @@ static auto run_headless_mode(goggles::app::Application& app,
     return EXIT_SUCCESS;
 }
 
-static auto run_windowed_mode(goggles::app::Application& app,
-                              const goggles::app::CliOptions& cli_opts) -> int {
-    const auto x11_display = app.x11_display();
-    const auto wayland_display = app.wayland_display();
-
-    auto spawn_result = spawn_target_app(cli_opts.app_command, x11_display, wayland_display,
-                                         cli_opts.app_width, cli_opts.app_height, app.gpu_uuid());
-    if (!spawn_result) {
-        GOGGLES_LOG_CRITICAL("Failed to launch target app: {} ({})", spawn_result.error().message,
-                             goggles::error_code_name(spawn_result.error().code));
-        return EXIT_FAILURE;
-    }
-    const pid_t child_pid = spawn_result.value();
+static auto run_windowed_mode(goggles::app::Application& app, pid_t child_pid) -> int {
     GOGGLES_LOG_INFO("Launched target app (pid={})", child_pid);
 
     int child_status = 0;
     bool child_exited = false;
+    auto xwayland_ready = app.xwayland_ready();
 
     while (app.is_running()) {
         app.process_event();
@@ -433,6 +440,7 @@ static auto run_windowed_mode(goggles::app::Application& app,
             break;
         }
         app.tick_frame();
+        check_xwayland_ready(xwayland_ready);
 
         if (!child_exited) {
             const pid_t result = waitpid(child_pid, &child_status, WNOHANG);
@@ -514,16 +522,33 @@ static auto run_app(int argc, char** argv) -> int {
         config.render.target_fps = *cli_opts.target_fps;
         GOGGLES_LOG_INFO("Target FPS overridden by CLI: {}", config.render.target_fps);
     }
+    if (cli_opts.present_policy.has_value()) {
+        config.render.present_policy = *cli_opts.present_policy;
+        GOGGLES_LOG_INFO("Present policy overridden by CLI: {}",
+                         to_string(config.render.present_policy));
+    }
     if (!cli_opts.gpu_selector.empty()) {
         config.render.gpu_selector = cli_opts.gpu_selector;
         GOGGLES_LOG_INFO("GPU selector overridden by CLI: {}", config.render.gpu_selector);
     }
+    if (cli_opts.metrics) {
+        config.metrics.enabled = true;
+        GOGGLES_LOG_INFO("Metrics exporter enabled by CLI");
+    }
+    if (cli_opts.control) {
+        config.control.enabled = true;
+        GOGGLES_LOG_INFO("Control socket enabled by CLI");
+    }
     if (cli_opts.app_width != 0 || cli_opts.app_height != 0) {
         config.render.source_width = cli_opts.app_width;
         config.render.source_height = cli_opts.app_height;
         GOGGLES_LOG_INFO("Source resolution: {}x{}", config.render.source_width,
                          config.render.source_height);
     }
+    if (cli_opts.lockstep) {
+        config.render.lockstep = true;
+        GOGGLES_LOG_INFO("Lockstep frame stepping enabled by CLI");
+    }
     if (!config.shader.preset.empty()) {
         std::filesystem::path preset_path{config.shader.preset};
         if (preset_path.is_relative()) {
@@ -552,10 +577,23 @@ static auto run_app(int argc, char** argv) -> int {
         headless_signal_fd = std::move(signal_fd_result.value());
     }
 
-    auto app_result = cli_opts.headless
-                          ? goggles::app::Application::create_headless(config, app_dirs)
-                          : goggles::app::Application::create(config, app_dirs);
+    // Spawned from the compositor's socket-ready hook, so the target boots while the compositor
+    // is still bringing up its backend and output.
+    std::optional<goggles::Result<pid_t>> spawn_result;
+    auto launch_target = [&](const std::string& x11_display, const std::string& wayland_display,
+                             const std::string& gpu_uuid) {
+        spawn_result = spawn_target_app(cli_opts.app_command, x11_display, wayland_display,
+                                        cli_opts.app_width, cli_opts.app_height, gpu_uuid);
+    };
+
+    auto app_result =
+        cli_opts.headless
+            ? goggles::app::Application::create_headless(config, app_dirs, launch_target)
+            : goggles::app::Application::create(config, app_dirs, launch_target);
     if (!app_result) {
+        if (spawn_result && spawn_result->has_value()) {
+            terminate_child(spawn_result->value());
+        }
         GOGGLES_LOG_CRITICAL("Failed to initialize app: {} ({})", app_result.error().message,
                              goggles::error_code_name(app_result.error().code));
         return EXIT_FAILURE;
@@ -563,11 +601,23 @@ static auto run_app(int argc, char** argv) -> int {
 
     auto app = std::move(app_result.value());
 
+    if (!spawn_result) {
+        GOGGLES_LOG_CRITICAL("Failed to launch target app: compositor never became ready");
+        return EXIT_FAILURE;
+    }
+    if (!spawn_result->has_value()) {
+        GOGGLES_LOG_CRITICAL("Failed to launch target app: {} ({})",
+                             spawn_result->error().message,
+                             goggles::error_code_name(spawn_result->error().code));
+        return EXIT_FAILURE;
+    }
+    const pid_t child_pid = spawn_result->value();
+
     if (cli_opts.headless) {
-        return run_headless_mode(*app, cli_opts, std::move(headless_signal_fd));
+        return run_headless_mode(*app, cli_opts, child_pid, std::move(headless_signal_fd));
     }
 
-    return run_windowed_mode(*app, cli_opts);
+    return run_windowed_mode(*app, child_pid);
 }
 
 auto main(int argc, char** argv) -> int {
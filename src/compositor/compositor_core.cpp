@@ -13,10 +13,14 @@ extern "C" {
 #include <wlr/render/swapchain.h>
 #include <wlr/render/wlr_renderer.h>
 #include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_fractional_scale_v1.h>
 #include <wlr/types/wlr_linux_drm_syncobj_v1.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_presentation_time.h>
 #include <wlr/types/wlr_seat.h>
+#include <wlr/types/wlr_tearing_control_v1.h>
+#include <wlr/types/wlr_viewporter.h>
 #include <wlr/util/log.h>
 
 #ifdef __clang__
@@ -197,6 +201,31 @@ auto CompositorState::create_compositor() -> Result<void> {
         }
     }
 
+    // Together these let clients render at a scale other than 1 and map the buffer back to
+    // their logical size, which is how native-resolution capture reaches them.
+    viewporter = wlr_viewporter_create(display);
+    if (!viewporter) {
+        return make_error<void>(ErrorCode::input_init_failed, "Failed to create viewporter");
+    }
+    fractional_scale_manager = wlr_fractional_scale_manager_v1_create(display, 1);
+    if (!fractional_scale_manager) {
+        return make_error<void>(ErrorCode::input_init_failed,
+                                "Failed to create fractional scale manager");
+    }
+
+    // Feedback is sent once the viewer reports its present; see `handle_present_feedback()`.
+    presentation = wlr_presentation_create(display, backend, 1);
+    if (!presentation) {
+        return make_error<void>(ErrorCode::input_init_failed, "Failed to create presentation");
+    }
+
+    // Hints are read per commit in `process_capture_pacing()`; only honored when allowed.
+    tearing_control = wlr_tearing_control_manager_v1_create(display, 1);
+    if (!tearing_control) {
+        return make_error<void>(ErrorCode::input_init_failed,
+                                "Failed to create tearing control manager");
+    }
+
     return {};
 }
 
@@ -273,7 +302,8 @@ auto CompositorState::start_backend() -> Result<void> {
 
 auto CompositorState::setup_output() -> Result<void> {
     GOGGLES_PROFILE_FUNCTION();
-    output = wlr_headless_add_output(backend, 1920, 1080);
+    output = wlr_headless_add_output(backend, static_cast<unsigned int>(output_mode.width),
+                                     static_cast<unsigned int>(output_mode.height));
     if (!output) {
         return make_error<void>(ErrorCode::input_init_failed, "Failed to create headless output");
     }
@@ -289,6 +319,63 @@ auto CompositorState::setup_output() -> Result<void> {
     return {};
 }
 
+void CompositorState::request_output_mode(const OutputMode& mode) {
+    {
+        std::scoped_lock lock(present_mutex);
+        pending_output_mode = mode;
+    }
+    wake_event_loop();
+}
+
+void CompositorState::handle_output_mode_request() {
+    std::optional<OutputMode> mode;
+    {
+        std::scoped_lock lock(present_mutex);
+        mode.swap(pending_output_mode);
+    }
+    if (!mode || *mode == output_mode || !output || mode->width == 0 || mode->height == 0 ||
+        mode->scale <= 0.0) {
+        return;
+    }
+    GOGGLES_PROFILE_FUNCTION();
+
+    wlr_output_state state;
+    wlr_output_state_init(&state);
+    wlr_output_state_set_custom_mode(&state, static_cast<int32_t>(mode->width),
+                                     static_cast<int32_t>(mode->height), 0);
+    wlr_output_state_set_scale(&state, static_cast<float>(mode->scale));
+    const bool committed = wlr_output_commit_state(output, &state);
+    wlr_output_state_finish(&state);
+    if (!committed) {
+        GOGGLES_LOG_WARN("Compositor output mode {}x{}@{:.3f} rejected", mode->width, mode->height,
+                         mode->scale);
+        return;
+    }
+    output_mode = *mode;
+    GOGGLES_LOG_DEBUG("Compositor output mode {}x{}@{:.3f}", mode->width, mode->height,
+                      mode->scale);
+
+    // Xwayland surfaces are left alone: X11 has no per-window scale to prefer.
+    {
+        std::scoped_lock lock(hooks_mutex);
+        for (const auto& hooks : xdg_hooks) {
+            send_preferred_scale(hooks->surface);
+        }
+        for (const auto& hooks : layer_hooks) {
+            if (!hooks->destroyed) {
+                send_preferred_scale(hooks->surface);
+            }
+        }
+    }
+    request_present_reset();
+}
+
+void CompositorState::send_preferred_scale(wlr_surface* surface) const {
+    if (surface) {
+        wlr_fractional_scale_v1_notify_scale(surface, output_mode.scale);
+    }
+}
+
 void CompositorState::start_compositor_thread() {
     compositor_thread = std::jthread([this] {
         GOGGLES_PROFILE_FUNCTION();
@@ -327,9 +414,13 @@ void CompositorState::teardown() {
     keyboard_entered_surface = nullptr;
     pointer_entered_surface = nullptr;
     clear_presented_frame();
+    discard_presentation_feedback();
+    clear_surface_exports();
     clear_cursor_theme();
 
     detach_listener(listeners.new_xwayland_surface);
+    detach_listener(listeners.xwayland_ready);
+    report_xwayland_ready(false);
     detach_listener(listeners.new_pointer_constraint);
     detach_listener(listeners.new_xdg_popup);
     detach_listener(listeners.new_xdg_toplevel);
@@ -365,12 +456,14 @@ void CompositorState::teardown() {
 
     xdg_shell = nullptr;
     layer_shell = nullptr;
+    viewporter = nullptr;
+    fractional_scale_manager = nullptr;
+    presentation = nullptr;
+    tearing_control = nullptr;
+    async_presentation.store(false, std::memory_order_release);
     compositor = nullptr;
     output = nullptr;
-    if (present_swapchain) {
-        wlr_swapchain_destroy(present_swapchain);
-        present_swapchain = nullptr;
-    }
+    present_buffers.clear();
 
     if (output_layout) {
         wlr_output_layout_destroy(output_layout);
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <ctime>
 #include <vector>
 
@@ -83,18 +84,61 @@ auto fallback_cursor_pixels() -> std::vector<uint32_t> {
     return pixels;
 }
 
+/// Converts premultiplied native-endian ARGB32, as used by xcursor, to straight-alpha RGBA8.
+auto cursor_pixels_to_rgba(const uint8_t* pixels, uint32_t width, uint32_t height)
+    -> std::vector<uint8_t> {
+    const size_t count = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> rgba(count * 4);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t argb = 0;
+        std::memcpy(&argb, pixels + (i * 4), sizeof(argb));
+        const uint32_t alpha = argb >> 24;
+        auto unpremultiply = [alpha](uint32_t channel) -> uint8_t {
+            return alpha == 0 ? 0 : static_cast<uint8_t>(std::min(255U, channel * 255 / alpha));
+        };
+        rgba[(i * 4) + 0] = unpremultiply((argb >> 16) & 0xFF);
+        rgba[(i * 4) + 1] = unpremultiply((argb >> 8) & 0xFF);
+        rgba[(i * 4) + 2] = unpremultiply(argb & 0xFF);
+        rgba[(i * 4) + 3] = static_cast<uint8_t>(alpha);
+    }
+    return rgba;
+}
+
 } // namespace
 
 void CompositorServer::set_cursor_visible(bool visible) {
     m_state->set_cursor_visible(visible);
 }
 
-auto CompositorState::setup_cursor_theme() -> Result<void> {
+void CompositorServer::set_cursor_plane(CursorPlane plane) {
+    m_state->set_cursor_plane(plane);
+}
+
+auto CompositorServer::cursor_images() const -> std::vector<CursorImage> {
+    return m_state->cursor_images;
+}
+
+auto CompositorServer::get_cursor_state() const -> CursorState {
+    return m_state->get_cursor_state();
+}
+
+void XcursorThemeDeleter::operator()(wlr_xcursor_theme* theme) const {
+    if (theme) {
+        wlr_xcursor_theme_destroy(theme);
+    }
+}
+
+auto CompositorState::load_cursor_theme() -> UniqueXcursorTheme {
+    GOGGLES_PROFILE_FUNCTION();
+    return UniqueXcursorTheme{wlr_xcursor_theme_load(nullptr, CURSOR_SIZE)};
+}
+
+auto CompositorState::setup_cursor_theme(UniqueXcursorTheme theme) -> Result<void> {
     GOGGLES_PROFILE_FUNCTION();
 
     clear_cursor_theme();
 
-    cursor_theme = wlr_xcursor_theme_load(nullptr, CURSOR_SIZE);
+    cursor_theme = theme.release();
     if (!cursor_theme) {
         return make_error<void>(ErrorCode::input_init_failed, "Failed to load system cursor theme");
     }
@@ -130,6 +174,14 @@ auto CompositorState::setup_cursor_theme() -> Result<void> {
         frame.hotspot_y = std::min(source.hotspot_y, source.height - 1);
         frame.delay_ms = source.delay_ms;
         cursor_frames.push_back(frame);
+        cursor_images.push_back({
+            .width = frame.width,
+            .height = frame.height,
+            .hotspot_x = frame.hotspot_x,
+            .hotspot_y = frame.hotspot_y,
+            .delay_ms = frame.delay_ms,
+            .rgba = cursor_pixels_to_rgba(source.pixels, source.width, source.height),
+        });
         return {};
     };
 
@@ -147,6 +199,7 @@ auto CompositorState::setup_cursor_theme() -> Result<void> {
         }
     }
     cursor_frames.clear();
+    cursor_images.clear();
 
     if (cursor_shape) {
         cursor_frames.reserve(cursor_shape->image_count);
@@ -207,6 +260,7 @@ void CompositorState::clear_cursor_theme() {
         }
     }
     cursor_frames.clear();
+    cursor_images.clear();
     cursor_shape = nullptr;
     if (cursor_theme) {
         wlr_xcursor_theme_destroy(cursor_theme);
@@ -232,13 +286,48 @@ auto CompositorState::get_cursor_frame(uint32_t time_msec) const -> const Cursor
 
 void CompositorState::set_cursor_visible(bool visible) {
     bool previous = cursor_visible.exchange(visible, std::memory_order_acq_rel);
-    if (previous != visible) {
+    if (previous != visible &&
+        cursor_plane.load(std::memory_order_acquire) == CursorPlane::composited) {
         request_present_reset();
     }
 }
 
+void CompositorState::set_cursor_plane(CursorPlane plane) {
+    if (cursor_plane.exchange(plane, std::memory_order_acq_rel) != plane) {
+        // Add the cursor to, or drop it from, the frame already presented.
+        request_present_reset();
+    }
+}
+
+void CompositorState::publish_cursor_state() {
+    const bool shown =
+        cursor_initialized &&
+        (!active_constraint || active_constraint->type != WLR_POINTER_CONSTRAINT_V1_LOCKED);
+    // `cursor_surface` is the captured root, whose buffer sets the presented frame's scale.
+    const double scale = get_surface_buffer_scale(cursor_surface);
+    std::scoped_lock lock(cursor_mutex);
+    published_cursor.visible = shown;
+    published_cursor.x = cursor_x * scale;
+    published_cursor.y = cursor_y * scale;
+    published_cursor.scale = scale;
+}
+
+auto CompositorState::get_cursor_state() const -> CursorState {
+    CursorState state;
+    {
+        std::scoped_lock lock(cursor_mutex);
+        state = published_cursor;
+    }
+    // `cursor_frames` and `cursor_shape` are fixed once the compositor thread runs.
+    const auto* frame = get_cursor_frame(get_time_msec());
+    state.visible = state.visible && frame && cursor_visible.load(std::memory_order_acquire);
+    state.image_index = frame ? static_cast<uint32_t>(frame - cursor_frames.data()) : 0;
+    return state;
+}
+
 void CompositorState::render_cursor_overlay(wlr_render_pass* pass) const {
     const bool show_cursor =
+        cursor_plane.load(std::memory_order_acquire) == CursorPlane::composited &&
         cursor_visible.load(std::memory_order_acquire) &&
         (!active_constraint || active_constraint->type != WLR_POINTER_CONSTRAINT_V1_LOCKED);
     if (!show_cursor || !cursor_initialized || present_width == 0 || present_height == 0) {
@@ -250,14 +339,22 @@ void CompositorState::render_cursor_overlay(wlr_render_pass* pass) const {
         return;
     }
 
-    const int center_x = static_cast<int>(std::lround(cursor_x));
-    const int center_y = static_cast<int>(std::lround(cursor_y));
-    const int min_x = -static_cast<int>(frame->hotspot_x);
-    const int min_y = -static_cast<int>(frame->hotspot_y);
-    const int max_x = static_cast<int>(present_width - 1) - static_cast<int>(frame->hotspot_x);
-    const int max_y = static_cast<int>(present_height - 1) - static_cast<int>(frame->hotspot_y);
-    const int draw_x = std::clamp(center_x - static_cast<int>(frame->hotspot_x), min_x, max_x);
-    const int draw_y = std::clamp(center_y - static_cast<int>(frame->hotspot_y), min_y, max_y);
+    // Cursor position and image are logical; the frame may be drawn at another scale.
+    const auto to_frame = [this](double value) {
+        return static_cast<int>(std::lround(value * present_scale));
+    };
+    const int width = std::max(1, to_frame(frame->width));
+    const int height = std::max(1, to_frame(frame->height));
+    const int hotspot_x = to_frame(frame->hotspot_x);
+    const int hotspot_y = to_frame(frame->hotspot_y);
+    const int center_x = to_frame(cursor_x);
+    const int center_y = to_frame(cursor_y);
+    const int min_x = -hotspot_x;
+    const int min_y = -hotspot_y;
+    const int max_x = static_cast<int>(present_width - 1) - hotspot_x;
+    const int max_y = static_cast<int>(present_height - 1) - hotspot_y;
+    const int draw_x = std::clamp(center_x - hotspot_x, min_x, max_x);
+    const int draw_y = std::clamp(center_y - hotspot_y, min_y, max_y);
 
     wlr_render_texture_options options{};
     options.texture = frame->texture;
@@ -270,8 +367,8 @@ void CompositorState::render_cursor_overlay(wlr_render_pass* pass) const {
     options.dst_box = wlr_box{
         .x = draw_x,
         .y = draw_y,
-        .width = static_cast<int>(frame->width),
-        .height = static_cast<int>(frame->height),
+        .width = width,
+        .height = height,
     };
     options.filter_mode = WLR_SCALE_FILTER_NEAREST;
     options.blend_mode = WLR_RENDER_BLEND_MODE_PREMULTIPLIED;
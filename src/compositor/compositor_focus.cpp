@@ -5,6 +5,7 @@
 #include <limits>
 
 extern "C" {
+#include <wlr/render/wlr_texture.h>
 #include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_pointer_constraints_v1.h>
@@ -123,11 +124,19 @@ void CompositorServer::set_input_target(uint32_t surface_id) {
     m_state->request_focus_target(surface_id);
 }
 
+void CompositorServer::set_capture_surfaces(std::vector<uint32_t> surface_ids) {
+    m_state->request_capture_surfaces(std::move(surface_ids));
+}
+
 void CompositorServer::request_surface_resize(uint32_t surface_id,
                                               const SurfaceResizeInfo& resize) {
     m_state->request_surface_resize(surface_id, resize);
 }
 
+void CompositorServer::set_surface_allow_tearing(uint32_t surface_id, bool allow) {
+    m_state->set_surface_allow_tearing(surface_id, allow);
+}
+
 void CompositorState::handle_focus_request() {
     const auto focus_id = pending_focus_target.exchange(NO_FOCUS_TARGET, std::memory_order_acq_rel);
     if (focus_id == NO_FOCUS_TARGET) {
@@ -215,6 +224,7 @@ void CompositorState::handle_constraint_set_region(ConstraintHooks* hooks) {
         wlr_seat_pointer_notify_frame(seat);
     }
 
+    publish_cursor_state();
     request_present_reset();
 }
 
@@ -226,6 +236,7 @@ void CompositorState::handle_constraint_destroy(ConstraintHooks* hooks) {
     if (active_constraint == hooks->constraint) {
         active_constraint = nullptr;
         pointer_locked.store(false, std::memory_order_release);
+        publish_cursor_state();
         request_present_reset();
     }
 
@@ -252,6 +263,7 @@ void CompositorState::activate_constraint(wlr_pointer_constraint_v1* constraint)
                          std::memory_order_release);
     wlr_pointer_constraint_v1_send_activated(constraint);
     apply_cursor_hint_if_needed();
+    publish_cursor_state();
     request_present_reset();
     GOGGLES_LOG_DEBUG("Pointer constraint activated: type={}",
                       constraint->type == WLR_POINTER_CONSTRAINT_V1_LOCKED ? "locked" : "confined");
@@ -265,6 +277,7 @@ void CompositorState::deactivate_constraint() {
     GOGGLES_LOG_DEBUG("Pointer constraint deactivated");
     active_constraint = nullptr;
     pointer_locked.store(false, std::memory_order_release);
+    publish_cursor_state();
     request_present_reset();
 }
 
@@ -481,6 +494,32 @@ auto get_surface_extent(wlr_surface* surface) -> std::optional<std::pair<uint32_
     return std::nullopt;
 }
 
+auto get_output_layout_size(wlr_output* output) -> std::pair<int, int> {
+    int width = 0;
+    int height = 0;
+    if (output) {
+        wlr_output_effective_resolution(output, &width, &height);
+    }
+    return {width, height};
+}
+
+auto get_surface_buffer_scale(wlr_surface* surface) -> double {
+    wlr_texture* texture = surface ? wlr_surface_get_texture(surface) : nullptr;
+    if (!texture || surface->current.width <= 0) {
+        return 1.0;
+    }
+    return static_cast<double>(texture->width) / static_cast<double>(surface->current.width);
+}
+
+auto get_scaled_surface_box(wlr_surface* surface, int x, int y, double scale) -> wlr_box {
+    // Rounding both edges keeps adjacent subsurfaces seamless at fractional scales.
+    const auto left = static_cast<int>(std::lround(x * scale));
+    const auto top = static_cast<int>(std::lround(y * scale));
+    const auto right = static_cast<int>(std::lround((x + surface->current.width) * scale));
+    const auto bottom = static_cast<int>(std::lround((y + surface->current.height) * scale));
+    return {.x = left, .y = top, .width = right - left, .height = bottom - top};
+}
+
 auto get_root_xdg_surface(wlr_surface* surface) -> wlr_xdg_surface* {
     auto* xdg_surface = wlr_xdg_surface_try_from_wlr_surface(surface);
     while (xdg_surface && xdg_surface->role == WLR_XDG_SURFACE_ROLE_POPUP) {
@@ -540,6 +579,64 @@ auto get_xdg_popup_position(const XdgPopupHooks* hooks) -> std::pair<double, dou
     return {popup_x, popup_y};
 }
 
+auto union_box(const wlr_box& lhs, const wlr_box& rhs) -> wlr_box {
+    if (wlr_box_empty(&lhs)) {
+        return rhs;
+    }
+    if (wlr_box_empty(&rhs)) {
+        return lhs;
+    }
+    const int min_x = std::min(lhs.x, rhs.x);
+    const int min_y = std::min(lhs.y, rhs.y);
+    const int max_x = std::max(lhs.x + lhs.width, rhs.x + rhs.width);
+    const int max_y = std::max(lhs.y + lhs.height, rhs.y + rhs.height);
+    return {.x = min_x, .y = min_y, .width = max_x - min_x, .height = max_y - min_y};
+}
+
+auto get_xwayland_popup_box(const wlr_xwayland_surface& popup) -> wlr_box {
+    wlr_box box{.x = popup.x, .y = popup.y, .width = popup.width, .height = popup.height};
+    // Surfaces are drawn at buffer size, which can run ahead of the X11 geometry.
+    if (auto extent = get_surface_extent(popup.surface)) {
+        box.width = std::max(box.width, static_cast<int>(extent->first));
+        box.height = std::max(box.height, static_cast<int>(extent->second));
+    }
+    return box;
+}
+
+auto get_damage_frame_box(const wlr_box& damage, int root_x, int root_y, double scale,
+                          int frame_width, int frame_height) -> std::optional<wlr_box> {
+    const int damage_x = damage.x - root_x;
+    const int damage_y = damage.y - root_y;
+    const auto left = static_cast<int>(std::floor(damage_x * scale));
+    const auto top = static_cast<int>(std::floor(damage_y * scale));
+    const wlr_box local_damage{
+        .x = left,
+        .y = top,
+        .width = static_cast<int>(std::ceil((damage_x + damage.width) * scale)) - left,
+        .height = static_cast<int>(std::ceil((damage_y + damage.height) * scale)) - top,
+    };
+    const wlr_box frame_box{.x = 0, .y = 0, .width = frame_width, .height = frame_height};
+    wlr_box clipped{};
+    if (!wlr_box_intersection(&clipped, &local_damage, &frame_box)) {
+        return std::nullopt;
+    }
+    return clipped;
+}
+
+void cache_xwayland_popup_parents(XWaylandSurfaceHooks& hooks) {
+    hooks.popup_parents.clear();
+    for (auto* parent = hooks.xsurface ? hooks.xsurface->parent : nullptr; parent;
+         parent = parent->parent) {
+        hooks.popup_parents.push_back(parent);
+    }
+}
+
+auto xwayland_popup_belongs_to_root(const XWaylandSurfaceHooks& hooks,
+                                    const wlr_xwayland_surface* root) -> bool {
+    return hooks.popup_parents.empty() ||
+           std::ranges::find(hooks.popup_parents, root) != hooks.popup_parents.end();
+}
+
 auto compute_layer_position(const wlr_layer_surface_v1_state& state, int out_w, int out_h)
     -> std::pair<int, int> {
     const auto& margin = state.margin;
@@ -624,31 +721,13 @@ auto get_cursor_bounds_rect(const CompositorState& state, const InputTarget& roo
         return bounds;
     }
 
-    std::scoped_lock lock(state.hooks_mutex);
-    for (const auto& hooks_entry : state.xwayland_hooks) {
-        const auto* hooks = hooks_entry.get();
-        if (!hooks->mapped || !hooks->override_redirect || !hooks->xsurface ||
-            !hooks->xsurface->surface) {
+    for (const auto* hooks : state.xwayland_popups) {
+        if (!hooks->xsurface || !hooks->xsurface->surface ||
+            !xwayland_popup_belongs_to_root(*hooks, root_target.root_xsurface)) {
             continue;
         }
 
         const auto* popup = hooks->xsurface;
-        const auto* parent = popup->parent;
-        bool belongs_to_root = false;
-        while (parent) {
-            if (parent == root_target.root_xsurface) {
-                belongs_to_root = true;
-                break;
-            }
-            parent = parent->parent;
-        }
-        if (!belongs_to_root && !popup->parent) {
-            belongs_to_root = true;
-        }
-        if (!belongs_to_root) {
-            continue;
-        }
-
         auto popup_extent = get_surface_extent(popup->surface);
         if (!popup_extent) {
             continue;
@@ -693,21 +772,14 @@ auto get_surface_local_coords(const CompositorState& state, const InputTarget& t
 
 void CompositorState::reset_cursor_for_surface(wlr_surface* surface) {
     cursor_surface = surface;
+    cursor_initialized = false;
     auto extent_opt = get_surface_extent(surface);
-    if (!extent_opt) {
-        cursor_initialized = false;
-        return;
-    }
-
-    const auto [width, height] = *extent_opt;
-    if (width == 0 || height == 0) {
-        cursor_initialized = false;
-        return;
+    if (extent_opt && extent_opt->first > 0 && extent_opt->second > 0) {
+        cursor_x = static_cast<double>(extent_opt->first) * 0.5;
+        cursor_y = static_cast<double>(extent_opt->second) * 0.5;
+        cursor_initialized = true;
     }
-
-    cursor_x = static_cast<double>(width) * 0.5;
-    cursor_y = static_cast<double>(height) * 0.5;
-    cursor_initialized = true;
+    publish_cursor_state();
 }
 
 void CompositorState::apply_cursor_hint_if_needed() {
@@ -739,8 +811,10 @@ void CompositorState::apply_cursor_hint_if_needed() {
     }
     cursor_x = std::clamp(cursor_x, 0.0, static_cast<double>(width - 1));
     cursor_y = std::clamp(cursor_y, 0.0, static_cast<double>(height - 1));
+    publish_cursor_state();
 
     if ((previous_x != cursor_x || previous_y != cursor_y) &&
+        cursor_plane.load(std::memory_order_acquire) == CursorPlane::composited &&
         cursor_visible.load(std::memory_order_acquire)) {
         request_present_reset();
     }
@@ -828,8 +902,11 @@ void CompositorState::update_cursor_position(const InputEvent& event,
     cursor_x = next_x;
     cursor_y = next_y;
     cursor_initialized = true;
+    publish_cursor_state();
 
+    // An overlay cursor is drawn by the viewer; only a composited one needs a new frame.
     const bool show_cursor =
+        cursor_plane.load(std::memory_order_acquire) == CursorPlane::composited &&
         cursor_visible.load(std::memory_order_acquire) &&
         (!active_constraint || active_constraint->type != WLR_POINTER_CONSTRAINT_V1_LOCKED);
     if (show_cursor && (previous_x != cursor_x || previous_y != cursor_y)) {
@@ -853,8 +930,7 @@ auto get_root_input_target(CompositorState& state) -> InputTarget {
             }
 
             const auto& layer_state = hooks->layer_surface->current;
-            const int out_w = state.output ? state.output->width : 0;
-            const int out_h = state.output ? state.output->height : 0;
+            const auto [out_w, out_h] = get_output_layout_size(state.output);
             const int surf_w = static_cast<int>(layer_state.actual_width);
             const int surf_h = static_cast<int>(layer_state.actual_height);
 
@@ -963,32 +1039,9 @@ auto resolve_input_target(CompositorState& state, const InputTarget& root_target
     }
 
     XWaylandSurfaceHooks* topmost_popup = nullptr;
-    {
-        std::scoped_lock lock(state.hooks_mutex);
-        for (const auto& hooks_entry : state.xwayland_hooks) {
-            auto* hooks = hooks_entry.get();
-            if (!hooks->mapped || !hooks->override_redirect || !hooks->xsurface ||
-                !hooks->xsurface->surface) {
-                continue;
-            }
-
-            const auto* popup = hooks->xsurface;
-            const auto* parent = popup->parent;
-            bool belongs_to_root = false;
-            while (parent) {
-                if (parent == root_target.root_xsurface) {
-                    belongs_to_root = true;
-                    break;
-                }
-                parent = parent->parent;
-            }
-            if (!belongs_to_root && !popup->parent) {
-                belongs_to_root = true;
-            }
-            if (!belongs_to_root) {
-                continue;
-            }
-
+    for (auto* hooks : state.xwayland_popups) {
+        if (hooks->xsurface && hooks->xsurface->surface &&
+            xwayland_popup_belongs_to_root(*hooks, root_target.root_xsurface)) {
             topmost_popup = hooks;
         }
     }
@@ -16,6 +16,7 @@ extern "C" {
 
 #include <goggles/profiling.hpp>
 #include <util/logging.hpp>
+#include <util/metrics.hpp>
 
 namespace goggles::compositor {
 
@@ -296,6 +297,7 @@ auto CompositorServer::forward_mouse_wheel(const SDL_MouseWheelEvent& event) ->
 auto CompositorServer::inject_event(const InputEvent& event) -> bool {
     GOGGLES_PROFILE_FUNCTION();
     if (!m_state->event_queue.try_push(event)) {
+        util::Metrics::increment(util::MetricCounter::input_events_dropped);
         return false;
     }
     return m_state->wake_event_loop();
@@ -336,6 +338,9 @@ void CompositorState::process_input_events() {
     GOGGLES_PROFILE_FUNCTION();
     handle_focus_request();
     handle_surface_resize_requests();
+    handle_capture_surfaces_request();
+    handle_output_mode_request();
+    handle_present_feedback();
     if (present_reset_requested.exchange(false, std::memory_order_acq_rel)) {
         refresh_presented_frame();
     }
@@ -35,6 +35,8 @@ struct RenderSurfaceContext {
     wlr_render_pass* pass = nullptr;
     int32_t offset_x = 0;
     int32_t offset_y = 0;
+    /// Frame pixels per logical pixel.
+    double scale = 1.0;
 };
 
 void render_surface_iterator(wlr_surface* surface, int sx, int sy, void* data) {
@@ -53,18 +55,9 @@ void render_surface_iterator(wlr_surface* surface, int sx, int sy, void* data) {
 
     wlr_render_texture_options options{};
     options.texture = texture;
-    options.src_box = wlr_fbox{
-        .x = 0.0,
-        .y = 0.0,
-        .width = static_cast<double>(texture->width),
-        .height = static_cast<double>(texture->height),
-    };
-    options.dst_box = wlr_box{
-        .x = context->offset_x + sx,
-        .y = context->offset_y + sy,
-        .width = static_cast<int>(texture->width),
-        .height = static_cast<int>(texture->height),
-    };
+    wlr_surface_get_buffer_source_box(surface, &options.src_box);
+    options.dst_box = get_scaled_surface_box(surface, context->offset_x + sx,
+                                             context->offset_y + sy, context->scale);
     options.filter_mode = WLR_SCALE_FILTER_BILINEAR;
     options.blend_mode = WLR_RENDER_BLEND_MODE_PREMULTIPLIED;
     wlr_render_pass_add_texture(context->pass, &options);
@@ -175,8 +168,7 @@ void CompositorState::handle_layer_surface_commit(LayerSurfaceHooks* hooks) {
         const auto& margin = hooks->layer_surface->pending.margin;
         const auto desired_w = hooks->layer_surface->pending.desired_width;
         const auto desired_h = hooks->layer_surface->pending.desired_height;
-        const int out_w = output ? output->width : 0;
-        const int out_h = output ? output->height : 0;
+        const auto [out_w, out_h] = get_output_layout_size(output);
 
         constexpr uint32_t ALL_ANCHORS =
             ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP | ZWLR_LAYER_SURFACE_V1_ANCHOR_BOTTOM |
@@ -207,6 +199,7 @@ void CompositorState::handle_layer_surface_commit(LayerSurfaceHooks* hooks) {
             height = desired_h > 0 ? desired_h : static_cast<uint32_t>(out_h);
         }
 
+        send_preferred_scale(hooks->surface);
         wlr_layer_surface_v1_configure(hooks->layer_surface, width, height);
         hooks->configured = true;
         return;
@@ -307,14 +300,14 @@ void CompositorState::render_layer_surfaces(wlr_render_pass* pass, uint32_t targ
         }
 
         const auto& state = hooks->layer_surface->current;
-        const int out_w = output ? output->width : 0;
-        const int out_h = output ? output->height : 0;
+        const auto [out_w, out_h] = get_output_layout_size(output);
         const auto [pos_x, pos_y] = compute_layer_position(state, out_w, out_h);
 
         RenderSurfaceContext context{};
         context.pass = pass;
         context.offset_x = static_cast<int32_t>(pos_x);
         context.offset_y = static_cast<int32_t>(pos_y);
+        context.scale = present_scale;
         wlr_layer_surface_v1_for_each_surface(hooks->layer_surface, render_surface_iterator,
                                               &context);
     }
@@ -5,6 +5,7 @@
 #include <chrono>
 #include <cstddef>
 #include <ctime>
+#include <iterator>
 #include <numeric>
 
 extern "C" {
@@ -17,6 +18,8 @@ extern "C" {
 #include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_linux_drm_syncobj_v1.h>
 #include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_presentation_time.h>
+#include <wlr/types/wlr_tearing_control_v1.h>
 #include <wlr/types/wlr_xdg_shell.h>
 
 #ifdef __clang__
@@ -44,6 +47,8 @@ extern "C" {
 #endif
 }
 
+#include <util/metrics.hpp>
+
 #include <goggles/profiling.hpp>
 #include <util/drm_fourcc.hpp>
 #include <util/logging.hpp>
@@ -80,8 +85,16 @@ struct RenderSurfaceContext {
     wlr_render_pass* pass = nullptr;
     int32_t offset_x = 0;
     int32_t offset_y = 0;
+    /// Frame pixels per logical pixel.
+    double scale = 1.0;
 };
 
+// `wp_presentation_feedback.kind` bits from presentation-time.xml.
+constexpr uint32_t PRESENTATION_KIND_VSYNC = 0x1;
+constexpr uint32_t PRESENTATION_KIND_HW_COMPLETION = 0x4;
+// Feedback the viewer never reports back on (it is hidden or stalled) is discarded past this.
+constexpr size_t MAX_PENDING_PRESENTATION_FEEDBACK = 16;
+
 void send_frame_done_now(wlr_surface* surface) {
     if (!surface) {
         return;
@@ -92,11 +105,65 @@ void send_frame_done_now(wlr_surface* surface) {
     wlr_surface_send_frame_done(surface, &now);
 }
 
+void send_frame_done_at(wlr_surface* surface, uint64_t time_ns) {
+    if (!surface) {
+        return;
+    }
+
+    constexpr uint64_t NS_PER_SECOND = 1'000'000'000;
+    const timespec time{
+        .tv_sec = static_cast<time_t>(time_ns / NS_PER_SECOND),
+        .tv_nsec = static_cast<long>(time_ns % NS_PER_SECOND),
+    };
+    wlr_surface_send_frame_done(surface, &time);
+}
+
+/// Exact integer step so long lockstep runs never drift from `frame_index / target_fps`.
+auto lockstep_frame_time_ns(uint64_t frame_index, uint32_t target_fps) -> uint64_t {
+    if (target_fps == 0) {
+        return 0;
+    }
+    return frame_index * 1'000'000'000ULL / target_fps;
+}
+
 auto is_same_capture_target(const RuntimeMetricsState::CaptureTarget& lhs,
                             const RuntimeMetricsState::CaptureTarget& rhs) -> bool {
     return lhs.root_surface == rhs.root_surface && lhs.surface == rhs.surface;
 }
 
+auto is_tearing_allowed(const CompositorState& state, const InputTarget& target) -> bool {
+    if (!target.root_surface) {
+        return false;
+    }
+    std::scoped_lock lock(state.hooks_mutex);
+    if (target.root_xsurface) {
+        for (const auto& hooks_entry : state.xwayland_hooks) {
+            const auto* hooks = hooks_entry.get();
+            if (!hooks->override_redirect && hooks->xsurface == target.root_xsurface) {
+                return hooks->allow_tearing;
+            }
+        }
+        return false;
+    }
+    for (const auto& hooks_entry : state.xdg_hooks) {
+        const auto* hooks = hooks_entry.get();
+        if (hooks->surface == target.root_surface) {
+            return hooks->allow_tearing;
+        }
+    }
+    return false;
+}
+
+auto wants_async_presentation(const CompositorState& state, const InputTarget& target,
+                              wlr_surface* surface) -> bool {
+    if (!surface || !state.tearing_control || !is_tearing_allowed(state, target)) {
+        return false;
+    }
+    return wlr_tearing_control_manager_v1_surface_hint_from_surface(state.tearing_control,
+                                                                    surface) ==
+           WP_TEARING_CONTROL_V1_PRESENTATION_HINT_ASYNC;
+}
+
 auto take_pending_capture_callback(CapturePacingState& capture_pacing) -> wlr_surface* {
     if (!capture_pacing.has_pending_frame || !capture_pacing.callback_surface) {
         return nullptr;
@@ -165,20 +232,13 @@ void render_surface_iterator(wlr_surface* surface, int sx, int sy, void* data) {
         return;
     }
 
+    // The source box carries any `wp_viewporter` crop; the destination follows the surface's
+    // logical size so scaled and viewported buffers land where the client placed them.
     wlr_render_texture_options options{};
     options.texture = texture;
-    options.src_box = wlr_fbox{
-        .x = 0.0,
-        .y = 0.0,
-        .width = static_cast<double>(texture->width),
-        .height = static_cast<double>(texture->height),
-    };
-    options.dst_box = wlr_box{
-        .x = context->offset_x + sx,
-        .y = context->offset_y + sy,
-        .width = static_cast<int>(texture->width),
-        .height = static_cast<int>(texture->height),
-    };
+    wlr_surface_get_buffer_source_box(surface, &options.src_box);
+    options.dst_box = get_scaled_surface_box(surface, context->offset_x + sx,
+                                             context->offset_y + sy, context->scale);
     options.filter_mode = WLR_SCALE_FILTER_BILINEAR;
     options.blend_mode = WLR_RENDER_BLEND_MODE_PREMULTIPLIED;
     wlr_render_pass_add_texture(context->pass, &options);
@@ -233,6 +293,114 @@ void refresh_published_runtime_metrics(RuntimeMetricsState& metrics) {
         [](float latency_ms) { return latency_ms; });
 }
 
+auto steady_time_ns(std::chrono::steady_clock::time_point time) -> uint64_t {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+}
+
+auto dup_exported_frame(const util::ExternalImageFrame& stored)
+    -> std::optional<util::ExternalImageFrame> {
+    util::ExternalImageFrame frame{};
+    frame.image.width = stored.image.width;
+    frame.image.height = stored.image.height;
+    frame.image.stride = stored.image.stride;
+    frame.image.offset = stored.image.offset;
+    frame.image.format = stored.image.format;
+    frame.image.modifier = stored.image.modifier;
+    frame.frame_number = stored.frame_number;
+    frame.commit_time_ns = stored.commit_time_ns;
+    frame.image.handle = stored.image.handle.dup();
+    if (!frame.image.handle) {
+        return std::nullopt;
+    }
+    if (stored.sync_fd.valid()) {
+        frame.sync_fd = stored.sync_fd.dup();
+        if (!frame.sync_fd.valid()) {
+            return std::nullopt;
+        }
+    }
+    return frame;
+}
+
+auto resize_export_swapchain(wlr_allocator* allocator, const wlr_drm_format& format,
+                             wlr_swapchain*& swapchain, uint32_t& width, uint32_t& height,
+                             uint32_t desired_width, uint32_t desired_height) -> bool {
+    if (swapchain && width == desired_width && height == desired_height) {
+        return true;
+    }
+
+    if (swapchain) {
+        wlr_swapchain_destroy(swapchain);
+    }
+    swapchain = wlr_swapchain_create(allocator, static_cast<int>(desired_width),
+                                     static_cast<int>(desired_height), &format);
+    if (!swapchain) {
+        width = 0;
+        height = 0;
+        return false;
+    }
+    width = desired_width;
+    height = desired_height;
+    return true;
+}
+
+/// Wraps a rendered swapchain buffer as a frame; `frame_number` is left for the caller.
+auto export_buffer_frame(wlr_buffer* buffer, wlr_surface* root_surface)
+    -> std::optional<util::ExternalImageFrame> {
+    wlr_dmabuf_attributes attribs{};
+    if (!wlr_buffer_get_dmabuf(buffer, &attribs)) {
+        return std::nullopt;
+    }
+
+    if (attribs.n_planes != 1) {
+        GOGGLES_LOG_DEBUG("Skipping multi-plane DMA-BUF output (planes={})", attribs.n_planes);
+        return std::nullopt;
+    }
+
+    auto dup_fd = util::UniqueFd::dup_from(attribs.fd[0]);
+    if (!dup_fd) {
+        return std::nullopt;
+    }
+
+    util::ExternalImageFrame frame{};
+    frame.image.width = static_cast<uint32_t>(attribs.width);
+    frame.image.height = static_cast<uint32_t>(attribs.height);
+    frame.image.stride = attribs.stride[0];
+    frame.image.offset = attribs.offset[0];
+    frame.image.format = drm_to_vk_format(attribs.format);
+    frame.image.modifier = attribs.modifier;
+    frame.image.handle = std::move(dup_fd);
+
+    // Export the acquire fence from the root surface so Vulkan waits on compositor writes.
+    wlr_linux_drm_syncobj_surface_v1_state* syncobj_state =
+        wlr_linux_drm_syncobj_v1_get_surface_state(root_surface);
+    if (syncobj_state && syncobj_state->acquire_timeline) {
+        int sync_file = wlr_drm_syncobj_timeline_export_sync_file(syncobj_state->acquire_timeline,
+                                                                  syncobj_state->acquire_point);
+        if (sync_file >= 0) {
+            frame.sync_fd = util::UniqueFd{sync_file};
+        }
+    }
+
+    // Release stays tied to the exported buffer so wlroots can retire it after import completes.
+    if (syncobj_state && syncobj_state->release_timeline) {
+        wlr_linux_drm_syncobj_v1_state_signal_release_with_buffer(syncobj_state, buffer);
+    }
+    return frame;
+}
+
+void release_export_resources(SurfaceExport& entry) {
+    if (entry.buffer) {
+        wlr_buffer_unlock(entry.buffer);
+        entry.buffer = nullptr;
+    }
+    if (entry.swapchain) {
+        wlr_swapchain_destroy(entry.swapchain);
+        entry.swapchain = nullptr;
+    }
+    entry.frame.reset();
+}
+
 } // namespace
 
 auto CompositorState::initialize_present_output() -> Result<void> {
@@ -270,19 +438,95 @@ auto CompositorState::initialize_present_output() -> Result<void> {
     present_format.capacity = present_modifiers.size();
     present_format.modifiers = present_modifiers.data();
 
-    present_swapchain =
-        wlr_swapchain_create(allocator, output->width, output->height, &present_format);
-    if (!present_swapchain) {
+    present_buffers.allocator = allocator;
+    present_buffers.format = &present_format;
+    // Probe allocation once at the output size; the bucket idles out after the first capture.
+    wlr_buffer* probe = present_buffers.acquire(static_cast<uint32_t>(output->width),
+                                                static_cast<uint32_t>(output->height));
+    if (!probe) {
+        present_buffers.allocator = nullptr;
         GOGGLES_LOG_WARN(
-            "Compositor present swapchain unavailable; non-Vulkan presentation disabled");
+            "Compositor present buffers unavailable; non-Vulkan presentation disabled");
         return {};
     }
+    wlr_buffer_unlock(probe);
 
     present_width = static_cast<uint32_t>(output->width);
     present_height = static_cast<uint32_t>(output->height);
     return {};
 }
 
+auto PresentBufferPool::acquire(uint32_t width, uint32_t height) -> wlr_buffer* {
+    if (!allocator || !format || width == 0 || height == 0) {
+        return nullptr;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    auto bucket = std::find_if(buckets.begin(), buckets.end(), [&](const Bucket& current) {
+        return current.width == width && current.height == height;
+    });
+    if (bucket == buckets.end()) {
+        buckets.push_back(
+            Bucket{.width = width, .height = height, .buffers = {}, .last_used = now});
+        bucket = std::prev(buckets.end());
+    }
+    bucket->last_used = now;
+
+    wlr_buffer* buffer = nullptr;
+    for (wlr_buffer* candidate : bucket->buffers) {
+        if (candidate->n_locks == 0) {
+            buffer = candidate;
+            break;
+        }
+    }
+    if (!buffer && bucket->buffers.size() < buffer_count) {
+        buffer = wlr_allocator_create_buffer(allocator, static_cast<int>(width),
+                                             static_cast<int>(height), format);
+        if (buffer) {
+            bucket->buffers.push_back(buffer);
+        }
+    }
+    if (!buffer) {
+        GOGGLES_LOG_DEBUG("No free present buffer at {}x{} ({} in flight)", width, height,
+                          bucket->buffers.size());
+    } else {
+        wlr_buffer_lock(buffer);
+    }
+    if (bucket->buffers.empty()) {
+        buckets.erase(bucket);
+    }
+    trim(now);
+    return buffer;
+}
+
+void PresentBufferPool::trim(std::chrono::steady_clock::time_point now) {
+    // Dropping a buffer someone still holds only defers its destruction to the last unlock.
+    auto drop_bucket = [](Bucket& bucket) {
+        for (wlr_buffer* buffer : bucket.buffers) {
+            wlr_buffer_drop(buffer);
+        }
+        bucket.buffers.clear();
+    };
+    std::sort(buckets.begin(), buckets.end(), [](const Bucket& lhs, const Bucket& rhs) {
+        return lhs.last_used > rhs.last_used;
+    });
+    // The most recently used bucket is the one being captured and is never trimmed.
+    for (size_t i = 1; i < buckets.size(); ++i) {
+        if (i >= MAX_BUCKETS || now - buckets[i].last_used > IDLE_TIMEOUT) {
+            drop_bucket(buckets[i]);
+        }
+    }
+    std::erase_if(buckets, [](const Bucket& bucket) { return bucket.buffers.empty(); });
+}
+
+void PresentBufferPool::clear() {
+    for (auto& bucket : buckets) {
+        for (wlr_buffer* buffer : bucket.buffers) {
+            wlr_buffer_drop(buffer);
+        }
+    }
+    buckets.clear();
+}
+
 auto CompositorServer::get_presented_frame(uint64_t after_frame_number) const
     -> std::optional<util::ExternalImageFrame> {
     GOGGLES_PROFILE_FUNCTION();
@@ -294,26 +538,34 @@ auto CompositorServer::get_presented_frame(uint64_t after_frame_number) const
     if (stored.frame_number <= after_frame_number) {
         return std::nullopt;
     }
+    return dup_exported_frame(stored);
+}
 
-    util::ExternalImageFrame frame{};
-    frame.image.width = stored.image.width;
-    frame.image.height = stored.image.height;
-    frame.image.stride = stored.image.stride;
-    frame.image.offset = stored.image.offset;
-    frame.image.format = stored.image.format;
-    frame.image.modifier = stored.image.modifier;
-    frame.frame_number = stored.frame_number;
-    frame.image.handle = stored.image.handle.dup();
-    if (!frame.image.handle) {
-        return std::nullopt;
-    }
-    if (stored.sync_fd.valid()) {
-        frame.sync_fd = stored.sync_fd.dup();
-        if (!frame.sync_fd.valid()) {
+auto CompositorServer::wait_for_presented_frame(uint64_t after_frame_number,
+                                                std::chrono::steady_clock::time_point deadline)
+    const -> bool {
+    GOGGLES_PROFILE_FUNCTION();
+    std::unique_lock lock(m_state->present_mutex);
+    return m_state->presented_frame_cv.wait_until(lock, deadline, [&] {
+        return m_state->presented_frame &&
+               m_state->presented_frame->frame_number > after_frame_number;
+    });
+}
+
+auto CompositorServer::get_surface_frame(uint32_t surface_id, uint64_t after_frame_number) const
+    -> std::optional<util::ExternalImageFrame> {
+    GOGGLES_PROFILE_FUNCTION();
+    std::scoped_lock lock(m_state->present_mutex);
+    for (const auto& entry : m_state->surface_exports) {
+        if (entry.surface_id != surface_id) {
+            continue;
+        }
+        if (!entry.frame || entry.frame->frame_number <= after_frame_number) {
             return std::nullopt;
         }
+        return dup_exported_frame(*entry.frame);
     }
-    return frame;
+    return std::nullopt;
 }
 
 void CompositorState::clear_presented_frame() {
@@ -333,18 +585,18 @@ void CompositorState::request_present_reset() {
     }
 }
 
-void CompositorState::update_presented_frame(wlr_surface* surface) {
+bool CompositorState::update_presented_frame(wlr_surface* surface) {
     GOGGLES_PROFILE_FUNCTION();
     auto target = get_input_target(*this);
     if (!target.root_surface || !surface) {
-        return;
+        return false;
     }
 
     if (target.surface != surface && target.root_surface != surface) {
-        return;
+        return false;
     }
 
-    render_surface_to_frame(target);
+    return render_surface_to_frame(target);
 }
 
 void CompositorState::refresh_presented_frame() {
@@ -370,6 +622,7 @@ void CompositorState::schedule_capture_pacing(wlr_surface* surface) {
     GOGGLES_PROFILE_FUNCTION();
     auto target = get_input_target(*this);
     if (!surface || !target.root_surface) {
+        update_surface_export(surface);
         send_frame_done_now(surface);
         return;
     }
@@ -379,6 +632,7 @@ void CompositorState::schedule_capture_pacing(wlr_surface* surface) {
         .surface = target.surface ? target.surface : target.root_surface,
     };
     if (surface != capture_target.surface) {
+        update_surface_export(surface);
         send_frame_done_now(surface);
         return;
     }
@@ -406,6 +660,18 @@ void CompositorState::schedule_capture_pacing(wlr_surface* surface) {
     process_capture_pacing();
 }
 
+void CompositorState::schedule_popup_damage(const wlr_box& damage) {
+    if (wlr_box_empty(&damage)) {
+        return;
+    }
+    {
+        std::scoped_lock lock(present_mutex);
+        capture_pacing.popup_damage = union_box(capture_pacing.popup_damage, damage);
+        capture_pacing.has_popup_damage = true;
+    }
+    process_capture_pacing();
+}
+
 void CompositorState::arm_capture_pacing_timer(std::chrono::steady_clock::time_point deadline) {
     if (!pacing_timer_source) {
         return;
@@ -424,13 +690,18 @@ void CompositorState::process_capture_pacing() {
     GOGGLES_PROFILE_FUNCTION();
     wlr_surface* resolved_surface = nullptr;
     wlr_surface* ready_surface = nullptr;
+    std::optional<wlr_box> popup_damage;
     std::optional<SteadyClock::time_point> next_deadline;
+    std::optional<uint64_t> lockstep_time_ns;
 
     auto target = get_input_target(*this);
     const RuntimeMetricsState::CaptureTarget capture_target = {
         .root_surface = target.root_surface,
         .surface = target.surface ? target.surface : target.root_surface,
     };
+    // The hint is double-buffered state, so re-resolving it here keeps up with every commit.
+    const bool async_target = wants_async_presentation(*this, target, capture_target.surface);
+    async_presentation.store(async_target, std::memory_order_release);
 
     {
         std::scoped_lock lock(present_mutex);
@@ -446,26 +717,67 @@ void CompositorState::process_capture_pacing() {
             capture_pacing.has_capture_target = true;
         }
 
-        if (capture_pacing.has_pending_frame && capture_pacing.callback_surface) {
+        // Popup captures share the target's dispatch slot; a target frame covers them anyway.
+        const bool has_pending_frame =
+            capture_pacing.has_pending_frame && capture_pacing.callback_surface;
+        const bool has_pending_popup = !has_pending_frame && capture_pacing.has_popup_damage;
+
+        if (lockstep.enabled) {
+            // The consumer, not the clock, paces the target; no timer is ever armed. Popups wait
+            // for the next stepped frame so every published frame stays on the virtual clock.
+            if (capture_pacing.has_pending_frame && capture_pacing.callback_surface &&
+                lockstep.frame_consumed) {
+                ready_surface = capture_pacing.callback_surface;
+                capture_pacing.has_pending_frame = false;
+                lockstep.frame_consumed = false;
+                lockstep.frame_time_ns = lockstep_frame_time_ns(
+                    lockstep.frame_index++, target_fps.load(std::memory_order_acquire));
+                lockstep_time_ns = lockstep.frame_time_ns;
+            }
+        } else if (has_pending_frame || has_pending_popup) {
             const auto target_interval =
                 frame_interval_for_fps(target_fps.load(std::memory_order_acquire));
             const auto now = SteadyClock::now();
-            if (target_interval == SteadyClock::duration::zero() ||
+            bool dispatch = false;
+            // An async target is published as it commits; the viewer presents it immediately.
+            if (async_target || (!vrr_range && target_interval == SteadyClock::duration::zero()) ||
                 !capture_pacing.has_last_dispatch_time) {
-                ready_surface = capture_pacing.callback_surface;
-                capture_pacing.has_pending_frame = false;
+                dispatch = true;
                 capture_pacing.last_dispatch_time = now;
                 capture_pacing.has_last_dispatch_time = true;
+            } else if (vrr_range) {
+                // The next frame goes out once the viewer presented the last one, no sooner than
+                // the display's max refresh and no later than its min refresh.
+                const bool viewer_caught_up =
+                    !presented_frame ||
+                    capture_pacing.viewer_frame_number >= presented_frame->frame_number;
+                const auto earliest =
+                    capture_pacing.last_dispatch_time + util::min_present_interval(*vrr_range);
+                const auto latest =
+                    capture_pacing.last_dispatch_time + util::max_present_interval(*vrr_range);
+                if (now >= latest || (viewer_caught_up && now >= earliest)) {
+                    dispatch = true;
+                    capture_pacing.last_dispatch_time = now;
+                } else {
+                    next_deadline = viewer_caught_up ? earliest : latest;
+                }
             } else {
                 const auto dispatch_deadline = capture_pacing.last_dispatch_time + target_interval;
                 if (dispatch_deadline <= now) {
-                    ready_surface = capture_pacing.callback_surface;
-                    capture_pacing.has_pending_frame = false;
+                    dispatch = true;
                     capture_pacing.last_dispatch_time = dispatch_deadline;
                 } else {
                     next_deadline = dispatch_deadline;
                 }
             }
+            if (dispatch && has_pending_frame) {
+                ready_surface = capture_pacing.callback_surface;
+                capture_pacing.has_pending_frame = false;
+            } else if (dispatch) {
+                popup_damage = capture_pacing.popup_damage;
+                capture_pacing.popup_damage = {};
+                capture_pacing.has_popup_damage = false;
+            }
         }
     }
 
@@ -474,17 +786,73 @@ void CompositorState::process_capture_pacing() {
         update_presented_frame(resolved_surface);
     }
 
+    if (ready_surface && lockstep_time_ns) {
+        send_frame_done_at(ready_surface, *lockstep_time_ns);
+        if (!update_presented_frame(ready_surface)) {
+            // Nothing was published for the consumer to release; give the tick back.
+            std::scoped_lock lock(present_mutex);
+            lockstep.frame_consumed = true;
+            --lockstep.frame_index;
+        }
+        return;
+    }
+
     if (ready_surface) {
         send_frame_done_now(ready_surface);
         update_presented_frame(ready_surface);
         return;
     }
 
+    if (popup_damage && target.root_surface && target.root_xsurface) {
+        // Popups are captured whole on the paced slot; the damage only skips changes that lie
+        // entirely outside the last captured frame.
+        const bool on_frame =
+            present_width == 0 || present_height == 0 ||
+            get_damage_frame_box(*popup_damage, static_cast<int>(target.root_xsurface->x),
+                                 static_cast<int>(target.root_xsurface->y),
+                                 get_surface_buffer_scale(target.root_surface),
+                                 static_cast<int>(present_width), static_cast<int>(present_height))
+                .has_value();
+        if (on_frame) {
+            render_surface_to_frame(target);
+            return;
+        }
+    }
+
     if (next_deadline) {
         arm_capture_pacing_timer(*next_deadline);
     }
 }
 
+void CompositorState::set_lockstep(bool enabled) {
+    {
+        std::scoped_lock lock(present_mutex);
+        lockstep = {};
+        lockstep.enabled = enabled;
+    }
+    // Let a callback held under the previous mode go out under the new one.
+    wake_event_loop();
+}
+
+void CompositorState::set_vrr_range(std::optional<util::RefreshRange> range) {
+    {
+        std::scoped_lock lock(present_mutex);
+        vrr_range = range;
+    }
+    wake_event_loop();
+}
+
+void CompositorState::release_lockstep_frame() {
+    {
+        std::scoped_lock lock(present_mutex);
+        if (!lockstep.enabled || lockstep.frame_consumed) {
+            return;
+        }
+        lockstep.frame_consumed = true;
+    }
+    wake_event_loop();
+}
+
 void CompositorState::note_active_surface_commit(wlr_surface* surface) {
     GOGGLES_PROFILE_FUNCTION();
     auto target = get_input_target(*this);
@@ -520,6 +888,7 @@ void CompositorState::note_active_surface_commit(wlr_surface* surface) {
             runtime_metrics.game_frame_intervals_ms, runtime_metrics.game_frame_interval_count);
         runtime_metrics.snapshot.game_fps = avg_ms > 0.0F ? 1000.0F / avg_ms : 0.0F;
         refresh_published_runtime_metrics(runtime_metrics);
+        util::Metrics::set_gauge(util::MetricGauge::game_fps, runtime_metrics.snapshot.game_fps);
     }
 
     runtime_metrics.last_game_commit_time = now;
@@ -568,6 +937,7 @@ auto CompositorState::get_runtime_metrics_snapshot() const
 void CompositorState::render_root_surface_tree(wlr_render_pass* pass, wlr_surface* root_surface) {
     RenderSurfaceContext context{};
     context.pass = pass;
+    context.scale = present_scale;
 
     auto* root_xdg = get_root_xdg_surface(root_surface);
     if (root_xdg && root_xdg->role == WLR_XDG_SURFACE_ROLE_TOPLEVEL) {
@@ -579,33 +949,17 @@ void CompositorState::render_root_surface_tree(wlr_render_pass* pass, wlr_surfac
 
 void CompositorState::render_xwayland_popup_surfaces(wlr_render_pass* pass,
                                                      const InputTarget& target) {
-    std::scoped_lock lock(hooks_mutex);
-    for (const auto& hooks_entry : xwayland_hooks) {
-        const auto* hooks = hooks_entry.get();
-        if (!hooks->mapped || !hooks->override_redirect || !hooks->xsurface ||
-            !hooks->xsurface->surface) {
-            continue;
-        }
-
-        const auto* popup = hooks->xsurface;
-        const auto* parent = popup->parent;
-        bool belongs_to_root = false;
-        while (parent) {
-            if (parent == target.root_xsurface) {
-                belongs_to_root = true;
-                break;
-            }
-            parent = parent->parent;
-        }
-        if (!belongs_to_root && !popup->parent) {
-            belongs_to_root = true;
-        }
-        if (!belongs_to_root) {
+    for (auto* hooks : xwayland_popups) {
+        if (!hooks->xsurface || !hooks->xsurface->surface ||
+            !xwayland_popup_belongs_to_root(*hooks, target.root_xsurface)) {
             continue;
         }
 
+        auto* popup = hooks->xsurface;
+        hooks->popup_box = get_xwayland_popup_box(*popup);
         RenderSurfaceContext context{};
         context.pass = pass;
+        context.scale = present_scale;
         context.offset_x =
             static_cast<int32_t>(popup->x) - static_cast<int32_t>(target.root_xsurface->x);
         context.offset_y =
@@ -614,80 +968,73 @@ void CompositorState::render_xwayland_popup_surfaces(wlr_render_pass* pass,
     }
 }
 
-bool CompositorState::render_surface_to_frame(const InputTarget& target) {
-    GOGGLES_PROFILE_SCOPE("CompositorRenderSurfaceToFrame");
-    wlr_surface* root_surface = target.root_surface ? target.root_surface : target.surface;
-    if (!present_swapchain || !root_surface) {
-        return false;
-    }
-
-    wlr_texture* root_texture = wlr_surface_get_texture(root_surface);
-    if (!root_texture) {
-        return false;
-    }
-
-    // Export sizing tracks the root surface texture so retained frames stay surface-native.
-    const auto desired_width = static_cast<uint32_t>(root_texture->width);
-    const auto desired_height = static_cast<uint32_t>(root_texture->height);
-    if (desired_width == 0 || desired_height == 0) {
-        return false;
-    }
-
-    if (present_width != desired_width || present_height != desired_height) {
-        wlr_swapchain_destroy(present_swapchain);
-        present_swapchain = wlr_swapchain_create(allocator, static_cast<int>(desired_width),
-                                                 static_cast<int>(desired_height), &present_format);
-        if (!present_swapchain) {
-            GOGGLES_LOG_WARN("Compositor present swapchain unavailable; non-Vulkan presentation "
-                             "disabled");
-            present_width = 0;
-            present_height = 0;
-            return false;
-        }
-        present_width = desired_width;
-        present_height = desired_height;
-    }
-
-    wlr_buffer* buffer = wlr_swapchain_acquire(present_swapchain);
+auto CompositorState::render_target_to_buffer(wlr_buffer* buffer, const InputTarget& target,
+                                             bool include_overlays) -> wlr_buffer* {
     if (!buffer) {
-        return false;
+        return nullptr;
     }
 
     wlr_render_pass* pass = wlr_renderer_begin_buffer_pass(renderer, buffer, nullptr);
     if (!pass) {
         wlr_buffer_unlock(buffer);
-        return false;
+        return nullptr;
     }
 
-    render_layer_surfaces(pass, ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND);
-    render_layer_surfaces(pass, ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM);
+    wlr_surface* root_surface = target.root_surface ? target.root_surface : target.surface;
+    // Frames are sized to the root's buffer, so a scaled or viewported root sets the scale
+    // everything else is drawn at.
+    present_scale = get_surface_buffer_scale(root_surface);
+    if (include_overlays) {
+        render_layer_surfaces(pass, ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND);
+        render_layer_surfaces(pass, ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM);
+    }
     render_root_surface_tree(pass, root_surface);
     if (target.root_xsurface) {
         render_xwayland_popup_surfaces(pass, target);
     }
-    render_layer_surfaces(pass, ZWLR_LAYER_SHELL_V1_LAYER_TOP);
-    render_layer_surfaces(pass, ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY);
-    render_cursor_overlay(pass);
+    if (include_overlays) {
+        render_layer_surfaces(pass, ZWLR_LAYER_SHELL_V1_LAYER_TOP);
+        render_layer_surfaces(pass, ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY);
+        render_cursor_overlay(pass);
+    }
 
     if (!wlr_render_pass_submit(pass)) {
         wlr_buffer_unlock(buffer);
+        return nullptr;
+    }
+    return buffer;
+}
+
+bool CompositorState::render_surface_to_frame(const InputTarget& target) {
+    GOGGLES_PROFILE_SCOPE("CompositorRenderSurfaceToFrame");
+    wlr_surface* root_surface = target.root_surface ? target.root_surface : target.surface;
+    if (!present_buffers.allocator || !root_surface) {
         return false;
     }
 
-    wlr_dmabuf_attributes attribs{};
-    if (!wlr_buffer_get_dmabuf(buffer, &attribs)) {
-        wlr_buffer_unlock(buffer);
+    wlr_texture* root_texture = wlr_surface_get_texture(root_surface);
+    if (!root_texture) {
         return false;
     }
 
-    if (attribs.n_planes != 1) {
-        GOGGLES_LOG_DEBUG("Skipping multi-plane DMA-BUF output (planes={})", attribs.n_planes);
-        wlr_buffer_unlock(buffer);
+    // Export sizing tracks the root surface texture so retained frames stay surface-native.
+    const auto desired_width = static_cast<uint32_t>(root_texture->width);
+    const auto desired_height = static_cast<uint32_t>(root_texture->height);
+    if (desired_width == 0 || desired_height == 0) {
         return false;
     }
 
-    auto dup_fd = util::UniqueFd::dup_from(attribs.fd[0]);
-    if (!dup_fd) {
+    present_buffers.buffer_count = present_buffer_count.load(std::memory_order_acquire);
+    wlr_buffer* buffer = render_target_to_buffer(
+        present_buffers.acquire(desired_width, desired_height), target, true);
+    if (!buffer) {
+        return false;
+    }
+    present_width = desired_width;
+    present_height = desired_height;
+
+    auto frame = export_buffer_frame(buffer, root_surface);
+    if (!frame) {
         wlr_buffer_unlock(buffer);
         return false;
     }
@@ -695,6 +1042,9 @@ bool CompositorState::render_surface_to_frame(const InputTarget& target) {
     const auto capture_time = std::chrono::steady_clock::now();
 
     std::scoped_lock lock(present_mutex);
+    // Whatever popup damage was pending is covered by this frame.
+    capture_pacing.popup_damage = {};
+    capture_pacing.has_popup_damage = false;
     const RuntimeMetricsState::CaptureTarget capture_target = {
         .root_surface = root_surface,
         .surface = target.surface ? target.surface : root_surface,
@@ -708,31 +1058,13 @@ bool CompositorState::render_surface_to_frame(const InputTarget& target) {
     }
 
     presented_buffer = buffer;
-
-    util::ExternalImageFrame frame{};
-    frame.image.width = static_cast<uint32_t>(attribs.width);
-    frame.image.height = static_cast<uint32_t>(attribs.height);
-    frame.image.stride = attribs.stride[0];
-    frame.image.offset = attribs.offset[0];
-    frame.image.format = drm_to_vk_format(attribs.format);
-    frame.image.modifier = attribs.modifier;
-    frame.image.handle = std::move(dup_fd);
-    frame.frame_number = ++presented_frame_number;
-
-    // Export the acquire fence from the root surface so Vulkan waits on compositor writes.
-    wlr_linux_drm_syncobj_surface_v1_state* syncobj_state =
-        wlr_linux_drm_syncobj_v1_get_surface_state(root_surface);
-    if (syncobj_state && syncobj_state->acquire_timeline) {
-        int sync_file = wlr_drm_syncobj_timeline_export_sync_file(syncobj_state->acquire_timeline,
-                                                                  syncobj_state->acquire_point);
-        if (sync_file >= 0) {
-            frame.sync_fd = util::UniqueFd{sync_file};
-        }
-    }
-
-    // Release stays tied to the exported buffer so wlroots can retire it after import completes.
-    if (syncobj_state && syncobj_state->release_timeline) {
-        wlr_linux_drm_syncobj_v1_state_signal_release_with_buffer(syncobj_state, buffer);
+    frame->frame_number = ++presented_frame_number;
+    if (lockstep.enabled) {
+        frame->commit_time_ns = lockstep.frame_time_ns;
+    } else {
+        frame->commit_time_ns = steady_time_ns(runtime_metrics.has_pending_capture_commit_time
+                                                   ? runtime_metrics.pending_capture_commit_time
+                                                   : capture_time);
     }
 
     if (runtime_metrics.has_pending_capture_commit_time) {
@@ -746,12 +1078,264 @@ bool CompositorState::render_surface_to_frame(const InputTarget& target) {
             average_runtime_metric_sample(runtime_metrics.compositor_latency_samples_ms,
                                           runtime_metrics.compositor_latency_count);
         refresh_published_runtime_metrics(runtime_metrics);
+        util::Metrics::set_gauge(util::MetricGauge::compositor_latency_seconds,
+                                 runtime_metrics.snapshot.compositor_latency_ms / 1000.0);
         runtime_metrics.has_pending_capture_commit_time = false;
     }
 
+    sample_presentation_feedback(root_surface, frame->frame_number);
     presented_frame = std::move(frame);
     presented_surface = root_surface;
+    presented_frame_cv.notify_all();
     return true;
 }
 
+void CompositorState::sample_presentation_feedback(wlr_surface* root_surface,
+                                                   uint64_t frame_number) {
+    if (!presentation) {
+        return;
+    }
+    struct SampleContext {
+        std::vector<PendingPresentationFeedback>* pending;
+        uint64_t frame_number;
+    } context{.pending = &presentation_feedback, .frame_number = frame_number};
+    wlr_surface_for_each_surface(
+        root_surface,
+        [](wlr_surface* surface, int /*sx*/, int /*sy*/, void* data) {
+            auto* sample = static_cast<SampleContext*>(data);
+            if (auto* feedback = wlr_presentation_surface_sampled(surface)) {
+                sample->pending->push_back(
+                    {.frame_number = sample->frame_number, .feedback = feedback});
+            }
+        },
+        &context);
+    while (presentation_feedback.size() > MAX_PENDING_PRESENTATION_FEEDBACK) {
+        wlr_presentation_feedback_destroy(presentation_feedback.front().feedback);
+        presentation_feedback.erase(presentation_feedback.begin());
+    }
+}
+
+void CompositorState::report_present_feedback(const util::PresentFeedback& feedback) {
+    if (feedback.frame_number == 0 || !present_feedback_queue.try_push(feedback)) {
+        return;
+    }
+    wake_event_loop();
+}
+
+void CompositorState::handle_present_feedback() {
+    uint64_t newest_frame_number = 0;
+    while (auto feedback = present_feedback_queue.try_pop()) {
+        newest_frame_number = std::max(newest_frame_number, feedback->frame_number);
+        constexpr uint64_t NS_PER_SECOND = 1'000'000'000;
+        wlr_presentation_event event{};
+        event.output = output;
+        event.tv_sec = feedback->time_ns / NS_PER_SECOND;
+        event.tv_nsec = static_cast<uint32_t>(feedback->time_ns % NS_PER_SECOND);
+        // Refresh is unknown: the viewer does not query display timing.
+        event.refresh = 0;
+        event.seq = feedback->sequence;
+        event.flags = (feedback->vsync ? PRESENTATION_KIND_VSYNC : 0U) |
+                      (feedback->hw_completion ? PRESENTATION_KIND_HW_COMPLETION : 0U);
+
+        // Older frames were superseded before reaching the display; newer ones are still due.
+        auto due = presentation_feedback.begin();
+        for (; due != presentation_feedback.end() && due->frame_number <= feedback->frame_number;
+             ++due) {
+            if (due->frame_number == feedback->frame_number) {
+                wlr_presentation_feedback_send_presented(due->feedback, &event);
+            }
+            wlr_presentation_feedback_destroy(due->feedback);
+        }
+        presentation_feedback.erase(presentation_feedback.begin(), due);
+    }
+
+    if (newest_frame_number != 0) {
+        // `process_capture_pacing()` runs next and releases a VRR-paced frame callback.
+        std::scoped_lock lock(present_mutex);
+        capture_pacing.viewer_frame_number =
+            std::max(capture_pacing.viewer_frame_number, newest_frame_number);
+    }
+}
+
+void CompositorState::discard_presentation_feedback() {
+    for (const auto& pending : presentation_feedback) {
+        wlr_presentation_feedback_destroy(pending.feedback);
+    }
+    presentation_feedback.clear();
+}
+
+void CompositorState::request_capture_surfaces(std::vector<uint32_t> surface_ids) {
+    {
+        std::scoped_lock lock(present_mutex);
+        pending_capture_surfaces = std::move(surface_ids);
+    }
+    wake_event_loop();
+}
+
+void CompositorState::set_surface_allow_tearing(uint32_t surface_id, bool allow) {
+    {
+        std::scoped_lock lock(hooks_mutex);
+        for (const auto& hooks_entry : xwayland_hooks) {
+            if (!hooks_entry->override_redirect && hooks_entry->id == surface_id) {
+                hooks_entry->allow_tearing = allow;
+            }
+        }
+        for (const auto& hooks_entry : xdg_hooks) {
+            if (hooks_entry->id == surface_id) {
+                hooks_entry->allow_tearing = allow;
+            }
+        }
+    }
+    // Re-resolves `async_presentation` for the current target without waiting for a commit.
+    wake_event_loop();
+}
+
+void CompositorState::handle_capture_surfaces_request() {
+    std::optional<std::vector<uint32_t>> surface_ids;
+    {
+        std::scoped_lock lock(present_mutex);
+        surface_ids.swap(pending_capture_surfaces);
+    }
+    if (!surface_ids) {
+        return;
+    }
+
+    std::vector<SurfaceExport> resolved;
+    {
+        std::scoped_lock lock(hooks_mutex);
+        for (uint32_t surface_id : *surface_ids) {
+            SurfaceExport entry{};
+            entry.surface_id = surface_id;
+            for (const auto& hooks_entry : xwayland_hooks) {
+                const auto* hooks = hooks_entry.get();
+                if (!hooks->override_redirect && hooks->id == surface_id && hooks->xsurface &&
+                    hooks->xsurface->surface) {
+                    entry.root_surface = hooks->xsurface->surface;
+                    entry.root_xsurface = hooks->xsurface;
+                    break;
+                }
+            }
+            if (!entry.root_surface) {
+                for (const auto& hooks_entry : xdg_hooks) {
+                    const auto* hooks = hooks_entry.get();
+                    if (hooks->id == surface_id && hooks->surface && hooks->toplevel) {
+                        entry.root_surface = hooks->surface;
+                        break;
+                    }
+                }
+            }
+            if (entry.root_surface) {
+                resolved.push_back(std::move(entry));
+            }
+        }
+    }
+
+    std::vector<wlr_surface*> added;
+    {
+        std::scoped_lock lock(present_mutex);
+        for (auto& entry : resolved) {
+            auto existing = std::find_if(
+                surface_exports.begin(), surface_exports.end(), [&entry](const auto& current) {
+                    return current.surface_id == entry.surface_id &&
+                           current.root_surface == entry.root_surface;
+                });
+            if (existing != surface_exports.end()) {
+                entry = std::move(*existing);
+                surface_exports.erase(existing);
+            } else {
+                added.push_back(entry.root_surface);
+            }
+        }
+        for (auto& stale : surface_exports) {
+            release_export_resources(stale);
+        }
+        surface_exports = std::move(resolved);
+    }
+
+    // Seed new exports immediately; otherwise an idle window would stay blank until it commits.
+    for (auto* surface : added) {
+        update_surface_export(surface);
+    }
+}
+
+void CompositorState::update_surface_export(wlr_surface* surface) {
+    // Only the compositor thread mutates `surface_exports`, so the lookup needs no lock.
+    auto entry = std::find_if(surface_exports.begin(), surface_exports.end(),
+                              [surface](const auto& current) {
+                                  return surface && current.root_surface == surface;
+                              });
+    if (entry == surface_exports.end()) {
+        return;
+    }
+    GOGGLES_PROFILE_SCOPE("CompositorUpdateSurfaceExport");
+
+    wlr_texture* root_texture = wlr_surface_get_texture(surface);
+    if (!root_texture || root_texture->width <= 0 || root_texture->height <= 0) {
+        return;
+    }
+
+    wlr_swapchain* swapchain = entry->swapchain;
+    uint32_t width = entry->width;
+    uint32_t height = entry->height;
+    if (!resize_export_swapchain(allocator, present_format, swapchain, width, height,
+                                 static_cast<uint32_t>(root_texture->width),
+                                 static_cast<uint32_t>(root_texture->height))) {
+        std::scoped_lock lock(present_mutex);
+        entry->swapchain = nullptr;
+        release_export_resources(*entry);
+        return;
+    }
+
+    const InputTarget target = {
+        .surface = surface,
+        .xsurface = entry->root_xsurface,
+        .root_surface = surface,
+        .root_xsurface = entry->root_xsurface,
+    };
+    // Secondary exports carry only the window itself; layers and the cursor belong to the target.
+    wlr_buffer* buffer = render_target_to_buffer(wlr_swapchain_acquire(swapchain), target, false);
+    auto frame = buffer ? export_buffer_frame(buffer, surface) : std::nullopt;
+    if (buffer && !frame) {
+        wlr_buffer_unlock(buffer);
+        buffer = nullptr;
+    }
+
+    std::scoped_lock lock(present_mutex);
+    entry->swapchain = swapchain;
+    entry->width = width;
+    entry->height = height;
+    if (!buffer) {
+        return;
+    }
+    if (entry->buffer) {
+        wlr_buffer_unlock(entry->buffer);
+    }
+    entry->buffer = buffer;
+    frame->frame_number = ++presented_frame_number;
+    frame->commit_time_ns = steady_time_ns(std::chrono::steady_clock::now());
+    entry->frame = std::move(frame);
+}
+
+void CompositorState::release_surface_export(wlr_surface* surface) {
+    std::scoped_lock lock(present_mutex);
+    auto entry = std::find_if(surface_exports.begin(), surface_exports.end(),
+                              [surface](const auto& current) {
+                                  return surface && current.root_surface == surface;
+                              });
+    if (entry == surface_exports.end()) {
+        return;
+    }
+    release_export_resources(*entry);
+    surface_exports.erase(entry);
+}
+
+void CompositorState::clear_surface_exports() {
+    std::scoped_lock lock(present_mutex);
+    for (auto& entry : surface_exports) {
+        release_export_resources(entry);
+    }
+    surface_exports.clear();
+    pending_capture_surfaces.reset();
+}
+
 } // namespace goggles::compositor
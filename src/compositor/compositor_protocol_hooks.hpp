@@ -1,9 +1,11 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 extern "C" {
 #include <wayland-server-core.h>
+#include <wlr/util/box.h>
 // NOLINTBEGIN(readability-identifier-naming)
 struct wlr_layer_surface_v1;
 struct wlr_pointer_constraint_v1;
@@ -36,10 +38,18 @@ struct XWaylandSurfaceHooks {
     bool map_requested = false;
     bool mapped = false;
     bool override_redirect = false;
+    /// Honor this surface's async tearing hint; set from the viewer under `hooks_mutex`.
+    bool allow_tearing = false;
+    // Override-redirect only: ancestor chain cached at map time and on reparent, so captures
+    // match popups to their root without walking parents.
+    std::vector<wlr_xwayland_surface*> popup_parents;
+    // Override-redirect only: X11 geometry as last drawn, the area damaged when it changes.
+    wlr_box popup_box{};
     wl_listener associate{};
     wl_listener dissociate{};
     wl_listener map_request{};
     wl_listener commit{};
+    wl_listener set_parent{};
     wl_listener destroy{};
 };
 
@@ -69,6 +79,8 @@ struct XdgToplevelHooks {
     bool sent_configure = false;
     bool acked_configure = false;
     bool mapped = false;
+    /// Honor this surface's async tearing hint; set from the viewer under `hooks_mutex`.
+    bool allow_tearing = false;
 
     wl_listener surface_commit{};
     wl_listener surface_map{};
@@ -1,22 +1,35 @@
 #include "compositor_state.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <goggles/profiling.hpp>
 #include <memory>
+#include <util/job_system.hpp>
 #include <util/logging.hpp>
 
 namespace goggles::compositor {
 
+namespace {
+
+auto elapsed_ms(std::chrono::steady_clock::time_point since) -> double {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since)
+        .count();
+}
+
+} // namespace
+
 CompositorServer::CompositorServer() : m_state(std::make_unique<CompositorState>()) {}
 
 CompositorServer::~CompositorServer() {
     stop();
 }
 
-auto CompositorServer::create() -> ResultPtr<CompositorServer> {
+auto CompositorServer::create(const SocketReadyCallback& on_socket_ready)
+    -> ResultPtr<CompositorServer> {
     GOGGLES_PROFILE_FUNCTION();
     auto server = std::make_unique<CompositorServer>();
 
-    auto start_result = server->start();
+    auto start_result = server->start(on_socket_ready);
     if (!start_result) {
         return nonstd::make_unexpected(
             Error{start_result.error().code, start_result.error().message});
@@ -25,66 +38,93 @@ auto CompositorServer::create() -> ResultPtr<CompositorServer> {
     return {std::move(server)};
 }
 
-auto CompositorServer::start() -> Result<void> {
+auto CompositorServer::start(const SocketReadyCallback& on_socket_ready) -> Result<void> {
     GOGGLES_PROFILE_FUNCTION();
     auto& state = *m_state;
     auto cleanup_on_error = [this](void*) { stop(); };
     std::unique_ptr<void, decltype(cleanup_on_error)> guard(this, cleanup_on_error);
+    state.start_time = std::chrono::steady_clock::now();
+
+    // Only disk I/O, so it overlaps the whole wlroots bring-up; the upload waits for the renderer.
+    auto cursor_theme_job = util::JobSystem::submit(&CompositorState::load_cursor_theme);
 
-    auto run_step = [](auto&& step) -> Result<void> {
+    auto run_step = [](const char* name, auto&& step) -> Result<void> {
+        const auto step_start = std::chrono::steady_clock::now();
         auto result = step();
+        GOGGLES_LOG_DEBUG("Compositor start: {} took {:.2f} ms", name, elapsed_ms(step_start));
         if (!result) {
             return make_error<void>(result.error().code, result.error().message);
         }
         return {};
     };
 
-    if (auto result = run_step([&] { return state.setup_base_components(); }); !result) {
+    if (auto result = run_step("base components", [&] { return state.setup_base_components(); });
+        !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.create_allocator(); }); !result) {
+    if (auto result = run_step("allocator", [&] { return state.create_allocator(); }); !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.create_compositor(); }); !result) {
+    if (auto result = run_step("compositor", [&] { return state.create_compositor(); }); !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.create_output_layout(); }); !result) {
+    if (auto result = run_step("output layout", [&] { return state.create_output_layout(); });
+        !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.setup_xdg_shell(); }); !result) {
+    if (auto result = run_step("xdg shell", [&] { return state.setup_xdg_shell(); }); !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.setup_layer_shell(); }); !result) {
+    if (auto result = run_step("layer shell", [&] { return state.setup_layer_shell(); });
+        !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.setup_input_devices(); }); !result) {
+    if (auto result = run_step("input devices", [&] { return state.setup_input_devices(); });
+        !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.setup_event_loop_fd(); }); !result) {
+    if (auto result = run_step("event loop fd", [&] { return state.setup_event_loop_fd(); });
+        !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.bind_wayland_socket(); }); !result) {
+    if (auto result = run_step("wayland socket", [&] { return state.bind_wayland_socket(); });
+        !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.setup_xwayland(); }); !result) {
+    // Forks Xwayland right away so it boots during the backend and output steps below; the
+    // ready signal is only delivered once the compositor thread runs.
+    if (auto result = run_step("xwayland spawn", [&] { return state.setup_xwayland(); });
+        !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.start_backend(); }); !result) {
+    GOGGLES_LOG_DEBUG("Compositor start: Wayland socket {} ready after {:.2f} ms",
+                      state.wayland_socket_name, elapsed_ms(state.start_time));
+    // Both display names are final here. Clients connecting now queue on the listening sockets
+    // and are served once the compositor thread starts.
+    if (on_socket_ready) {
+        on_socket_ready(*this);
+    }
+    if (auto result = run_step("backend", [&] { return state.start_backend(); }); !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.setup_output(); }); !result) {
+    if (auto result = run_step("output", [&] { return state.setup_output(); }); !result) {
         return result;
     }
-    if (auto result = run_step([&] { return state.initialize_present_output(); }); !result) {
+    if (auto result =
+            run_step("present output", [&] { return state.initialize_present_output(); });
+        !result) {
         return result;
     }
 
-    auto cursor_result = state.setup_cursor_theme();
+    auto cursor_result = run_step("cursor theme", [&] {
+        return state.setup_cursor_theme(cursor_theme_job.get());
+    });
     if (!cursor_result) {
         GOGGLES_LOG_WARN("Compositor cursor theme unavailable: {}", cursor_result.error().message);
     }
 
     state.start_compositor_thread();
+    GOGGLES_LOG_INFO("Compositor started in {:.1f} ms", elapsed_ms(state.start_time));
 
     guard.release(); // NOLINT(bugprone-unused-return-value)
     return {};
@@ -103,6 +143,10 @@ auto CompositorServer::wayland_display() const -> std::string {
     return m_state->wayland_socket_name;
 }
 
+auto CompositorServer::xwayland_ready() const -> std::shared_future<bool> {
+    return m_state->xwayland_ready_future;
+}
+
 auto CompositorServer::target_fps() const -> uint32_t {
     return m_state->target_fps.load(std::memory_order_acquire);
 }
@@ -112,6 +156,34 @@ void CompositorServer::set_target_fps(uint32_t target_fps) {
     m_state->wake_event_loop();
 }
 
+auto CompositorServer::async_presentation() const -> bool {
+    return m_state->async_presentation.load(std::memory_order_acquire);
+}
+
+void CompositorServer::set_output_mode(const OutputMode& mode) {
+    m_state->request_output_mode(mode);
+}
+
+void CompositorServer::report_present_feedback(const util::PresentFeedback& feedback) {
+    m_state->report_present_feedback(feedback);
+}
+
+void CompositorServer::set_present_buffer_count(uint32_t count) {
+    m_state->present_buffer_count.store(std::max(count, 2U), std::memory_order_release);
+}
+
+void CompositorServer::set_lockstep(bool enabled) {
+    m_state->set_lockstep(enabled);
+}
+
+void CompositorServer::release_lockstep_frame() {
+    m_state->release_lockstep_frame();
+}
+
+void CompositorServer::set_vrr_pacing(std::optional<util::RefreshRange> range) {
+    m_state->set_vrr_range(range);
+}
+
 auto CompositorServer::get_runtime_metrics_snapshot() const
     -> util::CompositorRuntimeMetricsSnapshot {
     return m_state->get_runtime_metrics_snapshot();
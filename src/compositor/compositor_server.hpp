@@ -1,13 +1,18 @@
 #pragma once
 
 #include <SDL3/SDL_events.h>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <goggles/error.hpp>
 #include <memory>
 #include <optional>
 #include <string>
+#include <util/cursor_plane.hpp>
 #include <util/external_image.hpp>
 #include <util/runtime_metrics.hpp>
+#include <util/vrr_pacing.hpp>
 #include <vector>
 
 namespace goggles::compositor {
@@ -23,6 +28,10 @@ struct SurfaceInfo {
     bool is_xwayland;
     bool is_input_target;
     bool filter_chain_enabled = false;
+    bool frame_interpolation_enabled = false;
+    bool allow_tearing = false;
+
+    auto operator==(const SurfaceInfo&) const -> bool = default;
 };
 
 struct SurfaceResizeInfo {
@@ -31,6 +40,43 @@ struct SurfaceResizeInfo {
     bool maximized = false;
 };
 
+/// @brief Mode of the compositor's headless output.
+///
+/// `scale` is also sent to Wayland clients as their preferred fractional scale, so a client
+/// honoring `wp_fractional_scale_v1` renders `scale` buffer pixels per logical pixel and maps
+/// them back with `wp_viewporter`.
+struct OutputMode {
+    uint32_t width = 1920;
+    uint32_t height = 1080;
+    double scale = 1.0;
+
+    auto operator==(const OutputMode&) const -> bool = default;
+};
+
+/// @brief One frame of the compositor's cursor image, for viewers drawing the cursor themselves.
+struct CursorImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t hotspot_x = 0;
+    uint32_t hotspot_y = 0;
+    /// Time this frame is shown in an animated cursor; 0 for a static one.
+    uint32_t delay_ms = 0;
+    /// Tightly packed straight-alpha RGBA8 pixels.
+    std::vector<uint8_t> rgba;
+};
+
+/// @brief Pointer state exported beside presented frames under `CursorPlane::overlay`.
+struct CursorState {
+    bool visible = false;
+    /// Pointer position in presented-frame pixels; the image's hotspot is drawn here.
+    double x = 0.0;
+    double y = 0.0;
+    /// Presented-frame pixels per cursor image pixel; below 1 while clients render scaled down.
+    double scale = 1.0;
+    /// Index into `CompositorServer::cursor_images()` of the animation frame to show now.
+    uint32_t image_index = 0;
+};
+
 /// Normalized from SDL events into compositor-native units.
 struct InputEvent {
     InputEventType type;
@@ -46,8 +92,14 @@ struct CompositorState;
 /// @brief Runs a headless Wayland/XWayland compositor for input forwarding and surface capture.
 ///
 /// `start()` spawns a compositor thread. Input injection methods queue events for that thread.
+/// Xwayland keeps starting in the background after `start()` returns; X11 clients launched
+/// before it is ready wait on its already-listening socket.
 class CompositorServer {
 public:
+    /// Runs on the `start()` caller's thread once the Wayland socket is bound and Xwayland is
+    /// spawned, before backend and output setup. Clients may be launched from it.
+    using SocketReadyCallback = std::function<void(CompositorServer&)>;
+
     CompositorServer();
     ~CompositorServer();
 
@@ -56,13 +108,34 @@ public:
     CompositorServer(CompositorServer&&) = delete;
     CompositorServer& operator=(CompositorServer&&) = delete;
 
-    [[nodiscard]] static auto create() -> ResultPtr<CompositorServer>;
-    [[nodiscard]] auto start() -> Result<void>;
+    [[nodiscard]] static auto create(const SocketReadyCallback& on_socket_ready = {})
+        -> ResultPtr<CompositorServer>;
+    [[nodiscard]] auto start(const SocketReadyCallback& on_socket_ready = {}) -> Result<void>;
     void stop();
     [[nodiscard]] auto x11_display() const -> std::string;
     [[nodiscard]] auto wayland_display() const -> std::string;
+    /// Becomes true once Xwayland accepts X11 clients, or false if the compositor stops first.
+    [[nodiscard]] auto xwayland_ready() const -> std::shared_future<bool>;
     [[nodiscard]] auto target_fps() const -> uint32_t;
     void set_target_fps(uint32_t target_fps);
+    /// Whether the input target currently asks for async presentation and has tearing allowed;
+    /// the viewer should then present immediately.
+    [[nodiscard]] auto async_presentation() const -> bool;
+    /// Reconfigures the output and every client's preferred scale; applied asynchronously.
+    void set_output_mode(const OutputMode& mode);
+    /// Render buffers kept per captured size, at least 2. Lowering it frees nothing already
+    /// allocated until that size idles out of the pool.
+    void set_present_buffer_count(uint32_t count);
+    /// In lockstep the input target only receives its next frame callback once
+    /// `release_lockstep_frame()` reports the last presented frame consumed, and presented frames
+    /// carry a virtual `commit_time_ns` of exactly `n / target_fps` seconds for the n-th frame.
+    void set_lockstep(bool enabled);
+    /// Call after rendering each frame from `get_presented_frame()`; a no-op outside lockstep.
+    void release_lockstep_frame();
+    /// While set, the input target's frame callbacks follow the viewer's presents, as reported
+    /// through `report_present_feedback()`, within `range` instead of `target_fps`. Ignored in
+    /// lockstep and for targets presenting asynchronously.
+    void set_vrr_pacing(std::optional<util::RefreshRange> range);
 
     /// Events may be silently dropped if the internal queue is full.
     [[nodiscard]] auto forward_key(const SDL_KeyboardEvent& event) -> Result<void>;
@@ -78,15 +151,40 @@ public:
     /// Locked (not confined) by the target app's pointer lock request.
     [[nodiscard]] auto is_pointer_locked() const -> bool;
     void set_cursor_visible(bool visible);
+    /// Under `overlay` the cursor is left out of presented frames and pointer motion or cursor
+    /// visibility changes never re-render them; read it with `get_cursor_state()` instead.
+    void set_cursor_plane(CursorPlane plane);
+    /// Cursor animation frames; fixed once `start()` returns.
+    [[nodiscard]] auto cursor_images() const -> std::vector<CursorImage>;
+    [[nodiscard]] auto get_cursor_state() const -> CursorState;
 
     [[nodiscard]] auto get_presented_frame(uint64_t after_frame_number) const
         -> std::optional<util::ExternalImageFrame>;
+    /// Blocks until a frame newer than `after_frame_number` is presented or `deadline` passes;
+    /// returns whether one is available.
+    [[nodiscard]] auto wait_for_presented_frame(uint64_t after_frame_number,
+                                                std::chrono::steady_clock::time_point deadline)
+        const -> bool;
+    /// Reports that a frame from `get_presented_frame()` reached the display, which completes
+    /// the capture target's `wp_presentation` feedback. Single caller thread; queued behind a
+    /// short mutex, and dropped when the compositor falls behind.
+    void report_present_feedback(const util::PresentFeedback& feedback);
     [[nodiscard]] auto get_runtime_metrics_snapshot() const
         -> util::CompositorRuntimeMetricsSnapshot;
+    /// Latest export of a surface registered with `set_capture_surfaces()`.
+    [[nodiscard]] auto get_surface_frame(uint32_t surface_id, uint64_t after_frame_number) const
+        -> std::optional<util::ExternalImageFrame>;
 
     [[nodiscard]] auto get_surfaces() const -> std::vector<SurfaceInfo>;
     void set_input_target(uint32_t surface_id);
+    /// Surfaces exported on every commit in addition to the input target. An empty list stops
+    /// multi-surface capture. The input target itself is still read with `get_presented_frame()`.
+    void set_capture_surfaces(std::vector<uint32_t> surface_ids);
     void request_surface_resize(uint32_t surface_id, const SurfaceResizeInfo& resize);
+    /// Opts one toplevel in to honoring its `wp_tearing_control_v1` async hint: while it is the
+    /// input target, its commits skip `target_fps` pacing and are published as they arrive.
+    /// Off for every surface until set; the flag is dropped with the surface.
+    void set_surface_allow_tearing(uint32_t surface_id, bool allow);
 
 private:
     std::unique_ptr<CompositorState> m_state;
@@ -7,6 +7,8 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -26,10 +28,13 @@ struct wlr_allocator;
 struct wlr_backend;
 struct wlr_buffer;
 struct wlr_compositor;
+struct wlr_fractional_scale_manager_v1;
 struct wlr_layer_shell_v1;
 struct wlr_linux_drm_syncobj_manager_v1;
 struct wlr_output;
 struct wlr_output_layout;
+struct wlr_presentation;
+struct wlr_presentation_feedback;
 struct wlr_pointer_constraint_v1;
 struct wlr_pointer_constraints_v1;
 struct wlr_relative_pointer_manager_v1;
@@ -38,7 +43,9 @@ struct wlr_renderer;
 struct wlr_seat;
 struct wlr_surface;
 struct wlr_swapchain;
+struct wlr_tearing_control_manager_v1;
 struct wlr_texture;
+struct wlr_viewporter;
 struct wlr_xcursor;
 struct wlr_xcursor_theme;
 struct wlr_xdg_popup;
@@ -61,16 +68,21 @@ using ::wlr_allocator;
 using ::wlr_backend;
 using ::wlr_buffer;
 using ::wlr_compositor;
+using ::wlr_fractional_scale_manager_v1;
 using ::wlr_linux_drm_syncobj_manager_v1;
 using ::wlr_output;
 using ::wlr_output_layout;
+using ::wlr_presentation;
+using ::wlr_presentation_feedback;
 using ::wlr_pointer_constraints_v1;
 using ::wlr_relative_pointer_manager_v1;
 using ::wlr_render_pass;
 using ::wlr_renderer;
 using ::wlr_seat;
 using ::wlr_swapchain;
+using ::wlr_tearing_control_manager_v1;
 using ::wlr_texture;
+using ::wlr_viewporter;
 using ::wlr_xcursor;
 using ::wlr_xcursor_theme;
 using ::wlr_xdg_shell;
@@ -99,6 +111,79 @@ struct CapturePacingState {
     bool has_capture_target = false;
     bool has_pending_frame = false;
     bool has_last_dispatch_time = false;
+    /// Override-redirect popup area changed since the last capture, in X11 root coordinates.
+    /// Captured on the next paced dispatch unless it lies entirely off-frame.
+    wlr_box popup_damage{};
+    bool has_popup_damage = false;
+    /// Newest input-target frame the viewer reported presented; paces VRR frame callbacks.
+    uint64_t viewer_frame_number = 0;
+};
+
+/// @brief Deterministic frame stepping for reproducible headless runs.
+///
+/// While enabled, the capture target's frame callback is held until the consumer reports that it
+/// rendered the last published frame, and frames are stamped with a virtual clock advancing
+/// exactly `1 / target_fps` per dispatched frame instead of wall-clock time. Guarded by
+/// `present_mutex`.
+struct LockstepState {
+    bool enabled = false;
+    bool frame_consumed = true;
+    uint64_t frame_index = 0;
+    /// Virtual time of the last dispatched frame, in nanoseconds since lockstep was enabled.
+    uint64_t frame_time_ns = 0;
+};
+
+/// @brief Export of a captured surface other than the input target, for multi-surface capture.
+///
+/// Each export owns its own swapchain sized to the surface, so secondary windows never resize
+/// the primary present buffers. `buffer` and `frame` are guarded by `present_mutex`.
+struct SurfaceExport {
+    uint32_t surface_id = 0;
+    wlr_surface* root_surface = nullptr;
+    wlr_xwayland_surface* root_xsurface = nullptr;
+    wlr_swapchain* swapchain = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    wlr_buffer* buffer = nullptr;
+    std::optional<util::ExternalImageFrame> frame;
+};
+
+/// @brief Size-bucketed render buffers for the presented frame.
+///
+/// A root resize switches buckets instead of reallocating, so a client toggling between a few
+/// sizes keeps rendering into the same buffers. Buckets idle for `IDLE_TIMEOUT` are dropped, as
+/// is the least recently used one beyond `MAX_BUCKETS`. Buffers are allocated lazily up to
+/// `buffer_count` per bucket; one is free once nothing holds a lock on it. Compositor thread
+/// only.
+struct PresentBufferPool {
+    static constexpr uint32_t DEFAULT_BUFFER_COUNT = 3;
+    static constexpr size_t MAX_BUCKETS = 3;
+    static constexpr std::chrono::seconds IDLE_TIMEOUT{5};
+
+    struct Bucket {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<wlr_buffer*> buffers;
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    wlr_allocator* allocator = nullptr;
+    const wlr_drm_format* format = nullptr;
+    uint32_t buffer_count = DEFAULT_BUFFER_COUNT;
+    std::vector<Bucket> buckets;
+
+    /// Returns a locked buffer of the given size, or null when allocation fails or every buffer
+    /// of that size is still in use.
+    [[nodiscard]] auto acquire(uint32_t width, uint32_t height) -> wlr_buffer*;
+    void trim(std::chrono::steady_clock::time_point now);
+    void clear();
+};
+
+/// @brief Client presentation feedback sampled into a published frame, awaiting the viewer's
+/// present of that frame.
+struct PendingPresentationFeedback {
+    uint64_t frame_number = 0;
+    wlr_presentation_feedback* feedback = nullptr;
 };
 
 struct Listeners {
@@ -107,6 +192,7 @@ struct Listeners {
     wl_listener new_xdg_toplevel{};
     wl_listener new_xdg_popup{};
     wl_listener new_xwayland_surface{};
+    wl_listener xwayland_ready{};
     wl_listener new_pointer_constraint{};
     wl_listener new_layer_surface{};
 };
@@ -122,9 +208,17 @@ struct KeyboardDeleter {
 
 using UniqueKeyboard = std::unique_ptr<wlr_keyboard, KeyboardDeleter>;
 
+struct XcursorThemeDeleter {
+    void operator()(wlr_xcursor_theme* theme) const;
+};
+
+using UniqueXcursorTheme = std::unique_ptr<wlr_xcursor_theme, XcursorThemeDeleter>;
+
 struct CompositorState {
     util::SPSCQueue<InputEvent> event_queue{64};
     util::SPSCQueue<SurfaceResizeRequest> resize_queue{64};
+    /// Viewer present completions; produced by the viewer thread only.
+    util::SPSCQueue<util::PresentFeedback> present_feedback_queue{64};
     wl_display* display = nullptr;
     wl_event_loop* event_loop = nullptr;
     wl_event_source* event_source = nullptr;
@@ -147,7 +241,7 @@ struct CompositorState {
     wlr_xwayland_surface* focused_xsurface = nullptr;
     wlr_surface* keyboard_entered_surface = nullptr;
     wlr_surface* pointer_entered_surface = nullptr;
-    wlr_swapchain* present_swapchain = nullptr;
+    PresentBufferPool present_buffers;
     std::vector<uint64_t> present_modifiers;
     double cursor_x = 0.0;
     double cursor_y = 0.0;
@@ -159,32 +253,71 @@ struct CompositorState {
     uint64_t presented_frame_number = 0;
     std::jthread compositor_thread;
     std::vector<CursorFrame> cursor_frames;
+    /// CPU copies of `cursor_frames` for viewers drawing the cursor themselves.
+    std::vector<CursorImage> cursor_images;
     std::vector<std::unique_ptr<XdgToplevelHooks>> xdg_hooks;
     std::vector<std::unique_ptr<XdgPopupHooks>> xdg_popup_hooks;
     std::vector<std::unique_ptr<XWaylandSurfaceHooks>> xwayland_hooks;
+    /// Mapped override-redirect hooks in stacking order. Compositor thread only, so captures
+    /// walk it without `hooks_mutex`.
+    std::vector<XWaylandSurfaceHooks*> xwayland_popups;
     std::vector<std::unique_ptr<ConstraintHooks>> constraint_hooks;
     std::vector<std::unique_ptr<LayerSurfaceHooks>> layer_hooks;
     wlr_layer_shell_v1* layer_shell = nullptr;
     wlr_linux_drm_syncobj_manager_v1* syncobj_manager = nullptr;
+    wlr_viewporter* viewporter = nullptr;
+    wlr_fractional_scale_manager_v1* fractional_scale_manager = nullptr;
+    wlr_presentation* presentation = nullptr;
+    wlr_tearing_control_manager_v1* tearing_control = nullptr;
+    /// Oldest first; compositor thread only.
+    std::vector<PendingPresentationFeedback> presentation_feedback;
     wlr_drm_format present_format{};
     std::string wayland_socket_name;
     mutable std::mutex hooks_mutex;
     mutable std::mutex present_mutex;
+    /// Notified under `present_mutex` whenever `presented_frame` is replaced.
+    mutable std::condition_variable presented_frame_cv;
     std::optional<util::ExternalImageFrame> presented_frame;
+    std::vector<SurfaceExport> surface_exports;
+    std::optional<std::vector<uint32_t>> pending_capture_surfaces;
     RuntimeMetricsState runtime_metrics;
     CapturePacingState capture_pacing;
+    LockstepState lockstep;
+    /// Set while the viewer paces a VRR display: frame callbacks then follow its presents within
+    /// this window instead of `target_fps`. Guarded by `present_mutex`.
+    std::optional<util::RefreshRange> vrr_range;
     Listeners listeners;
     uint32_t present_width = 0;
     uint32_t present_height = 0;
+    /// Frame pixels per logical pixel of the frame being rendered; compositor thread only.
+    double present_scale = 1.0;
+    /// Applied output mode; compositor thread only.
+    OutputMode output_mode;
+    /// Latest `set_output_mode()` not yet applied; guarded by `present_mutex`.
+    std::optional<OutputMode> pending_output_mode;
     util::UniqueFd event_fd;
     uint32_t next_surface_id = 1;
     static constexpr uint32_t NO_FOCUS_TARGET = 0;
     std::atomic<uint32_t> pending_focus_target{NO_FOCUS_TARGET};
     std::atomic<bool> cursor_visible{true};
+    std::atomic<CursorPlane> cursor_plane{CursorPlane::composited};
+    /// Pointer position as last published to the viewer; guarded by `cursor_mutex`.
+    mutable std::mutex cursor_mutex;
+    CursorState published_cursor;
     std::atomic<uint32_t> target_fps{60};
+    /// The capture target currently commits for async presentation, as last resolved by
+    /// `process_capture_pacing()`.
+    std::atomic<bool> async_presentation{false};
+    /// Applied to `present_buffers` on the compositor thread at the next capture.
+    std::atomic<uint32_t> present_buffer_count{PresentBufferPool::DEFAULT_BUFFER_COUNT};
     bool cursor_initialized = false;
     std::atomic<bool> pointer_locked{false};
     std::atomic<bool> present_reset_requested{false};
+    std::chrono::steady_clock::time_point start_time;
+    std::promise<bool> xwayland_ready_promise;
+    std::shared_future<bool> xwayland_ready_future = xwayland_ready_promise.get_future().share();
+    /// Set once `xwayland_ready_promise` holds a value; compositor thread or teardown only.
+    bool xwayland_ready_reported = false;
 
     CompositorState();
 
@@ -199,10 +332,15 @@ struct CompositorState {
     [[nodiscard]] auto bind_wayland_socket() -> Result<void>;
     [[nodiscard]] auto setup_xwayland() -> Result<void>;
     [[nodiscard]] auto x11_display_name() const -> std::string;
+    void report_xwayland_ready(bool ready);
     [[nodiscard]] auto start_backend() -> Result<void>;
     [[nodiscard]] auto setup_output() -> Result<void>;
     [[nodiscard]] auto initialize_present_output() -> Result<void>;
-    [[nodiscard]] auto setup_cursor_theme() -> Result<void>;
+    /// Reads the cursor theme from disk; touches no compositor state, so it may run on any thread.
+    [[nodiscard]] static auto load_cursor_theme() -> UniqueXcursorTheme;
+    /// Uploads the default cursor of `theme`, falling back to a built-in one when the theme has
+    /// no usable pointer shape. Fails when `theme` is null.
+    [[nodiscard]] auto setup_cursor_theme(UniqueXcursorTheme theme) -> Result<void>;
     void start_compositor_thread();
     void run_compositor_display_loop();
     void teardown();
@@ -210,9 +348,20 @@ struct CompositorState {
     bool wake_event_loop();
     void request_focus_target(uint32_t surface_id);
     void request_surface_resize(uint32_t surface_id, const SurfaceResizeInfo& resize);
+    void request_capture_surfaces(std::vector<uint32_t> surface_ids);
+    void set_surface_allow_tearing(uint32_t surface_id, bool allow);
+    void request_output_mode(const OutputMode& mode);
     void process_input_events();
     void handle_focus_request();
     void handle_surface_resize_requests();
+    void handle_capture_surfaces_request();
+    void handle_output_mode_request();
+    void report_present_feedback(const util::PresentFeedback& feedback);
+    void handle_present_feedback();
+    void sample_presentation_feedback(wlr_surface* root_surface, uint64_t frame_number);
+    void discard_presentation_feedback();
+    /// Sends the output's preferred scale to a client surface before its first configure.
+    void send_preferred_scale(wlr_surface* surface) const;
     void handle_key_event(const InputEvent& event, uint32_t time);
     void handle_pointer_motion_event(const InputEvent& event, uint32_t time);
     void handle_pointer_button_event(const InputEvent& event, uint32_t time);
@@ -238,6 +387,9 @@ struct CompositorState {
     void handle_xwayland_surface_map_request(XWaylandSurfaceHooks* hooks);
     void handle_xwayland_surface_commit(XWaylandSurfaceHooks* hooks);
     void handle_xwayland_surface_destroy(wlr_xwayland_surface* xsurface);
+    void map_xwayland_popup(XWaylandSurfaceHooks* hooks);
+    void unmap_xwayland_popup(XWaylandSurfaceHooks* hooks);
+    void damage_xwayland_popup(XWaylandSurfaceHooks* hooks);
 
     void handle_new_pointer_constraint(wlr_pointer_constraint_v1* constraint);
     void handle_constraint_set_region(ConstraintHooks* hooks);
@@ -263,11 +415,15 @@ struct CompositorState {
 
     void clear_presented_frame();
     void request_present_reset();
-    void update_presented_frame(wlr_surface* surface);
+    bool update_presented_frame(wlr_surface* surface);
     void refresh_presented_frame();
     void note_active_surface_commit(wlr_surface* surface);
     void schedule_capture_pacing(wlr_surface* surface);
+    void schedule_popup_damage(const wlr_box& damage);
     void process_capture_pacing();
+    void set_lockstep(bool enabled);
+    void set_vrr_range(std::optional<util::RefreshRange> range);
+    void release_lockstep_frame();
     void arm_capture_pacing_timer(std::chrono::steady_clock::time_point deadline);
     void reset_runtime_metrics_for_target(const RuntimeMetricsState::CaptureTarget& capture_target);
     [[nodiscard]] auto get_runtime_metrics_snapshot() const
@@ -275,11 +431,21 @@ struct CompositorState {
     void render_root_surface_tree(wlr_render_pass* pass, wlr_surface* root_surface);
     void render_xwayland_popup_surfaces(wlr_render_pass* pass, const InputTarget& target);
     void render_cursor_overlay(wlr_render_pass* pass) const;
+    /// Renders into `buffer`, which the caller acquired locked. Returns it, or null after
+    /// unlocking it when rendering fails.
+    [[nodiscard]] auto render_target_to_buffer(wlr_buffer* buffer, const InputTarget& target,
+                                               bool include_overlays) -> wlr_buffer*;
     bool render_surface_to_frame(const InputTarget& target);
+    void update_surface_export(wlr_surface* surface);
+    void release_surface_export(wlr_surface* surface);
+    void clear_surface_exports();
 
     void clear_cursor_theme();
     [[nodiscard]] auto get_cursor_frame(uint32_t time_msec) const -> const CursorFrame*;
     void set_cursor_visible(bool visible);
+    void set_cursor_plane(CursorPlane plane);
+    void publish_cursor_state();
+    [[nodiscard]] auto get_cursor_state() const -> CursorState;
 };
 
 } // namespace goggles::compositor
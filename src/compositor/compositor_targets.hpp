@@ -5,8 +5,11 @@
 #include <utility>
 
 extern "C" {
+#include <wlr/util/box.h>
+
 // NOLINTBEGIN(readability-identifier-naming)
 struct wlr_layer_surface_v1_state;
+struct wlr_output;
 struct wlr_surface;
 struct wlr_xdg_surface;
 struct wlr_xwayland_surface;
@@ -18,8 +21,10 @@ namespace goggles::compositor {
 struct CompositorState;
 struct LayerSurfaceHooks;
 struct XdgPopupHooks;
+struct XWaylandSurfaceHooks;
 
 using ::wlr_layer_surface_v1_state;
+using ::wlr_output;
 using ::wlr_surface;
 using ::wlr_xdg_surface;
 using ::wlr_xwayland_surface;
@@ -33,13 +38,34 @@ struct InputTarget {
     double offset_y = 0.0;
 };
 
+/// Logical size of `output` that layer surfaces are laid out in; 0x0 without an output.
+auto get_output_layout_size(wlr_output* output) -> std::pair<int, int>;
 auto compute_layer_position(const wlr_layer_surface_v1_state& state, int out_w, int out_h)
     -> std::pair<int, int>;
 auto get_surface_extent(wlr_surface* surface) -> std::optional<std::pair<uint32_t, uint32_t>>;
+/// Buffer pixels per logical pixel of `surface`: its buffer scale, or what a `wp_viewporter`
+/// destination implies. 1 when unknown.
+auto get_surface_buffer_scale(wlr_surface* surface) -> double;
+/// Frame-pixel box covered by `surface` placed at logical `(x, y)` in a frame drawn at `scale`.
+auto get_scaled_surface_box(wlr_surface* surface, int x, int y, double scale) -> wlr_box;
 auto get_root_xdg_surface(wlr_surface* surface) -> wlr_xdg_surface*;
 auto get_popup_owner_root_surface(const CompositorState& state, const XdgPopupHooks& hooks)
     -> wlr_surface*;
 auto get_xdg_popup_position(const XdgPopupHooks* hooks) -> std::pair<double, double>;
+/// Smallest box covering both; empty boxes are ignored.
+auto union_box(const wlr_box& lhs, const wlr_box& rhs) -> wlr_box;
+/// X11 root-coordinate area an override-redirect popup draws over.
+auto get_xwayland_popup_box(const wlr_xwayland_surface& popup) -> wlr_box;
+/// Frame pixels covering `damage` (X11 root coordinates) of a root placed at `(root_x, root_y)`
+/// and drawn at `scale`: grown outward to whole pixels and clipped to the frame. Nothing when
+/// the damage lies entirely off-frame.
+auto get_damage_frame_box(const wlr_box& damage, int root_x, int root_y, double scale,
+                          int frame_width, int frame_height) -> std::optional<wlr_box>;
+/// Caches the ancestors of the popup's X11 surface, nearest first, in `hooks.popup_parents`.
+void cache_xwayland_popup_parents(XWaylandSurfaceHooks& hooks);
+/// Whether a mapped override-redirect popup draws over `root`; parentless popups draw over any.
+auto xwayland_popup_belongs_to_root(const XWaylandSurfaceHooks& hooks,
+                                    const wlr_xwayland_surface* root) -> bool;
 auto get_root_input_target(CompositorState& state) -> InputTarget;
 auto resolve_input_target(CompositorState& state, const InputTarget& root_target,
                           bool use_pointer_hit_test) -> InputTarget;
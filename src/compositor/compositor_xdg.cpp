@@ -267,6 +267,7 @@ void CompositorState::handle_xdg_surface_commit(XdgToplevelHooks* hooks) {
     }
 
     if (!hooks->sent_configure) {
+        send_preferred_scale(hooks->surface);
         wlr_xdg_surface_schedule_configure(hooks->toplevel->base);
         hooks->sent_configure = true;
     }
@@ -338,6 +339,7 @@ void CompositorState::handle_xdg_surface_destroy(XdgToplevelHooks* hooks) {
         pointer_entered_surface = nullptr;
         cursor_surface = nullptr;
         cursor_initialized = false;
+        publish_cursor_state();
         wlr_seat_keyboard_clear_focus(seat);
         wlr_seat_pointer_clear_focus(seat);
         while (event_queue.try_pop()) {
@@ -347,6 +349,7 @@ void CompositorState::handle_xdg_surface_destroy(XdgToplevelHooks* hooks) {
     if (presented_surface == surface) {
         clear_presented_frame();
     }
+    release_surface_export(surface);
 }
 
 } // namespace goggles::compositor
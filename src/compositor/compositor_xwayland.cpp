@@ -121,6 +121,12 @@ auto CompositorState::setup_xwayland() -> Result<void> {
     {
         ScopedXwaylandStderrSuppression suppress_stderr;
         xwayland = wlr_xwayland_create(display, compositor, false);
+        // The non-lazy start is only queued as an idle source; dispatch it now so the Xwayland
+        // process boots while the backend and outputs are still being set up, instead of
+        // waiting for the compositor thread's first loop iteration.
+        if (xwayland) {
+            wl_event_loop_dispatch_idle(event_loop);
+        }
     }
     if (!xwayland) {
         return make_error<void>(ErrorCode::input_init_failed, "Failed to create XWayland server");
@@ -134,6 +140,14 @@ auto CompositorState::setup_xwayland() -> Result<void> {
     };
     wl_signal_add(&xwayland->events.new_surface, &listeners.new_xwayland_surface);
 
+    wl_list_init(&listeners.xwayland_ready.link);
+    listeners.xwayland_ready.notify = [](wl_listener* listener, void* /*data*/) {
+        auto* list = reinterpret_cast<Listeners*>(reinterpret_cast<char*>(listener) -
+                                                  offsetof(Listeners, xwayland_ready));
+        list->state->report_xwayland_ready(true);
+    };
+    wl_signal_add(&xwayland->events.ready, &listeners.xwayland_ready);
+
     // wlr_xwm translates seat events to X11 KeyPress/MotionNotify
     wlr_xwayland_set_seat(xwayland, seat);
 
@@ -147,6 +161,19 @@ auto CompositorState::x11_display_name() const -> std::string {
     return "";
 }
 
+void CompositorState::report_xwayland_ready(bool ready) {
+    if (xwayland_ready_reported) {
+        return;
+    }
+    xwayland_ready_reported = true;
+    xwayland_ready_promise.set_value(ready);
+    if (ready) {
+        const auto elapsed = std::chrono::steady_clock::now() - start_time;
+        GOGGLES_LOG_INFO("XWayland ready on {} after {:.1f} ms", x11_display_name(),
+                         std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+}
+
 void CompositorState::run_compositor_display_loop() {
     ScopedXwaylandStderrSuppression suppress_stderr;
     wl_display_run(display);
@@ -218,6 +245,7 @@ void CompositorState::handle_new_xwayland_surface(wlr_xwayland_surface* xsurface
     wl_list_init(&hooks_ptr->associate.link);
     wl_list_init(&hooks_ptr->map_request.link);
     wl_list_init(&hooks_ptr->commit.link);
+    wl_list_init(&hooks_ptr->set_parent.link);
     wl_list_init(&hooks_ptr->destroy.link);
 
     hooks_ptr->associate.notify = [](wl_listener* listener, void* /*data*/) {
@@ -242,8 +270,7 @@ void CompositorState::handle_new_xwayland_surface(wlr_xwayland_surface* xsurface
         auto* h = reinterpret_cast<XWaylandSurfaceHooks*>(
             reinterpret_cast<char*>(listener) - offsetof(XWaylandSurfaceHooks, dissociate));
         if (h->override_redirect && h->mapped) {
-            h->mapped = false;
-            h->state->request_present_reset();
+            h->state->unmap_xwayland_popup(h);
         }
         // Stale commit events after dissociation would dereference the now-invalid wlr_surface.
         if (h->commit.link.next != nullptr && h->commit.link.next != &h->commit.link) {
@@ -260,12 +287,27 @@ void CompositorState::handle_new_xwayland_surface(wlr_xwayland_surface* xsurface
     };
     wl_signal_add(&xsurface->events.map_request, &hooks_ptr->map_request);
 
+    hooks_ptr->set_parent.notify = [](wl_listener* listener, void* /*data*/) {
+        auto* h = reinterpret_cast<XWaylandSurfaceHooks*>(
+            reinterpret_cast<char*>(listener) - offsetof(XWaylandSurfaceHooks, set_parent));
+        if (!h->override_redirect) {
+            return;
+        }
+        cache_xwayland_popup_parents(*h);
+        if (h->mapped) {
+            // The popup may have moved to another root; recapture right away.
+            h->state->request_present_reset();
+        }
+    };
+    wl_signal_add(&xsurface->events.set_parent, &hooks_ptr->set_parent);
+
     hooks_ptr->destroy.notify = [](wl_listener* listener, void* /*data*/) {
         auto* h = reinterpret_cast<XWaylandSurfaceHooks*>(reinterpret_cast<char*>(listener) -
                                                           offsetof(XWaylandSurfaceHooks, destroy));
         wl_list_remove(&h->associate.link);
         wl_list_remove(&h->dissociate.link);
         wl_list_remove(&h->map_request.link);
+        wl_list_remove(&h->set_parent.link);
         if (h->commit.link.next != nullptr && h->commit.link.next != &h->commit.link) {
             wl_list_remove(&h->commit.link);
         }
@@ -306,8 +348,7 @@ void CompositorState::handle_xwayland_surface_associate(wlr_xwayland_surface* xs
         if (hooks->override_redirect) {
             // Override-redirect windows bypass the WM: events.map_request never fires
             // for them (X11 sends MapNotify, not MapRequest). Treat association as mapped.
-            hooks->mapped = true;
-            request_present_reset();
+            map_xwayland_popup(hooks);
         } else if (hooks->map_requested) {
             hooks->mapped = true;
             focus_xwayland_surface(xsurface);
@@ -331,12 +372,11 @@ void CompositorState::handle_xwayland_surface_map_request(XWaylandSurfaceHooks*
         return;
     }
 
-    hooks->mapped = true;
-
     if (!hooks->override_redirect) {
+        hooks->mapped = true;
         focus_xwayland_surface(xsurface);
-    } else {
-        request_present_reset();
+    } else if (!hooks->mapped) {
+        map_xwayland_popup(hooks);
     }
 }
 
@@ -353,10 +393,11 @@ void CompositorState::handle_xwayland_surface_commit(XWaylandSurfaceHooks* hooks
     // Without this, X11 clients block on vkQueuePresentKHR
     if (hooks->mapped) {
         if (hooks->override_redirect) {
+            // Popups are never throttled; only the capture of their damage is paced.
             timespec now{};
             clock_gettime(CLOCK_MONOTONIC, &now);
             wlr_surface_send_frame_done(hooks->xsurface->surface, &now);
-            request_present_reset();
+            damage_xwayland_popup(hooks);
         } else {
             schedule_capture_pacing(hooks->xsurface->surface);
         }
@@ -367,6 +408,35 @@ void CompositorState::handle_xwayland_surface_commit(XWaylandSurfaceHooks* hooks
     }
 }
 
+void CompositorState::map_xwayland_popup(XWaylandSurfaceHooks* hooks) {
+    hooks->mapped = true;
+    cache_xwayland_popup_parents(*hooks);
+    if (std::ranges::find(xwayland_popups, hooks) == xwayland_popups.end()) {
+        xwayland_popups.push_back(hooks);
+    }
+    damage_xwayland_popup(hooks);
+}
+
+void CompositorState::unmap_xwayland_popup(XWaylandSurfaceHooks* hooks) {
+    hooks->mapped = false;
+    std::erase(xwayland_popups, hooks);
+    const auto target = get_input_target(*this);
+    if (target.root_xsurface && xwayland_popup_belongs_to_root(*hooks, target.root_xsurface)) {
+        schedule_popup_damage(hooks->popup_box);
+    }
+    hooks->popup_box = {};
+}
+
+void CompositorState::damage_xwayland_popup(XWaylandSurfaceHooks* hooks) {
+    const auto target = get_input_target(*this);
+    if (!hooks->xsurface || !hooks->xsurface->surface || !target.root_xsurface ||
+        !xwayland_popup_belongs_to_root(*hooks, target.root_xsurface)) {
+        return;
+    }
+    // Both where the popup was last drawn and where it is now, so moves leave no trail.
+    schedule_popup_damage(union_box(hooks->popup_box, get_xwayland_popup_box(*hooks->xsurface)));
+}
+
 void CompositorState::handle_xwayland_surface_destroy(wlr_xwayland_surface* xsurface) {
     auto* surface = xsurface ? xsurface->surface : nullptr;
 
@@ -375,6 +445,13 @@ void CompositorState::handle_xwayland_surface_destroy(wlr_xwayland_surface* xsur
                           static_cast<uint32_t>(xsurface->window_id), static_cast<void*>(xsurface));
     }
 
+    auto popup_it = std::ranges::find_if(
+        xwayland_popups, [xsurface](const auto* hooks) { return hooks->xsurface == xsurface; });
+    if (popup_it != xwayland_popups.end()) {
+        // Repair the area while the hooks are still alive; the popup is no longer drawn.
+        unmap_xwayland_popup(*popup_it);
+    }
+
     bool clear_focus = false;
     {
         std::scoped_lock lock(hooks_mutex);
@@ -402,10 +479,7 @@ void CompositorState::handle_xwayland_surface_destroy(wlr_xwayland_surface* xsur
     if (presented_surface == surface) {
         clear_presented_frame();
     }
-
-    if (xsurface && xsurface->override_redirect) {
-        request_present_reset();
-    }
+    release_surface_export(surface);
 
     if (!clear_focus) {
         return;
@@ -417,6 +491,7 @@ void CompositorState::handle_xwayland_surface_destroy(wlr_xwayland_surface* xsur
     pointer_entered_surface = nullptr;
     cursor_surface = nullptr;
     cursor_initialized = false;
+    publish_cursor_state();
     wlr_seat_keyboard_clear_focus(seat);
     wlr_seat_pointer_clear_focus(seat);
     while (event_queue.try_pop()) {
@@ -2,6 +2,7 @@
 
 #include <format>
 #include <util/logging.hpp>
+#include <util/metrics.hpp>
 
 namespace goggles::render::backend_internal {
 
@@ -256,6 +257,7 @@ auto ExternalFrameImporter::import_external_image(VulkanContext& context,
 
     GOGGLES_LOG_TRACE("DMA-BUF imported: {}x{}, format={}, modifier=0x{:x}", image.width,
                       image.height, vk::to_string(vk_format), image.modifier);
+    util::Metrics::increment(util::MetricCounter::frames_imported);
     return current_source();
 }
 
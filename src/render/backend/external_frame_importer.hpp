@@ -12,7 +12,9 @@ namespace goggles::render::backend_internal {
 /// @brief Backend-owned DMA-BUF import state and temporary explicit-sync waits.
 struct ExternalFrameImporter {
     static constexpr uint32_t MAX_FRAME_SLOTS = 2;
-    static constexpr vk::PipelineStageFlags WAIT_STAGE = vk::PipelineStageFlagBits::eFragmentShader;
+    /// First reads of an imported frame: frame interpolation (compute) or the filter chain.
+    static constexpr vk::PipelineStageFlags WAIT_STAGE =
+        vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eFragmentShader;
 
     struct ImportedImage {
         vk::Image image;
@@ -1,17 +1,22 @@
 #include "filter_chain_controller.hpp"
 
 #include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
 #include <format>
+#include <fstream>
 #include <goggles/profiling.hpp>
 #include <limits>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <util/job_system.hpp>
 #include <util/logging.hpp>
+#include <util/metrics.hpp>
 #include <vector>
 
 namespace goggles::render::backend_internal {
@@ -36,6 +41,93 @@ auto to_utf8_bytes(const std::filesystem::path& path) -> std::string {
     return {reinterpret_cast<const char*>(utf8.c_str()), utf8.size()};
 }
 
+// ---------------------------------------------------------------------------
+// Preset frame-dependence scan
+// ---------------------------------------------------------------------------
+
+// Lowercased semantics and preset keys whose value changes between frames of an unchanged
+// source: frame counters and timing, source history and pass feedback.
+constexpr std::array<std::string_view, 5> FRAME_DEPENDENT_TOKENS = {
+    "framecount", "frametimedelta", "subframe", "originalhistory", "feedback"};
+constexpr int MAX_PRESET_SCAN_DEPTH = 16;
+
+auto trim(std::string_view text) -> std::string_view {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+/// File named by a preset `shaderN = path` or a `#reference`/`#include "path"` line.
+auto referenced_path(std::string_view line) -> std::optional<std::string_view> {
+    line = trim(line);
+    std::string_view value;
+    if (line.starts_with("#reference") || line.starts_with("#include")) {
+        const auto directive_end = line.find_first_of(" \t\"");
+        if (directive_end == std::string_view::npos) {
+            return std::nullopt;
+        }
+        value = trim(line.substr(directive_end));
+    } else if (line.starts_with("shader")) {
+        const auto equals = line.find('=');
+        const auto index = trim(line.substr(6, equals == std::string_view::npos ? 0 : equals - 6));
+        if (index.empty() ||
+            !std::ranges::all_of(index, [](char c) { return c >= '0' && c <= '9'; })) {
+            return std::nullopt;
+        }
+        value = trim(line.substr(equals + 1));
+    } else {
+        return std::nullopt;
+    }
+
+    if (value.starts_with('"')) {
+        const auto close = value.find('"', 1);
+        value = close == std::string_view::npos ? std::string_view{} : value.substr(1, close - 1);
+    } else {
+        value = value.substr(0, value.find_first_of(" \t#"));
+    }
+    return value.empty() ? std::nullopt : std::optional(value);
+}
+
+auto scan_frame_dependence(const std::filesystem::path& path, int depth,
+                           std::vector<std::filesystem::path>& visited) -> bool {
+    if (depth > MAX_PRESET_SCAN_DEPTH) {
+        return true;
+    }
+    std::error_code ec;
+    auto canonical = std::filesystem::weakly_canonical(path, ec);
+    if (ec) {
+        return true;
+    }
+    if (std::ranges::find(visited, canonical) != visited.end()) {
+        return false;
+    }
+    visited.push_back(canonical);
+
+    std::ifstream file(canonical);
+    if (!file.is_open()) {
+        return true;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string lowered = line;
+        std::ranges::transform(lowered, lowered.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (std::ranges::any_of(FRAME_DEPENDENT_TOKENS, [&lowered](std::string_view token) {
+                return lowered.find(token) != std::string::npos;
+            })) {
+            return true;
+        }
+        if (auto reference = referenced_path(line);
+            reference && scan_frame_dependence(canonical.parent_path() / *reference, depth + 1,
+                                               visited)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // ---------------------------------------------------------------------------
 // Stage / control translation helpers
 // ---------------------------------------------------------------------------
@@ -166,28 +258,53 @@ auto snapshot_slot_controls(const FilterChainController::FilterChainSlot& slot)
     return controls;
 }
 
-auto resolve_slot_control_index(const FilterChainController::FilterChainSlot& slot,
-                                goggles::fc::FilterControlId control_id) -> Result<uint32_t> {
-    if (!slot.chain) {
-        return make_error<uint32_t>(ErrorCode::vulkan_init_failed, "Chain not initialized");
-    }
-
+auto index_slot_controls(FilterChainController::FilterChainSlot& slot) -> Result<void> {
+    slot.control_indices.clear();
     auto count_result = slot.chain.get_control_count();
     if (!count_result) {
         return nonstd::make_unexpected(count_result.error());
     }
 
+    slot.control_indices.reserve(count_result.value());
     for (uint32_t i = 0; i < count_result.value(); ++i) {
         auto info_result = slot.chain.get_control_info(i);
         if (!info_result) {
+            slot.control_indices.clear();
             return nonstd::make_unexpected(info_result.error());
         }
-        if (make_control_id_from_info(*info_result) == control_id) {
-            return i;
-        }
+        slot.control_indices.try_emplace(make_control_id_from_info(*info_result), i);
+    }
+    return {};
+}
+
+auto resolve_slot_control_index(FilterChainController::FilterChainSlot& slot,
+                                goggles::fc::FilterControlId control_id) -> Result<uint32_t> {
+    if (!slot.chain) {
+        return make_error<uint32_t>(ErrorCode::vulkan_init_failed, "Chain not initialized");
+    }
+    if (slot.control_indices.empty()) {
+        GOGGLES_TRY(index_slot_controls(slot));
     }
 
-    return make_error<uint32_t>(ErrorCode::invalid_data, "Control id not found on active chain");
+    const auto it = slot.control_indices.find(control_id);
+    if (it == slot.control_indices.end()) {
+        return make_error<uint32_t>(ErrorCode::invalid_data,
+                                    "Control id not found on active chain");
+    }
+    return it->second;
+}
+
+/// Sets one control and returns the value the chain stored (it may clamp).
+auto set_slot_control_value(FilterChainController::FilterChainSlot& slot,
+                            goggles::fc::FilterControlId control_id, float value)
+    -> Result<float> {
+    const auto index = GOGGLES_TRY(resolve_slot_control_index(slot, control_id));
+    GOGGLES_TRY(slot.chain.set_control_value_f32(index, value));
+    auto info_result = slot.chain.get_control_info(index);
+    if (!info_result) {
+        return nonstd::make_unexpected(info_result.error());
+    }
+    return info_result->current_value;
 }
 
 auto apply_slot_controls(FilterChainController::FilterChainSlot& slot,
@@ -227,13 +344,16 @@ auto rebuild_slot_chain(FilterChainController::FilterChainSlot& slot, bool prese
         return nonstd::make_unexpected(chain_result.error());
     }
 
+    util::Metrics::increment(util::MetricCounter::filter_chain_rebuilds);
     auto new_chain = std::move(chain_result.value());
     auto old_chain = std::move(slot.chain);
     slot.chain = std::move(new_chain);
+    slot.control_indices.clear();
 
     auto apply_result = apply_slot_controls(slot, *controls_result);
     if (!apply_result) {
         slot.chain = std::move(old_chain);
+        slot.control_indices.clear();
         return nonstd::make_unexpected(apply_result.error());
     }
 
@@ -333,6 +453,7 @@ auto load_passthrough_into_slot(FilterChainController::FilterChainSlot& slot,
 }
 
 void shutdown_slot(FilterChainController::FilterChainSlot& slot) {
+    slot.control_indices.clear();
     slot.chain = {};
     slot.program = {};
     slot.device = {};
@@ -370,7 +491,7 @@ auto record_slot(FilterChainController::FilterChainSlot& slot,
 // ---------------------------------------------------------------------------
 
 auto snapshot_adapter_controls(const FilterChainController::FilterChainSlot& slot)
-    -> std::vector<FilterChainController::ControlOverride> {
+    -> FilterChainController::ControlValueMap {
     if (!slot.chain) {
         return {};
     }
@@ -381,7 +502,7 @@ auto snapshot_adapter_controls(const FilterChainController::FilterChainSlot& slo
         return {};
     }
 
-    std::vector<FilterChainController::ControlOverride> controls;
+    FilterChainController::ControlValueMap controls;
     const uint32_t count = count_result.value();
     controls.reserve(count);
     for (uint32_t i = 0; i < count; ++i) {
@@ -390,55 +511,32 @@ auto snapshot_adapter_controls(const FilterChainController::FilterChainSlot& slo
             continue;
         }
         const auto descriptor = to_filter_descriptor(*info_result);
-        controls.push_back(FilterChainController::ControlOverride{
-            .control_id = descriptor.control_id,
-            .value = descriptor.current_value,
-        });
+        controls.insert_or_assign(descriptor.control_id, descriptor.current_value);
     }
     return controls;
 }
 
-auto snapshot_adapter_control_ids(const FilterChainController::FilterChainSlot& slot)
-    -> std::vector<goggles::fc::FilterControlId> {
-    if (!slot.chain) {
-        return {};
-    }
-
-    auto count_result = slot.chain.get_control_count();
-    if (!count_result) {
-        GOGGLES_LOG_WARN("Failed to snapshot filter control ids: {}", count_result.error().message);
+auto apply_adapter_controls(FilterChainController::FilterChainSlot& slot,
+                            const FilterChainController::ControlValueMap& controls,
+                            const char* failure_prefix) -> Result<void> {
+    if (!slot.chain || controls.empty()) {
         return {};
     }
-
-    std::vector<goggles::fc::FilterControlId> control_ids;
-    const uint32_t count = count_result.value();
-    control_ids.reserve(count);
-    for (uint32_t i = 0; i < count; ++i) {
-        auto info_result = slot.chain.get_control_info(i);
-        if (!info_result) {
-            continue;
+    if (slot.control_indices.empty()) {
+        auto index_result = index_slot_controls(slot);
+        if (!index_result) {
+            GOGGLES_LOG_WARN("{}: {}", failure_prefix, index_result.error().message);
+            return {};
         }
-        control_ids.push_back(to_filter_descriptor(*info_result).control_id);
     }
-    return control_ids;
-}
-
-auto apply_adapter_controls(FilterChainController::FilterChainSlot& slot,
-                            const std::vector<FilterChainController::ControlOverride>& controls,
-                            const char* failure_prefix) -> Result<void> {
-    const auto active_control_ids = snapshot_adapter_control_ids(slot);
-    for (const auto& control : controls) {
-        if (std::find(active_control_ids.begin(), active_control_ids.end(), control.control_id) ==
-            active_control_ids.end()) {
-            continue;
-        }
 
-        auto index_result = resolve_slot_control_index(slot, control.control_id);
-        if (!index_result) {
-            GOGGLES_LOG_WARN("{}: {}", failure_prefix, index_result.error().message);
+    // Overrides for controls this chain does not expose (e.g. after a preset switch) are skipped.
+    for (const auto& [control_id, value] : controls) {
+        const auto it = slot.control_indices.find(control_id);
+        if (it == slot.control_indices.end()) {
             continue;
         }
-        auto result = slot.chain.set_control_value_f32(*index_result, control.value);
+        auto result = slot.chain.set_control_value_f32(it->second, value);
         if (!result) {
             GOGGLES_LOG_WARN("{}: {}", failure_prefix, result.error().message);
         }
@@ -578,6 +676,7 @@ auto FilterChainController::recreate_filter_chain(const VulkanDeviceInfo& device
                                    ? snapshot_adapter_controls(active_slot)
                                    : authoritative_control_overrides;
 
+    companion_chains.clear();
     shutdown_slot(active_slot);
 
     auto slot_result = create_and_load_slot(device_info, chain_config, preset_path);
@@ -593,7 +692,9 @@ auto FilterChainController::recreate_filter_chain(const VulkanDeviceInfo& device
         return nonstd::make_unexpected(controls_result.error());
     }
 
+    // Same preset as before, so `frame_dependent` still holds.
     authoritative_control_overrides = snapshot_adapter_controls(active_slot);
+    ++output_revision;
 
     return {};
 }
@@ -601,6 +702,9 @@ auto FilterChainController::recreate_filter_chain(const VulkanDeviceInfo& device
 auto FilterChainController::retarget_filter_chain(const OutputTarget& output_target)
     -> Result<void> {
     authoritative_output_target = output_target;
+    ++output_revision;
+    // Companions are rebuilt for the new format on their next record.
+    companion_chains.clear();
 
     if (!active_slot.chain) {
         return {};
@@ -641,6 +745,7 @@ void FilterChainController::shutdown(const std::function<void()>& wait_for_gpu_i
 
     wait_for_gpu_idle();
 
+    companion_chains.clear();
     shutdown_slot(active_slot);
     shutdown_slot(pending_slot);
     shutdown_retired_adapter_tracker(retired_adapters);
@@ -663,6 +768,7 @@ void FilterChainController::load_shader_preset(const std::filesystem::path& new_
     if (wait_for_safe_rebuild) {
         wait_for_safe_rebuild();
     }
+    companion_chains.clear();
 
     // For sync preset loads on the active slot, we keep using the
     // current slot's device and rebuild just the program/chain.
@@ -702,6 +808,8 @@ void FilterChainController::load_shader_preset(const std::filesystem::path& new_
     }
 
     authoritative_control_overrides = snapshot_adapter_controls(active_slot);
+    frame_dependent = !load_result || preset_is_frame_dependent(new_preset_path);
+    ++output_revision;
 }
 
 auto FilterChainController::reload_shader_preset(std::filesystem::path new_preset_path,
@@ -755,6 +863,7 @@ auto FilterChainController::reload_shader_preset(std::filesystem::path new_prese
             }
 
             pending_slot = std::move(new_adapter);
+            pending_frame_dependent = preset_is_frame_dependent(requested_preset_path);
             pending_chain_ready.store(true, std::memory_order_release);
 
             GOGGLES_LOG_INFO("Shader preset compiled: {}", requested_preset_path.empty()
@@ -825,6 +934,11 @@ void FilterChainController::check_pending_chain_swap(const std::function<void()>
         }
     }
 
+    // Companion chains are not retired with their program; drain the frames that use them.
+    if (!companion_chains.empty()) {
+        wait_all_frames();
+        companion_chains.clear();
+    }
     retire_adapter_with_bounded_fallback(retired_adapters, std::move(active_slot), frame_count,
                                          wait_all_frames);
 
@@ -848,6 +962,8 @@ void FilterChainController::check_pending_chain_swap(const std::function<void()>
 
     authoritative_control_overrides = snapshot_adapter_controls(active_slot);
     preset_path = pending_preset_path;
+    frame_dependent = pending_frame_dependent;
+    ++output_revision;
     pending_chain_ready.store(false, std::memory_order_release);
     chain_swapped.store(true, std::memory_order_release);
 
@@ -869,6 +985,7 @@ void FilterChainController::set_stage_policy(
 
     prechain_policy_enabled = prechain_enabled;
     effect_stage_policy_enabled = effect_stage_enabled;
+    ++output_revision;
 
     if (!active_slot.chain) {
         return;
@@ -893,6 +1010,7 @@ void FilterChainController::set_prechain_resolution(
     }
 
     source_resolution = resolution;
+    ++output_revision;
     if (active_slot.chain) {
         active_slot.prechain_width = resolution.width;
         active_slot.prechain_height = resolution.height;
@@ -903,9 +1021,21 @@ void FilterChainController::set_prechain_resolution(
             GOGGLES_LOG_WARN("Failed to set prechain resolution: {}", result.error().message);
         }
     }
+    for (auto& [surface_id, companion] : companion_chains) {
+        companion.slot.prechain_width = resolution.width;
+        companion.slot.prechain_height = resolution.height;
+        goggles_fc_extent_2d_t fc_resolution{.width = resolution.width,
+                                             .height = resolution.height};
+        auto result = companion.slot.chain.set_prechain_resolution(&fc_resolution);
+        if (!result) {
+            GOGGLES_LOG_WARN("Failed to set prechain resolution for surface {}: {}", surface_id,
+                             result.error().message);
+        }
+    }
 }
 
 auto FilterChainController::handle_resize(vk::Extent2D target_extent) -> Result<void> {
+    ++output_revision;
     if (!active_slot.chain) {
         return {};
     }
@@ -922,6 +1052,71 @@ auto FilterChainController::record(const RecordParams& record_params) -> Result<
     return record_slot(active_slot, record_params);
 }
 
+auto FilterChainController::record_companion(uint32_t surface_id, bool prechain_enabled,
+                                             bool effect_stage_enabled,
+                                             const RecordParams& record_params) -> Result<void> {
+    if (!active_slot.chain || !active_slot.program) {
+        return make_error<void>(ErrorCode::vulkan_init_failed, "Filter chain not initialized");
+    }
+
+    const auto stage_mask = stage_mask_from_policy(prechain_enabled, effect_stage_enabled);
+    auto [it, inserted] = companion_chains.try_emplace(surface_id);
+    auto& companion = it->second;
+    auto& slot = companion.slot;
+    if (inserted) {
+        slot.target_format = active_slot.target_format;
+        slot.frames_in_flight = active_slot.frames_in_flight;
+        slot.stage_mask = stage_mask;
+        slot.prechain_width = active_slot.prechain_width;
+        slot.prechain_height = active_slot.prechain_height;
+        auto chain_info = make_chain_create_info(slot);
+        auto chain_result = goggles::filter_chain::Chain::create(active_slot.device,
+                                                                 active_slot.program, &chain_info);
+        if (!chain_result) {
+            companion_chains.erase(it);
+            return nonstd::make_unexpected(chain_result.error());
+        }
+        slot.chain = std::move(chain_result.value());
+        util::Metrics::increment(util::MetricCounter::filter_chain_rebuilds);
+        GOGGLES_LOG_DEBUG("Created companion filter chain for surface {}", surface_id);
+    }
+
+    const vk::Extent2D target_extent{record_params.target_width, record_params.target_height};
+    if (companion.target_extent != target_extent) {
+        goggles_fc_extent_2d_t extent{.width = target_extent.width,
+                                      .height = target_extent.height};
+        GOGGLES_TRY(slot.chain.resize(&extent));
+        companion.target_extent = target_extent;
+    }
+    if (slot.stage_mask != stage_mask) {
+        GOGGLES_TRY(slot.chain.set_stage_mask(stage_mask));
+        slot.stage_mask = stage_mask;
+    }
+    if (companion.control_revision != control_revision) {
+        GOGGLES_TRY(apply_adapter_controls(slot, authoritative_control_overrides,
+                                           "Failed to sync companion filter control"));
+        companion.control_revision = control_revision;
+    }
+
+    return record_slot(slot, record_params);
+}
+
+void FilterChainController::retain_companions(std::span<const uint32_t> surface_ids,
+                                              const std::function<void()>& wait_for_gpu_idle) {
+    bool waited = false;
+    for (auto it = companion_chains.begin(); it != companion_chains.end();) {
+        if (std::find(surface_ids.begin(), surface_ids.end(), it->first) != surface_ids.end()) {
+            ++it;
+            continue;
+        }
+        if (!waited && wait_for_gpu_idle) {
+            wait_for_gpu_idle();
+            waited = true;
+        }
+        it = companion_chains.erase(it);
+    }
+}
+
 auto FilterChainController::current_prechain_resolution() const -> vk::Extent2D {
     return vk::Extent2D{active_slot.prechain_width, active_slot.prechain_height};
 }
@@ -992,17 +1187,14 @@ auto FilterChainController::set_filter_control_value(goggles::fc::FilterControlI
         return false;
     }
 
-    auto index_result = resolve_slot_control_index(active_slot, control_id);
-    if (!index_result) {
-        GOGGLES_LOG_WARN("Failed to set filter control value: {}", index_result.error().message);
-        return false;
-    }
-    auto result = active_slot.chain.set_control_value_f32(*index_result, value);
+    auto result = set_slot_control_value(active_slot, control_id, value);
     if (!result) {
         GOGGLES_LOG_WARN("Failed to set filter control value: {}", result.error().message);
         return false;
     }
-    authoritative_control_overrides = snapshot_adapter_controls(active_slot);
+    pending_control_updates.erase(control_id);
+    authoritative_control_overrides.insert_or_assign(control_id, *result);
+    ++control_revision;
     return true;
 }
 
@@ -1012,27 +1204,25 @@ auto FilterChainController::reset_filter_control_value(goggles::fc::FilterContro
         return false;
     }
 
-    const auto controls = list_filter_controls();
-    const auto it =
-        std::find_if(controls.begin(), controls.end(), [control_id](const auto& control) {
-            return control.control_id == control_id;
-        });
-    if (it == controls.end()) {
+    auto index_result = resolve_slot_control_index(active_slot, control_id);
+    if (!index_result) {
         GOGGLES_LOG_WARN("Failed to reset filter control value: control {} not found", control_id);
         return false;
     }
-
-    auto index_result = resolve_slot_control_index(active_slot, control_id);
-    if (!index_result) {
-        GOGGLES_LOG_WARN("Failed to reset filter control value: {}", index_result.error().message);
+    auto info_result = active_slot.chain.get_control_info(*index_result);
+    if (!info_result) {
+        GOGGLES_LOG_WARN("Failed to reset filter control value: {}", info_result.error().message);
         return false;
     }
-    auto result = active_slot.chain.set_control_value_f32(*index_result, it->default_value);
+
+    auto result = set_slot_control_value(active_slot, control_id, info_result->default_value);
     if (!result) {
         GOGGLES_LOG_WARN("Failed to reset filter control value: {}", result.error().message);
         return false;
     }
-    authoritative_control_overrides = snapshot_adapter_controls(active_slot);
+    pending_control_updates.erase(control_id);
+    authoritative_control_overrides.insert_or_assign(control_id, *result);
+    ++control_revision;
     return true;
 }
 
@@ -1060,7 +1250,48 @@ void FilterChainController::reset_filter_controls() {
         }
     }
 
+    pending_control_updates.clear();
     authoritative_control_overrides = snapshot_adapter_controls(active_slot);
+    ++control_revision;
+}
+
+void FilterChainController::queue_filter_control_value(goggles::fc::FilterControlId control_id,
+                                                       float value) {
+    pending_control_updates.insert_or_assign(control_id, value);
+}
+
+auto FilterChainController::flush_filter_control_updates() -> size_t {
+    if (pending_control_updates.empty()) {
+        return 0;
+    }
+    GOGGLES_PROFILE_FUNCTION();
+
+    size_t applied = 0;
+    if (active_slot.chain) {
+        for (const auto& [control_id, value] : pending_control_updates) {
+            auto result = set_slot_control_value(active_slot, control_id, value);
+            if (!result) {
+                GOGGLES_LOG_WARN("Failed to apply queued filter control {}: {}", control_id,
+                                 result.error().message);
+                continue;
+            }
+            authoritative_control_overrides.insert_or_assign(control_id, *result);
+            ++applied;
+        }
+    }
+    pending_control_updates.clear();
+    if (applied > 0) {
+        ++control_revision;
+    }
+    return applied;
+}
+
+auto preset_is_frame_dependent(const std::filesystem::path& preset_path) -> bool {
+    if (preset_path.empty()) {
+        return false;
+    }
+    std::vector<std::filesystem::path> visited;
+    return scan_frame_dependence(preset_path, 0, visited);
 }
 
 } // namespace goggles::render::backend_internal
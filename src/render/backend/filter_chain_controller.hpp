@@ -2,12 +2,15 @@
 
 #include <array>
 #include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <future>
 #include <goggles/filter_chain.h>
 #include <goggles/filter_chain.hpp>
 #include <goggles/filter_chain/filter_controls.hpp>
+#include <span>
+#include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan.hpp>
@@ -15,10 +18,8 @@
 namespace goggles::render::backend_internal {
 
 struct FilterChainController {
-    struct ControlOverride {
-        goggles::fc::FilterControlId control_id = 0;
-        float value = 0.0F;
-    };
+    /// Control values keyed by id; used for authoritative overrides and per-frame batches.
+    using ControlValueMap = std::unordered_map<goggles::fc::FilterControlId, float>;
 
     struct VulkanDeviceInfo {
         VkPhysicalDevice physical_device = VK_NULL_HANDLE;
@@ -79,6 +80,14 @@ struct FilterChainController {
         const std::function<void()>& wait_for_safe_rebuild = std::function<void()>{});
     [[nodiscard]] auto handle_resize(vk::Extent2D target_extent) -> Result<void>;
     [[nodiscard]] auto record(const RecordParams& record_params) -> Result<void>;
+    /// Records through the companion chain of `surface_id`, created on the active program on
+    /// first use. Resizes to the record target and follows the active chain's control values.
+    [[nodiscard]] auto record_companion(uint32_t surface_id, bool prechain_enabled,
+                                        bool effect_stage_enabled,
+                                        const RecordParams& record_params) -> Result<void>;
+    /// Drops companion chains whose surface is not listed, waiting for the GPU first if any go.
+    void retain_companions(std::span<const uint32_t> surface_ids,
+                           const std::function<void()>& wait_for_gpu_idle);
 
     [[nodiscard]] auto current_prechain_resolution() const -> vk::Extent2D;
     [[nodiscard]] auto current_preset_path() const -> const std::filesystem::path& {
@@ -102,6 +111,13 @@ struct FilterChainController {
     [[nodiscard]] auto reset_filter_control_value(goggles::fc::FilterControlId control_id) -> bool;
     void reset_filter_controls();
 
+    /// Queues a control change for the next `flush_filter_control_updates()`. Repeated changes
+    /// to one control within a frame collapse to the last value.
+    void queue_filter_control_value(goggles::fc::FilterControlId control_id, float value);
+    /// Applies queued control changes to the active chain. Call once per frame before `record()`.
+    /// @return Number of controls updated.
+    auto flush_filter_control_updates() -> size_t;
+
     struct FilterChainSlot {
         goggles::filter_chain::Instance instance;
         goggles::filter_chain::Device device;
@@ -113,6 +129,17 @@ struct FilterChainController {
         uint32_t stage_mask = GOGGLES_FC_STAGE_MASK_ALL;
         uint32_t prechain_width = 0;
         uint32_t prechain_height = 0;
+        // Control id -> chain control index; rebuilt lazily after the chain is replaced.
+        std::unordered_map<goggles::fc::FilterControlId, uint32_t> control_indices;
+    };
+
+    /// Extra chain on the active program for one more captured surface. Each surface needs its
+    /// own chain because history and feedback images are per chain, not per program.
+    struct CompanionChain {
+        /// Only `chain` and its create parameters are set; device and program are borrowed.
+        FilterChainSlot slot;
+        vk::Extent2D target_extent;
+        uint64_t control_revision = UINT64_MAX;
     };
 
     struct RetiredAdapter {
@@ -132,16 +159,33 @@ struct FilterChainController {
     FilterChainSlot pending_slot;
     std::filesystem::path preset_path;
     std::filesystem::path pending_preset_path;
+    /// `preset_is_frame_dependent(pending_preset_path)`, scanned by the async load job so the
+    /// swap does no file I/O; published with `pending_chain_ready`.
+    bool pending_frame_dependent = true;
     vk::Extent2D source_resolution;
     std::atomic<bool> pending_chain_ready{false};
     std::atomic<bool> chain_swapped{false};
     std::future<Result<void>> pending_load_future;
     RetiredAdapterTracker retired_adapters;
-    std::vector<ControlOverride> authoritative_control_overrides;
+    ControlValueMap authoritative_control_overrides;
+    ControlValueMap pending_control_updates;
     uint64_t frame_count = 0;
     bool prechain_policy_enabled = true;
     bool effect_stage_policy_enabled = true;
     OutputTarget authoritative_output_target;
+    std::unordered_map<uint32_t, CompanionChain> companion_chains;
+    /// Bumped whenever `authoritative_control_overrides` changes so companions resync lazily.
+    uint64_t control_revision = 0;
+    /// Bumped whenever the active chain may render the same source differently: chain swaps and
+    /// rebuilds, stage policy, prechain resolution and output target changes.
+    uint64_t output_revision = 0;
+    /// Whether the active preset may change its output between frames of an unchanged source.
+    bool frame_dependent = true;
 };
 
+/// Whether `preset_path` may render an unchanged source differently from frame to frame, i.e.
+/// any pass reads FrameCount, frame timing, history or feedback. Scans the preset, its
+/// `#reference`s and its shaders with their `#include`s; unreadable files count as dependent.
+[[nodiscard]] auto preset_is_frame_dependent(const std::filesystem::path& preset_path) -> bool;
+
 } // namespace goggles::render::backend_internal
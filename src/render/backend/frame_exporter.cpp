@@ -0,0 +1,528 @@
+#include "frame_exporter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <goggles/profiling.hpp>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <util/drm_fourcc.hpp>
+#include <util/logging.hpp>
+
+namespace goggles::render::backend_internal {
+
+namespace {
+
+constexpr uint32_t BYTES_PER_PIXEL = 4;
+
+auto monotonic_now_ns() -> uint64_t {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+auto supports_dmabuf_export(vk::PhysicalDevice physical_device, vk::Format format) -> bool {
+    vk::PhysicalDeviceExternalImageFormatInfo external_info{};
+    external_info.handleType = vk::ExternalMemoryHandleTypeFlagBits::eDmaBufEXT;
+
+    vk::PhysicalDeviceImageFormatInfo2 format_info{};
+    format_info.pNext = &external_info;
+    format_info.format = format;
+    format_info.type = vk::ImageType::e2D;
+    format_info.tiling = vk::ImageTiling::eLinear;
+    format_info.usage = vk::ImageUsageFlagBits::eTransferDst;
+
+    vk::ExternalImageFormatProperties external_props{};
+    vk::ImageFormatProperties2 format_props{};
+    format_props.pNext = &external_props;
+    if (physical_device.getImageFormatProperties2(&format_info, &format_props) !=
+        vk::Result::eSuccess) {
+        return false;
+    }
+    if (!(external_props.externalMemoryProperties.externalMemoryFeatures &
+          vk::ExternalMemoryFeatureFlagBits::eExportable)) {
+        return false;
+    }
+
+    vk::PhysicalDeviceExternalSemaphoreInfo semaphore_info{};
+    semaphore_info.handleType = vk::ExternalSemaphoreHandleTypeFlagBits::eSyncFd;
+    vk::ExternalSemaphoreProperties semaphore_props{};
+    physical_device.getExternalSemaphoreProperties(&semaphore_info, &semaphore_props);
+    return static_cast<bool>(semaphore_props.externalSemaphoreFeatures &
+                             vk::ExternalSemaphoreFeatureFlagBits::eExportable);
+}
+
+auto create_export_semaphore(vk::Device device) -> Result<vk::Semaphore> {
+    vk::ExportSemaphoreCreateInfo export_info{};
+    export_info.handleTypes = vk::ExternalSemaphoreHandleTypeFlagBits::eSyncFd;
+    vk::SemaphoreCreateInfo semaphore_info{};
+    semaphore_info.pNext = &export_info;
+
+    auto [result, semaphore] = device.createSemaphore(semaphore_info);
+    if (result != vk::Result::eSuccess) {
+        return make_error<vk::Semaphore>(ErrorCode::vulkan_init_failed,
+                                         "Failed to create export semaphore: " +
+                                             vk::to_string(result));
+    }
+    return semaphore;
+}
+
+/// Creates one linear, exportable DMA-BUF slot and returns its memory fd.
+auto create_dmabuf_slot(VulkanContext& context, vk::Extent2D extent, vk::Format format,
+                        FrameExporter::Slot& slot, vk::SubresourceLayout& layout)
+    -> Result<util::UniqueFd> {
+    auto& device = context.device;
+
+    vk::ExternalMemoryImageCreateInfo external_info{};
+    external_info.handleTypes = vk::ExternalMemoryHandleTypeFlagBits::eDmaBufEXT;
+
+    vk::ImageCreateInfo image_info{};
+    image_info.pNext = &external_info;
+    image_info.imageType = vk::ImageType::e2D;
+    image_info.format = format;
+    image_info.extent = vk::Extent3D{extent.width, extent.height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = vk::SampleCountFlagBits::e1;
+    image_info.tiling = vk::ImageTiling::eLinear;
+    image_info.usage = vk::ImageUsageFlagBits::eTransferDst;
+    image_info.sharingMode = vk::SharingMode::eExclusive;
+    image_info.initialLayout = vk::ImageLayout::eUndefined;
+
+    auto [image_result, image] = device.createImage(image_info);
+    if (image_result != vk::Result::eSuccess) {
+        return make_error<util::UniqueFd>(ErrorCode::vulkan_init_failed,
+                                          "Failed to create export image: " +
+                                              vk::to_string(image_result));
+    }
+    slot.image = image;
+
+    const auto requirements = device.getImageMemoryRequirements(slot.image);
+    const auto memory_type =
+        select_memory_type(context.allocator.memory_properties, requirements.memoryTypeBits, {},
+                           vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!memory_type) {
+        return make_error<util::UniqueFd>(ErrorCode::vulkan_init_failed,
+                                          "No memory type for export image");
+    }
+
+    // Exported memory is always dedicated so the consumer sees exactly one image per fd.
+    vk::MemoryDedicatedAllocateInfo dedicated_info{};
+    dedicated_info.image = slot.image;
+    vk::ExportMemoryAllocateInfo export_info{};
+    export_info.pNext = &dedicated_info;
+    export_info.handleTypes = vk::ExternalMemoryHandleTypeFlagBits::eDmaBufEXT;
+
+    vk::MemoryAllocateInfo alloc_info{};
+    alloc_info.pNext = &export_info;
+    alloc_info.allocationSize = requirements.size;
+    alloc_info.memoryTypeIndex = *memory_type;
+
+    auto [alloc_result, memory] = device.allocateMemory(alloc_info);
+    if (alloc_result != vk::Result::eSuccess) {
+        return make_error<util::UniqueFd>(ErrorCode::vulkan_init_failed,
+                                          "Failed to allocate export memory: " +
+                                              vk::to_string(alloc_result));
+    }
+    slot.memory = memory;
+
+    auto bind_result = device.bindImageMemory(slot.image, slot.memory, 0);
+    if (bind_result != vk::Result::eSuccess) {
+        return make_error<util::UniqueFd>(ErrorCode::vulkan_init_failed,
+                                          "Failed to bind export memory: " +
+                                              vk::to_string(bind_result));
+    }
+
+    vk::ImageSubresource subresource{};
+    subresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    layout = device.getImageSubresourceLayout(slot.image, subresource);
+
+    vk::MemoryGetFdInfoKHR fd_info{};
+    fd_info.memory = slot.memory;
+    fd_info.handleType = vk::ExternalMemoryHandleTypeFlagBits::eDmaBufEXT;
+    auto [fd_result, fd] = device.getMemoryFdKHR(fd_info);
+    if (fd_result != vk::Result::eSuccess) {
+        return make_error<util::UniqueFd>(ErrorCode::vulkan_init_failed,
+                                          "Failed to export DMA-BUF fd: " +
+                                              vk::to_string(fd_result));
+    }
+    util::UniqueFd dmabuf_fd{fd};
+
+    slot.ready_semaphore = GOGGLES_TRY(create_export_semaphore(device));
+    return dmabuf_fd;
+}
+
+/// Creates one sealed memfd slot of `size` bytes, mapped for the CPU copy.
+auto create_memfd_slot(uint64_t size, FrameExporter::Slot& slot) -> Result<util::UniqueFd> {
+    slot.memfd = util::UniqueFd{::memfd_create("goggles-frame", MFD_CLOEXEC | MFD_ALLOW_SEALING)};
+    if (!slot.memfd || ::ftruncate(slot.memfd.get(), static_cast<off_t>(size)) != 0) {
+        return make_error<util::UniqueFd>(ErrorCode::unknown_error,
+                                          "Failed to create export memfd: " +
+                                              std::string(std::strerror(errno)));
+    }
+    // Consumers may map the slot, so its size must never change underneath them.
+    static_cast<void>(::fcntl(slot.memfd.get(), F_ADD_SEALS,
+                              F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL));
+
+    void* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, slot.memfd.get(), 0);
+    if (mapped == MAP_FAILED) {
+        return make_error<util::UniqueFd>(ErrorCode::unknown_error,
+                                          "Failed to map export memfd: " +
+                                              std::string(std::strerror(errno)));
+    }
+    slot.mapped = mapped;
+    auto consumer_fd = slot.memfd.dup();
+    if (!consumer_fd) {
+        return make_error<util::UniqueFd>(ErrorCode::unknown_error, "Failed to dup export memfd");
+    }
+    return consumer_fd;
+}
+
+auto create_readback(VulkanContext& context, vk::DeviceSize size, FrameExporter::Readback& readback)
+    -> Result<void> {
+    auto& device = context.device;
+    vk::BufferCreateInfo buffer_info{};
+    buffer_info.size = size;
+    buffer_info.usage = vk::BufferUsageFlagBits::eTransferDst;
+    buffer_info.sharingMode = vk::SharingMode::eExclusive;
+
+    auto [buffer_result, buffer] = device.createBuffer(buffer_info);
+    if (buffer_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create export readback buffer: " +
+                                    vk::to_string(buffer_result));
+    }
+    readback.buffer = buffer;
+
+    auto allocation =
+        context.allocator.allocate_buffer(device, readback.buffer,
+                                          vk::MemoryPropertyFlagBits::eHostVisible,
+                                          vk::MemoryPropertyFlagBits::eHostCached);
+    if (!allocation) {
+        return make_error<void>(allocation.error().code,
+                                "Export readback buffer: " + allocation.error().message,
+                                allocation.error().location);
+    }
+    readback.allocation = *allocation;
+    return {};
+}
+
+void destroy_slot(VulkanContext& context, FrameExporter::Slot& slot, uint64_t memfd_size) {
+    auto& device = context.device;
+    if (device) {
+        if (slot.ready_semaphore) {
+            device.destroySemaphore(slot.ready_semaphore);
+        }
+        if (slot.image) {
+            device.destroyImage(slot.image);
+        }
+        if (slot.memory) {
+            device.freeMemory(slot.memory);
+        }
+    }
+    if (slot.mapped != nullptr) {
+        ::munmap(slot.mapped, memfd_size);
+    }
+    slot = FrameExporter::Slot{};
+}
+
+} // namespace
+
+auto vk_to_drm_format(vk::Format format) -> uint32_t {
+    switch (format) {
+    case vk::Format::eB8G8R8A8Unorm:
+    case vk::Format::eB8G8R8A8Srgb:
+        return util::DRM_FORMAT_ARGB8888;
+    case vk::Format::eR8G8B8A8Unorm:
+    case vk::Format::eR8G8B8A8Srgb:
+        return util::DRM_FORMAT_ABGR8888;
+    case vk::Format::eA2R10G10B10UnormPack32:
+        return util::DRM_FORMAT_ARGB2101010;
+    case vk::Format::eA2B10G10R10UnormPack32:
+        return util::DRM_FORMAT_ABGR2101010;
+    default:
+        return 0;
+    }
+}
+
+auto FrameExporter::ensure(VulkanContext& context, vk::Extent2D target_extent,
+                           vk::Format target_format,
+                           const std::function<void()>& wait_for_gpu_idle) -> Result<void> {
+    if (!slots.empty() && extent == target_extent && format == target_format) {
+        return {};
+    }
+    GOGGLES_PROFILE_FUNCTION();
+
+    const uint32_t drm_format = vk_to_drm_format(target_format);
+    if (drm_format == 0) {
+        disabled = true;
+        return make_error<void>(ErrorCode::invalid_data,
+                                "Frame export does not support " + vk::to_string(target_format));
+    }
+
+    if (!slots.empty() && wait_for_gpu_idle) {
+        wait_for_gpu_idle();
+    }
+    destroy(context);
+
+    const uint32_t count = std::clamp(ring_size, 2U, util::FrameExportServer::MAX_RING_SIZE);
+    const uint64_t tight_size =
+        static_cast<uint64_t>(target_extent.width) * target_extent.height * BYTES_PER_PIXEL;
+    std::vector<util::UniqueFd> buffers;
+    buffers.reserve(count);
+    slots.resize(count);
+
+    util::FrameExportRingInfo info{};
+    info.width = target_extent.width;
+    info.height = target_extent.height;
+    info.drm_format = drm_format;
+    info.modifier = util::DRM_FORMAT_MOD_LINEAR;
+
+    storage = util::FrameExportStorage::memfd;
+    if (!force_memfd && supports_dmabuf_export(context.physical_device, target_format)) {
+        vk::SubresourceLayout layout{};
+        Result<void> created{};
+        for (auto& slot : slots) {
+            auto fd = create_dmabuf_slot(context, target_extent, target_format, slot, layout);
+            if (!fd) {
+                created = make_error<void>(fd.error().code, fd.error().message);
+                break;
+            }
+            buffers.push_back(std::move(*fd));
+        }
+        if (created) {
+            storage = util::FrameExportStorage::dmabuf;
+            info.stride = static_cast<uint32_t>(layout.rowPitch);
+            info.offset = static_cast<uint32_t>(layout.offset);
+            info.size = layout.size;
+        } else {
+            GOGGLES_LOG_WARN("DMA-BUF frame export unavailable, using memfd: {}",
+                             created.error().message);
+            destroy(context);
+            slots.resize(count);
+            buffers.clear();
+        }
+    }
+
+    if (storage == util::FrameExportStorage::memfd) {
+        // `destroy()` unmaps by stride * height, so set them before the first mapping exists.
+        extent = target_extent;
+        stride = target_extent.width * BYTES_PER_PIXEL;
+        for (auto& slot : slots) {
+            auto fd = create_memfd_slot(tight_size, slot);
+            if (!fd) {
+                destroy(context);
+                disabled = true;
+                return make_error<void>(fd.error().code, fd.error().message);
+            }
+            buffers.push_back(std::move(*fd));
+        }
+        for (auto& readback : readbacks) {
+            auto readback_result = create_readback(context, tight_size, readback);
+            if (!readback_result) {
+                destroy(context);
+                disabled = true;
+                return readback_result;
+            }
+        }
+        info.stride = stride;
+        info.size = tight_size;
+    }
+
+    info.storage = static_cast<uint32_t>(storage);
+    extent = target_extent;
+    format = target_format;
+    stride = info.stride;
+    next_slot = 0;
+    generation = server->publish_ring(info, std::move(buffers));
+    GOGGLES_LOG_INFO("Frame export ring: {} x {}x{} {} (generation {})", count, extent.width,
+                     extent.height,
+                     storage == util::FrameExportStorage::dmabuf ? "DMA-BUF" : "memfd",
+                     generation);
+    return {};
+}
+
+void FrameExporter::record_copy(vk::CommandBuffer cmd, vk::Image source, uint32_t frame_slot) {
+    if (slots.empty()) {
+        return;
+    }
+    GOGGLES_PROFILE_FUNCTION();
+
+    const uint32_t slot_index = next_slot;
+    next_slot = (next_slot + 1) % static_cast<uint32_t>(slots.size());
+
+    util::FrameExportFrameInfo info{};
+    info.generation = generation;
+    info.slot = slot_index;
+    info.sequence = ++sequence;
+    info.source_frame_number = source_frame_number;
+    info.timestamp_ns = monotonic_now_ns();
+
+    vk::ImageSubresourceLayers layers{};
+    layers.aspectMask = vk::ImageAspectFlagBits::eColor;
+    layers.layerCount = 1;
+
+    if (storage == util::FrameExportStorage::memfd) {
+        auto& readback = readbacks[frame_slot];
+        vk::BufferImageCopy region{};
+        region.imageSubresource = layers;
+        region.imageExtent = vk::Extent3D{extent.width, extent.height, 1};
+        cmd.copyImageToBuffer(source, vk::ImageLayout::eTransferSrcOptimal, readback.buffer,
+                              region);
+
+        vk::BufferMemoryBarrier host_barrier{};
+        host_barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        host_barrier.dstAccessMask = vk::AccessFlagBits::eHostRead;
+        host_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        host_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        host_barrier.buffer = readback.buffer;
+        host_barrier.size = VK_WHOLE_SIZE;
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                            vk::PipelineStageFlagBits::eHost, {}, {}, host_barrier, {});
+        readback.pending = true;
+        readback.info = info;
+        return;
+    }
+
+    auto& slot = slots[slot_index];
+    vk::ImageMemoryBarrier barrier{};
+    barrier.srcAccessMask = vk::AccessFlagBits::eNone;
+    barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+    // The slot's previous contents are stale by the time it comes around again.
+    barrier.oldLayout = vk::ImageLayout::eUndefined;
+    barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = slot.image;
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                        vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, barrier);
+
+    vk::ImageCopy region{};
+    region.srcSubresource = layers;
+    region.dstSubresource = layers;
+    region.extent = vk::Extent3D{extent.width, extent.height, 1};
+    cmd.copyImage(source, vk::ImageLayout::eTransferSrcOptimal, slot.image,
+                  vk::ImageLayout::eTransferDstOptimal, region);
+
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eNone;
+    barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.newLayout = vk::ImageLayout::eGeneral;
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                        vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, barrier);
+
+    recorded_slot = slot_index;
+    recorded_info = info;
+    recorded_frame_slot = frame_slot;
+}
+
+auto FrameExporter::signal_semaphore() const -> vk::Semaphore {
+    return recorded_slot ? slots[*recorded_slot].ready_semaphore : vk::Semaphore{};
+}
+
+void FrameExporter::publish_submitted(VulkanContext& context) {
+    if (!recorded_slot) {
+        return;
+    }
+    auto& slot = slots[*recorded_slot];
+    recorded_slot.reset();
+
+    vk::SemaphoreGetFdInfoKHR fd_info{};
+    fd_info.semaphore = slot.ready_semaphore;
+    fd_info.handleType = vk::ExternalSemaphoreHandleTypeFlagBits::eSyncFd;
+    auto [fd_result, fd] = context.device.getSemaphoreFdKHR(fd_info);
+    if (fd_result != vk::Result::eSuccess) {
+        // The semaphore still holds this submission's signal, so it cannot be signaled again;
+        // swap in a fresh one and free the old one after the frame slot retires.
+        GOGGLES_LOG_WARN("Failed to export frame sync_file: {}", vk::to_string(fd_result));
+        auto replacement = create_export_semaphore(context.device);
+        if (!replacement) {
+            disabled = true;
+            return;
+        }
+        retired_semaphores[recorded_frame_slot] = slot.ready_semaphore;
+        slot.ready_semaphore = *replacement;
+        return;
+    }
+
+    recorded_info.has_sync_fd = 1;
+    server->publish_frame(recorded_info, util::UniqueFd{fd});
+}
+
+void FrameExporter::discard_recorded(uint32_t frame_slot) {
+    recorded_slot.reset();
+    if (frame_slot < readbacks.size()) {
+        readbacks[frame_slot].pending = false;
+    }
+}
+
+void FrameExporter::collect(VulkanContext& context, uint32_t frame_slot) {
+    if (frame_slot >= readbacks.size()) {
+        return;
+    }
+    auto& device = context.device;
+    if (retired_semaphores[frame_slot]) {
+        device.destroySemaphore(retired_semaphores[frame_slot]);
+        retired_semaphores[frame_slot] = nullptr;
+    }
+
+    auto& readback = readbacks[frame_slot];
+    if (!readback.pending) {
+        return;
+    }
+    readback.pending = false;
+    if (readback.info.generation != generation || readback.info.slot >= slots.size()) {
+        return;
+    }
+    GOGGLES_PROFILE_FUNCTION();
+
+    if (!readback.allocation.coherent) {
+        vk::MappedMemoryRange range{};
+        range.memory = readback.allocation.memory;
+        range.offset = readback.allocation.offset;
+        range.size = readback.allocation.size;
+        auto invalidate_result = device.invalidateMappedMemoryRanges(range);
+        if (invalidate_result != vk::Result::eSuccess) {
+            GOGGLES_LOG_WARN("invalidateMappedMemoryRanges failed: {}",
+                             vk::to_string(invalidate_result));
+        }
+    }
+    const auto size = static_cast<size_t>(stride) * extent.height;
+    std::memcpy(slots[readback.info.slot].mapped, readback.allocation.mapped, size);
+    server->publish_frame(readback.info, util::UniqueFd{});
+}
+
+void FrameExporter::destroy(VulkanContext& context) {
+    const uint64_t memfd_size = static_cast<uint64_t>(stride) * extent.height;
+    for (auto& slot : slots) {
+        destroy_slot(context, slot, memfd_size);
+    }
+    slots.clear();
+
+    auto& device = context.device;
+    for (auto& readback : readbacks) {
+        if (device && readback.buffer) {
+            device.destroyBuffer(readback.buffer);
+        }
+        context.allocator.free(device, readback.allocation);
+        readback = Readback{};
+    }
+    for (auto& semaphore : retired_semaphores) {
+        if (device && semaphore) {
+            device.destroySemaphore(semaphore);
+        }
+        semaphore = nullptr;
+    }
+    recorded_slot.reset();
+    extent = vk::Extent2D{};
+    format = vk::Format::eUndefined;
+    stride = 0;
+}
+
+} // namespace goggles::render::backend_internal
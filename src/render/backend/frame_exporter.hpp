@@ -0,0 +1,94 @@
+#pragma once
+
+#include "gpu_allocator.hpp"
+#include "render_output.hpp"
+#include "vulkan_context.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <goggles/error.hpp>
+#include <optional>
+#include <util/frame_export.hpp>
+#include <util/unique_fd.hpp>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace goggles::render::backend_internal {
+
+/// @brief DRM fourcc with the same byte layout as `format`, or 0 when the export ring cannot
+/// describe it.
+[[nodiscard]] auto vk_to_drm_format(vk::Format format) -> uint32_t;
+
+/// @brief GPU side of the frame export socket.
+///
+/// The filtered frame is copied into the next ring slot inside the frame's own command buffer,
+/// before the overlay is drawn. DMA-BUF slots are linear images; each submission signals the
+/// slot's semaphore, which is exported as the frame's sync_file. The memfd fallback copies into
+/// a per-frame-slot readback buffer and is published from `collect()` once that slot's fence
+/// has been waited, so software consumers only ever see finished frames. Slots are never held
+/// back for consumers; see `util::FrameExportServer` for the lifetime they can rely on.
+struct FrameExporter {
+    static constexpr uint32_t DEFAULT_RING_SIZE = 3;
+
+    struct Slot {
+        vk::Image image;
+        vk::DeviceMemory memory;
+        vk::Semaphore ready_semaphore;
+        util::UniqueFd memfd;
+        void* mapped = nullptr;
+    };
+
+    struct Readback {
+        vk::Buffer buffer;
+        GpuAllocation allocation;
+        bool pending = false;
+        util::FrameExportFrameInfo info;
+    };
+
+    /// True once a consumer is connected; the ring is created lazily for the first one.
+    [[nodiscard]] auto wants_frame() const -> bool {
+        return server != nullptr && !disabled && server->client_count() > 0;
+    }
+    /// (Re)creates the ring for `extent`/`format` and advertises it. Call before the frame's
+    /// fence is reset, since a rebuild waits for the GPU.
+    [[nodiscard]] auto ensure(VulkanContext& context, vk::Extent2D extent, vk::Format format,
+                              const std::function<void()>& wait_for_gpu_idle) -> Result<void>;
+    /// Records the copy of `source` (in `eTransferSrcOptimal`) into the next ring slot.
+    void record_copy(vk::CommandBuffer cmd, vk::Image source, uint32_t frame_slot);
+    /// Semaphore the frame submission must signal; null when nothing was recorded for DMA-BUF.
+    [[nodiscard]] auto signal_semaphore() const -> vk::Semaphore;
+    /// Publishes the DMA-BUF frame recorded for the submission that just succeeded.
+    void publish_submitted(VulkanContext& context);
+    /// Forgets the frame recorded into `frame_slot` for a submission that failed.
+    void discard_recorded(uint32_t frame_slot);
+    /// Publishes the memfd frame read back in `frame_slot`; call after its fence was waited.
+    void collect(VulkanContext& context, uint32_t frame_slot);
+    void destroy(VulkanContext& context);
+
+    util::FrameExportServer* server = nullptr;
+    uint32_t ring_size = DEFAULT_RING_SIZE;
+    bool force_memfd = false;
+    /// Compositor frame number of the source filtered this frame, stamped on its metadata.
+    uint64_t source_frame_number = 0;
+
+    util::FrameExportStorage storage = util::FrameExportStorage::dmabuf;
+    std::vector<Slot> slots;
+    std::array<Readback, RenderOutput::MAX_FRAMES_IN_FLIGHT> readbacks{};
+    /// Semaphores whose payload could not be exported, freed once their frame slot retires.
+    std::array<vk::Semaphore, RenderOutput::MAX_FRAMES_IN_FLIGHT> retired_semaphores{};
+    vk::Extent2D extent;
+    vk::Format format = vk::Format::eUndefined;
+    uint32_t stride = 0;
+    uint32_t generation = 0;
+    uint32_t next_slot = 0;
+    uint64_t sequence = 0;
+    /// Index into `slots` of the DMA-BUF frame recorded for the pending submission.
+    std::optional<uint32_t> recorded_slot;
+    util::FrameExportFrameInfo recorded_info;
+    uint32_t recorded_frame_slot = 0;
+    /// Set after an unrecoverable setup failure so it is not retried every frame.
+    bool disabled = false;
+};
+
+} // namespace goggles::render::backend_internal
@@ -0,0 +1,642 @@
+#include "frame_interpolator.hpp"
+
+#include "vulkan_error.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <goggles/profiling.hpp>
+#include <slang-com-ptr.h>
+#include <slang.h>
+#include <sstream>
+#include <string>
+#include <util/logging.hpp>
+#include <vector>
+
+namespace goggles::render::backend_internal {
+
+namespace {
+
+// Flag bits and block size shared with the interpolation_*.comp.slang shaders.
+constexpr uint32_t FLAG_CAPTURE = 1;
+constexpr uint32_t FLAG_COARSE_MOTION = 2;
+constexpr uint32_t BLOCK_SIZE = 8;
+constexpr uint32_t WORKGROUP_SIZE = 8;
+
+constexpr uint32_t LEVELS = FrameInterpolator::PYRAMID_LEVELS;
+// Capture and synthesis sets per slot, pyramid sets above level 0, motion sets per level.
+constexpr uint32_t SET_COUNT = RenderOutput::MAX_FRAMES_IN_FLIGHT + 2 + (2 * (LEVELS - 1)) +
+                               (2 * LEVELS);
+
+struct PushConstants {
+    std::array<int32_t, 2> source_size{};
+    std::array<int32_t, 2> target_size{};
+    float phase = 0.0F;
+    uint32_t flags = 0;
+};
+static_assert(sizeof(PushConstants) == 24);
+
+auto to_size(vk::Extent2D extent) -> std::array<int32_t, 2> {
+    return {static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height)};
+}
+
+auto halve(vk::Extent2D extent) -> vk::Extent2D {
+    return {std::max((extent.width + 1) / 2, 1U), std::max((extent.height + 1) / 2, 1U)};
+}
+
+auto blocks(vk::Extent2D extent) -> vk::Extent2D {
+    return {std::max((extent.width + BLOCK_SIZE - 1) / BLOCK_SIZE, 1U),
+            std::max((extent.height + BLOCK_SIZE - 1) / BLOCK_SIZE, 1U)};
+}
+
+auto read_shader_source(const std::filesystem::path& path) -> Result<std::string> {
+    std::ifstream file(path);
+    if (!file) {
+        return make_error<std::string>(ErrorCode::file_not_found,
+                                       "Interpolation shader not found: " + path.string());
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+auto diagnostics_text(slang::IBlob* diagnostics) -> std::string {
+    if (!diagnostics) {
+        return "no diagnostics";
+    }
+    return static_cast<const char*>(diagnostics->getBufferPointer());
+}
+
+auto compile_compute_shader(slang::IGlobalSession& global_session,
+                            const std::filesystem::path& path) -> Result<std::vector<uint32_t>> {
+    const auto source = GOGGLES_TRY(read_shader_source(path));
+
+    slang::TargetDesc target{};
+    target.format = SLANG_SPIRV;
+    target.profile = global_session.findProfile("spirv_1_3");
+    slang::SessionDesc session_desc{};
+    session_desc.targets = &target;
+    session_desc.targetCount = 1;
+
+    Slang::ComPtr<slang::ISession> session;
+    if (SLANG_FAILED(global_session.createSession(session_desc, session.writeRef()))) {
+        return make_error<std::vector<uint32_t>>(ErrorCode::shader_compile_failed,
+                                                 "Failed to create Slang session");
+    }
+
+    Slang::ComPtr<slang::IBlob> diagnostics;
+    const auto module_name = path.stem().string();
+    const auto module_path = path.string();
+    slang::IModule* module = session->loadModuleFromSourceString(
+        module_name.c_str(), module_path.c_str(), source.c_str(), diagnostics.writeRef());
+    if (!module) {
+        return make_error<std::vector<uint32_t>>(ErrorCode::shader_compile_failed,
+                                                 path.filename().string() + ": " +
+                                                     diagnostics_text(diagnostics));
+    }
+
+    Slang::ComPtr<slang::IEntryPoint> entry_point;
+    if (SLANG_FAILED(module->findEntryPointByName("main", entry_point.writeRef()))) {
+        return make_error<std::vector<uint32_t>>(ErrorCode::shader_compile_failed,
+                                                 path.filename().string() + ": no entry point");
+    }
+
+    std::array<slang::IComponentType*, 2> components = {module, entry_point.get()};
+    Slang::ComPtr<slang::IComponentType> composite;
+    Slang::ComPtr<slang::IComponentType> linked;
+    Slang::ComPtr<slang::IBlob> code;
+    if (SLANG_FAILED(session->createCompositeComponentType(
+            components.data(), components.size(), composite.writeRef(), diagnostics.writeRef())) ||
+        SLANG_FAILED(composite->link(linked.writeRef(), diagnostics.writeRef())) ||
+        SLANG_FAILED(linked->getEntryPointCode(0, 0, code.writeRef(), diagnostics.writeRef()))) {
+        return make_error<std::vector<uint32_t>>(ErrorCode::shader_compile_failed,
+                                                 path.filename().string() + ": " +
+                                                     diagnostics_text(diagnostics));
+    }
+
+    std::vector<uint32_t> spirv(code->getBufferSize() / sizeof(uint32_t));
+    std::memcpy(spirv.data(), code->getBufferPointer(), spirv.size() * sizeof(uint32_t));
+    return spirv;
+}
+
+auto create_compute_pipeline(vk::Device device, vk::PipelineLayout layout,
+                             const std::vector<uint32_t>& spirv) -> Result<vk::Pipeline> {
+    vk::ShaderModuleCreateInfo module_info{};
+    module_info.codeSize = spirv.size() * sizeof(uint32_t);
+    module_info.pCode = spirv.data();
+    auto [module_result, module] = device.createShaderModule(module_info);
+    if (module_result != vk::Result::eSuccess) {
+        return make_error<vk::Pipeline>(ErrorCode::vulkan_init_failed,
+                                        "Failed to create interpolation shader module: " +
+                                            vk::to_string(module_result));
+    }
+
+    vk::ComputePipelineCreateInfo pipeline_info{};
+    pipeline_info.stage.stage = vk::ShaderStageFlagBits::eCompute;
+    pipeline_info.stage.module = module;
+    pipeline_info.stage.pName = "main";
+    pipeline_info.layout = layout;
+    auto [pipeline_result, pipeline] = device.createComputePipeline(nullptr, pipeline_info);
+    device.destroyShaderModule(module);
+    if (pipeline_result != vk::Result::eSuccess) {
+        return make_error<vk::Pipeline>(ErrorCode::vulkan_init_failed,
+                                        "Failed to create interpolation pipeline: " +
+                                            vk::to_string(pipeline_result));
+    }
+    return pipeline;
+}
+
+void destroy_image(VulkanContext& context, FrameInterpolator::Image& image) {
+    auto& device = context.device;
+    if (device) {
+        if (image.view) {
+            device.destroyImageView(image.view);
+        }
+        if (image.image) {
+            device.destroyImage(image.image);
+        }
+        context.allocator.free(device, image.allocation);
+    }
+    image = {};
+}
+
+auto create_image(VulkanContext& context, vk::Extent2D extent, vk::Format format,
+                  FrameInterpolator::Image& image) -> Result<void> {
+    auto& device = context.device;
+
+    vk::ImageCreateInfo image_info{};
+    image_info.imageType = vk::ImageType::e2D;
+    image_info.format = format;
+    image_info.extent = vk::Extent3D{extent.width, extent.height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = vk::SampleCountFlagBits::e1;
+    image_info.tiling = vk::ImageTiling::eOptimal;
+    image_info.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled;
+    image_info.sharingMode = vk::SharingMode::eExclusive;
+    image_info.initialLayout = vk::ImageLayout::eUndefined;
+
+    auto [image_result, created] = device.createImage(image_info);
+    if (image_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create interpolation image: " +
+                                    vk::to_string(image_result));
+    }
+    image.image = created;
+
+    auto allocation = context.allocator.allocate_image(device, image.image, {},
+                                                       vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!allocation) {
+        return make_error<void>(allocation.error().code,
+                                "Interpolation image: " + allocation.error().message,
+                                allocation.error().location);
+    }
+    image.allocation = *allocation;
+
+    vk::ImageViewCreateInfo view_info{};
+    view_info.image = image.image;
+    view_info.viewType = vk::ImageViewType::e2D;
+    view_info.format = format;
+    view_info.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.layerCount = 1;
+
+    auto [view_result, view] = device.createImageView(view_info);
+    if (view_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create interpolation view: " +
+                                    vk::to_string(view_result));
+    }
+    image.view = view;
+    image.extent = extent;
+    return {};
+}
+
+void write_image(vk::Device device, vk::DescriptorSet set, uint32_t binding, vk::ImageView view,
+                 vk::ImageLayout layout = vk::ImageLayout::eGeneral) {
+    vk::DescriptorImageInfo image_info{};
+    image_info.imageView = view;
+    image_info.imageLayout = layout;
+
+    vk::WriteDescriptorSet write{};
+    write.dstSet = set;
+    write.dstBinding = binding;
+    write.descriptorCount = 1;
+    // Bindings 0-2 are sampled, 3-4 storage; see FrameInterpolationPipelines::create.
+    write.descriptorType =
+        binding < 3 ? vk::DescriptorType::eSampledImage : vk::DescriptorType::eStorageImage;
+    write.pImageInfo = &image_info;
+    device.updateDescriptorSets(write, {});
+}
+
+auto create_resources(VulkanContext& context, const FrameInterpolationPipelines& pipelines,
+                      FrameInterpolator& interpolator, vk::Extent2D extent) -> Result<void> {
+    using Image = FrameInterpolator::Image;
+    auto& device = context.device;
+
+    for (auto& image : interpolator.history) {
+        GOGGLES_TRY(create_image(context, extent, FrameInterpolator::COLOR_FORMAT, image));
+    }
+    GOGGLES_TRY(
+        create_image(context, extent, FrameInterpolator::COLOR_FORMAT, interpolator.output));
+    for (auto& levels : interpolator.pyramid) {
+        vk::Extent2D level_extent = halve(extent);
+        for (auto& level : levels) {
+            GOGGLES_TRY(create_image(context, level_extent, vk::Format::eR32Sfloat, level));
+            level_extent = halve(level_extent);
+        }
+    }
+    for (uint32_t level = 0; level < LEVELS; ++level) {
+        GOGGLES_TRY(create_image(context, blocks(interpolator.pyramid[0][level].extent),
+                                 FrameInterpolator::COLOR_FORMAT, interpolator.motion[level]));
+    }
+
+    std::array pool_sizes = {
+        vk::DescriptorPoolSize{vk::DescriptorType::eSampledImage, 3 * SET_COUNT},
+        vk::DescriptorPoolSize{vk::DescriptorType::eStorageImage, 2 * SET_COUNT},
+        vk::DescriptorPoolSize{vk::DescriptorType::eSampler, SET_COUNT},
+    };
+    vk::DescriptorPoolCreateInfo pool_info{};
+    pool_info.maxSets = SET_COUNT;
+    pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+    pool_info.pPoolSizes = pool_sizes.data();
+    auto [pool_result, pool] = device.createDescriptorPool(pool_info);
+    if (pool_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create interpolation descriptor pool: " +
+                                    vk::to_string(pool_result));
+    }
+    interpolator.descriptor_pool = pool;
+
+    std::vector<vk::DescriptorSetLayout> layouts(SET_COUNT, pipelines.set_layout);
+    vk::DescriptorSetAllocateInfo alloc_info{};
+    alloc_info.descriptorPool = interpolator.descriptor_pool;
+    alloc_info.descriptorSetCount = SET_COUNT;
+    alloc_info.pSetLayouts = layouts.data();
+    auto [sets_result, sets] = device.allocateDescriptorSets(alloc_info);
+    if (sets_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to allocate interpolation descriptor sets: " +
+                                    vk::to_string(sets_result));
+    }
+
+    auto next_set = sets.begin();
+    for (auto& set : interpolator.capture_sets) {
+        set = *next_set++;
+    }
+    for (uint32_t slot = 0; slot < 2; ++slot) {
+        const auto& history = interpolator.history;
+        const auto& pyramid = interpolator.pyramid;
+        for (uint32_t level = 1; level < LEVELS; ++level) {
+            auto set = *next_set++;
+            interpolator.pyramid_sets[slot][level] = set;
+            write_image(device, set, 0, pyramid[slot][level - 1].view);
+            write_image(device, set, 3, pyramid[slot][level].view);
+            // Unwritten above level 0, but the capture path keeps the binding live.
+            write_image(device, set, 4, history[slot].view);
+        }
+        for (uint32_t level = 0; level < LEVELS; ++level) {
+            auto set = *next_set++;
+            interpolator.motion_sets[slot][level] = set;
+            write_image(device, set, 0, pyramid[slot][level].view);
+            write_image(device, set, 1, pyramid[1 - slot][level].view);
+            // The coarsest level has no prediction and never reads binding 2.
+            const Image& coarse = interpolator.motion[level + 1 < LEVELS ? level + 1 : 0];
+            write_image(device, set, 2, coarse.view);
+            write_image(device, set, 3, interpolator.motion[level].view);
+        }
+        auto set = *next_set++;
+        interpolator.synthesize_sets[slot] = set;
+        write_image(device, set, 0, history[1 - slot].view);
+        write_image(device, set, 1, history[slot].view);
+        write_image(device, set, 2, interpolator.motion[0].view);
+        write_image(device, set, 3, interpolator.output.view);
+    }
+    return {};
+}
+
+void compute_barrier(vk::CommandBuffer cmd) {
+    vk::MemoryBarrier barrier{};
+    barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                        vk::PipelineStageFlagBits::eComputeShader, {}, barrier, {}, {});
+}
+
+auto make_general_barrier(vk::Image image, vk::ImageLayout old_layout, vk::ImageLayout new_layout,
+                          vk::AccessFlags src_access, vk::AccessFlags dst_access)
+    -> vk::ImageMemoryBarrier {
+    vk::ImageMemoryBarrier barrier{};
+    barrier.srcAccessMask = src_access;
+    barrier.dstAccessMask = dst_access;
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    return barrier;
+}
+
+void dispatch(vk::CommandBuffer cmd, const FrameInterpolationPipelines& pipelines,
+              vk::Pipeline pipeline, vk::DescriptorSet set, const PushConstants& push) {
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipelines.pipeline_layout, 0, set,
+                           {});
+    cmd.pushConstants(pipelines.pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+                      sizeof(push), &push);
+    const auto groups = [](int32_t size) {
+        return (static_cast<uint32_t>(size) + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    };
+    cmd.dispatch(groups(push.target_size[0]), groups(push.target_size[1]), 1);
+}
+
+} // namespace
+
+auto FrameInterpolationPipelines::create(VulkanContext& context,
+                                         const std::filesystem::path& shader_dir) -> Result<void> {
+    GOGGLES_PROFILE_FUNCTION();
+    auto& device = context.device;
+
+    Slang::ComPtr<slang::IGlobalSession> global_session;
+    if (SLANG_FAILED(slang::createGlobalSession(global_session.writeRef()))) {
+        return make_error<void>(ErrorCode::shader_compile_failed,
+                                "Failed to create Slang global session");
+    }
+    const auto pyramid_spirv = GOGGLES_TRY(
+        compile_compute_shader(*global_session, shader_dir / "interpolation_pyramid.comp.slang"));
+    const auto motion_spirv = GOGGLES_TRY(
+        compile_compute_shader(*global_session, shader_dir / "interpolation_motion.comp.slang"));
+    const auto synthesize_spirv = GOGGLES_TRY(compile_compute_shader(
+        *global_session, shader_dir / "interpolation_synthesize.comp.slang"));
+
+    vk::SamplerCreateInfo sampler_info{};
+    sampler_info.magFilter = vk::Filter::eLinear;
+    sampler_info.minFilter = vk::Filter::eLinear;
+    sampler_info.mipmapMode = vk::SamplerMipmapMode::eNearest;
+    sampler_info.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+    sampler_info.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+    sampler_info.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+    sampler_info.maxLod = 0.0F;
+    auto [sampler_result, created_sampler] = device.createSampler(sampler_info);
+    if (sampler_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create interpolation sampler: " +
+                                    vk::to_string(sampler_result));
+    }
+    sampler = created_sampler;
+
+    std::array<vk::DescriptorSetLayoutBinding, 6> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = vk::ShaderStageFlagBits::eCompute;
+        bindings[i].descriptorType =
+            i < 3 ? vk::DescriptorType::eSampledImage : vk::DescriptorType::eStorageImage;
+    }
+    bindings[5].descriptorType = vk::DescriptorType::eSampler;
+    bindings[5].pImmutableSamplers = &sampler;
+
+    vk::DescriptorSetLayoutCreateInfo set_layout_info{};
+    set_layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
+    set_layout_info.pBindings = bindings.data();
+    auto [set_layout_result, created_set_layout] =
+        device.createDescriptorSetLayout(set_layout_info);
+    if (set_layout_result != vk::Result::eSuccess) {
+        destroy(context);
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create interpolation set layout: " +
+                                    vk::to_string(set_layout_result));
+    }
+    set_layout = created_set_layout;
+
+    vk::PushConstantRange push_range{};
+    push_range.stageFlags = vk::ShaderStageFlagBits::eCompute;
+    push_range.size = sizeof(PushConstants);
+    vk::PipelineLayoutCreateInfo layout_info{};
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &set_layout;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_range;
+    auto [layout_result, created_layout] = device.createPipelineLayout(layout_info);
+    if (layout_result != vk::Result::eSuccess) {
+        destroy(context);
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create interpolation pipeline layout: " +
+                                    vk::to_string(layout_result));
+    }
+    pipeline_layout = created_layout;
+
+    auto pyramid_result = create_compute_pipeline(device, pipeline_layout, pyramid_spirv);
+    auto motion_result = create_compute_pipeline(device, pipeline_layout, motion_spirv);
+    auto synthesize_result = create_compute_pipeline(device, pipeline_layout, synthesize_spirv);
+    pyramid = pyramid_result.value_or(nullptr);
+    motion = motion_result.value_or(nullptr);
+    synthesize = synthesize_result.value_or(nullptr);
+    for (const auto* result : {&pyramid_result, &motion_result, &synthesize_result}) {
+        if (!*result) {
+            destroy(context);
+            return nonstd::make_unexpected(result->error());
+        }
+    }
+
+    GOGGLES_LOG_DEBUG("Frame interpolation pipelines compiled from {}", shader_dir.string());
+    return {};
+}
+
+void FrameInterpolationPipelines::destroy(VulkanContext& context) {
+    auto& device = context.device;
+    if (device) {
+        for (auto pipeline : {pyramid, motion, synthesize}) {
+            if (pipeline) {
+                device.destroyPipeline(pipeline);
+            }
+        }
+        if (pipeline_layout) {
+            device.destroyPipelineLayout(pipeline_layout);
+        }
+        if (set_layout) {
+            device.destroyDescriptorSetLayout(set_layout);
+        }
+        if (sampler) {
+            device.destroySampler(sampler);
+        }
+    }
+    *this = {};
+}
+
+auto FrameInterpolator::ensure(VulkanContext& context, const FrameInterpolationPipelines& pipelines,
+                               vk::Extent2D extent, const std::function<void()>& wait_for_gpu_idle)
+    -> Result<void> {
+    if (allocated() && output.extent == extent) {
+        return {};
+    }
+    if (extent.width == 0 || extent.height == 0) {
+        return make_error<void>(ErrorCode::invalid_data, "Interpolation extent is zero");
+    }
+
+    if (allocated() && wait_for_gpu_idle) {
+        wait_for_gpu_idle();
+    }
+    destroy(context);
+
+    auto result = create_resources(context, pipelines, *this, extent);
+    if (!result) {
+        destroy(context);
+        return result;
+    }
+    GOGGLES_LOG_DEBUG("Frame interpolation images: {}x{}", extent.width, extent.height);
+    return {};
+}
+
+auto FrameInterpolator::record(VulkanContext& context, const FrameInterpolationPipelines& pipelines,
+                               vk::CommandBuffer cmd, const SourceFrame& source,
+                               uint32_t frame_slot, uint64_t present_time_ns)
+    -> std::optional<ExternalFrameImporter::ImportedSource> {
+    GOGGLES_PROFILE_SCOPE("FrameInterpolation");
+    phase = 1.0F;
+    if (!allocated() || !pipelines.ready() || source.image.extent != output.extent) {
+        return std::nullopt;
+    }
+
+    if (!layouts_ready) {
+        std::vector<vk::ImageMemoryBarrier> barriers;
+        const auto add = [&barriers](const Image& image) {
+            barriers.push_back(make_general_barrier(
+                image.image, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral,
+                vk::AccessFlagBits::eNone,
+                vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite));
+        };
+        std::for_each(history.begin(), history.end(), add);
+        for (const auto& levels : pyramid) {
+            std::for_each(levels.begin(), levels.end(), add);
+        }
+        std::for_each(motion.begin(), motion.end(), add);
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                            vk::PipelineStageFlagBits::eComputeShader, {}, {}, {}, barriers);
+        layouts_ready = true;
+    }
+
+    if (held_frames == 0 || source.frame_number != frame_numbers[current]) {
+        // The slot being replaced may still be read by the last present's synthesis.
+        compute_barrier(cmd);
+        const uint32_t next = held_frames == 0 ? current : 1 - current;
+        auto capture_set = capture_sets[frame_slot];
+        write_image(context.device, capture_set, 0, source.image.view,
+                    vk::ImageLayout::eShaderReadOnlyOptimal);
+        write_image(context.device, capture_set, 3, pyramid[next][0].view);
+        write_image(context.device, capture_set, 4, history[next].view);
+        dispatch(cmd, pipelines, pipelines.pyramid, capture_set,
+                 PushConstants{.source_size = to_size(output.extent),
+                               .target_size = to_size(pyramid[next][0].extent),
+                               .flags = FLAG_CAPTURE});
+        for (uint32_t level = 1; level < PYRAMID_LEVELS; ++level) {
+            compute_barrier(cmd);
+            dispatch(cmd, pipelines, pipelines.pyramid, pyramid_sets[next][level],
+                     PushConstants{.source_size = to_size(pyramid[next][level - 1].extent),
+                                   .target_size = to_size(pyramid[next][level].extent)});
+        }
+
+        current = next;
+        frame_numbers[current] = source.frame_number;
+        commit_times_ns[current] = source.commit_time_ns;
+        held_frames = std::min(held_frames + 1, 2U);
+
+        if (held_frames == 2) {
+            for (uint32_t level = PYRAMID_LEVELS; level-- > 0;) {
+                compute_barrier(cmd);
+                dispatch(cmd, pipelines, pipelines.motion, motion_sets[current][level],
+                         PushConstants{
+                             .source_size = to_size(pyramid[current][level].extent),
+                             .target_size = to_size(motion[level].extent),
+                             .flags = level + 1 < PYRAMID_LEVELS ? FLAG_COARSE_MOTION : 0U,
+                         });
+            }
+        }
+    }
+
+    if (held_frames < 2) {
+        return std::nullopt;
+    }
+    const uint64_t previous_time = commit_times_ns[1 - current];
+    const uint64_t current_time = commit_times_ns[current];
+    if (current_time <= previous_time || current_time - previous_time > MAX_FRAME_INTERVAL_NS) {
+        return std::nullopt;
+    }
+    // Presents trail the newest frame by up to one interval: at its arrival the previous frame
+    // is shown, and the newest one is reached an interval later.
+    const uint64_t elapsed = present_time_ns > current_time ? present_time_ns - current_time : 0;
+    phase = std::min(static_cast<float>(static_cast<double>(elapsed) /
+                                        static_cast<double>(current_time - previous_time)),
+                     1.0F);
+    if (phase >= 1.0F) {
+        return std::nullopt;
+    }
+
+    vk::MemoryBarrier motion_barrier{};
+    motion_barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+    motion_barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    const auto output_barrier = make_general_barrier(
+        output.image, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral,
+        vk::AccessFlagBits::eNone, vk::AccessFlagBits::eShaderWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader |
+                            vk::PipelineStageFlagBits::eFragmentShader,
+                        vk::PipelineStageFlagBits::eComputeShader, {}, motion_barrier, {},
+                        output_barrier);
+    dispatch(cmd, pipelines, pipelines.synthesize, synthesize_sets[current],
+             PushConstants{.source_size = to_size(output.extent),
+                           .target_size = to_size(output.extent),
+                           .phase = phase});
+
+    const auto read_barrier = make_general_barrier(
+        output.image, vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal,
+        vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                        vk::PipelineStageFlagBits::eFragmentShader |
+                            vk::PipelineStageFlagBits::eComputeShader,
+                        {}, {}, {}, read_barrier);
+
+    return ExternalFrameImporter::ImportedSource{
+        .image = output.image,
+        .view = output.view,
+        .extent = output.extent,
+        .format = COLOR_FORMAT,
+    };
+}
+
+void FrameInterpolator::reset() {
+    frame_numbers = {};
+    commit_times_ns = {};
+    current = 0;
+    held_frames = 0;
+    phase = 1.0F;
+}
+
+void FrameInterpolator::destroy(VulkanContext& context) {
+    for (auto& image : history) {
+        destroy_image(context, image);
+    }
+    for (auto& levels : pyramid) {
+        for (auto& level : levels) {
+            destroy_image(context, level);
+        }
+    }
+    for (auto& image : motion) {
+        destroy_image(context, image);
+    }
+    destroy_image(context, output);
+    if (descriptor_pool && context.device) {
+        context.device.destroyDescriptorPool(descriptor_pool);
+    }
+    descriptor_pool = nullptr;
+    capture_sets = {};
+    pyramid_sets = {};
+    motion_sets = {};
+    synthesize_sets = {};
+    layouts_ready = false;
+    reset();
+}
+
+} // namespace goggles::render::backend_internal
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "external_frame_importer.hpp"
+#include "gpu_allocator.hpp"
+#include "render_output.hpp"
+#include "vulkan_context.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <goggles/error.hpp>
+#include <optional>
+#include <vulkan/vulkan.hpp>
+
+namespace goggles::render::backend_internal {
+
+/// @brief Compute pipelines of the frame interpolation stage, shared by every interpolator.
+///
+/// Compiled with Slang from the `interpolation_*.comp.slang` internal shaders on first use. All
+/// three share one descriptor set layout: sampled images at bindings 0-2, storage images at 3-4
+/// and an immutable linear clamp sampler at 5.
+struct FrameInterpolationPipelines {
+    [[nodiscard]] auto create(VulkanContext& context, const std::filesystem::path& shader_dir)
+        -> Result<void>;
+    void destroy(VulkanContext& context);
+
+    [[nodiscard]] auto ready() const -> bool { return static_cast<bool>(synthesize); }
+
+    vk::Sampler sampler;
+    vk::DescriptorSetLayout set_layout;
+    vk::PipelineLayout pipeline_layout;
+    vk::Pipeline pyramid;
+    vk::Pipeline motion;
+    vk::Pipeline synthesize;
+};
+
+/// @brief Optional temporal stage of one surface, between import and the filter chain.
+///
+/// Holds the last two imported frames. Each new frame is copied into the color history and
+/// reduced to a luma pyramid, then block motion against the previous frame is estimated coarse
+/// to fine on that pyramid. Every present warps both frames along the motion to the present's
+/// phase between their commit times and blends them, so the filter chain sees a frame for each
+/// present rather than a repeat. Output trails the source by one frame interval.
+///
+/// Internal images stay in `eGeneral`; the output is handed over in `eShaderReadOnlyOptimal`.
+struct FrameInterpolator {
+    static constexpr uint32_t PYRAMID_LEVELS = 3;
+    static constexpr vk::Format COLOR_FORMAT = vk::Format::eR16G16B16A16Sfloat;
+    /// Frames further apart than this are a stall or a scene change; they are not blended.
+    static constexpr uint64_t MAX_FRAME_INTERVAL_NS = 100'000'000;
+
+    struct Image {
+        vk::Image image;
+        vk::ImageView view;
+        GpuAllocation allocation;
+        vk::Extent2D extent;
+    };
+
+    struct SourceFrame {
+        /// Imported frame in `eShaderReadOnlyOptimal`, visible to compute shaders.
+        ExternalFrameImporter::ImportedSource image;
+        uint64_t frame_number = 0;
+        uint64_t commit_time_ns = 0;
+    };
+
+    [[nodiscard]] auto allocated() const -> bool { return static_cast<bool>(output.image); }
+    /// Recreates the images when the source extent changed, waiting for the GPU before older
+    /// ones are released. Call before the frame slot's fence is reset.
+    [[nodiscard]] auto ensure(VulkanContext& context, const FrameInterpolationPipelines& pipelines,
+                              vk::Extent2D extent, const std::function<void()>& wait_for_gpu_idle)
+        -> Result<void>;
+    /// Records the stage for a present at `present_time_ns` (steady clock). Returns the frame to
+    /// filter instead of `source`, or nothing when `source` itself is the right frame: until two
+    /// frames are held, across a stall, and once the present has caught up with the newest one.
+    [[nodiscard]] auto record(VulkanContext& context, const FrameInterpolationPipelines& pipelines,
+                              vk::CommandBuffer cmd, const SourceFrame& source, uint32_t frame_slot,
+                              uint64_t present_time_ns)
+        -> std::optional<ExternalFrameImporter::ImportedSource>;
+    /// Whether the last `record()` passed the newest frame through, so presenting again without a
+    /// new frame would repeat the same image.
+    [[nodiscard]] auto settled() const -> bool { return phase >= 1.0F; }
+    /// Forgets the held frames; the next source starts a new history.
+    void reset();
+    void destroy(VulkanContext& context);
+
+    std::array<Image, 2> history{};
+    std::array<std::array<Image, PYRAMID_LEVELS>, 2> pyramid{};
+    std::array<Image, PYRAMID_LEVELS> motion{};
+    Image output;
+    vk::DescriptorPool descriptor_pool;
+    /// Level 0 reads the imported frame, whose view can change each frame.
+    std::array<vk::DescriptorSet, RenderOutput::MAX_FRAMES_IN_FLIGHT> capture_sets{};
+    /// [history slot][level]; level 0 is built by the capture sets.
+    std::array<std::array<vk::DescriptorSet, PYRAMID_LEVELS>, 2> pyramid_sets{};
+    /// [current history slot][level].
+    std::array<std::array<vk::DescriptorSet, PYRAMID_LEVELS>, 2> motion_sets{};
+    std::array<vk::DescriptorSet, 2> synthesize_sets{};
+
+    std::array<uint64_t, 2> frame_numbers{};
+    std::array<uint64_t, 2> commit_times_ns{};
+    uint32_t current = 0;
+    uint32_t held_frames = 0;
+    bool layouts_ready = false;
+    float phase = 1.0F;
+};
+
+} // namespace goggles::render::backend_internal
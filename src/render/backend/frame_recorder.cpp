@@ -0,0 +1,143 @@
+#include "frame_recorder.hpp"
+
+#include <cstring>
+#include <goggles/profiling.hpp>
+#include <string>
+#include <util/logging.hpp>
+
+namespace goggles::render::backend_internal {
+
+namespace {
+
+constexpr vk::DeviceSize BYTES_PER_PIXEL = 4;
+
+} // namespace
+
+auto FrameRecorder::ensure(VulkanContext& context, vk::Extent2D target_extent) -> Result<void> {
+    if (staging[0].buffer && extent == target_extent) {
+        return {};
+    }
+    GOGGLES_PROFILE_FUNCTION();
+
+    const auto& options = recorder->options();
+    if (target_extent.width != options.width || target_extent.height != options.height) {
+        return make_error<void>(ErrorCode::invalid_data,
+                                "Render target " + std::to_string(target_extent.width) + "x" +
+                                    std::to_string(target_extent.height) +
+                                    " does not match the recording size");
+    }
+    destroy(context);
+
+    auto& device = context.device;
+    const vk::DeviceSize size =
+        static_cast<vk::DeviceSize>(target_extent.width) * target_extent.height * BYTES_PER_PIXEL;
+    for (auto& slot : staging) {
+        vk::BufferCreateInfo buffer_info{};
+        buffer_info.size = size;
+        buffer_info.usage = vk::BufferUsageFlagBits::eTransferDst;
+        buffer_info.sharingMode = vk::SharingMode::eExclusive;
+
+        auto [buffer_result, buffer] = device.createBuffer(buffer_info);
+        if (buffer_result != vk::Result::eSuccess) {
+            destroy(context);
+            return make_error<void>(ErrorCode::vulkan_init_failed,
+                                    "Failed to create recording staging buffer: " +
+                                        vk::to_string(buffer_result));
+        }
+        slot.buffer = buffer;
+
+        auto allocation = context.allocator.allocate_buffer(
+            device, slot.buffer, vk::MemoryPropertyFlagBits::eHostVisible,
+            vk::MemoryPropertyFlagBits::eHostCached);
+        if (!allocation) {
+            destroy(context);
+            return make_error<void>(allocation.error().code,
+                                    "Recording staging buffer: " + allocation.error().message,
+                                    allocation.error().location);
+        }
+        slot.allocation = *allocation;
+    }
+    extent = target_extent;
+    return {};
+}
+
+void FrameRecorder::record_copy(vk::CommandBuffer cmd, vk::Image source, uint32_t frame_slot) {
+    if (frame_slot >= staging.size() || !staging[frame_slot].buffer) {
+        return;
+    }
+    GOGGLES_PROFILE_FUNCTION();
+    auto& slot = staging[frame_slot];
+
+    vk::BufferImageCopy region{};
+    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = vk::Extent3D{extent.width, extent.height, 1};
+    cmd.copyImageToBuffer(source, vk::ImageLayout::eTransferSrcOptimal, slot.buffer, region);
+
+    vk::BufferMemoryBarrier host_barrier{};
+    host_barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    host_barrier.dstAccessMask = vk::AccessFlagBits::eHostRead;
+    host_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    host_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    host_barrier.buffer = slot.buffer;
+    host_barrier.size = VK_WHOLE_SIZE;
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost,
+                        {}, {}, host_barrier, {});
+
+    slot.pending = true;
+    slot.timestamp_ns = timestamp_ns;
+    slot.source_frame_number = source_frame_number;
+}
+
+void FrameRecorder::discard(uint32_t frame_slot) {
+    if (frame_slot < staging.size()) {
+        staging[frame_slot].pending = false;
+    }
+}
+
+void FrameRecorder::collect(VulkanContext& context, uint32_t frame_slot) {
+    if (frame_slot >= staging.size() || !staging[frame_slot].pending) {
+        return;
+    }
+    GOGGLES_PROFILE_FUNCTION();
+    auto& slot = staging[frame_slot];
+    slot.pending = false;
+    if (!recorder) {
+        return;
+    }
+
+    // Under the `block` policy this is where a slow encoder pushes back on rendering.
+    auto* frame = recorder->acquire_frame();
+    if (!frame) {
+        return;
+    }
+    if (!slot.allocation.coherent) {
+        vk::MappedMemoryRange range{};
+        range.memory = slot.allocation.memory;
+        range.offset = slot.allocation.offset;
+        range.size = slot.allocation.size;
+        auto invalidate_result = context.device.invalidateMappedMemoryRanges(range);
+        if (invalidate_result != vk::Result::eSuccess) {
+            GOGGLES_LOG_WARN("invalidateMappedMemoryRanges failed: {}",
+                             vk::to_string(invalidate_result));
+        }
+    }
+    std::memcpy(frame->rgba.data(), slot.allocation.mapped, frame->rgba.size());
+    frame->timestamp_ns = slot.timestamp_ns;
+    frame->source_frame_number = slot.source_frame_number;
+    recorder->submit_frame(frame);
+}
+
+void FrameRecorder::destroy(VulkanContext& context) {
+    auto& device = context.device;
+    for (auto& slot : staging) {
+        if (device && slot.buffer) {
+            device.destroyBuffer(slot.buffer);
+        }
+        context.allocator.free(device, slot.allocation);
+        slot = Staging{};
+    }
+    extent = vk::Extent2D{};
+}
+
+} // namespace goggles::render::backend_internal
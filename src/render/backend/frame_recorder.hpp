@@ -0,0 +1,50 @@
+#pragma once
+
+#include "gpu_allocator.hpp"
+#include "render_output.hpp"
+#include "vulkan_context.hpp"
+
+#include <array>
+#include <cstdint>
+#include <goggles/error.hpp>
+#include <util/video_recorder.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace goggles::render::backend_internal {
+
+/// @brief GPU side of the headless recorder.
+///
+/// Each recorded frame is copied into its frame slot's host-visible staging buffer inside the
+/// frame's own command buffer. `collect()` runs once that slot's fence has been waited and moves
+/// the pixels into a `util::VideoRecorder` pool buffer for the encoder thread, so the render
+/// thread never waits on the GPU for a readback.
+struct FrameRecorder {
+    struct Staging {
+        vk::Buffer buffer;
+        GpuAllocation allocation;
+        bool pending = false;
+        uint64_t timestamp_ns = 0;
+        uint64_t source_frame_number = 0;
+    };
+
+    [[nodiscard]] auto active() const -> bool { return recorder != nullptr; }
+    /// Creates the staging buffers for `extent`, which must match the recorder's size.
+    [[nodiscard]] auto ensure(VulkanContext& context, vk::Extent2D extent) -> Result<void>;
+    /// Records the copy of `source` (in `eTransferSrcOptimal`) into `frame_slot`'s staging.
+    void record_copy(vk::CommandBuffer cmd, vk::Image source, uint32_t frame_slot);
+    /// Forgets the copy recorded into `frame_slot` for a submission that failed.
+    void discard(uint32_t frame_slot);
+    /// Hands `frame_slot`'s finished copy to the recorder; call after its fence was waited.
+    void collect(VulkanContext& context, uint32_t frame_slot);
+    void destroy(VulkanContext& context);
+
+    util::VideoRecorder* recorder = nullptr;
+    /// Commit time and number of the source frame being rendered, stamped on its copy.
+    uint64_t timestamp_ns = 0;
+    uint64_t source_frame_number = 0;
+
+    std::array<Staging, RenderOutput::MAX_FRAMES_IN_FLIGHT> staging{};
+    vk::Extent2D extent;
+};
+
+} // namespace goggles::render::backend_internal
@@ -0,0 +1,410 @@
+#include "gpu_allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <string>
+#include <util/logging.hpp>
+
+namespace goggles::render::backend_internal {
+
+namespace {
+
+auto align_up(vk::DeviceSize value, vk::DeviceSize alignment) -> vk::DeviceSize {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+auto map_whole(vk::Device device, vk::DeviceMemory memory, vk::MemoryPropertyFlags flags)
+    -> Result<void*> {
+    if (!(flags & vk::MemoryPropertyFlagBits::eHostVisible)) {
+        return nullptr;
+    }
+    auto [map_result, mapped] = device.mapMemory(memory, 0, VK_WHOLE_SIZE);
+    if (map_result != vk::Result::eSuccess) {
+        return make_error<void*>(ErrorCode::vulkan_init_failed,
+                                 "Failed to map device memory: " + vk::to_string(map_result));
+    }
+    return mapped;
+}
+
+auto allocate_device_memory(vk::Device device, vk::DeviceSize size, uint32_t memory_type,
+                            vk::Image dedicated_image, vk::Buffer dedicated_buffer)
+    -> Result<vk::DeviceMemory> {
+    vk::MemoryDedicatedAllocateInfo dedicated_info{};
+    dedicated_info.image = dedicated_image;
+    dedicated_info.buffer = dedicated_buffer;
+
+    vk::MemoryAllocateInfo alloc_info{};
+    alloc_info.allocationSize = size;
+    alloc_info.memoryTypeIndex = memory_type;
+    if (dedicated_image || dedicated_buffer) {
+        alloc_info.pNext = &dedicated_info;
+    }
+
+    auto [alloc_result, memory] = device.allocateMemory(alloc_info);
+    if (alloc_result != vk::Result::eSuccess) {
+        return make_error<vk::DeviceMemory>(ErrorCode::vulkan_init_failed,
+                                            "Failed to allocate device memory: " +
+                                                vk::to_string(alloc_result));
+    }
+    return memory;
+}
+
+struct AllocationRequest {
+    vk::MemoryRequirements requirements;
+    bool dedicated = false;
+    vk::Image image;
+    vk::Buffer buffer;
+    GpuAllocator::ResourceKind kind = GpuAllocator::ResourceKind::buffer;
+    vk::MemoryPropertyFlags required;
+    vk::MemoryPropertyFlags preferred;
+};
+
+auto allocate_dedicated(GpuAllocator& allocator, vk::Device device,
+                        const AllocationRequest& request, uint32_t memory_type,
+                        vk::DeviceSize size) -> Result<GpuAllocation> {
+    const auto flags = allocator.memory_properties.memoryTypes[memory_type].propertyFlags;
+    auto memory = GOGGLES_TRY(
+        allocate_device_memory(device, size, memory_type, request.image, request.buffer));
+    auto mapped = map_whole(device, memory, flags);
+    if (!mapped) {
+        device.freeMemory(memory);
+        return nonstd::make_unexpected(mapped.error());
+    }
+
+    ++allocator.dedicated_count;
+    allocator.dedicated_bytes += size;
+    allocator.used_bytes += size;
+    return GpuAllocation{
+        .memory = memory,
+        .offset = 0,
+        .size = size,
+        .mapped = *mapped,
+        .memory_type = memory_type,
+        .coherent = static_cast<bool>(flags & vk::MemoryPropertyFlagBits::eHostCoherent),
+        .dedicated = true,
+    };
+}
+
+auto allocate(GpuAllocator& allocator, vk::Device device, const AllocationRequest& request)
+    -> Result<GpuAllocation> {
+    const auto memory_type =
+        select_memory_type(allocator.memory_properties, request.requirements.memoryTypeBits,
+                           request.required, request.preferred);
+    if (!memory_type) {
+        return make_error<GpuAllocation>(ErrorCode::vulkan_init_failed,
+                                         "No memory type with properties " +
+                                             vk::to_string(request.required));
+    }
+
+    const auto flags = allocator.memory_properties.memoryTypes[*memory_type].propertyFlags;
+    const bool coherent = static_cast<bool>(flags & vk::MemoryPropertyFlagBits::eHostCoherent);
+    vk::DeviceSize size = request.requirements.size;
+    vk::DeviceSize alignment = std::max<vk::DeviceSize>(request.requirements.alignment, 1);
+    if ((flags & vk::MemoryPropertyFlagBits::eHostVisible) && !coherent) {
+        // Flush/invalidate ranges must cover whole atoms without touching a neighbour.
+        alignment = std::max(alignment, allocator.non_coherent_atom_size);
+        size = align_up(size, allocator.non_coherent_atom_size);
+    }
+
+    const auto block_size = allocator.block_size_for(*memory_type);
+    if (request.dedicated || size > block_size / 2) {
+        return allocate_dedicated(allocator, device, request, *memory_type, size);
+    }
+
+    auto pool_it = std::ranges::find_if(allocator.pools, [&](const GpuAllocator::Pool& pool) {
+        return pool.memory_type == *memory_type && pool.kind == request.kind;
+    });
+    if (pool_it == allocator.pools.end()) {
+        allocator.pools.push_back(
+            {.memory_type = *memory_type, .kind = request.kind, .blocks = {}});
+        pool_it = std::prev(allocator.pools.end());
+    }
+
+    const auto sub_allocation = [&](GpuAllocator::Block& block,
+                                    vk::DeviceSize offset) -> GpuAllocation {
+        allocator.used_bytes += size;
+        return GpuAllocation{
+            .memory = block.memory,
+            .offset = offset,
+            .size = size,
+            .mapped = block.mapped != nullptr ? static_cast<char*>(block.mapped) + offset
+                                              : nullptr,
+            .memory_type = *memory_type,
+            .coherent = coherent,
+            .dedicated = false,
+        };
+    };
+
+    for (auto& block : pool_it->blocks) {
+        if (auto offset = block.free_ranges.allocate(size, alignment)) {
+            return sub_allocation(block, *offset);
+        }
+    }
+
+    auto memory = allocate_device_memory(device, block_size, *memory_type, nullptr, nullptr);
+    if (!memory) {
+        // A fresh block may not fit a nearly exhausted heap while the resource itself still does.
+        GOGGLES_LOG_DEBUG("Block allocation failed ({}), falling back to dedicated memory",
+                          memory.error().message);
+        return allocate_dedicated(allocator, device, request, *memory_type, size);
+    }
+    auto mapped = map_whole(device, *memory, flags);
+    if (!mapped) {
+        device.freeMemory(*memory);
+        return nonstd::make_unexpected(mapped.error());
+    }
+
+    GpuAllocator::Block block{};
+    block.memory = *memory;
+    block.size = block_size;
+    block.mapped = *mapped;
+    block.free_ranges.reset(block_size);
+    auto& new_block = pool_it->blocks.emplace_back(std::move(block));
+    GOGGLES_LOG_DEBUG("GPU allocator: new {} MiB block (memory type {})",
+                      block_size / (1024 * 1024), *memory_type);
+
+    auto offset = new_block.free_ranges.allocate(size, alignment);
+    return sub_allocation(new_block, offset.value_or(0));
+}
+
+} // namespace
+
+auto select_memory_type(const vk::PhysicalDeviceMemoryProperties& mem_props, uint32_t type_bits,
+                        vk::MemoryPropertyFlags required, vk::MemoryPropertyFlags preferred)
+    -> std::optional<uint32_t> {
+    std::optional<uint32_t> best;
+    int best_score = -1;
+    for (uint32_t i = 0; i < mem_props.memoryTypeCount; ++i) {
+        const auto flags = mem_props.memoryTypes[i].propertyFlags;
+        if (!(type_bits & (1U << i)) || (flags & required) != required) {
+            continue;
+        }
+        const int score =
+            std::popcount(static_cast<VkMemoryPropertyFlags>(flags & preferred));
+        if (score > best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+void FreeRangeList::reset(vk::DeviceSize capacity) {
+    ranges.assign(1, Range{.offset = 0, .size = capacity});
+}
+
+auto FreeRangeList::allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+    -> std::optional<vk::DeviceSize> {
+    alignment = std::max<vk::DeviceSize>(alignment, 1);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        auto& range = ranges[i];
+        const auto aligned = align_up(range.offset, alignment);
+        const auto padding = aligned - range.offset;
+        if (range.size < padding + size) {
+            continue;
+        }
+
+        const Range tail{.offset = aligned + size, .size = range.size - padding - size};
+        if (padding > 0) {
+            range.size = padding;
+            if (tail.size > 0) {
+                ranges.insert(ranges.begin() + static_cast<std::ptrdiff_t>(i) + 1, tail);
+            }
+        } else if (tail.size > 0) {
+            range = tail;
+        } else {
+            ranges.erase(ranges.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        return aligned;
+    }
+    return std::nullopt;
+}
+
+void FreeRangeList::release(vk::DeviceSize offset, vk::DeviceSize size) {
+    auto it = std::ranges::lower_bound(ranges, offset, {}, &Range::offset);
+    it = ranges.insert(it, Range{.offset = offset, .size = size});
+
+    const auto next = std::next(it);
+    if (next != ranges.end() && it->offset + it->size == next->offset) {
+        it->size += next->size;
+        ranges.erase(next);
+    }
+    if (it != ranges.begin()) {
+        const auto prev = std::prev(it);
+        if (prev->offset + prev->size == it->offset) {
+            prev->size += it->size;
+            ranges.erase(it);
+        }
+    }
+}
+
+auto FreeRangeList::free_bytes() const -> vk::DeviceSize {
+    vk::DeviceSize total = 0;
+    for (const auto& range : ranges) {
+        total += range.size;
+    }
+    return total;
+}
+
+void GpuAllocator::init(vk::PhysicalDevice device, bool budget_supported) {
+    physical_device = device;
+    memory_properties = device.getMemoryProperties();
+    non_coherent_atom_size =
+        std::max<vk::DeviceSize>(device.getProperties().limits.nonCoherentAtomSize, 1);
+    memory_budget_supported = budget_supported;
+}
+
+void GpuAllocator::destroy(vk::Device device) {
+    if (used_bytes > 0) {
+        GOGGLES_LOG_WARN("GPU allocator destroyed with {} bytes still allocated", used_bytes);
+    }
+    if (device) {
+        for (auto& pool : pools) {
+            for (auto& block : pool.blocks) {
+                device.freeMemory(block.memory);
+            }
+        }
+    }
+    pools.clear();
+    used_bytes = 0;
+    dedicated_bytes = 0;
+    dedicated_count = 0;
+    physical_device = nullptr;
+    memory_budget_supported = false;
+}
+
+auto GpuAllocator::allocate_image(vk::Device device, vk::Image image,
+                                  vk::MemoryPropertyFlags required,
+                                  vk::MemoryPropertyFlags preferred) -> Result<GpuAllocation> {
+    vk::ImageMemoryRequirementsInfo2 reqs_info{};
+    reqs_info.image = image;
+    vk::MemoryDedicatedRequirements dedicated_reqs{};
+    vk::MemoryRequirements2 reqs2{};
+    reqs2.pNext = &dedicated_reqs;
+    device.getImageMemoryRequirements2(&reqs_info, &reqs2);
+
+    auto allocation =
+        GOGGLES_TRY(allocate(*this, device,
+                             {.requirements = reqs2.memoryRequirements,
+                              .dedicated = dedicated_reqs.requiresDedicatedAllocation ||
+                                           dedicated_reqs.prefersDedicatedAllocation,
+                              .image = image,
+                              .buffer = nullptr,
+                              .kind = ResourceKind::optimal_image,
+                              .required = required,
+                              .preferred = preferred}));
+    auto bind_result = device.bindImageMemory(image, allocation.memory, allocation.offset);
+    if (bind_result != vk::Result::eSuccess) {
+        free(device, allocation);
+        return make_error<GpuAllocation>(ErrorCode::vulkan_init_failed,
+                                         "Failed to bind image memory: " +
+                                             vk::to_string(bind_result));
+    }
+    return allocation;
+}
+
+auto GpuAllocator::allocate_buffer(vk::Device device, vk::Buffer buffer,
+                                   vk::MemoryPropertyFlags required,
+                                   vk::MemoryPropertyFlags preferred) -> Result<GpuAllocation> {
+    vk::BufferMemoryRequirementsInfo2 reqs_info{};
+    reqs_info.buffer = buffer;
+    vk::MemoryDedicatedRequirements dedicated_reqs{};
+    vk::MemoryRequirements2 reqs2{};
+    reqs2.pNext = &dedicated_reqs;
+    device.getBufferMemoryRequirements2(&reqs_info, &reqs2);
+
+    auto allocation =
+        GOGGLES_TRY(allocate(*this, device,
+                             {.requirements = reqs2.memoryRequirements,
+                              .dedicated = dedicated_reqs.requiresDedicatedAllocation ||
+                                           dedicated_reqs.prefersDedicatedAllocation,
+                              .image = nullptr,
+                              .buffer = buffer,
+                              .kind = ResourceKind::buffer,
+                              .required = required,
+                              .preferred = preferred}));
+    auto bind_result = device.bindBufferMemory(buffer, allocation.memory, allocation.offset);
+    if (bind_result != vk::Result::eSuccess) {
+        free(device, allocation);
+        return make_error<GpuAllocation>(ErrorCode::vulkan_init_failed,
+                                         "Failed to bind buffer memory: " +
+                                             vk::to_string(bind_result));
+    }
+    return allocation;
+}
+
+void GpuAllocator::free(vk::Device device, GpuAllocation& allocation) {
+    if (!allocation) {
+        return;
+    }
+    used_bytes -= allocation.size;
+
+    if (allocation.dedicated) {
+        device.freeMemory(allocation.memory);
+        --dedicated_count;
+        dedicated_bytes -= allocation.size;
+        allocation = {};
+        return;
+    }
+
+    for (auto& pool : pools) {
+        auto block_it = std::ranges::find(pool.blocks, allocation.memory, &Block::memory);
+        if (block_it == pool.blocks.end()) {
+            continue;
+        }
+        block_it->free_ranges.release(allocation.offset, allocation.size);
+        // Keep one empty block per pool so the next resize reuses it; free any others.
+        if (block_it->free_ranges.is_empty(block_it->size) &&
+            std::ranges::count_if(pool.blocks, [](const Block& block) {
+                return block.free_ranges.is_empty(block.size);
+            }) > 1) {
+            device.freeMemory(block_it->memory);
+            pool.blocks.erase(block_it);
+        }
+        break;
+    }
+    allocation = {};
+}
+
+auto GpuAllocator::snapshot() const -> util::GpuMemorySnapshot {
+    util::GpuMemorySnapshot snapshot{};
+    snapshot.used_bytes = used_bytes;
+    snapshot.allocated_bytes = dedicated_bytes;
+    snapshot.dedicated_count = dedicated_count;
+    for (const auto& pool : pools) {
+        for (const auto& block : pool.blocks) {
+            snapshot.allocated_bytes += block.size;
+            ++snapshot.block_count;
+        }
+    }
+
+    snapshot.heap_count =
+        std::min<std::size_t>(memory_properties.memoryHeapCount, snapshot.heaps.size());
+    for (std::size_t i = 0; i < snapshot.heap_count; ++i) {
+        snapshot.heaps[i].size_bytes = memory_properties.memoryHeaps[i].size;
+        snapshot.heaps[i].device_local = static_cast<bool>(
+            memory_properties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+    }
+
+    if (memory_budget_supported && physical_device) {
+        vk::PhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+        vk::PhysicalDeviceMemoryProperties2 props2{};
+        props2.pNext = &budget;
+        physical_device.getMemoryProperties2(&props2);
+        for (std::size_t i = 0; i < snapshot.heap_count; ++i) {
+            snapshot.heaps[i].budget_bytes = budget.heapBudget[i];
+            snapshot.heaps[i].usage_bytes = budget.heapUsage[i];
+        }
+        snapshot.budget_available = true;
+    }
+    return snapshot;
+}
+
+auto GpuAllocator::block_size_for(uint32_t memory_type) const -> vk::DeviceSize {
+    const auto heap_index = memory_properties.memoryTypes[memory_type].heapIndex;
+    const auto heap_size = memory_properties.memoryHeaps[heap_index].size;
+    return std::clamp<vk::DeviceSize>(heap_size / 8, 1, DEFAULT_BLOCK_SIZE);
+}
+
+} // namespace goggles::render::backend_internal
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <goggles/error.hpp>
+#include <optional>
+#include <util/runtime_metrics.hpp>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace goggles::render::backend_internal {
+
+/// @brief Picks the memory type allowed by `type_bits` that has every `required` flag and the
+/// most `preferred` ones; ties go to the lowest index, matching the driver's ordering.
+[[nodiscard]] auto select_memory_type(const vk::PhysicalDeviceMemoryProperties& mem_props,
+                                      uint32_t type_bits, vk::MemoryPropertyFlags required,
+                                      vk::MemoryPropertyFlags preferred)
+    -> std::optional<uint32_t>;
+
+/// @brief Sorted, coalescing free list of one memory block.
+struct FreeRangeList {
+    struct Range {
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+    };
+
+    void reset(vk::DeviceSize capacity);
+    /// First fit; alignment padding stays in the free list. Returns the aligned offset.
+    [[nodiscard]] auto allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+        -> std::optional<vk::DeviceSize>;
+    void release(vk::DeviceSize offset, vk::DeviceSize size);
+    [[nodiscard]] auto free_bytes() const -> vk::DeviceSize;
+    [[nodiscard]] auto is_empty(vk::DeviceSize capacity) const -> bool {
+        return ranges.size() == 1 && ranges.front().offset == 0 &&
+               ranges.front().size == capacity;
+    }
+
+    std::vector<Range> ranges;
+};
+
+/// @brief Memory bound to one backend-owned image or buffer.
+struct GpuAllocation {
+    vk::DeviceMemory memory;
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize size = 0;
+    /// Host pointer at `offset` when the memory type is host-visible; blocks stay mapped.
+    void* mapped = nullptr;
+    uint32_t memory_type = UINT32_MAX;
+    bool coherent = false;
+    bool dedicated = false;
+
+    explicit operator bool() const { return static_cast<bool>(memory); }
+};
+
+/// @brief Sub-allocates backend images and buffers out of large per-memory-type blocks.
+///
+/// Buffers and optimal-tiling images draw from separate pools, so `bufferImageGranularity`
+/// never applies inside a block. One empty block per pool is kept after frees, so resize churn
+/// reuses memory instead of returning it to the driver. Resources the driver asks to be
+/// dedicated, or larger than half a block, get their own `vkAllocateMemory`.
+struct GpuAllocator {
+    static constexpr vk::DeviceSize DEFAULT_BLOCK_SIZE = 64ULL * 1024 * 1024;
+
+    enum class ResourceKind : std::uint8_t {
+        buffer,
+        optimal_image,
+    };
+
+    struct Block {
+        vk::DeviceMemory memory;
+        vk::DeviceSize size = 0;
+        void* mapped = nullptr;
+        FreeRangeList free_ranges;
+    };
+
+    struct Pool {
+        uint32_t memory_type = UINT32_MAX;
+        ResourceKind kind = ResourceKind::buffer;
+        std::vector<Block> blocks;
+    };
+
+    void init(vk::PhysicalDevice physical_device, bool memory_budget_supported);
+    /// Frees every block. All allocations must already be released.
+    void destroy(vk::Device device);
+
+    /// Allocates and binds memory for `image` (optimal tiling).
+    [[nodiscard]] auto allocate_image(vk::Device device, vk::Image image,
+                                      vk::MemoryPropertyFlags required,
+                                      vk::MemoryPropertyFlags preferred = {})
+        -> Result<GpuAllocation>;
+    /// Allocates and binds memory for `buffer`; host-visible memory comes back mapped.
+    [[nodiscard]] auto allocate_buffer(vk::Device device, vk::Buffer buffer,
+                                       vk::MemoryPropertyFlags required,
+                                       vk::MemoryPropertyFlags preferred = {})
+        -> Result<GpuAllocation>;
+    /// Returns `allocation` to its block (or frees its dedicated memory) and clears it.
+    void free(vk::Device device, GpuAllocation& allocation);
+
+    /// Allocator usage plus the driver's per-heap budget when `VK_EXT_memory_budget` is on.
+    [[nodiscard]] auto snapshot() const -> util::GpuMemorySnapshot;
+    /// Smaller than `DEFAULT_BLOCK_SIZE` on small heaps so one block never dominates a heap.
+    [[nodiscard]] auto block_size_for(uint32_t memory_type) const -> vk::DeviceSize;
+
+    vk::PhysicalDevice physical_device;
+    vk::PhysicalDeviceMemoryProperties memory_properties;
+    vk::DeviceSize non_coherent_atom_size = 1;
+    std::vector<Pool> pools;
+    vk::DeviceSize used_bytes = 0;
+    vk::DeviceSize dedicated_bytes = 0;
+    uint32_t dedicated_count = 0;
+    bool memory_budget_supported = false;
+};
+
+} // namespace goggles::render::backend_internal
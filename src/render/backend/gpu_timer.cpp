@@ -0,0 +1,202 @@
+#include "gpu_timer.hpp"
+
+#include <algorithm>
+#include <goggles/profiling.hpp>
+#include <util/logging.hpp>
+#include <util/metrics.hpp>
+
+#ifdef TRACY_ENABLE
+#include <string_view>
+#include <tracy/Tracy.hpp>
+#include <tracy/TracyC.h>
+#endif
+
+namespace goggles::render::backend_internal {
+
+namespace {
+
+auto ticks_to_ms(uint64_t begin, uint64_t end, float period_ns) -> float {
+    if (end <= begin) {
+        return 0.0F;
+    }
+    return static_cast<float>(static_cast<double>(end - begin) * period_ns / 1'000'000.0);
+}
+
+void push_frame_history(util::GpuTimingSnapshot& timings, float frame_ms) {
+    auto& history = timings.frame_history_ms;
+    if (timings.frame_history_count < history.size()) {
+        history[timings.frame_history_count++] = frame_ms;
+        return;
+    }
+    std::rotate(history.begin(), history.begin() + 1, history.end());
+    history.back() = frame_ms;
+}
+
+#ifdef TRACY_ENABLE
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+const std::array<___tracy_source_location_data, GpuTimer::ZONE_COUNT> K_TRACY_ZONES = {{
+    {"Import barrier", "VulkanBackend::render", __FILE__, __LINE__, 0},
+    {"Frame interpolation", "VulkanBackend::render", __FILE__, __LINE__, 0},
+    {"Filter chain", "VulkanBackend::render", __FILE__, __LINE__, 0},
+    {"UI overlay", "VulkanBackend::render", __FILE__, __LINE__, 0},
+}};
+
+void emit_tracy_zones(GpuTimer& timer, const std::array<uint64_t, GpuTimer::QUERY_COUNT>& ticks) {
+    if (!timer.tracy_context_created) {
+        // Anchored at the first resolved frame; the offset is at most a couple of frames.
+        timer.tracy_context = tracy::GetGpuCtxCounter().fetch_add(1, std::memory_order_relaxed);
+        ___tracy_emit_gpu_new_context_serial({
+            .gpuTime = static_cast<int64_t>(ticks[0]),
+            .period = timer.timestamp_period_ns,
+            .context = timer.tracy_context,
+            .flags = 0,
+            .type = static_cast<uint8_t>(tracy::GpuContextType::Vulkan),
+        });
+        constexpr std::string_view CONTEXT_NAME = "Goggles graphics queue";
+        ___tracy_emit_gpu_context_name_serial({
+            .context = timer.tracy_context,
+            .name = CONTEXT_NAME.data(),
+            .len = static_cast<uint16_t>(CONTEXT_NAME.size()),
+        });
+        timer.tracy_context_created = true;
+    }
+
+    for (uint32_t zone = 0; zone < GpuTimer::ZONE_COUNT; ++zone) {
+        const uint16_t begin_id = timer.tracy_query_id++;
+        const uint16_t end_id = timer.tracy_query_id++;
+        ___tracy_emit_gpu_zone_begin_serial({
+            .srcloc = reinterpret_cast<uint64_t>(&K_TRACY_ZONES[zone]),
+            .queryId = begin_id,
+            .context = timer.tracy_context,
+        });
+        ___tracy_emit_gpu_time_serial({
+            .gpuTime = static_cast<int64_t>(ticks[zone]),
+            .queryId = begin_id,
+            .context = timer.tracy_context,
+        });
+        ___tracy_emit_gpu_zone_end_serial({.queryId = end_id, .context = timer.tracy_context});
+        ___tracy_emit_gpu_time_serial({
+            .gpuTime = static_cast<int64_t>(ticks[zone + 1]),
+            .queryId = end_id,
+            .context = timer.tracy_context,
+        });
+    }
+}
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+#endif
+
+} // namespace
+
+auto GpuTimer::create(VulkanContext& context) -> Result<void> {
+    GOGGLES_PROFILE_FUNCTION();
+
+    const auto queue_families = context.physical_device.getQueueFamilyProperties();
+    const auto family = context.graphics_queue_family;
+    const uint32_t valid_bits =
+        family < queue_families.size() ? queue_families[family].timestampValidBits : 0u;
+    if (valid_bits == 0) {
+        GOGGLES_LOG_INFO("Graphics queue has no timestamp support, GPU timing disabled");
+        return {};
+    }
+
+    timestamp_mask = valid_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << valid_bits) - 1;
+    timestamp_period_ns = context.physical_device.getProperties().limits.timestampPeriod;
+
+    vk::QueryPoolCreateInfo pool_info{};
+    pool_info.queryType = vk::QueryType::eTimestamp;
+    pool_info.queryCount = QUERY_COUNT;
+
+    for (auto& frame : frames) {
+        auto [result, pool] = context.device.createQueryPool(pool_info);
+        if (result != vk::Result::eSuccess) {
+            destroy(context);
+            return make_error<void>(ErrorCode::vulkan_init_failed,
+                                    "Failed to create timestamp query pool: " +
+                                        vk::to_string(result));
+        }
+        frame.pool = pool;
+    }
+
+    enabled = true;
+    timings.available = true;
+    GOGGLES_LOG_DEBUG("GPU timing enabled: {} valid bits, {} ns/tick", valid_bits,
+                      timestamp_period_ns);
+    return {};
+}
+
+void GpuTimer::destroy(VulkanContext& context) {
+    if (context.device) {
+        for (auto& frame : frames) {
+            if (frame.pool) {
+                context.device.destroyQueryPool(frame.pool);
+            }
+        }
+    }
+    frames = {};
+    timings = {};
+    enabled = false;
+}
+
+void GpuTimer::collect(VulkanContext& context, uint32_t frame_slot) {
+    auto& frame = frames[frame_slot];
+    frame.recorded = false;
+    if (!enabled || !frame.pending) {
+        return;
+    }
+    frame.pending = false;
+
+    std::array<uint64_t, QUERY_COUNT> ticks{};
+    auto result = context.device.getQueryPoolResults(frame.pool, 0, QUERY_COUNT, sizeof(ticks),
+                                                     ticks.data(), sizeof(uint64_t),
+                                                     vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess) {
+        // eNotReady only happens if the slot fence was not waited; drop the sample.
+        return;
+    }
+    for (auto& tick : ticks) {
+        tick &= timestamp_mask;
+    }
+
+    const bool first_sample = timings.frame_history_count == 0;
+    for (uint32_t zone = 0; zone < ZONE_COUNT; ++zone) {
+        const float zone_ms = ticks_to_ms(ticks[zone], ticks[zone + 1], timestamp_period_ns);
+        auto& smoothed = timings.zone_ms[zone];
+        smoothed = first_sample ? zone_ms : smoothed + (zone_ms - smoothed) * SMOOTHING;
+    }
+    const float frame_ms = ticks_to_ms(ticks[0], ticks[ZONE_COUNT], timestamp_period_ns);
+    timings.frame_ms =
+        first_sample ? frame_ms : timings.frame_ms + (frame_ms - timings.frame_ms) * SMOOTHING;
+    push_frame_history(timings, frame_ms);
+    util::Metrics::observe(util::MetricHistogram::gpu_frame_time_seconds, frame_ms / 1000.0);
+
+#ifdef TRACY_ENABLE
+    emit_tracy_zones(*this, ticks);
+#endif
+}
+
+void GpuTimer::begin_frame(vk::CommandBuffer cmd, uint32_t frame_slot) {
+    if (!enabled) {
+        return;
+    }
+    auto& frame = frames[frame_slot];
+    cmd.resetQueryPool(frame.pool, 0, QUERY_COUNT);
+    cmd.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, frame.pool, 0);
+    frame.recorded = true;
+}
+
+void GpuTimer::end_zone(vk::CommandBuffer cmd, uint32_t frame_slot, util::GpuTimingZone zone) {
+    auto& frame = frames[frame_slot];
+    if (!frame.recorded) {
+        return;
+    }
+    cmd.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, frame.pool,
+                       static_cast<uint32_t>(zone) + 1);
+}
+
+void GpuTimer::mark_submitted(uint32_t frame_slot) {
+    auto& frame = frames[frame_slot];
+    frame.pending = frame.recorded;
+    frame.recorded = false;
+}
+
+} // namespace goggles::render::backend_internal
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "render_output.hpp"
+#include "vulkan_context.hpp"
+
+#include <array>
+#include <cstdint>
+#include <goggles/error.hpp>
+#include <util/runtime_metrics.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace goggles::render::backend_internal {
+
+/// @brief Timestamp queries around the backend-recorded segments of each frame.
+///
+/// Each frame slot owns a query pool. Results are read without waiting when the slot comes
+/// around again (after its in-flight fence), so they trail the presented frame by
+/// `MAX_FRAMES_IN_FLIGHT` frames. The filter chain records all of its stages through one call
+/// and is timed as a single zone.
+struct GpuTimer {
+    static constexpr uint32_t ZONE_COUNT = util::GpuTimingSnapshot::K_ZONE_COUNT;
+    static constexpr uint32_t QUERY_COUNT = ZONE_COUNT + 1;
+    static constexpr float SMOOTHING = 0.1F;
+
+    struct FrameQueries {
+        vk::QueryPool pool;
+        bool recorded = false;
+        bool pending = false;
+    };
+
+    [[nodiscard]] auto create(VulkanContext& context) -> Result<void>;
+    void destroy(VulkanContext& context);
+
+    /// Reads back the slot's previous results. Call after the slot's fence has been waited.
+    void collect(VulkanContext& context, uint32_t frame_slot);
+    void begin_frame(vk::CommandBuffer cmd, uint32_t frame_slot);
+    void end_zone(vk::CommandBuffer cmd, uint32_t frame_slot, util::GpuTimingZone zone);
+    void mark_submitted(uint32_t frame_slot);
+
+    [[nodiscard]] auto snapshot() const -> const util::GpuTimingSnapshot& { return timings; }
+
+    std::array<FrameQueries, RenderOutput::MAX_FRAMES_IN_FLIGHT> frames{};
+    util::GpuTimingSnapshot timings;
+    float timestamp_period_ns = 0.0F;
+    uint64_t timestamp_mask = 0;
+    bool enabled = false;
+#ifdef TRACY_ENABLE
+    uint16_t tracy_query_id = 0;
+    uint8_t tracy_context = 0;
+    bool tracy_context_created = false;
+#endif
+};
+
+} // namespace goggles::render::backend_internal
@@ -7,6 +7,7 @@
 #include <stb_image_write.h>
 #include <thread>
 #include <util/logging.hpp>
+#include <util/metrics.hpp>
 
 namespace goggles::render::backend_internal {
 
@@ -14,20 +15,9 @@ namespace {
 
 struct ReadbackStagingBuffer {
     vk::Buffer buffer;
-    vk::DeviceMemory memory;
-    bool is_coherent = false;
+    GpuAllocation allocation;
 };
 
-auto find_memory_type(const vk::PhysicalDeviceMemoryProperties& mem_props, uint32_t type_bits)
-    -> uint32_t {
-    for (uint32_t i = 0; i < mem_props.memoryTypeCount; ++i) {
-        if (type_bits & (1U << i)) {
-            return i;
-        }
-    }
-    return UINT32_MAX;
-}
-
 void destroy_render_finished_semaphores(vk::Device device, RenderOutput& output) {
     if (!device) {
         output.render_finished_sems.clear();
@@ -114,11 +104,12 @@ auto normalize_wait_stage(vk::Semaphore wait_semaphore, vk::PipelineStageFlags w
     return vk::PipelineStageFlagBits::eColorAttachmentOutput;
 }
 
-void destroy_offscreen_target(vk::Device device, RenderOutput& output) {
+void destroy_offscreen_target(VulkanContext& context, RenderOutput& output) {
+    auto& device = context.device;
     if (!device) {
         output.offscreen_view = nullptr;
         output.offscreen_image = nullptr;
-        output.offscreen_memory = nullptr;
+        output.offscreen_allocation = {};
         output.offscreen_extent = vk::Extent2D{};
         return;
     }
@@ -131,15 +122,13 @@ void destroy_offscreen_target(vk::Device device, RenderOutput& output) {
         device.destroyImage(output.offscreen_image);
         output.offscreen_image = nullptr;
     }
-    if (output.offscreen_memory) {
-        device.freeMemory(output.offscreen_memory);
-        output.offscreen_memory = nullptr;
-    }
+    context.allocator.free(device, output.offscreen_allocation);
     output.offscreen_extent = vk::Extent2D{};
 }
 
-auto create_readback_staging_buffer(vk::Device device, vk::PhysicalDevice physical_device,
-                                    vk::DeviceSize size) -> Result<ReadbackStagingBuffer> {
+auto create_readback_staging_buffer(VulkanContext& context, vk::DeviceSize size)
+    -> Result<ReadbackStagingBuffer> {
+    auto& device = context.device;
     vk::BufferCreateInfo buffer_info{};
     buffer_info.size = size;
     buffer_info.usage = vk::BufferUsageFlagBits::eTransferDst;
@@ -152,73 +141,29 @@ auto create_readback_staging_buffer(vk::Device device, vk::PhysicalDevice physic
                                                      vk::to_string(buffer_result));
     }
 
-    auto buffer_requirements = device.getBufferMemoryRequirements(buffer);
-    auto mem_props = physical_device.getMemoryProperties();
-    uint32_t staging_mem_type = UINT32_MAX;
-    for (uint32_t i = 0; i < mem_props.memoryTypeCount; ++i) {
-        if ((buffer_requirements.memoryTypeBits & (1U << i)) &&
-            (mem_props.memoryTypes[i].propertyFlags &
-             (vk::MemoryPropertyFlagBits::eHostVisible |
-              vk::MemoryPropertyFlagBits::eHostCoherent)) ==
-                (vk::MemoryPropertyFlagBits::eHostVisible |
-                 vk::MemoryPropertyFlagBits::eHostCoherent)) {
-            staging_mem_type = i;
-            break;
-        }
-    }
-    if (staging_mem_type == UINT32_MAX) {
-        for (uint32_t i = 0; i < mem_props.memoryTypeCount; ++i) {
-            if ((buffer_requirements.memoryTypeBits & (1U << i)) &&
-                (mem_props.memoryTypes[i].propertyFlags &
-                 vk::MemoryPropertyFlagBits::eHostVisible)) {
-                staging_mem_type = i;
-                break;
-            }
-        }
-    }
-    if (staging_mem_type == UINT32_MAX) {
+    // Cached memory makes the CPU-side PNG encode read at full speed.
+    auto allocation = context.allocator.allocate_buffer(
+        device, buffer, vk::MemoryPropertyFlagBits::eHostVisible,
+        vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostCached);
+    if (!allocation) {
         device.destroyBuffer(buffer);
-        return make_error<ReadbackStagingBuffer>(ErrorCode::vulkan_init_failed,
-                                                 "No host-visible memory type for staging buffer");
-    }
-
-    vk::MemoryAllocateInfo staging_alloc{};
-    staging_alloc.allocationSize = buffer_requirements.size;
-    staging_alloc.memoryTypeIndex = staging_mem_type;
-    auto [alloc_result, memory] = device.allocateMemory(staging_alloc);
-    if (alloc_result != vk::Result::eSuccess) {
-        device.destroyBuffer(buffer);
-        return make_error<ReadbackStagingBuffer>(ErrorCode::vulkan_init_failed,
-                                                 "Failed to allocate staging memory: " +
-                                                     vk::to_string(alloc_result));
-    }
-
-    auto bind_result = device.bindBufferMemory(buffer, memory, 0);
-    if (bind_result != vk::Result::eSuccess) {
-        device.freeMemory(memory);
-        device.destroyBuffer(buffer);
-        return make_error<ReadbackStagingBuffer>(ErrorCode::vulkan_init_failed,
-                                                 "Failed to bind staging buffer memory: " +
-                                                     vk::to_string(bind_result));
+        return make_error<ReadbackStagingBuffer>(allocation.error().code,
+                                                 "Staging buffer: " + allocation.error().message,
+                                                 allocation.error().location);
     }
 
     ReadbackStagingBuffer staging{};
     staging.buffer = buffer;
-    staging.memory = memory;
-    staging.is_coherent = (mem_props.memoryTypes[staging_mem_type].propertyFlags &
-                           vk::MemoryPropertyFlagBits::eHostCoherent) != vk::MemoryPropertyFlags{};
+    staging.allocation = *allocation;
     return staging;
 }
 
-void destroy_readback_staging_buffer(vk::Device device, ReadbackStagingBuffer& staging) {
-    if (staging.memory) {
-        device.freeMemory(staging.memory);
-        staging.memory = nullptr;
-    }
+void destroy_readback_staging_buffer(VulkanContext& context, ReadbackStagingBuffer& staging) {
     if (staging.buffer) {
-        device.destroyBuffer(staging.buffer);
+        context.device.destroyBuffer(staging.buffer);
         staging.buffer = nullptr;
     }
+    context.allocator.free(context.device, staging.allocation);
 }
 
 auto submit_readback_copy(vk::Device device, vk::Queue queue, vk::CommandBuffer cmd,
@@ -297,37 +242,207 @@ auto submit_readback_copy(vk::Device device, vk::Queue queue, vk::CommandBuffer
     return {};
 }
 
-auto apply_present_wait(VulkanContext& context, RenderOutput& output, uint64_t present_value)
-    -> Result<void> {
+auto record_and_submit_transfer_readback(VulkanContext& context, vk::CommandBuffer graphics_cmd,
+                                         vk::CommandPool transfer_pool,
+                                         vk::Semaphore released_sem, vk::Fence fence,
+                                         vk::Image source, vk::Buffer dest, uint32_t width,
+                                         uint32_t height, bool& submitted) -> Result<void> {
+    auto& device = context.device;
+
+    vk::CommandBufferAllocateInfo alloc_info{};
+    alloc_info.commandPool = transfer_pool;
+    alloc_info.level = vk::CommandBufferLevel::ePrimary;
+    alloc_info.commandBufferCount = 1;
+    auto [alloc_result, transfer_cmds] = device.allocateCommandBuffers(alloc_info);
+    VK_TRY(alloc_result, ErrorCode::vulkan_init_failed,
+           "Failed to allocate transfer command buffer");
+    vk::CommandBuffer transfer_cmd = transfer_cmds[0];
+
+    vk::ImageMemoryBarrier ownership{};
+    ownership.oldLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    ownership.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+    ownership.srcQueueFamilyIndex = context.graphics_queue_family;
+    ownership.dstQueueFamilyIndex = context.transfer_queue_family;
+    ownership.image = source;
+    ownership.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    ownership.subresourceRange.levelCount = 1;
+    ownership.subresourceRange.layerCount = 1;
+
+    vk::CommandBufferBeginInfo begin_info{};
+    begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+
+    VK_TRY(graphics_cmd.reset(), ErrorCode::vulkan_device_lost, "Command buffer reset failed");
+    VK_TRY(graphics_cmd.begin(begin_info), ErrorCode::vulkan_device_lost,
+           "Command buffer begin failed");
+    vk::ImageMemoryBarrier release = ownership;
+    release.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    graphics_cmd.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                                 vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, release);
+    VK_TRY(graphics_cmd.end(), ErrorCode::vulkan_device_lost, "Command buffer end failed");
+
+    VK_TRY(transfer_cmd.begin(begin_info), ErrorCode::vulkan_device_lost,
+           "Transfer command buffer begin failed");
+    vk::ImageMemoryBarrier acquire = ownership;
+    acquire.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+    transfer_cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                 vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, acquire);
+
+    vk::BufferImageCopy region{};
+    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = vk::Extent3D{width, height, 1};
+    transfer_cmd.copyImageToBuffer(source, vk::ImageLayout::eTransferSrcOptimal, dest, region);
+    VK_TRY(transfer_cmd.end(), ErrorCode::vulkan_device_lost,
+           "Transfer command buffer end failed");
+
+    VK_TRY(device.resetFences(fence), ErrorCode::vulkan_device_lost, "Fence reset failed");
+
+    vk::SubmitInfo release_submit{};
+    release_submit.commandBufferCount = 1;
+    release_submit.pCommandBuffers = &graphics_cmd;
+    release_submit.signalSemaphoreCount = 1;
+    release_submit.pSignalSemaphores = &released_sem;
+    VK_TRY(context.graphics_queue.submit(release_submit), ErrorCode::vulkan_device_lost,
+           "Queue submit failed");
+    submitted = true;
+
+    const vk::PipelineStageFlags wait_stage = vk::PipelineStageFlagBits::eTransfer;
+    vk::SubmitInfo copy_submit{};
+    copy_submit.waitSemaphoreCount = 1;
+    copy_submit.pWaitSemaphores = &released_sem;
+    copy_submit.pWaitDstStageMask = &wait_stage;
+    copy_submit.commandBufferCount = 1;
+    copy_submit.pCommandBuffers = &transfer_cmd;
+    VK_TRY(context.transfer_queue.submit(copy_submit, fence), ErrorCode::vulkan_device_lost,
+           "Transfer queue submit failed");
+
+    VK_TRY(device.waitForFences(fence, VK_TRUE, UINT64_MAX), ErrorCode::vulkan_device_lost,
+           "Fence wait failed during readback");
+    return {};
+}
+
+/// Copies `source` on the dedicated transfer queue so the graphics queue is free for the next
+/// frame. Ownership moves graphics -> transfer through a release/acquire barrier pair ordered by
+/// a semaphore. It is not handed back: the next frame transitions the target from `eUndefined`
+/// and discards its contents anyway.
+auto submit_readback_copy_on_transfer_queue(VulkanContext& context, vk::CommandBuffer graphics_cmd,
+                                            vk::Fence fence, vk::Image source, vk::Buffer dest,
+                                            uint32_t width, uint32_t height) -> Result<void> {
+    auto& device = context.device;
+
+    vk::CommandPoolCreateInfo pool_info{};
+    pool_info.flags = vk::CommandPoolCreateFlagBits::eTransient;
+    pool_info.queueFamilyIndex = context.transfer_queue_family;
+    auto [pool_result, transfer_pool] = device.createCommandPool(pool_info);
+    if (pool_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create transfer command pool: " +
+                                    vk::to_string(pool_result));
+    }
+    auto [sem_result, released_sem] = device.createSemaphore(vk::SemaphoreCreateInfo{});
+    if (sem_result != vk::Result::eSuccess) {
+        device.destroyCommandPool(transfer_pool);
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create readback semaphore: " +
+                                    vk::to_string(sem_result));
+    }
+
+    bool submitted = false;
+    auto result =
+        record_and_submit_transfer_readback(context, graphics_cmd, transfer_pool, released_sem,
+                                            fence, source, dest, width, height, submitted);
+    if (!result && submitted) {
+        // The semaphore may still be pending; nothing here can be freed before the GPU is idle.
+        static_cast<void>(device.waitIdle());
+    }
+    device.destroySemaphore(released_sem);
+    device.destroyCommandPool(transfer_pool);
+    return result;
+}
+
+/// Shortest interval between presents; zero leaves presentation unpaced.
+auto present_interval(const RenderOutput& output) -> std::chrono::nanoseconds {
+    if (output.effective_present_policy() == PresentPolicy::vrr) {
+        // Capped at the display's max refresh; below it, frame arrival paces presentation.
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            util::min_present_interval(output.refresh_range));
+    }
     if (output.target_fps == 0) {
-        return {};
+        return std::chrono::nanoseconds::zero();
+    }
+    return std::chrono::nanoseconds(1'000'000'000ULL / output.target_fps);
+}
+
+/// Returns whether the present completed, rather than timing out or being skipped.
+auto apply_present_wait(VulkanContext& context, RenderOutput& output, uint64_t present_value)
+    -> Result<bool> {
+    auto wait_interval = present_interval(output);
+    if (wait_interval == std::chrono::nanoseconds::zero()) {
+        return false;
+    }
+    if (output.effective_present_policy() == PresentPolicy::vrr) {
+        // A VRR display may hold a frame until its min refresh before showing it.
+        wait_interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            util::max_present_interval(output.refresh_range));
     }
 
     constexpr uint64_t MAX_TIMEOUT_NS = 1'000'000'000ULL;
     const uint64_t timeout_ns =
-        std::min(MAX_TIMEOUT_NS, static_cast<uint64_t>(1'000'000'000ULL / output.target_fps));
+        std::min(MAX_TIMEOUT_NS, static_cast<uint64_t>(wait_interval.count()));
+    util::Metrics::increment(util::MetricCounter::present_waits);
     auto wait_result = static_cast<vk::Result>(VULKAN_HPP_DEFAULT_DISPATCHER.vkWaitForPresentKHR(
         context.device, output.swapchain, present_value, timeout_ns));
-    if (wait_result == vk::Result::eSuccess || wait_result == vk::Result::eTimeout ||
-        wait_result == vk::Result::eSuboptimalKHR) {
-        return {};
+    if (wait_result == vk::Result::eSuccess || wait_result == vk::Result::eSuboptimalKHR) {
+        return true;
+    }
+    if (wait_result == vk::Result::eTimeout) {
+        return false;
     }
     if (wait_result == vk::Result::eErrorOutOfDateKHR ||
         wait_result == vk::Result::eErrorSurfaceLostKHR) {
         output.needs_resize = true;
-        return {};
+        return false;
     }
-    return make_error<void>(ErrorCode::vulkan_device_lost,
+    return make_error<bool>(ErrorCode::vulkan_device_lost,
                             "vkWaitForPresentKHR failed: " + vk::to_string(wait_result));
 }
 
+void push_present_feedback(RenderOutput& output, uint64_t frame_number, uint64_t sequence,
+                           bool hw_completion) {
+    // Bounded in case nobody drains it; stale feedback is worthless to clients anyway.
+    constexpr size_t MAX_PENDING_FEEDBACK = 64;
+    if (output.present_feedback.size() >= MAX_PENDING_FEEDBACK) {
+        output.present_feedback.erase(output.present_feedback.begin());
+    }
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    output.present_feedback.push_back(util::PresentFeedback{
+        .frame_number = frame_number,
+        .time_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()),
+        .sequence = sequence,
+        .hw_completion = hw_completion,
+        // A fence-time estimate says nothing about vblank alignment.
+        .vsync = hw_completion && !output.headless &&
+                 output.present_mode != vk::PresentModeKHR::eImmediate,
+    });
+}
+
+/// Completes the feedback of `frame` with an approximate time once its fence was seen signaled.
+void complete_fence_feedback(RenderOutput& output, RenderOutput::FrameResources& frame) {
+    if (frame.feedback_frame_number == 0) {
+        return;
+    }
+    push_present_feedback(output, frame.feedback_frame_number, frame.feedback_sequence, false);
+    frame.feedback_frame_number = 0;
+}
+
 void throttle_present(RenderOutput& output) {
-    if (output.target_fps == 0) {
+    const auto frame_duration = present_interval(output);
+    if (frame_duration == std::chrono::nanoseconds::zero()) {
         return;
     }
 
     using Clock = std::chrono::steady_clock;
-    const auto frame_duration = std::chrono::nanoseconds(1'000'000'000ULL / output.target_fps);
 
     if (output.last_present_time.time_since_epoch().count() == 0) {
         output.last_present_time = Clock::now();
@@ -344,14 +459,118 @@ void throttle_present(RenderOutput& output) {
     }
 }
 
+auto supports_present_mode(const std::vector<vk::PresentModeKHR>& modes, vk::PresentModeKHR mode)
+    -> bool {
+    return std::ranges::find(modes, mode) != modes.end();
+}
+
+// Modes the driver can switch to from `mode` without recreating the swapchain.
+auto query_switchable_present_modes(const VulkanContext& context, vk::PresentModeKHR mode,
+                                    const std::vector<vk::PresentModeKHR>& supported)
+    -> std::vector<vk::PresentModeKHR> {
+    if (!context.swapchain_maintenance1_supported) {
+        return {};
+    }
+
+    vk::SurfacePresentModeEXT surface_present_mode{};
+    surface_present_mode.presentMode = mode;
+    vk::PhysicalDeviceSurfaceInfo2KHR surface_info{};
+    surface_info.surface = context.surface;
+    surface_info.pNext = &surface_present_mode;
+
+    vk::SurfacePresentModeCompatibilityEXT compatibility{};
+    vk::SurfaceCapabilities2KHR capabilities{};
+    capabilities.pNext = &compatibility;
+    if (context.physical_device.getSurfaceCapabilities2KHR(&surface_info, &capabilities) !=
+        vk::Result::eSuccess) {
+        return {};
+    }
+
+    std::vector<vk::PresentModeKHR> compatible(compatibility.presentModeCount);
+    compatibility.pPresentModes = compatible.data();
+    if (context.physical_device.getSurfaceCapabilities2KHR(&surface_info, &capabilities) !=
+        vk::Result::eSuccess) {
+        return {};
+    }
+    compatible.resize(compatibility.presentModeCount);
+
+    std::erase_if(compatible, [&supported](vk::PresentModeKHR candidate) {
+        return !supports_present_mode(supported, candidate);
+    });
+    if (!supports_present_mode(compatible, mode)) {
+        compatible.insert(compatible.begin(), mode);
+    }
+    if (compatible.size() < 2) {
+        compatible.clear();
+    }
+    return compatible;
+}
+
 } // namespace
 
+auto select_present_mode(PresentPolicy policy, const std::vector<vk::PresentModeKHR>& available)
+    -> vk::PresentModeKHR {
+    switch (policy) {
+    case PresentPolicy::low_latency:
+        if (supports_present_mode(available, vk::PresentModeKHR::eImmediate)) {
+            return vk::PresentModeKHR::eImmediate;
+        }
+        if (supports_present_mode(available, vk::PresentModeKHR::eMailbox)) {
+            return vk::PresentModeKHR::eMailbox;
+        }
+        break;
+    case PresentPolicy::adaptive:
+        if (supports_present_mode(available, vk::PresentModeKHR::eFifoRelaxed)) {
+            return vk::PresentModeKHR::eFifoRelaxed;
+        }
+        break;
+    case PresentPolicy::smooth:
+        break;
+    }
+    return vk::PresentModeKHR::eFifo;
+}
+
+void RenderOutput::set_present_policy(PresentPolicy policy) {
+    present_policy = policy;
+    last_present_time = std::chrono::steady_clock::time_point{};
+    apply_present_mode();
+}
+
+void RenderOutput::set_async_presentation(bool enabled) {
+    if (async_presentation == enabled) {
+        return;
+    }
+    async_presentation = enabled;
+    last_present_time = std::chrono::steady_clock::time_point{};
+    GOGGLES_LOG_INFO("Async presentation {}", enabled ? "enabled" : "disabled");
+    apply_present_mode();
+}
+
+void RenderOutput::apply_present_mode() {
+    if (headless || !swapchain) {
+        return;
+    }
+
+    const auto policy = effective_present_policy();
+    const auto mode = select_present_mode(policy, supported_present_modes);
+    if (mode == present_mode) {
+        return;
+    }
+    if (supports_present_mode(switchable_present_modes, mode)) {
+        // Picked up by the VkSwapchainPresentModeInfoEXT chained on the next present.
+        present_mode = mode;
+        GOGGLES_LOG_INFO("Present mode switched to {} ({})", vk::to_string(mode),
+                         to_string(policy));
+        return;
+    }
+    needs_resize = true;
+}
+
 auto RenderOutput::create_swapchain(VulkanContext& context, uint32_t width, uint32_t height,
                                     vk::Format preferred_format) -> Result<void> {
     auto& physical_device = context.physical_device;
     auto& device = context.device;
     auto& surface = context.surface;
-    auto& present_wait_supported = context.present_wait_supported;
 
     auto [cap_result, capabilities] = physical_device.getSurfaceCapabilitiesKHR(surface);
     if (cap_result != vk::Result::eSuccess) {
@@ -397,31 +616,34 @@ auto RenderOutput::create_swapchain(VulkanContext& context, uint32_t width, uint
     create_info.imageArrayLayers = 1;
     create_info.imageUsage =
         vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst;
+    // Lets the frame export copy straight out of the presented image.
+    swapchain_transfer_src = static_cast<bool>(capabilities.supportedUsageFlags &
+                                               vk::ImageUsageFlagBits::eTransferSrc);
+    if (swapchain_transfer_src) {
+        create_info.imageUsage |= vk::ImageUsageFlagBits::eTransferSrc;
+    }
     create_info.imageSharingMode = vk::SharingMode::eExclusive;
     create_info.preTransform = capabilities.currentTransform;
     create_info.compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque;
 
     auto [pm_result, present_modes] = physical_device.getSurfacePresentModesKHR(surface);
-    vk::PresentModeKHR chosen_mode = vk::PresentModeKHR::eFifo;
-    bool mailbox_supported = false;
-    if (pm_result == vk::Result::eSuccess) {
-        for (auto mode : present_modes) {
-            if (mode == vk::PresentModeKHR::eMailbox) {
-                mailbox_supported = true;
-                break;
-            }
-        }
-    }
-
-    if (present_wait_supported) {
-        chosen_mode = vk::PresentModeKHR::eFifo;
-    } else if (mailbox_supported) {
-        chosen_mode = vk::PresentModeKHR::eMailbox;
+    if (pm_result != vk::Result::eSuccess) {
+        present_modes.clear();
     }
+    const vk::PresentModeKHR chosen_mode =
+        select_present_mode(effective_present_policy(), present_modes);
+    auto switchable_modes = query_switchable_present_modes(context, chosen_mode, present_modes);
 
     create_info.presentMode = chosen_mode;
     create_info.clipped = VK_TRUE;
 
+    vk::SwapchainPresentModesCreateInfoEXT present_modes_info{};
+    if (!switchable_modes.empty()) {
+        present_modes_info.presentModeCount = static_cast<uint32_t>(switchable_modes.size());
+        present_modes_info.pPresentModes = switchable_modes.data();
+        create_info.pNext = &present_modes_info;
+    }
+
     auto [swapchain_result, new_swapchain] = device.createSwapchainKHR(create_info);
     if (swapchain_result != vk::Result::eSuccess) {
         return make_error<void>(ErrorCode::vulkan_init_failed,
@@ -487,13 +709,18 @@ auto RenderOutput::create_swapchain(VulkanContext& context, uint32_t width, uint
     render_finished_sems = std::move(new_render_finished_sems);
     swapchain_format = chosen_format.format;
     swapchain_extent = extent;
+    present_mode = chosen_mode;
+    supported_present_modes = std::move(present_modes);
+    switchable_present_modes = std::move(switchable_modes);
     headless = false;
 
     present_id = 0;
     last_present_time = std::chrono::steady_clock::time_point{};
 
-    GOGGLES_LOG_DEBUG("Swapchain created: {}x{}, {} images", extent.width, extent.height,
-                      swapchain_images.size());
+    GOGGLES_LOG_DEBUG("Swapchain created: {}x{}, {} images, {} ({}, {} switchable modes)",
+                      extent.width, extent.height, swapchain_images.size(),
+                      vk::to_string(chosen_mode), to_string(effective_present_policy()),
+                      switchable_present_modes.size());
     return {};
 }
 
@@ -513,6 +740,7 @@ void RenderOutput::cleanup_swapchain(VulkanContext& context) {
 
     swapchain_image_views.clear();
     swapchain_images.clear();
+    switchable_present_modes.clear();
     swapchain = nullptr;
 }
 
@@ -621,7 +849,6 @@ auto RenderOutput::create_sync_objects_headless(VulkanContext& context) -> Resul
 auto RenderOutput::create_offscreen_image(VulkanContext& context, vk::Extent2D source_resolution)
     -> Result<void> {
     auto& device = context.device;
-    auto& physical_device = context.physical_device;
 
     uint32_t width = source_resolution.width;
     uint32_t height = source_resolution.height;
@@ -631,7 +858,7 @@ auto RenderOutput::create_offscreen_image(VulkanContext& context, vk::Extent2D s
     }
 
     vk::Image new_offscreen_image;
-    vk::DeviceMemory new_offscreen_memory;
+    GpuAllocation new_offscreen_allocation;
     vk::ImageView new_offscreen_view;
 
     const auto cleanup_new_offscreen_target = [&]() {
@@ -643,10 +870,7 @@ auto RenderOutput::create_offscreen_image(VulkanContext& context, vk::Extent2D s
             device.destroyImage(new_offscreen_image);
             new_offscreen_image = nullptr;
         }
-        if (new_offscreen_memory) {
-            device.freeMemory(new_offscreen_memory);
-            new_offscreen_memory = nullptr;
-        }
+        context.allocator.free(device, new_offscreen_allocation);
     };
 
     vk::ImageCreateInfo image_info{};
@@ -669,35 +893,15 @@ auto RenderOutput::create_offscreen_image(VulkanContext& context, vk::Extent2D s
     }
     new_offscreen_image = image;
 
-    auto mem_requirements = device.getImageMemoryRequirements(new_offscreen_image);
-    auto mem_props = physical_device.getMemoryProperties();
-    const uint32_t mem_type = find_memory_type(mem_props, mem_requirements.memoryTypeBits);
-    if (mem_type == UINT32_MAX) {
-        cleanup_new_offscreen_target();
-        return make_error<void>(ErrorCode::vulkan_init_failed,
-                                "No suitable memory type for offscreen image");
-    }
-
-    vk::MemoryAllocateInfo alloc_info{};
-    alloc_info.allocationSize = mem_requirements.size;
-    alloc_info.memoryTypeIndex = mem_type;
-
-    auto [memory_result, memory] = device.allocateMemory(alloc_info);
-    if (memory_result != vk::Result::eSuccess) {
-        cleanup_new_offscreen_target();
-        return make_error<void>(ErrorCode::vulkan_init_failed,
-                                "Failed to allocate offscreen memory: " +
-                                    vk::to_string(memory_result));
-    }
-    new_offscreen_memory = memory;
-
-    auto bind_result = device.bindImageMemory(new_offscreen_image, new_offscreen_memory, 0);
-    if (bind_result != vk::Result::eSuccess) {
+    auto allocation = context.allocator.allocate_image(device, new_offscreen_image, {},
+                                                       vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!allocation) {
         cleanup_new_offscreen_target();
-        return make_error<void>(ErrorCode::vulkan_init_failed,
-                                "Failed to bind offscreen image memory: " +
-                                    vk::to_string(bind_result));
+        return make_error<void>(allocation.error().code,
+                                "Offscreen image: " + allocation.error().message,
+                                allocation.error().location);
     }
+    new_offscreen_allocation = *allocation;
 
     vk::ImageViewCreateInfo view_info{};
     view_info.image = new_offscreen_image;
@@ -718,10 +922,10 @@ auto RenderOutput::create_offscreen_image(VulkanContext& context, vk::Extent2D s
     }
     new_offscreen_view = view;
 
-    destroy_offscreen_target(device, *this);
+    destroy_offscreen_target(context, *this);
 
     offscreen_image = new_offscreen_image;
-    offscreen_memory = new_offscreen_memory;
+    offscreen_allocation = new_offscreen_allocation;
     offscreen_view = new_offscreen_view;
     offscreen_extent = vk::Extent2D{width, height};
     swapchain_format = vk::Format::eR8G8B8A8Unorm;
@@ -735,7 +939,7 @@ auto RenderOutput::create_offscreen_image(VulkanContext& context, vk::Extent2D s
 void RenderOutput::destroy(VulkanContext& context) {
     auto& device = context.device;
 
-    destroy_offscreen_target(device, *this);
+    destroy_offscreen_target(context, *this);
 
     if (device) {
         for (auto& frame : frames) {
@@ -796,6 +1000,7 @@ auto RenderOutput::acquire_next_image(VulkanContext& context) -> Result<uint32_t
     if (wait_result != vk::Result::eSuccess) {
         return make_error<uint32_t>(ErrorCode::vulkan_device_lost, "Fence wait failed");
     }
+    complete_fence_feedback(*this, frame);
 
     uint32_t image_index = 0;
     auto result = static_cast<vk::Result>(VULKAN_HPP_DEFAULT_DISPATCHER.vkAcquireNextImageKHR(
@@ -831,6 +1036,7 @@ auto RenderOutput::prepare_headless_frame(VulkanContext& context) -> Result<vk::
     if (wait_result != vk::Result::eSuccess) {
         return make_error<vk::CommandBuffer>(ErrorCode::vulkan_device_lost, "Fence wait failed");
     }
+    complete_fence_feedback(*this, frame);
 
     auto reset_result = device.resetFences(frame.in_flight_fence);
     if (reset_result != vk::Result::eSuccess) {
@@ -843,7 +1049,12 @@ auto RenderOutput::prepare_headless_frame(VulkanContext& context) -> Result<vk::
 
 auto RenderOutput::submit_and_present(VulkanContext& context, uint32_t image_index,
                                       vk::Semaphore acquire_wait_semaphore,
-                                      vk::PipelineStageFlags acquire_wait_stage) -> Result<void> {
+                                      vk::PipelineStageFlags acquire_wait_stage,
+                                      std::span<const vk::Semaphore> extra_wait_semaphores)
+    -> Result<void> {
+    if (extra_wait_semaphores.size() > MAX_EXTRA_WAIT_SEMAPHORES) {
+        return make_error<void>(ErrorCode::invalid_data, "Too many submit wait semaphores");
+    }
     auto& graphics_queue = context.graphics_queue;
     auto& present_wait_supported = context.present_wait_supported;
     const vk::PipelineStageFlags normalized_acquire_wait_stage =
@@ -852,8 +1063,8 @@ auto RenderOutput::submit_and_present(VulkanContext& context, uint32_t image_ind
     auto& frame = frames[current_frame];
     vk::Semaphore render_finished_sem = render_finished_sems[image_index];
 
-    std::array<vk::Semaphore, 2> wait_semaphores{};
-    std::array<vk::PipelineStageFlags, 2> wait_stages{};
+    std::array<vk::Semaphore, 2 + MAX_EXTRA_WAIT_SEMAPHORES> wait_semaphores{};
+    std::array<vk::PipelineStageFlags, 2 + MAX_EXTRA_WAIT_SEMAPHORES> wait_stages{};
     uint32_t wait_count = 1;
     wait_semaphores[0] = frame.image_available_sem;
     wait_stages[0] = vk::PipelineStageFlagBits::eColorAttachmentOutput;
@@ -863,15 +1074,26 @@ auto RenderOutput::submit_and_present(VulkanContext& context, uint32_t image_ind
         wait_stages[wait_count] = normalized_acquire_wait_stage;
         ++wait_count;
     }
+    for (vk::Semaphore semaphore : extra_wait_semaphores) {
+        if (!semaphore) {
+            continue;
+        }
+        wait_semaphores[wait_count] = semaphore;
+        wait_stages[wait_count] = normalize_wait_stage(semaphore, acquire_wait_stage);
+        ++wait_count;
+    }
 
     vk::SubmitInfo submit_info{};
     submit_info.waitSemaphoreCount = wait_count;
     submit_info.pWaitSemaphores = wait_semaphores.data();
     submit_info.pWaitDstStageMask = wait_stages.data();
+    const std::array<vk::Semaphore, 2> signal_semaphores{render_finished_sem,
+                                                         pending_signal_semaphore};
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &frame.command_buffer;
-    submit_info.signalSemaphoreCount = 1;
-    submit_info.pSignalSemaphores = &render_finished_sem;
+    submit_info.signalSemaphoreCount = pending_signal_semaphore ? 2 : 1;
+    submit_info.pSignalSemaphores = signal_semaphores.data();
+    pending_signal_semaphore = nullptr;
 
     auto submit_result = graphics_queue.submit(submit_info, frame.in_flight_fence);
     if (submit_result != vk::Result::eSuccess) {
@@ -895,6 +1117,14 @@ auto RenderOutput::submit_and_present(VulkanContext& context, uint32_t image_ind
         present_info.pNext = &present_info_id;
     }
 
+    vk::SwapchainPresentModeInfoEXT present_mode_info{};
+    if (!switchable_present_modes.empty()) {
+        present_mode_info.swapchainCount = 1;
+        present_mode_info.pPresentModes = &present_mode;
+        present_mode_info.pNext = present_info.pNext;
+        present_info.pNext = &present_mode_info;
+    }
+
     auto present_result = graphics_queue.presentKHR(present_info);
     if (present_result == vk::Result::eErrorOutOfDateKHR ||
         present_result == vk::Result::eSuboptimalKHR) {
@@ -904,15 +1134,27 @@ auto RenderOutput::submit_and_present(VulkanContext& context, uint32_t image_ind
                                 "Present failed: " + vk::to_string(present_result));
     }
 
-    if (target_fps == 0) {
-    } else if (present_wait_supported && present_value > 0) {
-        auto wait_result = apply_present_wait(context, *this, present_value);
-        if (!wait_result) {
-            return wait_result;
-        }
+    // Low latency never blocks on the display; it paces on the CPU so frames can tear in.
+    // Async presentation is paced by the target's own commits instead.
+    const bool pace_with_present_wait = present_wait_supported && present_value > 0 &&
+                                        effective_present_policy() != PresentPolicy::low_latency;
+    const uint64_t feedback_frame_number = std::exchange(pending_feedback_frame_number, 0);
+    const uint64_t sequence = ++present_sequence;
+    bool present_completed = false;
+    if (present_interval(*this) == std::chrono::nanoseconds::zero() || async_presentation) {
+    } else if (pace_with_present_wait) {
+        present_completed = GOGGLES_TRY(apply_present_wait(context, *this, present_value));
     } else {
         throttle_present(*this);
     }
+    if (feedback_frame_number != 0) {
+        if (present_completed) {
+            push_present_feedback(*this, feedback_frame_number, sequence, true);
+        } else {
+            frame.feedback_frame_number = feedback_frame_number;
+            frame.feedback_sequence = sequence;
+        }
+    }
 
     current_frame = (current_frame + 1) % MAX_FRAMES_IN_FLIGHT;
     return {};
@@ -932,12 +1174,20 @@ auto RenderOutput::submit_headless(VulkanContext& context, vk::Semaphore acquire
     }
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &frame.command_buffer;
+    const vk::Semaphore signal_semaphore = pending_signal_semaphore;
+    pending_signal_semaphore = nullptr;
+    if (signal_semaphore) {
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &signal_semaphore;
+    }
 
     auto submit_result = graphics_queue.submit(submit_info, frame.in_flight_fence);
     if (submit_result != vk::Result::eSuccess) {
         return make_error<void>(ErrorCode::vulkan_device_lost,
                                 "Queue submit failed: " + vk::to_string(submit_result));
     }
+    frame.feedback_frame_number = std::exchange(pending_feedback_frame_number, 0);
+    frame.feedback_sequence = ++present_sequence;
 
     return {};
 }
@@ -945,7 +1195,6 @@ auto RenderOutput::submit_headless(VulkanContext& context, vk::Semaphore acquire
 auto RenderOutput::readback_to_png(VulkanContext& context, const std::filesystem::path& output)
     -> Result<void> {
     auto& device = context.device;
-    auto& physical_device = context.physical_device;
     auto& graphics_queue = context.graphics_queue;
 
     if (!headless || !offscreen_image) {
@@ -963,7 +1212,7 @@ auto RenderOutput::readback_to_png(VulkanContext& context, const std::filesystem
     const uint32_t height = offscreen_extent.height;
     const vk::DeviceSize buffer_size = static_cast<vk::DeviceSize>(width) * height * 4;
 
-    auto staging_result = create_readback_staging_buffer(device, physical_device, buffer_size);
+    auto staging_result = create_readback_staging_buffer(context, buffer_size);
     if (!staging_result) {
         return make_error<void>(staging_result.error().code, staging_result.error().message,
                                 staging_result.error().location);
@@ -971,26 +1220,24 @@ auto RenderOutput::readback_to_png(VulkanContext& context, const std::filesystem
     auto staging = staging_result.value();
 
     auto copy_result =
-        submit_readback_copy(device, graphics_queue, frame.command_buffer, frame.in_flight_fence,
-                             offscreen_image, staging.buffer, width, height);
+        context.has_dedicated_transfer_queue()
+            ? submit_readback_copy_on_transfer_queue(context, frame.command_buffer,
+                                                     frame.in_flight_fence, offscreen_image,
+                                                     staging.buffer, width, height)
+            : submit_readback_copy(device, graphics_queue, frame.command_buffer,
+                                   frame.in_flight_fence, offscreen_image, staging.buffer, width,
+                                   height);
     if (!copy_result) {
-        destroy_readback_staging_buffer(device, staging);
+        destroy_readback_staging_buffer(context, staging);
         return make_error<void>(copy_result.error().code, copy_result.error().message,
                                 copy_result.error().location);
     }
 
-    auto [map_result, data] = device.mapMemory(staging.memory, 0, buffer_size);
-    if (map_result != vk::Result::eSuccess) {
-        destroy_readback_staging_buffer(device, staging);
-        return make_error<void>(ErrorCode::vulkan_device_lost,
-                                "Failed to map staging memory: " + vk::to_string(map_result));
-    }
-
-    if (!staging.is_coherent) {
+    if (!staging.allocation.coherent) {
         vk::MappedMemoryRange range{};
-        range.memory = staging.memory;
-        range.offset = 0;
-        range.size = VK_WHOLE_SIZE;
+        range.memory = staging.allocation.memory;
+        range.offset = staging.allocation.offset;
+        range.size = staging.allocation.size;
         auto invalidate_result = device.invalidateMappedMemoryRanges(range);
         if (invalidate_result != vk::Result::eSuccess) {
             GOGGLES_LOG_WARN("invalidateMappedMemoryRanges failed: {}",
@@ -999,11 +1246,10 @@ auto RenderOutput::readback_to_png(VulkanContext& context, const std::filesystem
     }
 
     const int png_result =
-        stbi_write_png(output.c_str(), static_cast<int>(width), static_cast<int>(height), 4, data,
-                       static_cast<int>(width * 4));
+        stbi_write_png(output.c_str(), static_cast<int>(width), static_cast<int>(height), 4,
+                       staging.allocation.mapped, static_cast<int>(width * 4));
 
-    device.unmapMemory(staging.memory);
-    destroy_readback_staging_buffer(device, staging);
+    destroy_readback_staging_buffer(context, staging);
 
     if (png_result == 0) {
         return make_error<void>(ErrorCode::file_write_failed,
@@ -7,19 +7,35 @@
 #include <cstdint>
 #include <filesystem>
 #include <goggles/error.hpp>
+#include <span>
+#include <util/external_image.hpp>
+#include <util/present_policy.hpp>
+#include <util/vrr_pacing.hpp>
+#include <utility>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
 namespace goggles::render::backend_internal {
 
+/// @brief Picks the surface present mode that best serves `policy` from `available`.
+///
+/// Falls back to FIFO, which every surface supports, when no preferred mode is available.
+[[nodiscard]] auto select_present_mode(PresentPolicy policy,
+                                       const std::vector<vk::PresentModeKHR>& available)
+    -> vk::PresentModeKHR;
+
 /// @brief Backend-owned presentation and headless target state.
 struct RenderOutput {
     static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+    static constexpr uint32_t MAX_EXTRA_WAIT_SEMAPHORES = 8;
 
     struct FrameResources {
         vk::CommandBuffer command_buffer;
         vk::Fence in_flight_fence;
         vk::Semaphore image_available_sem;
+        /// Feedback completed once `in_flight_fence` is next seen signaled; 0 when none.
+        uint64_t feedback_frame_number = 0;
+        uint64_t feedback_sequence = 0;
     };
 
     [[nodiscard]] auto create_swapchain(VulkanContext& context, uint32_t width, uint32_t height,
@@ -35,10 +51,13 @@ struct RenderOutput {
 
     [[nodiscard]] auto acquire_next_image(VulkanContext& context) -> Result<uint32_t>;
     [[nodiscard]] auto prepare_headless_frame(VulkanContext& context) -> Result<vk::CommandBuffer>;
+    /// `extra_wait_semaphores` (at most `MAX_EXTRA_WAIT_SEMAPHORES`) wait at
+    /// `acquire_wait_stage` too, so several imported sources share one submission.
     [[nodiscard]] auto submit_and_present(VulkanContext& context, uint32_t image_index,
                                           vk::Semaphore acquire_wait_semaphore = nullptr,
                                           vk::PipelineStageFlags acquire_wait_stage =
-                                              vk::PipelineStageFlagBits::eColorAttachmentOutput)
+                                              vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                                          std::span<const vk::Semaphore> extra_wait_semaphores = {})
         -> Result<void>;
     [[nodiscard]] auto submit_headless(VulkanContext& context,
                                        vk::Semaphore acquire_wait_semaphore = nullptr,
@@ -52,6 +71,22 @@ struct RenderOutput {
         target_fps = value;
         last_present_time = std::chrono::steady_clock::time_point{};
     }
+    /// Display refresh window the `vrr` policy paces within.
+    void set_refresh_range(util::RefreshRange range) {
+        refresh_range = range;
+        last_present_time = std::chrono::steady_clock::time_point{};
+    }
+    /// Switches in place when the swapchain was created with the new mode as a
+    /// `VK_EXT_swapchain_maintenance1` compatible mode; otherwise requests a recreate.
+    void set_present_policy(PresentPolicy policy);
+    /// Presents the capture target's async (tearing) commits immediately and unpaced, switching
+    /// modes the same way `set_present_policy` does.
+    void set_async_presentation(bool enabled);
+    void apply_present_mode();
+    /// Policy the swapchain presents with: `low_latency` while presenting asynchronously.
+    [[nodiscard]] auto effective_present_policy() const -> PresentPolicy {
+        return async_presentation ? PresentPolicy::low_latency : present_policy;
+    }
 
     [[nodiscard]] auto command_buffer() const -> vk::CommandBuffer {
         return frames[current_frame].command_buffer;
@@ -76,6 +111,10 @@ struct RenderOutput {
         return static_cast<uint32_t>(swapchain_images.size());
     }
     void clear_resize_request() { needs_resize = false; }
+    /// Drains feedback for presents completed since the last call, oldest first.
+    [[nodiscard]] auto take_present_feedback() -> std::vector<util::PresentFeedback> {
+        return std::exchange(present_feedback, {});
+    }
 
     vk::SwapchainKHR swapchain;
     vk::CommandPool command_pool;
@@ -85,18 +124,35 @@ struct RenderOutput {
     std::array<FrameResources, MAX_FRAMES_IN_FLIGHT> frames{};
 
     vk::Image offscreen_image;
-    vk::DeviceMemory offscreen_memory;
+    GpuAllocation offscreen_allocation;
     vk::ImageView offscreen_view;
     vk::Extent2D offscreen_extent;
 
     vk::Format swapchain_format = vk::Format::eUndefined;
     vk::Extent2D swapchain_extent;
+    /// Swapchain images can be copied from, which the frame export needs.
+    bool swapchain_transfer_src = false;
     uint32_t current_frame = 0;
     bool headless = false;
     bool needs_resize = false;
     uint32_t target_fps = 0;
+    PresentPolicy present_policy = PresentPolicy::smooth;
+    bool async_presentation = false;
+    util::RefreshRange refresh_range{};
+    vk::PresentModeKHR present_mode = vk::PresentModeKHR::eFifo;
+    std::vector<vk::PresentModeKHR> supported_present_modes;
+    // Modes `present_mode` may switch between per present; empty without swapchain_maintenance1.
+    std::vector<vk::PresentModeKHR> switchable_present_modes;
     uint64_t present_id = 0;
     std::chrono::steady_clock::time_point last_present_time;
+    /// Signaled by the next `submit_and_present`/`submit_headless` alongside their own
+    /// semaphores, then cleared.
+    vk::Semaphore pending_signal_semaphore;
+    /// Captured frame the next `submit_and_present`/`submit_headless` shows, then cleared; 0
+    /// records no feedback.
+    uint64_t pending_feedback_frame_number = 0;
+    uint64_t present_sequence = 0;
+    std::vector<util::PresentFeedback> present_feedback;
 };
 
 } // namespace goggles::render::backend_internal
@@ -0,0 +1,181 @@
+#include "surface_compositor.hpp"
+
+#include <algorithm>
+#include <util/logging.hpp>
+
+namespace goggles::render::backend_internal {
+
+namespace {
+
+void destroy_tile_output(VulkanContext& context, SurfaceTile& tile) {
+    auto& device = context.device;
+    if (device) {
+        if (tile.output_view) {
+            device.destroyImageView(tile.output_view);
+        }
+        if (tile.output_image) {
+            device.destroyImage(tile.output_image);
+        }
+        context.allocator.free(device, tile.output_allocation);
+    }
+    tile.output_view = nullptr;
+    tile.output_image = nullptr;
+    tile.output_allocation = {};
+    tile.output_extent = vk::Extent2D{};
+    tile.output_format = vk::Format::eUndefined;
+}
+
+void destroy_tile(VulkanContext& context, SurfaceTile& tile) {
+    destroy_tile_output(context, tile);
+    tile.interpolator.destroy(context);
+    tile.interpolate_frame = false;
+    tile.importer.destroy(context);
+    tile.imported_frame_number = 0;
+}
+
+} // namespace
+
+auto compute_surface_tiles(vk::Extent2D extent, uint32_t count) -> std::vector<vk::Rect2D> {
+    if (count == 0 || extent.width == 0 || extent.height == 0) {
+        return {};
+    }
+
+    const bool horizontal = extent.width >= extent.height;
+    const uint32_t length = horizontal ? extent.width : extent.height;
+    count = std::min(count, length);
+    const uint32_t cell = length / count;
+
+    std::vector<vk::Rect2D> tiles;
+    tiles.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t offset = i * cell;
+        const uint32_t size = i + 1 == count ? length - offset : cell;
+        if (horizontal) {
+            tiles.push_back(vk::Rect2D{vk::Offset2D{static_cast<int32_t>(offset), 0},
+                                       vk::Extent2D{size, extent.height}});
+        } else {
+            tiles.push_back(vk::Rect2D{vk::Offset2D{0, static_cast<int32_t>(offset)},
+                                       vk::Extent2D{extent.width, size}});
+        }
+    }
+    return tiles;
+}
+
+auto SurfaceCompositor::find_tile(uint32_t surface_id) -> SurfaceTile* {
+    auto it = std::find_if(tiles.begin(), tiles.end(), [surface_id](const SurfaceTile& tile) {
+        return tile.surface_id == surface_id;
+    });
+    return it != tiles.end() ? &*it : nullptr;
+}
+
+auto SurfaceCompositor::tile_for(uint32_t surface_id) -> SurfaceTile& {
+    if (auto* tile = find_tile(surface_id)) {
+        return *tile;
+    }
+    auto& tile = tiles.emplace_back();
+    tile.surface_id = surface_id;
+    return tile;
+}
+
+auto SurfaceCompositor::ensure_output(VulkanContext& context, SurfaceTile& tile,
+                                      vk::Extent2D extent, vk::Format format,
+                                      const std::function<void()>& wait_for_gpu_idle)
+    -> Result<void> {
+    if (tile.output_image && tile.output_extent == extent && tile.output_format == format) {
+        return {};
+    }
+    if (extent.width == 0 || extent.height == 0) {
+        return make_error<void>(ErrorCode::invalid_data, "Surface tile extent is zero");
+    }
+
+    auto& device = context.device;
+    if (tile.output_image) {
+        if (wait_for_gpu_idle) {
+            wait_for_gpu_idle();
+        }
+        destroy_tile_output(context, tile);
+    }
+
+    vk::ImageCreateInfo image_info{};
+    image_info.imageType = vk::ImageType::e2D;
+    image_info.format = format;
+    image_info.extent = vk::Extent3D{extent.width, extent.height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = vk::SampleCountFlagBits::e1;
+    image_info.tiling = vk::ImageTiling::eOptimal;
+    image_info.usage =
+        vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc;
+    image_info.sharingMode = vk::SharingMode::eExclusive;
+    image_info.initialLayout = vk::ImageLayout::eUndefined;
+
+    auto [image_result, image] = device.createImage(image_info);
+    if (image_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create surface tile image: " +
+                                    vk::to_string(image_result));
+    }
+    tile.output_image = image;
+
+    auto allocation = context.allocator.allocate_image(device, tile.output_image, {},
+                                                       vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!allocation) {
+        destroy_tile_output(context, tile);
+        return make_error<void>(allocation.error().code,
+                                "Surface tile image: " + allocation.error().message,
+                                allocation.error().location);
+    }
+    tile.output_allocation = *allocation;
+
+    vk::ImageViewCreateInfo view_info{};
+    view_info.image = tile.output_image;
+    view_info.viewType = vk::ImageViewType::e2D;
+    view_info.format = format;
+    view_info.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    view_info.subresourceRange.baseMipLevel = 0;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.baseArrayLayer = 0;
+    view_info.subresourceRange.layerCount = 1;
+
+    auto [view_result, view] = device.createImageView(view_info);
+    if (view_result != vk::Result::eSuccess) {
+        destroy_tile_output(context, tile);
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create surface tile view: " +
+                                    vk::to_string(view_result));
+    }
+    tile.output_view = view;
+    tile.output_extent = extent;
+    tile.output_format = format;
+
+    GOGGLES_LOG_DEBUG("Surface {} tile output: {}x{}", tile.surface_id, extent.width,
+                      extent.height);
+    return {};
+}
+
+void SurfaceCompositor::retain(VulkanContext& context, std::span<const uint32_t> surface_ids,
+                               const std::function<void()>& wait_for_gpu_idle) {
+    bool waited = false;
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        if (std::find(surface_ids.begin(), surface_ids.end(), it->surface_id) !=
+            surface_ids.end()) {
+            ++it;
+            continue;
+        }
+        if (!waited && wait_for_gpu_idle) {
+            wait_for_gpu_idle();
+            waited = true;
+        }
+        destroy_tile(context, *it);
+        it = tiles.erase(it);
+    }
+}
+
+void SurfaceCompositor::destroy(VulkanContext& context) {
+    for (auto& tile : tiles) {
+        destroy_tile(context, tile);
+    }
+    tiles.clear();
+}
+
+} // namespace goggles::render::backend_internal
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "external_frame_importer.hpp"
+#include "frame_interpolator.hpp"
+#include "gpu_allocator.hpp"
+#include "vulkan_context.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <goggles/error.hpp>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace goggles::render::backend_internal {
+
+/// @brief Splits `extent` into `count` equal cells along its longer axis (left to right when
+/// wider than tall, top to bottom otherwise). The last cell absorbs the division remainder.
+[[nodiscard]] auto compute_surface_tiles(vk::Extent2D extent, uint32_t count)
+    -> std::vector<vk::Rect2D>;
+
+/// @brief Import and filtered output of one captured surface in multi-surface mode.
+struct SurfaceTile {
+    uint32_t surface_id = 0;
+    ExternalFrameImporter importer;
+    /// Frame currently held by `importer`; unchanged frames are not imported again.
+    uint64_t imported_frame_number = 0;
+    vk::Image output_image;
+    vk::ImageView output_view;
+    GpuAllocation output_allocation;
+    vk::Extent2D output_extent;
+    vk::Format output_format = vk::Format::eUndefined;
+    /// Used while the surface's policy enables frame interpolation.
+    FrameInterpolator interpolator;
+    bool interpolate_frame = false;
+};
+
+/// @brief Backend-owned per-surface state for multi-surface capture.
+///
+/// Every surface is filtered into its own offscreen output image, then copied into its cell of
+/// the viewer in the same command buffer. Output images come from the pooled allocator, so a
+/// layout change recycles block memory rather than allocating per surface.
+struct SurfaceCompositor {
+    static constexpr uint32_t MAX_SURFACES = 8;
+
+    [[nodiscard]] auto find_tile(uint32_t surface_id) -> SurfaceTile*;
+    /// Adds an empty tile on first use. May reallocate `tiles`; re-find earlier tiles after.
+    [[nodiscard]] auto tile_for(uint32_t surface_id) -> SurfaceTile&;
+    /// Recreates the output image when its extent or format changed, waiting for the GPU before
+    /// an older image is released.
+    [[nodiscard]] auto ensure_output(VulkanContext& context, SurfaceTile& tile,
+                                     vk::Extent2D extent, vk::Format format,
+                                     const std::function<void()>& wait_for_gpu_idle)
+        -> Result<void>;
+    /// Releases tiles whose surface is not listed, waiting for the GPU first if any go.
+    void retain(VulkanContext& context, std::span<const uint32_t> surface_ids,
+                const std::function<void()>& wait_for_gpu_idle);
+    void destroy(VulkanContext& context);
+
+    std::vector<SurfaceTile> tiles;
+};
+
+} // namespace goggles::render::backend_internal
@@ -2,7 +2,10 @@
 
 #include "external_frame_importer.hpp"
 #include "filter_chain_controller.hpp"
+#include "frame_interpolator.hpp"
+#include "gpu_timer.hpp"
 #include "render_output.hpp"
+#include "surface_compositor.hpp"
 #include "vulkan_context.hpp"
 #include "vulkan_error.hpp"
 
@@ -10,6 +13,7 @@
 #include <array>
 #include <goggles/profiling.hpp>
 #include <util/logging.hpp>
+#include <util/metrics.hpp>
 
 namespace goggles::render {
 
@@ -47,6 +51,32 @@ auto resolve_record_integer_scale(ScaleMode scale_mode, uint32_t integer_scale,
     return std::max(1u, std::min(max_scale_x, max_scale_y));
 }
 
+auto steady_time_ns() -> uint64_t {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+auto make_color_barrier(vk::Image image, vk::ImageLayout old_layout, vk::ImageLayout new_layout,
+                        vk::AccessFlags src_access, vk::AccessFlags dst_access)
+    -> vk::ImageMemoryBarrier {
+    vk::ImageMemoryBarrier barrier{};
+    barrier.srcAccessMask = src_access;
+    barrier.dstAccessMask = dst_access;
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    return barrier;
+}
+
+static_assert(backend_internal::SurfaceCompositor::MAX_SURFACES <=
+              backend_internal::RenderOutput::MAX_EXTRA_WAIT_SEMAPHORES);
+
 } // namespace
 
 VulkanBackend::~VulkanBackend() {
@@ -70,6 +100,7 @@ void VulkanBackend::initialize_settings(const RenderSettings& settings) {
     m_scale_mode = settings.scale_mode;
     m_integer_scale = settings.integer_scale;
     update_target_fps(settings.target_fps);
+    m_internal_shader_dir = settings.internal_shader_dir;
     m_filter_chain_controller.set_prechain_resolution(
         vk::Extent2D{settings.source_width, settings.source_height});
 }
@@ -100,11 +131,15 @@ auto VulkanBackend::create(SDL_Window* window, bool enable_validation,
                   "SDL_GetWindowSizeInPixels failed: " + std::string(SDL_GetError())});
     }
 
+    // The swapchain's initial present mode derives from the policy, so set it before creation.
+    backend->m_render_output.present_policy = settings.present_policy;
+    backend->m_render_output.refresh_range = settings.refresh_range;
     GOGGLES_TRY(backend->m_render_output.create_swapchain(
         backend->m_vulkan_context, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
-        vk::Format::eB8G8R8A8Srgb));
+        DISPLAY_SWAPCHAIN_FORMAT));
     GOGGLES_TRY(backend->m_render_output.create_command_resources(backend->m_vulkan_context));
     GOGGLES_TRY(backend->m_render_output.create_sync_objects(backend->m_vulkan_context));
+    GOGGLES_TRY(backend->m_gpu_timer.create(backend->m_vulkan_context));
     backend->initialize_settings(settings);
     GOGGLES_TRY(backend->init_filter_chain());
 
@@ -130,6 +165,7 @@ auto VulkanBackend::create_headless(bool enable_validation, const std::filesyste
 
     GOGGLES_TRY(backend->m_render_output.create_command_resources(backend->m_vulkan_context));
     GOGGLES_TRY(backend->m_render_output.create_sync_objects_headless(backend->m_vulkan_context));
+    GOGGLES_TRY(backend->m_gpu_timer.create(backend->m_vulkan_context));
     GOGGLES_TRY(backend->m_render_output.create_offscreen_image(
         backend->m_vulkan_context, vk::Extent2D{settings.source_width, settings.source_height}));
     backend->initialize_settings(settings);
@@ -153,7 +189,13 @@ void VulkanBackend::shutdown() {
         }
     });
 
+    m_surface_compositor.destroy(m_vulkan_context);
+    m_frame_interpolator.destroy(m_vulkan_context);
+    m_interpolation_pipelines.destroy(m_vulkan_context);
+    m_frame_exporter.destroy(m_vulkan_context);
+    m_frame_recorder.destroy(m_vulkan_context);
     m_external_frame_importer.destroy(m_vulkan_context);
+    m_gpu_timer.destroy(m_vulkan_context);
     m_render_output.destroy(m_vulkan_context);
 
     m_vulkan_context.destroy();
@@ -161,33 +203,29 @@ void VulkanBackend::shutdown() {
     GOGGLES_LOG_INFO("Vulkan backend shutdown");
 }
 
-auto VulkanBackend::recreate_swapchain(uint32_t width, uint32_t height, vk::Format source_format)
-    -> Result<void> {
+auto VulkanBackend::recreate_swapchain(uint32_t width, uint32_t height) -> Result<void> {
     GOGGLES_PROFILE_FUNCTION();
 
     if (width == 0 || height == 0) {
         return make_error<void>(ErrorCode::unknown_error, "Swapchain size is zero");
     }
 
-    vk::Format target_format = m_render_output.swapchain_format;
-    bool recreate_filter_chain = false;
-    if (source_format != vk::Format::eUndefined) {
-        target_format = get_matching_swapchain_format(source_format);
-        recreate_filter_chain = target_format != m_render_output.swapchain_format;
-        if (recreate_filter_chain) {
-            GOGGLES_LOG_INFO("Source format changed to {}, recreating swapchain with {}",
-                             vk::to_string(source_format), vk::to_string(target_format));
-        }
-    }
+    const vk::Format previous_format = m_render_output.swapchain_format;
+    m_presented_frame.reset();
 
     VK_TRY(m_vulkan_context.device.waitIdle(), ErrorCode::vulkan_device_lost,
            "waitIdle failed before swapchain recreation");
 
     m_render_output.cleanup_swapchain(m_vulkan_context);
 
-    GOGGLES_TRY(m_render_output.create_swapchain(m_vulkan_context, width, height, target_format));
+    GOGGLES_TRY(m_render_output.create_swapchain(m_vulkan_context, width, height,
+                                                 DISPLAY_SWAPCHAIN_FORMAT));
 
-    if (recreate_filter_chain) {
+    // Only a surface that dropped the display format can change it; retarget in that case.
+    const vk::Format target_format = m_render_output.swapchain_format;
+    if (target_format != previous_format) {
+        GOGGLES_LOG_INFO("Surface format changed from {} to {}", vk::to_string(previous_format),
+                         vk::to_string(target_format));
         if (!m_filter_chain_controller.has_filter_chain()) {
             GOGGLES_TRY(init_filter_chain());
         } else {
@@ -210,28 +248,6 @@ void VulkanBackend::wait_all_frames() {
     m_render_output.wait_all_frames(m_vulkan_context);
 }
 
-auto VulkanBackend::get_matching_swapchain_format(vk::Format source_format) -> vk::Format {
-    if (is_srgb_format(source_format)) {
-        return vk::Format::eB8G8R8A8Srgb;
-    }
-    return vk::Format::eB8G8R8A8Unorm;
-}
-
-auto VulkanBackend::is_srgb_format(vk::Format format) -> bool {
-    switch (format) {
-    case vk::Format::eR8Srgb:
-    case vk::Format::eR8G8Srgb:
-    case vk::Format::eR8G8B8Srgb:
-    case vk::Format::eB8G8R8Srgb:
-    case vk::Format::eR8G8B8A8Srgb:
-    case vk::Format::eB8G8R8A8Srgb:
-    case vk::Format::eA8B8G8R8SrgbPack32:
-        return true;
-    default:
-        return false;
-    }
-}
-
 auto VulkanBackend::init_filter_chain() -> Result<void> {
     GOGGLES_PROFILE_FUNCTION();
 
@@ -248,6 +264,7 @@ void VulkanBackend::set_prechain_resolution(uint32_t width, uint32_t height) {
 }
 
 auto VulkanBackend::record_render_commands(vk::CommandBuffer cmd, uint32_t image_index,
+                                           const util::ExternalImageFrame& frame,
                                            const UiRenderCallback& ui_callback) -> Result<void> {
     GOGGLES_PROFILE_SCOPE("RecordCommands");
 
@@ -263,6 +280,9 @@ auto VulkanBackend::record_render_commands(vk::CommandBuffer cmd, uint32_t image
     begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
     VK_TRY(cmd.begin(begin_info), ErrorCode::vulkan_device_lost, "Command buffer begin failed");
 
+    const uint32_t frame_slot = m_render_output.current_frame_slot();
+    m_gpu_timer.begin_frame(cmd, frame_slot);
+
     vk::ImageMemoryBarrier src_barrier{};
     src_barrier.srcAccessMask = vk::AccessFlagBits::eNone;
     src_barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
@@ -293,30 +313,49 @@ auto VulkanBackend::record_render_commands(vk::CommandBuffer cmd, uint32_t image
 
     std::array barriers = {src_barrier, dst_barrier};
     cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
-                        vk::PipelineStageFlagBits::eFragmentShader |
+                        vk::PipelineStageFlagBits::eComputeShader |
+                            vk::PipelineStageFlagBits::eFragmentShader |
                             vk::PipelineStageFlagBits::eColorAttachmentOutput,
                         {}, {}, {}, barriers);
+    m_gpu_timer.end_zone(cmd, frame_slot, util::GpuTimingZone::import_barrier);
+
+    auto filter_source = imported_source;
+    if (m_interpolate_frame) {
+        if (auto interpolated = m_frame_interpolator.record(
+                m_vulkan_context, m_interpolation_pipelines, cmd,
+                {.image = imported_source,
+                 .frame_number = frame.frame_number,
+                 .commit_time_ns = frame.commit_time_ns},
+                frame_slot, steady_time_ns())) {
+            filter_source = *interpolated;
+        }
+    }
+    m_gpu_timer.end_zone(cmd, frame_slot, util::GpuTimingZone::frame_interpolation);
 
     const auto integer_scale = resolve_record_integer_scale(
-        m_scale_mode, m_integer_scale, imported_source.extent, m_render_output.target_extent());
+        m_scale_mode, m_integer_scale, filter_source.extent, m_render_output.target_extent());
     GOGGLES_TRY(
         m_filter_chain_controller.record(backend_internal::FilterChainController::RecordParams{
             .command_buffer = cmd,
-            .source_image = imported_source.image,
-            .source_view = imported_source.view,
-            .source_width = imported_source.extent.width,
-            .source_height = imported_source.extent.height,
+            .source_image = filter_source.image,
+            .source_view = filter_source.view,
+            .source_width = filter_source.extent.width,
+            .source_height = filter_source.extent.height,
             .target_view = m_render_output.target_view(image_index),
             .target_width = m_render_output.target_extent().width,
             .target_height = m_render_output.target_extent().height,
-            .frame_index = m_render_output.current_frame_slot(),
+            .frame_index = frame_slot,
             .scale_mode = to_fc_scale_mode(m_scale_mode),
             .integer_scale = integer_scale,
         }));
+    m_gpu_timer.end_zone(cmd, frame_slot, util::GpuTimingZone::filter_chain);
+    record_frame_copies(cmd, m_render_output.target_image(image_index),
+                        vk::ImageLayout::eColorAttachmentOptimal, frame_slot);
 
     if (ui_callback) {
         ui_callback(cmd, m_render_output.target_view(image_index), m_render_output.target_extent());
     }
+    m_gpu_timer.end_zone(cmd, frame_slot, util::GpuTimingZone::ui_overlay);
 
     dst_barrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
     dst_barrier.dstAccessMask = vk::AccessFlagBits::eNone;
@@ -400,12 +439,31 @@ auto VulkanBackend::render(const util::ExternalImageFrame* frame,
     if (!m_filter_chain_controller.has_filter_chain()) {
         return make_error<void>(ErrorCode::vulkan_init_failed, "Filter chain not initialized");
     }
-    m_filter_chain_controller.advance_frame();
-    m_filter_chain_controller.check_pending_chain_swap([this]() { wait_all_frames(); });
-    m_filter_chain_controller.cleanup_retired_adapters();
+    prepare_filter_frame();
+    if (!m_surface_compositor.tiles.empty()) {
+        release_surface_tiles();
+    }
+    m_presented_frame.reset();
+
+    if (frame) {
+        m_frame_exporter.source_frame_number = frame->frame_number;
+        m_frame_recorder.source_frame_number = frame->frame_number;
+        m_frame_recorder.timestamp_ns = frame->commit_time_ns;
+        m_render_output.pending_feedback_frame_number = frame->frame_number;
+    }
+    prepare_frame_export();
+    prepare_frame_recording();
+
+    // Interpolation images are (re)sized before acquire, like tile outputs.
+    m_interpolate_frame =
+        frame && m_frame_interpolation && !m_render_output.is_headless() &&
+        ensure_interpolator(m_frame_interpolator, {frame->image.width, frame->image.height});
 
     if (m_render_output.is_headless()) {
         auto cmd = GOGGLES_TRY(m_render_output.prepare_headless_frame(m_vulkan_context));
+        m_gpu_timer.collect(m_vulkan_context, 0);
+        m_frame_exporter.collect(m_vulkan_context, 0);
+        m_frame_recorder.collect(m_vulkan_context, 0);
         m_external_frame_importer.retire_wait_semaphore(m_vulkan_context, 0);
         VK_TRY(cmd.reset(), ErrorCode::vulkan_device_lost, "Command buffer reset failed");
 
@@ -416,6 +474,7 @@ auto VulkanBackend::render(const util::ExternalImageFrame* frame,
         if (frame) {
             const auto imported_source = GOGGLES_TRY(
                 m_external_frame_importer.import_external_image(m_vulkan_context, frame->image));
+            m_gpu_timer.begin_frame(cmd, 0);
 
             vk::ImageMemoryBarrier src_barrier{};
             src_barrier.srcAccessMask = vk::AccessFlagBits::eNone;
@@ -446,6 +505,9 @@ auto VulkanBackend::render(const util::ExternalImageFrame* frame,
                                 vk::PipelineStageFlagBits::eFragmentShader |
                                     vk::PipelineStageFlagBits::eColorAttachmentOutput,
                                 {}, {}, {}, barriers);
+            m_gpu_timer.end_zone(cmd, 0, util::GpuTimingZone::import_barrier);
+            // Headless frames are paced by the caller, so there is nothing to interpolate.
+            m_gpu_timer.end_zone(cmd, 0, util::GpuTimingZone::frame_interpolation);
 
             const auto integer_scale =
                 resolve_record_integer_scale(m_scale_mode, m_integer_scale, imported_source.extent,
@@ -464,6 +526,11 @@ auto VulkanBackend::render(const util::ExternalImageFrame* frame,
                     .scale_mode = to_fc_scale_mode(m_scale_mode),
                     .integer_scale = integer_scale,
                 }));
+            m_gpu_timer.end_zone(cmd, 0, util::GpuTimingZone::filter_chain);
+            record_frame_copies(cmd, m_render_output.target_image(),
+                                vk::ImageLayout::eColorAttachmentOptimal, 0);
+            // Headless frames carry no overlay; close the zone so the query set is complete.
+            m_gpu_timer.end_zone(cmd, 0, util::GpuTimingZone::ui_overlay);
         } else {
             vk::ImageMemoryBarrier barrier{};
             barrier.srcAccessMask = vk::AccessFlagBits::eNone;
@@ -508,22 +575,27 @@ auto VulkanBackend::render(const util::ExternalImageFrame* frame,
         auto submit_result = m_render_output.submit_headless(
             m_vulkan_context, m_external_frame_importer.wait_semaphore(0),
             backend_internal::ExternalFrameImporter::WAIT_STAGE);
+        finish_frame_copies(submit_result.has_value(), 0);
         if (!submit_result) {
             m_external_frame_importer.retire_wait_semaphore(m_vulkan_context, 0);
             return submit_result;
         }
+        record_frame_submitted(0);
         return {};
     }
 
     uint32_t image_index = GOGGLES_TRY(m_render_output.acquire_next_image(m_vulkan_context));
     const uint32_t frame_slot = m_render_output.current_frame;
+    m_gpu_timer.collect(m_vulkan_context, frame_slot);
+    m_frame_exporter.collect(m_vulkan_context, frame_slot);
+    m_frame_recorder.collect(m_vulkan_context, frame_slot);
     m_external_frame_importer.retire_wait_semaphore(m_vulkan_context, frame_slot);
 
     if (frame) {
         GOGGLES_TRY(
             m_external_frame_importer.import_external_image(m_vulkan_context, frame->image));
-        GOGGLES_TRY(
-            record_render_commands(m_render_output.command_buffer(), image_index, ui_callback));
+        GOGGLES_TRY(record_render_commands(m_render_output.command_buffer(), image_index, *frame,
+                                           ui_callback));
         if (frame->sync_fd.valid()) {
             m_external_frame_importer.prepare_wait_semaphore(m_vulkan_context, frame->sync_fd,
                                                              frame_slot);
@@ -536,13 +608,491 @@ auto VulkanBackend::render(const util::ExternalImageFrame* frame,
     auto submit_result = m_render_output.submit_and_present(
         m_vulkan_context, image_index, m_external_frame_importer.wait_semaphore(frame_slot),
         backend_internal::ExternalFrameImporter::WAIT_STAGE);
+    finish_frame_copies(submit_result.has_value(), frame_slot);
     if (!submit_result) {
         m_external_frame_importer.retire_wait_semaphore(m_vulkan_context, frame_slot);
         return submit_result;
     }
+    record_frame_submitted(frame_slot);
+    if (frame) {
+        m_presented_frame = PresentedFrame{
+            .source_frame_number = frame->frame_number,
+            .control_revision = m_filter_chain_controller.control_revision,
+            .output_revision = m_filter_chain_controller.output_revision,
+            .target_extent = m_render_output.target_extent(),
+            .scale_mode = m_scale_mode,
+            .integer_scale = m_integer_scale,
+            .frame_interpolation = m_frame_interpolation,
+        };
+    }
+    return {};
+}
+
+auto VulkanBackend::is_frame_presented(const util::ExternalImageFrame& frame) const -> bool {
+    const auto& controller = m_filter_chain_controller;
+    if (!m_presented_frame || controller.frame_dependent ||
+        !controller.pending_control_updates.empty() ||
+        controller.pending_chain_ready.load(std::memory_order_acquire) ||
+        m_render_output.needs_resize || (m_interpolate_frame && !m_frame_interpolator.settled())) {
+        return false;
+    }
+    const auto& presented = *m_presented_frame;
+    return presented.source_frame_number == frame.frame_number &&
+           presented.control_revision == controller.control_revision &&
+           presented.output_revision == controller.output_revision &&
+           presented.target_extent == m_render_output.target_extent() &&
+           presented.scale_mode == m_scale_mode && presented.integer_scale == m_integer_scale &&
+           presented.frame_interpolation == m_frame_interpolation;
+}
+
+auto VulkanBackend::render_surfaces(std::span<const SurfaceSource> sources,
+                                    const UiRenderCallback& ui_callback) -> Result<void> {
+    GOGGLES_PROFILE_FUNCTION();
+    using backend_internal::SurfaceCompositor;
+
+    if (!m_vulkan_context.initialized()) {
+        return make_error<void>(ErrorCode::vulkan_init_failed, "Backend not initialized");
+    }
+    if (!m_filter_chain_controller.has_filter_chain()) {
+        return make_error<void>(ErrorCode::vulkan_init_failed, "Filter chain not initialized");
+    }
+    if (m_render_output.is_headless()) {
+        return make_error<void>(ErrorCode::invalid_data,
+                                "Multi-surface capture requires a presentation swapchain");
+    }
+    if (sources.size() > SurfaceCompositor::MAX_SURFACES) {
+        return make_error<void>(ErrorCode::invalid_data,
+                                "Multi-surface capture supports at most " +
+                                    std::to_string(SurfaceCompositor::MAX_SURFACES) +
+                                    " surfaces");
+    }
+    prepare_filter_frame();
+    m_presented_frame.reset();
+    // The input target is the first source; its client is the one paced by presentation feedback.
+    if (!sources.empty() && sources[0].frame) {
+        m_render_output.pending_feedback_frame_number = sources[0].frame->frame_number;
+    }
+
+    const auto wait_for_frames = [this]() { wait_all_frames(); };
+    std::array<uint32_t, SurfaceCompositor::MAX_SURFACES> surface_ids{};
+    for (size_t i = 0; i < sources.size(); ++i) {
+        surface_ids[i] = sources[i].surface_id;
+    }
+    const std::span<const uint32_t> active_ids{surface_ids.data(), sources.size()};
+    m_surface_compositor.retain(m_vulkan_context, active_ids, wait_for_frames);
+    m_filter_chain_controller.retain_companions(active_ids, wait_for_frames);
+    if (m_frame_interpolator.allocated()) {
+        wait_for_frames();
+        m_frame_interpolator.destroy(m_vulkan_context);
+    }
+
+    // Resize tile outputs before acquiring: the wait covers every frame fence, and the acquired
+    // slot's fence stays unsignaled until this frame is submitted.
+    const auto cells = backend_internal::compute_surface_tiles(
+        m_render_output.target_extent(), static_cast<uint32_t>(sources.size()));
+    for (size_t i = 0; i < cells.size(); ++i) {
+        auto& tile = m_surface_compositor.tile_for(sources[i].surface_id);
+        GOGGLES_TRY(m_surface_compositor.ensure_output(m_vulkan_context, tile, cells[i].extent,
+                                                       m_render_output.swapchain_format,
+                                                       wait_for_frames));
+        const auto* frame = sources[i].frame;
+        if (frame && sources[i].policy.frame_interpolation) {
+            tile.interpolate_frame =
+                ensure_interpolator(tile.interpolator, {frame->image.width, frame->image.height});
+        } else {
+            if (tile.interpolator.allocated()) {
+                wait_for_frames();
+                tile.interpolator.destroy(m_vulkan_context);
+            }
+            tile.interpolate_frame = false;
+        }
+    }
+
+    if (!sources.empty() && sources[0].frame) {
+        m_frame_exporter.source_frame_number = sources[0].frame->frame_number;
+        m_frame_recorder.source_frame_number = sources[0].frame->frame_number;
+        m_frame_recorder.timestamp_ns = sources[0].frame->commit_time_ns;
+    }
+    prepare_frame_export();
+    prepare_frame_recording();
+
+    uint32_t image_index = GOGGLES_TRY(m_render_output.acquire_next_image(m_vulkan_context));
+    const uint32_t frame_slot = m_render_output.current_frame;
+    m_gpu_timer.collect(m_vulkan_context, frame_slot);
+    m_frame_exporter.collect(m_vulkan_context, frame_slot);
+    m_frame_recorder.collect(m_vulkan_context, frame_slot);
+    for (auto& tile : m_surface_compositor.tiles) {
+        tile.importer.retire_wait_semaphore(m_vulkan_context, frame_slot);
+    }
+
+    for (size_t i = 0; i < cells.size(); ++i) {
+        const auto& source = sources[i];
+        auto& tile = *m_surface_compositor.find_tile(source.surface_id);
+        if (!source.frame || source.frame->frame_number == tile.imported_frame_number) {
+            continue;
+        }
+
+        // A stale export only blanks its own cell; the other surfaces still present.
+        auto import_result =
+            tile.importer.import_external_image(m_vulkan_context, source.frame->image);
+        if (!import_result) {
+            GOGGLES_LOG_DEBUG("Surface {} import failed: {}", source.surface_id,
+                              import_result.error().message);
+            tile.imported_frame_number = 0;
+            continue;
+        }
+        tile.imported_frame_number = source.frame->frame_number;
+        if (source.frame->sync_fd.valid()) {
+            tile.importer.prepare_wait_semaphore(m_vulkan_context, source.frame->sync_fd,
+                                                 frame_slot);
+        }
+    }
+
+    GOGGLES_TRY(record_surface_commands(m_render_output.command_buffer(), image_index, sources,
+                                        cells, ui_callback));
+
+    std::array<vk::Semaphore, SurfaceCompositor::MAX_SURFACES> wait_semaphores{};
+    size_t wait_count = 0;
+    for (const auto& tile : m_surface_compositor.tiles) {
+        if (auto semaphore = tile.importer.wait_semaphore(frame_slot)) {
+            wait_semaphores[wait_count++] = semaphore;
+        }
+    }
+
+    auto submit_result = m_render_output.submit_and_present(
+        m_vulkan_context, image_index, nullptr, backend_internal::ExternalFrameImporter::WAIT_STAGE,
+        std::span<const vk::Semaphore>{wait_semaphores.data(), wait_count});
+    finish_frame_copies(submit_result.has_value(), frame_slot);
+    if (!submit_result) {
+        for (auto& tile : m_surface_compositor.tiles) {
+            tile.importer.retire_wait_semaphore(m_vulkan_context, frame_slot);
+        }
+        return submit_result;
+    }
+    record_frame_submitted(frame_slot);
+    return {};
+}
+
+auto VulkanBackend::record_surface_commands(vk::CommandBuffer cmd, uint32_t image_index,
+                                            std::span<const SurfaceSource> sources,
+                                            std::span<const vk::Rect2D> cells,
+                                            const UiRenderCallback& ui_callback) -> Result<void> {
+    GOGGLES_PROFILE_SCOPE("RecordSurfaceCommands");
+    using backend_internal::SurfaceCompositor;
+    using backend_internal::SurfaceTile;
+    using BarrierList = vk::ArrayProxy<const vk::ImageMemoryBarrier>;
+
+    VK_TRY(cmd.reset(), ErrorCode::vulkan_device_lost, "Command buffer reset failed");
+
+    vk::CommandBufferBeginInfo begin_info{};
+    begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    VK_TRY(cmd.begin(begin_info), ErrorCode::vulkan_device_lost, "Command buffer begin failed");
+
+    const uint32_t frame_slot = m_render_output.current_frame_slot();
+    m_gpu_timer.begin_frame(cmd, frame_slot);
+
+    // Cells whose surface has no imported frame yet stay black.
+    std::array<SurfaceTile*, SurfaceCompositor::MAX_SURFACES> ready_tiles{};
+    for (size_t i = 0; i < cells.size(); ++i) {
+        auto* tile = m_surface_compositor.find_tile(sources[i].surface_id);
+        if (tile && tile->output_image && tile->importer.current_source().image) {
+            ready_tiles[i] = tile;
+        }
+    }
+
+    const vk::Image target_image = m_render_output.target_image(image_index);
+    std::array<vk::ImageMemoryBarrier, (2 * SurfaceCompositor::MAX_SURFACES) + 1> barriers{};
+    uint32_t barrier_count = 0;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (!ready_tiles[i]) {
+            continue;
+        }
+        barriers[barrier_count++] = make_color_barrier(
+            ready_tiles[i]->importer.current_source().image, vk::ImageLayout::eUndefined,
+            vk::ImageLayout::eShaderReadOnlyOptimal, vk::AccessFlagBits::eNone,
+            vk::AccessFlagBits::eShaderRead);
+        barriers[barrier_count++] = make_color_barrier(
+            ready_tiles[i]->output_image, vk::ImageLayout::eUndefined,
+            vk::ImageLayout::eColorAttachmentOptimal, vk::AccessFlagBits::eNone,
+            vk::AccessFlagBits::eColorAttachmentWrite);
+    }
+    barriers[barrier_count++] =
+        make_color_barrier(target_image, vk::ImageLayout::eUndefined,
+                           vk::ImageLayout::eTransferDstOptimal, vk::AccessFlagBits::eNone,
+                           vk::AccessFlagBits::eTransferWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                        vk::PipelineStageFlagBits::eComputeShader |
+                            vk::PipelineStageFlagBits::eFragmentShader |
+                            vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                            vk::PipelineStageFlagBits::eTransfer,
+                        {}, {}, {}, BarrierList{barrier_count, barriers.data()});
+    m_gpu_timer.end_zone(cmd, frame_slot, util::GpuTimingZone::import_barrier);
+
+    std::array<backend_internal::ExternalFrameImporter::ImportedSource,
+               SurfaceCompositor::MAX_SURFACES>
+        filter_sources{};
+    const uint64_t present_time_ns = steady_time_ns();
+    for (size_t i = 0; i < cells.size(); ++i) {
+        auto* tile = ready_tiles[i];
+        if (!tile) {
+            continue;
+        }
+        filter_sources[i] = tile->importer.current_source();
+        const auto* frame = sources[i].frame;
+        if (!tile->interpolate_frame || !frame ||
+            frame->frame_number != tile->imported_frame_number) {
+            continue;
+        }
+        if (auto interpolated = tile->interpolator.record(
+                m_vulkan_context, m_interpolation_pipelines, cmd,
+                {.image = filter_sources[i],
+                 .frame_number = frame->frame_number,
+                 .commit_time_ns = frame->commit_time_ns},
+                frame_slot, present_time_ns)) {
+            filter_sources[i] = *interpolated;
+        }
+    }
+    m_gpu_timer.end_zone(cmd, frame_slot, util::GpuTimingZone::frame_interpolation);
+
+    barrier_count = 0;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        auto* tile = ready_tiles[i];
+        if (!tile) {
+            continue;
+        }
+        const auto& source = filter_sources[i];
+        const auto integer_scale = resolve_record_integer_scale(m_scale_mode, m_integer_scale,
+                                                                source.extent, tile->output_extent);
+        GOGGLES_TRY(m_filter_chain_controller.record_companion(
+            sources[i].surface_id, sources[i].policy.prechain_enabled,
+            sources[i].policy.effect_stage_enabled,
+            backend_internal::FilterChainController::RecordParams{
+                .command_buffer = cmd,
+                .source_image = source.image,
+                .source_view = source.view,
+                .source_width = source.extent.width,
+                .source_height = source.extent.height,
+                .target_view = tile->output_view,
+                .target_width = tile->output_extent.width,
+                .target_height = tile->output_extent.height,
+                .frame_index = frame_slot,
+                .scale_mode = to_fc_scale_mode(m_scale_mode),
+                .integer_scale = integer_scale,
+            }));
+        barriers[barrier_count++] = make_color_barrier(
+            tile->output_image, vk::ImageLayout::eColorAttachmentOptimal,
+            vk::ImageLayout::eTransferSrcOptimal, vk::AccessFlagBits::eColorAttachmentWrite,
+            vk::AccessFlagBits::eTransferRead);
+    }
+    m_gpu_timer.end_zone(cmd, frame_slot, util::GpuTimingZone::filter_chain);
+
+    // Clear first so empty cells and gaps are black, then order the copies after the clear.
+    vk::ImageSubresourceRange color_range{};
+    color_range.aspectMask = vk::ImageAspectFlagBits::eColor;
+    color_range.levelCount = 1;
+    color_range.layerCount = 1;
+    cmd.clearColorImage(target_image, vk::ImageLayout::eTransferDstOptimal,
+                        vk::ClearColorValue{std::array{0.0F, 0.0F, 0.0F, 1.0F}}, color_range);
+    barriers[barrier_count++] =
+        make_color_barrier(target_image, vk::ImageLayout::eTransferDstOptimal,
+                           vk::ImageLayout::eTransferDstOptimal,
+                           vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput |
+                            vk::PipelineStageFlagBits::eTransfer,
+                        vk::PipelineStageFlagBits::eTransfer, {}, {}, {},
+                        BarrierList{barrier_count, barriers.data()});
+
+    for (size_t i = 0; i < cells.size(); ++i) {
+        const auto* tile = ready_tiles[i];
+        if (!tile) {
+            continue;
+        }
+        vk::ImageCopy region{};
+        region.srcSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+        region.srcSubresource.layerCount = 1;
+        region.dstSubresource = region.srcSubresource;
+        region.dstOffset = vk::Offset3D{cells[i].offset.x, cells[i].offset.y, 0};
+        region.extent = vk::Extent3D{tile->output_extent.width, tile->output_extent.height, 1};
+        cmd.copyImage(tile->output_image, vk::ImageLayout::eTransferSrcOptimal, target_image,
+                      vk::ImageLayout::eTransferDstOptimal, region);
+    }
+    record_frame_copies(cmd, target_image, vk::ImageLayout::eTransferDstOptimal, frame_slot);
+
+    auto target_barrier = make_color_barrier(
+        target_image, vk::ImageLayout::eTransferDstOptimal,
+        vk::ImageLayout::eColorAttachmentOptimal, vk::AccessFlagBits::eTransferWrite,
+        vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                        vk::PipelineStageFlagBits::eColorAttachmentOutput, {}, {}, {},
+                        target_barrier);
+
+    if (ui_callback) {
+        ui_callback(cmd, m_render_output.target_view(image_index), m_render_output.target_extent());
+    }
+    m_gpu_timer.end_zone(cmd, frame_slot, util::GpuTimingZone::ui_overlay);
+
+    target_barrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    target_barrier.dstAccessMask = vk::AccessFlagBits::eNone;
+    target_barrier.oldLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    target_barrier.newLayout = vk::ImageLayout::ePresentSrcKHR;
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                        vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, target_barrier);
+
+    VK_TRY(cmd.end(), ErrorCode::vulkan_device_lost, "Command buffer end failed");
     return {};
 }
 
+void VulkanBackend::prepare_filter_frame() {
+    m_filter_chain_controller.advance_frame();
+    // Flush before a pending swap so queued values are carried into the incoming chain.
+    m_filter_chain_controller.flush_filter_control_updates();
+    m_filter_chain_controller.check_pending_chain_swap([this]() { wait_all_frames(); });
+    m_filter_chain_controller.cleanup_retired_adapters();
+}
+
+void VulkanBackend::set_frame_export(util::FrameExportServer* server, uint32_t ring_size,
+                                     bool force_memfd) {
+    if (!m_frame_exporter.slots.empty()) {
+        wait_all_frames();
+        m_frame_exporter.destroy(m_vulkan_context);
+    }
+    m_frame_exporter.server = server;
+    m_frame_exporter.ring_size = ring_size;
+    m_frame_exporter.force_memfd = force_memfd;
+    m_frame_exporter.disabled = false;
+}
+
+void VulkanBackend::prepare_frame_export() {
+    // A frame that failed before submission leaves its copy armed; never signal it.
+    m_render_output.pending_signal_semaphore = nullptr;
+    m_frame_exporter.recorded_slot.reset();
+    m_export_frame = false;
+    if (!m_frame_exporter.wants_frame()) {
+        return;
+    }
+    if (!m_render_output.is_headless() && !m_render_output.swapchain_transfer_src) {
+        GOGGLES_LOG_WARN("Frame export disabled: swapchain images cannot be copied from");
+        m_frame_exporter.disabled = true;
+        return;
+    }
+    auto ensure_result = m_frame_exporter.ensure(
+        m_vulkan_context, m_render_output.target_extent(), m_render_output.swapchain_format,
+        [this]() { wait_all_frames(); });
+    if (!ensure_result) {
+        GOGGLES_LOG_WARN("Frame export disabled: {}", ensure_result.error().message);
+        m_frame_exporter.disabled = true;
+        return;
+    }
+    m_export_frame = true;
+}
+
+void VulkanBackend::set_video_recorder(util::VideoRecorder* recorder) {
+    if (m_frame_recorder.staging[0].buffer) {
+        wait_all_frames();
+        for (uint32_t slot = 0; slot < backend_internal::RenderOutput::MAX_FRAMES_IN_FLIGHT;
+             ++slot) {
+            m_frame_recorder.collect(m_vulkan_context, slot);
+        }
+        m_frame_recorder.destroy(m_vulkan_context);
+    }
+    m_frame_recorder.recorder = recorder;
+}
+
+void VulkanBackend::prepare_frame_recording() {
+    m_record_frame = false;
+    if (!m_frame_recorder.active()) {
+        return;
+    }
+    if (!m_render_output.is_headless() && !m_render_output.swapchain_transfer_src) {
+        GOGGLES_LOG_WARN("Recording stopped: swapchain images cannot be copied from");
+        m_frame_recorder.recorder = nullptr;
+        return;
+    }
+    const auto extent = m_render_output.target_extent();
+    if (m_frame_recorder.staging[0].buffer && m_frame_recorder.extent != extent) {
+        wait_all_frames();
+    }
+    auto ensure_result = m_frame_recorder.ensure(m_vulkan_context, extent);
+    if (!ensure_result) {
+        GOGGLES_LOG_WARN("Recording stopped: {}", ensure_result.error().message);
+        m_frame_recorder.recorder = nullptr;
+        return;
+    }
+    m_record_frame = true;
+}
+
+void VulkanBackend::record_frame_copies(vk::CommandBuffer cmd, vk::Image image,
+                                        vk::ImageLayout layout, uint32_t frame_slot) {
+    if (!m_export_frame && !m_record_frame) {
+        return;
+    }
+    GOGGLES_PROFILE_SCOPE("RecordFrameCopies");
+
+    const bool after_transfer = layout == vk::ImageLayout::eTransferDstOptimal;
+    const vk::PipelineStageFlags stage = after_transfer
+                                             ? vk::PipelineStageFlagBits::eTransfer
+                                             : vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    const vk::AccessFlags written = after_transfer ? vk::AccessFlagBits::eTransferWrite
+                                                   : vk::AccessFlagBits::eColorAttachmentWrite;
+    cmd.pipelineBarrier(stage, vk::PipelineStageFlagBits::eTransfer, {}, {}, {},
+                        make_color_barrier(image, layout, vk::ImageLayout::eTransferSrcOptimal,
+                                           written, vk::AccessFlagBits::eTransferRead));
+    if (m_export_frame) {
+        m_frame_exporter.record_copy(cmd, image, frame_slot);
+        m_render_output.pending_signal_semaphore = m_frame_exporter.signal_semaphore();
+    }
+    if (m_record_frame) {
+        m_frame_recorder.record_copy(cmd, image, frame_slot);
+    }
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, stage, {}, {}, {},
+                        make_color_barrier(image, vk::ImageLayout::eTransferSrcOptimal, layout,
+                                           vk::AccessFlagBits::eTransferRead, written));
+}
+
+void VulkanBackend::finish_frame_copies(bool submitted, uint32_t frame_slot) {
+    if (m_export_frame) {
+        if (submitted) {
+            m_frame_exporter.publish_submitted(m_vulkan_context);
+        } else {
+            m_frame_exporter.discard_recorded(frame_slot);
+        }
+    }
+    if (m_record_frame && !submitted) {
+        m_frame_recorder.discard(frame_slot);
+    }
+    m_export_frame = false;
+    m_record_frame = false;
+}
+
+void VulkanBackend::flush_recording() {
+    if (!m_frame_recorder.active()) {
+        return;
+    }
+    // Recorded copies are only handed over once their fence is known to be signaled.
+    wait_all_frames();
+    for (uint32_t slot = 0; slot < backend_internal::RenderOutput::MAX_FRAMES_IN_FLIGHT; ++slot) {
+        m_frame_recorder.collect(m_vulkan_context, slot);
+    }
+}
+
+void VulkanBackend::release_surface_tiles() {
+    wait_all_frames();
+    m_surface_compositor.destroy(m_vulkan_context);
+    m_filter_chain_controller.retain_companions({}, nullptr);
+}
+
+void VulkanBackend::record_frame_submitted(uint32_t frame_slot) {
+    m_gpu_timer.mark_submitted(frame_slot);
+
+    const auto now = std::chrono::steady_clock::now();
+    util::Metrics::increment(util::MetricCounter::frames_rendered);
+    if (m_last_submit_time != std::chrono::steady_clock::time_point{}) {
+        util::Metrics::observe(util::MetricHistogram::frame_time_seconds,
+                               std::chrono::duration<double>(now - m_last_submit_time).count());
+    }
+    m_last_submit_time = now;
+}
+
 auto VulkanBackend::readback_to_png(const std::filesystem::path& output) -> Result<void> {
     return m_render_output.readback_to_png(m_vulkan_context, output);
 }
@@ -561,6 +1111,54 @@ auto VulkanBackend::reload_shader_preset(const std::filesystem::path& preset_pat
 void VulkanBackend::set_filter_chain_policy(const FilterChainStagePolicy& policy) {
     m_filter_chain_controller.set_stage_policy(policy.prechain_enabled, policy.effect_stage_enabled,
                                                [this]() { wait_all_frames(); });
+    if (policy.frame_interpolation == m_frame_interpolation) {
+        return;
+    }
+    m_frame_interpolation = policy.frame_interpolation;
+    if (!m_frame_interpolation && m_frame_interpolator.allocated()) {
+        wait_all_frames();
+        m_frame_interpolator.destroy(m_vulkan_context);
+    }
+}
+
+void VulkanBackend::set_active_surface(uint32_t surface_id) {
+    if (surface_id == m_active_surface_id) {
+        return;
+    }
+    m_active_surface_id = surface_id;
+    m_frame_interpolator.reset();
+    m_presented_frame.reset();
+}
+
+auto VulkanBackend::ensure_interpolation_pipelines() -> bool {
+    if (m_interpolation_pipelines.ready()) {
+        return true;
+    }
+    if (m_interpolation_failed) {
+        return false;
+    }
+    auto result = m_interpolation_pipelines.create(m_vulkan_context, m_internal_shader_dir);
+    if (!result) {
+        GOGGLES_LOG_WARN("Frame interpolation unavailable: {}", result.error().message);
+        m_interpolation_failed = true;
+        return false;
+    }
+    return true;
+}
+
+auto VulkanBackend::ensure_interpolator(backend_internal::FrameInterpolator& interpolator,
+                                        vk::Extent2D extent) -> bool {
+    if (m_interpolation_failed || !ensure_interpolation_pipelines()) {
+        return false;
+    }
+    auto result = interpolator.ensure(m_vulkan_context, m_interpolation_pipelines, extent,
+                                      [this]() { wait_all_frames(); });
+    if (!result) {
+        GOGGLES_LOG_WARN("Frame interpolation disabled: {}", result.error().message);
+        m_interpolation_failed = true;
+        return false;
+    }
+    return true;
 }
 
 auto VulkanBackend::make_device_info() const
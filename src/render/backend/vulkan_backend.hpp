@@ -2,16 +2,28 @@
 
 #include "external_frame_importer.hpp"
 #include "filter_chain_controller.hpp"
+#include "frame_exporter.hpp"
+#include "frame_interpolator.hpp"
+#include "frame_recorder.hpp"
+#include "gpu_timer.hpp"
 #include "render_output.hpp"
+#include "surface_compositor.hpp"
 #include "vulkan_context.hpp"
 
 #include <SDL3/SDL.h>
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <goggles/filter_chain/filter_controls.hpp>
 #include <goggles/filter_chain/scale_mode.hpp>
+#include <optional>
+#include <span>
 #include <util/external_image.hpp>
+#include <util/frame_export.hpp>
+#include <util/runtime_metrics.hpp>
+#include <util/video_recorder.hpp>
+#include <util/vrr_pacing.hpp>
 #include <vector>
 
 namespace goggles::render {
@@ -20,14 +32,28 @@ struct RenderSettings {
     ScaleMode scale_mode = ScaleMode::stretch;
     uint32_t integer_scale = 0;
     uint32_t target_fps = 60;
+    PresentPolicy present_policy = PresentPolicy::smooth;
+    util::RefreshRange refresh_range{};
     std::string gpu_selector;
     uint32_t source_width = 0;
     uint32_t source_height = 0;
+    /// Internal compute shaders (frame interpolation); compiled only when that stage is used.
+    std::filesystem::path internal_shader_dir;
 };
 
 struct FilterChainStagePolicy {
     bool prechain_enabled = true;
     bool effect_stage_enabled = true;
+    /// Synthesizes a frame per present between the last two source frames; windowed only.
+    bool frame_interpolation = false;
+};
+
+/// One captured surface of a multi-surface frame.
+struct SurfaceSource {
+    uint32_t surface_id = 0;
+    /// Latest export; a frame number that is already imported is reused without a reimport.
+    const util::ExternalImageFrame* frame = nullptr;
+    FilterChainStagePolicy policy;
 };
 
 class VulkanBackend {
@@ -54,20 +80,35 @@ public:
     [[nodiscard]] auto reload_shader_preset(const std::filesystem::path& preset_path)
         -> Result<void>;
     void set_filter_chain_policy(const FilterChainStagePolicy& policy);
+    /// Surface whose frames `render()` receives. A switch drops the frames interpolation holds
+    /// and the presented-frame record, which both belong to the previous surface.
+    void set_active_surface(uint32_t surface_id);
 
     using UiRenderCallback = std::function<void(vk::CommandBuffer, vk::ImageView, vk::Extent2D)>;
     [[nodiscard]] auto render(const util::ExternalImageFrame* frame,
                               const UiRenderCallback& ui_callback = nullptr) -> Result<void>;
+    /// Multi-surface capture: imports every source, filters each through its own chain into an
+    /// offscreen output, and tiles the outputs across the viewer, all in one submission.
+    /// Windowed only; at most `SurfaceCompositor::MAX_SURFACES` sources.
+    [[nodiscard]] auto render_surfaces(std::span<const SurfaceSource> sources,
+                                       const UiRenderCallback& ui_callback = nullptr)
+        -> Result<void>;
     [[nodiscard]] auto readback_to_png(const std::filesystem::path& output) -> Result<void>;
+    /// Whether the last presented image already shows `frame` as `render()` would draw it now:
+    /// same source frame, filter-chain state, target and scaling, and a preset without
+    /// frame-dependent passes. The overlay is not compared; that is the caller's to track.
+    /// Never true while frame interpolation is still moving between two frames.
+    [[nodiscard]] auto is_frame_presented(const util::ExternalImageFrame& frame) const -> bool;
 
     [[nodiscard]] auto needs_resize() const -> bool { return m_render_output.needs_resize; }
 
-    [[nodiscard]] static auto get_matching_swapchain_format(vk::Format source_format) -> vk::Format;
+    /// Swapchain format chosen once for the display, independent of the captured format.
+    ///
+    /// Captured frames are display-encoded UNORM (8- or 10-bit), so the final filter pass writes
+    /// them through unchanged and any bit-depth conversion happens in that write.
+    static constexpr vk::Format DISPLAY_SWAPCHAIN_FORMAT = vk::Format::eB8G8R8A8Unorm;
 
-    /// `source_format = eUndefined` means resize-only (keep current format).
-    [[nodiscard]] auto recreate_swapchain(uint32_t width, uint32_t height,
-                                          vk::Format source_format = vk::Format::eUndefined)
-        -> Result<void>;
+    [[nodiscard]] auto recreate_swapchain(uint32_t width, uint32_t height) -> Result<void>;
     void wait_all_frames();
 
     void set_prechain_resolution(uint32_t width, uint32_t height);
@@ -78,6 +119,10 @@ public:
     [[nodiscard]] auto render_output() const -> const backend_internal::RenderOutput& {
         return m_render_output;
     }
+    /// Presents of captured frames completed since the last call; see `util::PresentFeedback`.
+    [[nodiscard]] auto take_present_feedback() -> std::vector<util::PresentFeedback> {
+        return m_render_output.take_present_feedback();
+    }
     [[nodiscard]] auto frame_importer() const -> const backend_internal::ExternalFrameImporter& {
         return m_external_frame_importer;
     }
@@ -89,11 +134,38 @@ public:
         return m_filter_chain_controller;
     }
 
+    /// Smoothed GPU timings of recent frames; lags presentation by the frames in flight.
+    [[nodiscard]] auto gpu_timing() const -> const util::GpuTimingSnapshot& {
+        return m_gpu_timer.snapshot();
+    }
+    /// Backend allocator usage plus driver heap budgets when the device reports them.
+    [[nodiscard]] auto gpu_memory() const -> util::GpuMemorySnapshot {
+        return m_vulkan_context.allocator.snapshot();
+    }
+
     [[nodiscard]] auto get_scale_mode() const -> ScaleMode { return m_scale_mode; }
     [[nodiscard]] auto get_integer_scale() const -> uint32_t { return m_integer_scale; }
+    [[nodiscard]] auto get_present_policy() const -> PresentPolicy {
+        return m_render_output.present_policy;
+    }
     void set_target_fps(uint32_t target_fps) { update_target_fps(target_fps); }
+    /// May set `needs_resize()` when the new mode cannot be switched to in place.
+    void set_present_policy(PresentPolicy policy) { m_render_output.set_present_policy(policy); }
+    [[nodiscard]] auto refresh_range() const -> util::RefreshRange {
+        return m_render_output.refresh_range;
+    }
+    /// Follows the capture target's tearing hint; may likewise set `needs_resize()`.
+    void set_async_presentation(bool enabled) { m_render_output.set_async_presentation(enabled); }
     void set_scale_mode(ScaleMode mode) { m_scale_mode = mode; }
     void set_integer_scale(uint32_t scale) { m_integer_scale = scale; }
+    /// Publishes each filtered frame (before the overlay) to `server`'s consumers; null stops.
+    /// The server must outlive the backend or be detached first.
+    void set_frame_export(util::FrameExportServer* server, uint32_t ring_size, bool force_memfd);
+    /// Streams each filtered frame (before the overlay) into `recorder`; null stops. Pending
+    /// copies are handed over first.
+    void set_video_recorder(util::VideoRecorder* recorder);
+    /// Hands every submitted copy to the recorder; waits for in-flight frames.
+    void flush_recording();
 
 private:
     VulkanBackend() = default;
@@ -109,22 +181,72 @@ private:
         -> backend_internal::FilterChainController::ChainConfig;
 
     [[nodiscard]] auto record_render_commands(vk::CommandBuffer cmd, uint32_t image_index,
+                                              const util::ExternalImageFrame& frame,
                                               const UiRenderCallback& ui_callback = nullptr)
         -> Result<void>;
     [[nodiscard]] auto record_clear_commands(vk::CommandBuffer cmd, uint32_t image_index,
                                              const UiRenderCallback& ui_callback = nullptr)
         -> Result<void>;
+    [[nodiscard]] auto record_surface_commands(vk::CommandBuffer cmd, uint32_t image_index,
+                                               std::span<const SurfaceSource> sources,
+                                               std::span<const vk::Rect2D> cells,
+                                               const UiRenderCallback& ui_callback)
+        -> Result<void>;
 
-    [[nodiscard]] static auto is_srgb_format(vk::Format format) -> bool;
+    void prepare_filter_frame();
+    void release_surface_tiles();
+    /// Compiles the interpolation pipelines on first use; false once that has failed.
+    [[nodiscard]] auto ensure_interpolation_pipelines() -> bool;
+    /// Sizes `interpolator` for `extent`; call before acquire. False disables it this frame.
+    [[nodiscard]] auto ensure_interpolator(backend_internal::FrameInterpolator& interpolator,
+                                           vk::Extent2D extent) -> bool;
+
+    /// Size the export ring and recorder staging for this frame; call before the frame slot's
+    /// fence is reset.
+    void prepare_frame_export();
+    void prepare_frame_recording();
+    /// Copies `image` (in `layout`, after the filter chain) into the export ring and the
+    /// recorder staging, then returns it to `layout`. No-op unless either was armed this frame.
+    void record_frame_copies(vk::CommandBuffer cmd, vk::Image image, vk::ImageLayout layout,
+                             uint32_t frame_slot);
+    void finish_frame_copies(bool submitted, uint32_t frame_slot);
+
+    void record_frame_submitted(uint32_t frame_slot);
 
     backend_internal::VulkanContext m_vulkan_context;
     backend_internal::RenderOutput m_render_output;
     backend_internal::ExternalFrameImporter m_external_frame_importer;
     backend_internal::FilterChainController m_filter_chain_controller;
+    backend_internal::GpuTimer m_gpu_timer;
+    backend_internal::SurfaceCompositor m_surface_compositor;
+    backend_internal::FrameExporter m_frame_exporter;
+    bool m_export_frame = false;
+    backend_internal::FrameRecorder m_frame_recorder;
+    bool m_record_frame = false;
+    backend_internal::FrameInterpolationPipelines m_interpolation_pipelines;
+    backend_internal::FrameInterpolator m_frame_interpolator;
+    std::filesystem::path m_internal_shader_dir;
+    bool m_frame_interpolation = false;
+    bool m_interpolate_frame = false;
+    bool m_interpolation_failed = false;
+    uint32_t m_active_surface_id = 0;
+
+    /// What the last windowed single-surface present shows; cleared by anything else.
+    struct PresentedFrame {
+        uint64_t source_frame_number = 0;
+        uint64_t control_revision = 0;
+        uint64_t output_revision = 0;
+        vk::Extent2D target_extent;
+        ScaleMode scale_mode = ScaleMode::stretch;
+        uint32_t integer_scale = 0;
+        bool frame_interpolation = false;
+    };
+    std::optional<PresentedFrame> m_presented_frame;
 
     std::filesystem::path m_cache_dir;
     uint32_t m_integer_scale = 0;
     ScaleMode m_scale_mode = ScaleMode::stretch;
+    std::chrono::steady_clock::time_point m_last_submit_time;
 
     [[nodiscard]] auto current_filter_target_extent() const -> vk::Extent2D;
 };
@@ -22,6 +22,12 @@ constexpr std::array REQUIRED_INSTANCE_EXTENSIONS = {
     VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME,
 };
 
+// Instance side of VK_EXT_swapchain_maintenance1; enabled only when all are available.
+constexpr std::array SURFACE_MAINTENANCE_INSTANCE_EXTENSIONS = {
+    VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME,
+    VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME,
+};
+
 constexpr const char* VALIDATION_LAYER_NAME = "VK_LAYER_KHRONOS_validation";
 
 constexpr std::array REQUIRED_DEVICE_EXTENSIONS = {
@@ -41,6 +47,7 @@ struct PhysicalDeviceCandidate {
     uint32_t graphics_family = UINT32_MAX;
     uint32_t index = 0;
     bool present_wait_supported = false;
+    bool swapchain_maintenance1_supported = false;
     int score = 0;
 };
 
@@ -68,6 +75,24 @@ auto has_device_extension(const std::vector<vk::ExtensionProperties>& extensions
     });
 }
 
+auto append_surface_maintenance_extensions(std::vector<const char*>& extensions) -> bool {
+    auto [result, available] = vk::enumerateInstanceExtensionProperties();
+    if (result != vk::Result::eSuccess) {
+        return false;
+    }
+    for (const auto* extension : SURFACE_MAINTENANCE_INSTANCE_EXTENSIONS) {
+        if (!has_device_extension(available, extension)) {
+            return false;
+        }
+    }
+    for (const auto* extension : SURFACE_MAINTENANCE_INSTANCE_EXTENSIONS) {
+        if (!has_string_extension(extensions, extension)) {
+            extensions.push_back(extension);
+        }
+    }
+    return true;
+}
+
 auto make_application_info() -> vk::ApplicationInfo {
     vk::ApplicationInfo app_info{};
     app_info.pApplicationName = "Goggles";
@@ -211,6 +236,10 @@ void populate_selected_device_details(VulkanContext& context,
     context.graphics_queue_family = selected.graphics_family;
     context.gpu_index = selected.index;
     context.present_wait_supported = headless_log ? false : selected.present_wait_supported;
+    // Stays false unless the instance enabled the surface maintenance extensions.
+    context.swapchain_maintenance1_supported = context.swapchain_maintenance1_supported &&
+                                               !headless_log &&
+                                               selected.swapchain_maintenance1_supported;
 
     vk::PhysicalDeviceIDProperties id_props{};
     vk::PhysicalDeviceProperties2 props2{};
@@ -269,6 +298,7 @@ auto select_physical_device(VulkanContext& context, const std::string& gpu_selec
         const bool surface_ok = graphics_family != UINT32_MAX;
         bool extensions_ok = false;
         bool present_wait_supported = false;
+        bool swapchain_maintenance1_supported = false;
 
         if (surface_ok) {
             auto [ext_result, available_extensions] = device.enumerateDeviceExtensionProperties();
@@ -287,6 +317,8 @@ auto select_physical_device(VulkanContext& context, const std::string& gpu_selec
                     const bool present_wait_ok = has_device_extension(
                         available_extensions, VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
                     present_wait_supported = present_id_ok && present_wait_ok;
+                    swapchain_maintenance1_supported = has_device_extension(
+                        available_extensions, VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME);
                 }
             }
         }
@@ -309,6 +341,8 @@ auto select_physical_device(VulkanContext& context, const std::string& gpu_selec
                                   .graphics_family = graphics_family,
                                   .index = static_cast<uint32_t>(idx),
                                   .present_wait_supported = present_wait_supported,
+                                  .swapchain_maintenance1_supported =
+                                      swapchain_maintenance1_supported,
                                   .score = score});
         }
     }
@@ -406,6 +440,7 @@ auto select_physical_device_headless(VulkanContext& context, const std::string&
                                   .graphics_family = graphics_family,
                                   .index = static_cast<uint32_t>(idx),
                                   .present_wait_supported = false,
+                                  .swapchain_maintenance1_supported = false,
                                   .score = score});
         }
     }
@@ -437,24 +472,62 @@ auto select_physical_device_headless(VulkanContext& context, const std::string&
     return {};
 }
 
+void select_async_queue_families(VulkanContext& context) {
+    const auto families = context.physical_device.getQueueFamilyProperties();
+    // A transfer-only family is the DMA engine; a compute family without graphics runs
+    // alongside the graphics queue. Either falls back to the graphics family when absent.
+    context.transfer_queue_family =
+        find_dedicated_queue_family(families, vk::QueueFlagBits::eTransfer,
+                                    vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)
+            .value_or(context.graphics_queue_family);
+    context.compute_queue_family =
+        find_dedicated_queue_family(families, vk::QueueFlagBits::eCompute,
+                                    vk::QueueFlagBits::eGraphics)
+            .value_or(context.graphics_queue_family);
+}
+
 auto create_device(VulkanContext& context) -> Result<void> {
+    select_async_queue_families(context);
+
+    auto [ext_result, available_extensions] =
+        context.physical_device.enumerateDeviceExtensionProperties();
+    context.memory_budget_supported =
+        ext_result == vk::Result::eSuccess &&
+        has_device_extension(available_extensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
     float queue_priority = 1.0F;
-    vk::DeviceQueueCreateInfo queue_info{};
-    queue_info.queueFamilyIndex = context.graphics_queue_family;
-    queue_info.queueCount = 1;
-    queue_info.pQueuePriorities = &queue_priority;
+    std::vector<vk::DeviceQueueCreateInfo> queue_infos;
+    for (const uint32_t family : {context.graphics_queue_family, context.transfer_queue_family,
+                                  context.compute_queue_family}) {
+        if (std::ranges::any_of(queue_infos, [family](const vk::DeviceQueueCreateInfo& info) {
+                return info.queueFamilyIndex == family;
+            })) {
+            continue;
+        }
+        vk::DeviceQueueCreateInfo queue_info{};
+        queue_info.queueFamilyIndex = family;
+        queue_info.queueCount = 1;
+        queue_info.pQueuePriorities = &queue_priority;
+        queue_infos.push_back(queue_info);
+    }
 
     vk::PhysicalDeviceVulkan11Features vk11_features{};
     vk::PhysicalDeviceVulkan12Features vk12_features{};
     vk::PhysicalDeviceVulkan13Features vk13_features{};
     vk::PhysicalDevicePresentIdFeaturesKHR present_id_features{};
     vk::PhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+    vk::PhysicalDeviceSwapchainMaintenance1FeaturesEXT maintenance1_features{};
     vk11_features.pNext = &vk12_features;
     vk12_features.pNext = &vk13_features;
 
+    void** features_tail = &vk13_features.pNext;
     if (context.present_wait_supported) {
-        vk13_features.pNext = &present_id_features;
+        *features_tail = &present_id_features;
         present_id_features.pNext = &present_wait_features;
+        features_tail = &present_wait_features.pNext;
+    }
+    if (context.swapchain_maintenance1_supported) {
+        *features_tail = &maintenance1_features;
     }
 
     vk::PhysicalDeviceFeatures2 features2{};
@@ -467,9 +540,12 @@ auto create_device(VulkanContext& context) -> Result<void> {
     if (context.present_wait_supported && !present_wait_ready) {
         GOGGLES_LOG_WARN(
             "VK_KHR_present_id/VK_KHR_present_wait extensions present but features disabled; "
-            "falling back to mailbox/throttle");
+            "falling back to CPU throttle");
     }
     context.present_wait_supported = present_wait_ready;
+    context.swapchain_maintenance1_supported = context.swapchain_maintenance1_supported &&
+                                               maintenance1_features.swapchainMaintenance1 !=
+                                                   VK_FALSE;
 
     if (!vk11_features.shaderDrawParameters) {
         return make_error<void>(ErrorCode::vulkan_init_failed,
@@ -487,16 +563,24 @@ auto create_device(VulkanContext& context) -> Result<void> {
     vk13_enable.dynamicRendering = VK_TRUE;
     vk::PhysicalDevicePresentIdFeaturesKHR present_id_enable{};
     vk::PhysicalDevicePresentWaitFeaturesKHR present_wait_enable{};
+    vk::PhysicalDeviceSwapchainMaintenance1FeaturesEXT maintenance1_enable{};
     vk11_enable.pNext = &vk12_enable;
     vk12_enable.pNext = &vk13_enable;
+    void** enable_tail = &vk13_enable.pNext;
     if (context.present_wait_supported) {
         present_id_enable.presentId = VK_TRUE;
         present_wait_enable.presentWait = VK_TRUE;
-        vk13_enable.pNext = &present_id_enable;
+        *enable_tail = &present_id_enable;
         present_id_enable.pNext = &present_wait_enable;
+        enable_tail = &present_wait_enable.pNext;
+    }
+    if (context.swapchain_maintenance1_supported) {
+        maintenance1_enable.swapchainMaintenance1 = VK_TRUE;
+        *enable_tail = &maintenance1_enable;
     }
 
-    std::array<const char*, REQUIRED_DEVICE_EXTENSIONS.size() + OPTIONAL_DEVICE_EXTENSIONS.size()>
+    std::array<const char*,
+               REQUIRED_DEVICE_EXTENSIONS.size() + OPTIONAL_DEVICE_EXTENSIONS.size() + 2>
         extensions{};
     size_t extension_count = 0;
     for (const auto* extension : REQUIRED_DEVICE_EXTENSIONS) {
@@ -510,11 +594,17 @@ auto create_device(VulkanContext& context) -> Result<void> {
             extensions[extension_count++] = extension;
         }
     }
+    if (context.swapchain_maintenance1_supported) {
+        extensions[extension_count++] = VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME;
+    }
+    if (context.memory_budget_supported) {
+        extensions[extension_count++] = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+    }
 
     vk::DeviceCreateInfo create_info{};
     create_info.pNext = &vk11_enable;
-    create_info.queueCreateInfoCount = 1;
-    create_info.pQueueCreateInfos = &queue_info;
+    create_info.queueCreateInfoCount = static_cast<uint32_t>(queue_infos.size());
+    create_info.pQueueCreateInfos = queue_infos.data();
     create_info.enabledExtensionCount = static_cast<uint32_t>(extension_count);
     create_info.ppEnabledExtensionNames = extensions.data();
 
@@ -527,13 +617,35 @@ auto create_device(VulkanContext& context) -> Result<void> {
     context.device = device;
     VULKAN_HPP_DEFAULT_DISPATCHER.init(context.device);
     context.graphics_queue = context.device.getQueue(context.graphics_queue_family, 0);
-
+    context.transfer_queue = context.device.getQueue(context.transfer_queue_family, 0);
+    context.compute_queue = context.device.getQueue(context.compute_queue_family, 0);
+    context.allocator.init(context.physical_device, context.memory_budget_supported);
+
+    GOGGLES_LOG_INFO("Queue families: graphics={}, transfer={}{}, compute={}{}",
+                     context.graphics_queue_family, context.transfer_queue_family,
+                     context.has_dedicated_transfer_queue() ? "" : " (shared)",
+                     context.compute_queue_family,
+                     context.compute_queue_family != context.graphics_queue_family ? ""
+                                                                                   : " (shared)");
     GOGGLES_LOG_DEBUG("Vulkan device created");
     return {};
 }
 
 } // namespace
 
+auto find_dedicated_queue_family(const std::vector<vk::QueueFamilyProperties>& families,
+                                 vk::QueueFlags required, vk::QueueFlags excluded)
+    -> std::optional<uint32_t> {
+    for (uint32_t family_index = 0; family_index < families.size(); ++family_index) {
+        const auto flags = families[family_index].queueFlags;
+        if (families[family_index].queueCount > 0 && (flags & required) == required &&
+            !(flags & excluded)) {
+            return family_index;
+        }
+    }
+    return std::nullopt;
+}
+
 VulkanContext::VulkanContext(VulkanContext&& other) noexcept {
     *this = std::move(other);
 }
@@ -549,16 +661,23 @@ auto VulkanContext::operator=(VulkanContext&& other) noexcept -> VulkanContext&
     physical_device = std::exchange(other.physical_device, nullptr);
     device = std::exchange(other.device, nullptr);
     graphics_queue = std::exchange(other.graphics_queue, nullptr);
+    transfer_queue = std::exchange(other.transfer_queue, nullptr);
+    compute_queue = std::exchange(other.compute_queue, nullptr);
     surface = std::exchange(other.surface, nullptr);
     debug_messenger = std::move(other.debug_messenger);
     other.debug_messenger.reset();
+    allocator = std::exchange(other.allocator, {});
     graphics_queue_family = std::exchange(other.graphics_queue_family, UINT32_MAX);
+    transfer_queue_family = std::exchange(other.transfer_queue_family, UINT32_MAX);
+    compute_queue_family = std::exchange(other.compute_queue_family, UINT32_MAX);
     gpu_index = std::exchange(other.gpu_index, 0u);
     gpu_uuid = std::move(other.gpu_uuid);
     other.gpu_uuid.clear();
     enable_validation = std::exchange(other.enable_validation, false);
     headless = std::exchange(other.headless, false);
     present_wait_supported = std::exchange(other.present_wait_supported, false);
+    swapchain_maintenance1_supported = std::exchange(other.swapchain_maintenance1_supported, false);
+    memory_budget_supported = std::exchange(other.memory_budget_supported, false);
 
     return *this;
 }
@@ -590,6 +709,7 @@ auto VulkanContext::create(SDL_Window* window, bool enable_validation,
     }
 
     std::vector<const char*> extensions(sdl_extensions, sdl_extensions + sdl_extension_count);
+    context.swapchain_maintenance1_supported = append_surface_maintenance_extensions(extensions);
 
     auto instance_result = create_instance(context, std::move(extensions));
     if (!instance_result) {
@@ -677,11 +797,14 @@ auto VulkanContext::create_headless(bool enable_validation, const std::string& g
 }
 
 void VulkanContext::destroy() {
+    allocator.destroy(device);
     if (device) {
         device.destroy();
         device = nullptr;
     }
     graphics_queue = nullptr;
+    transfer_queue = nullptr;
+    compute_queue = nullptr;
     physical_device = nullptr;
 
     if (instance && surface) {
@@ -697,11 +820,15 @@ void VulkanContext::destroy() {
     }
 
     graphics_queue_family = UINT32_MAX;
+    transfer_queue_family = UINT32_MAX;
+    compute_queue_family = UINT32_MAX;
     gpu_index = 0;
     gpu_uuid.clear();
     enable_validation = false;
     headless = false;
     present_wait_supported = false;
+    swapchain_maintenance1_supported = false;
+    memory_budget_supported = false;
 }
 
 auto VulkanContext::boundary_context() const -> ::goggles::fc::VulkanContext {
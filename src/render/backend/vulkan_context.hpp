@@ -1,17 +1,25 @@
 #pragma once
 
+#include "gpu_allocator.hpp"
 #include "vulkan_debug.hpp"
 
 #include <cstdint>
 #include <goggles/filter_chain/vulkan_context.hpp>
 #include <optional>
 #include <string>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 struct SDL_Window;
 
 namespace goggles::render::backend_internal {
 
+/// @brief Returns the first queue family that has every `required` flag and none of `excluded`.
+[[nodiscard]] auto
+find_dedicated_queue_family(const std::vector<vk::QueueFamilyProperties>& families,
+                            vk::QueueFlags required, vk::QueueFlags excluded)
+    -> std::optional<uint32_t>;
+
 struct VulkanContext {
     VulkanContext() = default;
     ~VulkanContext() = default;
@@ -33,19 +41,34 @@ struct VulkanContext {
     [[nodiscard]] auto boundary_context() const -> ::goggles::fc::VulkanContext;
     [[nodiscard]] auto initialized() const -> bool { return static_cast<bool>(device); }
     [[nodiscard]] auto is_headless() const -> bool { return headless; }
+    /// False on single-family devices (e.g. lavapipe), where transfers share the graphics queue.
+    [[nodiscard]] auto has_dedicated_transfer_queue() const -> bool {
+        return transfer_queue_family != graphics_queue_family;
+    }
 
     vk::Instance instance;
     vk::PhysicalDevice physical_device;
     vk::Device device;
     vk::Queue graphics_queue;
+    // Alias `graphics_queue` and its family when the device has no dedicated family for them.
+    vk::Queue transfer_queue;
+    vk::Queue compute_queue;
     vk::SurfaceKHR surface;
     std::optional<VulkanDebugMessenger> debug_messenger;
+    /// Backs backend-owned images and buffers; imported DMA-BUF memory stays outside it.
+    GpuAllocator allocator;
     uint32_t graphics_queue_family = UINT32_MAX;
+    uint32_t transfer_queue_family = UINT32_MAX;
+    uint32_t compute_queue_family = UINT32_MAX;
     uint32_t gpu_index = 0;
     std::string gpu_uuid;
     bool enable_validation = false;
     bool headless = false;
     bool present_wait_supported = false;
+    // VK_EXT_swapchain_maintenance1: present modes can change without a swapchain recreate.
+    bool swapchain_maintenance1_supported = false;
+    // VK_EXT_memory_budget: per-heap budget/usage for the allocator's memory snapshot.
+    bool memory_budget_supported = false;
 };
 
 } // namespace goggles::render::backend_internal
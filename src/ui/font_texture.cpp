@@ -0,0 +1,320 @@
+#include "font_texture.hpp"
+
+#include <cstring>
+#include <goggles/profiling.hpp>
+#include <limits>
+#include <render/backend/gpu_allocator.hpp>
+#include <string>
+#include <util/logging.hpp>
+
+namespace goggles::ui {
+
+namespace {
+
+auto upload_error(const std::string& message, vk::Result result) -> Result<FontTextureUpload> {
+    return make_error<FontTextureUpload>(ErrorCode::vulkan_init_failed,
+                                         message + ": " + vk::to_string(result));
+}
+
+auto create_texture(vk::Device device, const vk::PhysicalDeviceMemoryProperties& mem_props,
+                    uint32_t width, uint32_t height, FontTexture& texture) -> Result<void> {
+    vk::ImageCreateInfo image_info{};
+    image_info.imageType = vk::ImageType::e2D;
+    image_info.format = vk::Format::eR8G8B8A8Unorm;
+    image_info.extent = vk::Extent3D{width, height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = vk::SampleCountFlagBits::e1;
+    image_info.tiling = vk::ImageTiling::eOptimal;
+    image_info.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+    image_info.sharingMode = vk::SharingMode::eExclusive;
+    image_info.initialLayout = vk::ImageLayout::eUndefined;
+
+    auto [image_result, image] = device.createImage(image_info);
+    if (image_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create font image: " + vk::to_string(image_result));
+    }
+    texture.image = image;
+
+    auto requirements = device.getImageMemoryRequirements(image);
+    auto mem_type = render::backend_internal::select_memory_type(
+        mem_props, requirements.memoryTypeBits, {}, vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (!mem_type) {
+        return make_error<void>(ErrorCode::vulkan_init_failed, "No memory type for font image");
+    }
+
+    vk::MemoryAllocateInfo alloc_info{};
+    alloc_info.allocationSize = requirements.size;
+    alloc_info.memoryTypeIndex = *mem_type;
+    auto [alloc_result, memory] = device.allocateMemory(alloc_info);
+    if (alloc_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to allocate font image memory: " +
+                                    vk::to_string(alloc_result));
+    }
+    texture.memory = memory;
+
+    auto bind_result = device.bindImageMemory(image, memory, 0);
+    if (bind_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to bind font image memory: " + vk::to_string(bind_result));
+    }
+
+    vk::ImageViewCreateInfo view_info{};
+    view_info.image = image;
+    view_info.viewType = vk::ImageViewType::e2D;
+    view_info.format = image_info.format;
+    view_info.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+    auto [view_result, view] = device.createImageView(view_info);
+    if (view_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create font image view: " + vk::to_string(view_result));
+    }
+    texture.view = view;
+
+    // Matches the sampler the ImGui Vulkan backend creates for its own font texture.
+    vk::SamplerCreateInfo sampler_info{};
+    sampler_info.magFilter = vk::Filter::eLinear;
+    sampler_info.minFilter = vk::Filter::eLinear;
+    sampler_info.mipmapMode = vk::SamplerMipmapMode::eLinear;
+    sampler_info.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+    sampler_info.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+    sampler_info.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+    sampler_info.minLod = -1000.0F;
+    sampler_info.maxLod = 1000.0F;
+    sampler_info.maxAnisotropy = 1.0F;
+    auto [sampler_result, sampler] = device.createSampler(sampler_info);
+    if (sampler_result != vk::Result::eSuccess) {
+        return make_error<void>(ErrorCode::vulkan_init_failed,
+                                "Failed to create font sampler: " + vk::to_string(sampler_result));
+    }
+    texture.sampler = sampler;
+    return {};
+}
+
+} // namespace
+
+void FontTexture::destroy(vk::Device device) {
+    if (sampler) {
+        device.destroySampler(sampler);
+        sampler = nullptr;
+    }
+    if (view) {
+        device.destroyImageView(view);
+        view = nullptr;
+    }
+    if (image) {
+        device.destroyImage(image);
+        image = nullptr;
+    }
+    if (memory) {
+        device.freeMemory(memory);
+        memory = nullptr;
+    }
+}
+
+void record_font_texture_acquire(vk::CommandBuffer cmd, const FontTexture& texture,
+                                 uint32_t transfer_queue_family, uint32_t graphics_queue_family) {
+    vk::ImageMemoryBarrier acquire{};
+    acquire.srcAccessMask = {};
+    acquire.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    acquire.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    acquire.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    acquire.srcQueueFamilyIndex = transfer_queue_family;
+    acquire.dstQueueFamilyIndex = graphics_queue_family;
+    acquire.image = texture.image;
+    acquire.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                        vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, acquire);
+}
+
+auto FontTextureUpload::begin(vk::Device device, vk::PhysicalDevice physical_device,
+                              uint32_t transfer_queue_family, vk::Queue transfer_queue,
+                              uint32_t graphics_queue_family, const unsigned char* pixels,
+                              uint32_t width, uint32_t height) -> Result<FontTextureUpload> {
+    GOGGLES_PROFILE_FUNCTION();
+    FontTextureUpload upload{};
+    const auto fail = [&](Result<FontTextureUpload> error) {
+        upload.destroy(device);
+        return error;
+    };
+
+    const auto mem_props = physical_device.getMemoryProperties();
+    if (auto texture_result = create_texture(device, mem_props, width, height, upload.texture);
+        !texture_result) {
+        return fail(nonstd::make_unexpected(texture_result.error()));
+    }
+
+    const vk::DeviceSize size = static_cast<vk::DeviceSize>(width) * height * 4;
+    vk::BufferCreateInfo buffer_info{};
+    buffer_info.size = size;
+    buffer_info.usage = vk::BufferUsageFlagBits::eTransferSrc;
+    buffer_info.sharingMode = vk::SharingMode::eExclusive;
+    auto [buffer_result, buffer] = device.createBuffer(buffer_info);
+    if (buffer_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to create font staging buffer", buffer_result));
+    }
+    upload.staging_buffer = buffer;
+
+    auto requirements = device.getBufferMemoryRequirements(buffer);
+    auto mem_type = render::backend_internal::select_memory_type(
+        mem_props, requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible,
+        vk::MemoryPropertyFlagBits::eHostCoherent);
+    if (!mem_type) {
+        return fail(make_error<FontTextureUpload>(
+            ErrorCode::vulkan_init_failed, "No host-visible memory type for font staging buffer"));
+    }
+    const bool coherent = static_cast<bool>(mem_props.memoryTypes[*mem_type].propertyFlags &
+                                            vk::MemoryPropertyFlagBits::eHostCoherent);
+
+    vk::MemoryAllocateInfo alloc_info{};
+    alloc_info.allocationSize = requirements.size;
+    alloc_info.memoryTypeIndex = *mem_type;
+    auto [alloc_result, memory] = device.allocateMemory(alloc_info);
+    if (alloc_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to allocate font staging memory", alloc_result));
+    }
+    upload.staging_memory = memory;
+
+    auto bind_result = device.bindBufferMemory(buffer, memory, 0);
+    if (bind_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to bind font staging memory", bind_result));
+    }
+
+    auto [map_result, mapped] = device.mapMemory(memory, 0, VK_WHOLE_SIZE);
+    if (map_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to map font staging memory", map_result));
+    }
+    std::memcpy(mapped, pixels, static_cast<size_t>(size));
+    if (!coherent) {
+        auto flush_result =
+            device.flushMappedMemoryRanges(vk::MappedMemoryRange{memory, 0, VK_WHOLE_SIZE});
+        if (flush_result != vk::Result::eSuccess) {
+            device.unmapMemory(memory);
+            return fail(upload_error("Failed to flush font staging memory", flush_result));
+        }
+    }
+    device.unmapMemory(memory);
+
+    vk::CommandPoolCreateInfo pool_info{};
+    pool_info.flags = vk::CommandPoolCreateFlagBits::eTransient;
+    pool_info.queueFamilyIndex = transfer_queue_family;
+    auto [pool_result, pool] = device.createCommandPool(pool_info);
+    if (pool_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to create font upload command pool", pool_result));
+    }
+    upload.command_pool = pool;
+
+    vk::CommandBufferAllocateInfo cmd_info{};
+    cmd_info.commandPool = pool;
+    cmd_info.level = vk::CommandBufferLevel::ePrimary;
+    cmd_info.commandBufferCount = 1;
+    auto [cmd_result, cmds] = device.allocateCommandBuffers(cmd_info);
+    if (cmd_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to allocate font upload command buffer", cmd_result));
+    }
+    vk::CommandBuffer cmd = cmds[0];
+
+    vk::CommandBufferBeginInfo begin_info{};
+    begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    auto begin_result = cmd.begin(begin_info);
+    if (begin_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to begin font upload command buffer", begin_result));
+    }
+
+    vk::ImageMemoryBarrier to_transfer{};
+    to_transfer.srcAccessMask = {};
+    to_transfer.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+    to_transfer.oldLayout = vk::ImageLayout::eUndefined;
+    to_transfer.newLayout = vk::ImageLayout::eTransferDstOptimal;
+    to_transfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_transfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_transfer.image = upload.texture.image;
+    to_transfer.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                        vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, to_transfer);
+
+    vk::BufferImageCopy region{};
+    region.imageSubresource = {vk::ImageAspectFlagBits::eColor, 0, 0, 1};
+    region.imageExtent = vk::Extent3D{width, height, 1};
+    cmd.copyBufferToImage(buffer, upload.texture.image, vk::ImageLayout::eTransferDstOptimal,
+                          region);
+
+    vk::ImageMemoryBarrier to_shader = to_transfer;
+    to_shader.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    to_shader.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    to_shader.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    to_shader.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    upload.needs_acquire = transfer_queue_family != graphics_queue_family;
+    if (upload.needs_acquire) {
+        // Release half of the ownership transfer; the graphics queue performs the acquire.
+        to_shader.dstAccessMask = {};
+        to_shader.srcQueueFamilyIndex = transfer_queue_family;
+        to_shader.dstQueueFamilyIndex = graphics_queue_family;
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                            vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, to_shader);
+    } else {
+        cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                            vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, to_shader);
+    }
+
+    auto end_result = cmd.end();
+    if (end_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to end font upload command buffer", end_result));
+    }
+
+    auto [fence_result, fence] = device.createFence(vk::FenceCreateInfo{});
+    if (fence_result != vk::Result::eSuccess) {
+        return fail(upload_error("Failed to create font upload fence", fence_result));
+    }
+
+    vk::SubmitInfo submit_info{};
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &cmd;
+    auto submit_result = transfer_queue.submit(submit_info, fence);
+    if (submit_result != vk::Result::eSuccess) {
+        device.destroyFence(fence);
+        return fail(upload_error("Failed to submit font upload", submit_result));
+    }
+    // Only a submitted upload owns a fence, so `destroy()` never waits on one that cannot signal.
+    upload.fence = fence;
+    return upload;
+}
+
+auto FontTextureUpload::is_complete(vk::Device device) const -> bool {
+    return !fence || device.getFenceStatus(fence) != vk::Result::eNotReady;
+}
+
+void FontTextureUpload::release_staging(vk::Device device) {
+    if (fence) {
+        device.destroyFence(fence);
+        fence = nullptr;
+    }
+    if (command_pool) {
+        device.destroyCommandPool(command_pool);
+        command_pool = nullptr;
+    }
+    if (staging_buffer) {
+        device.destroyBuffer(staging_buffer);
+        staging_buffer = nullptr;
+    }
+    if (staging_memory) {
+        device.freeMemory(staging_memory);
+        staging_memory = nullptr;
+    }
+}
+
+void FontTextureUpload::destroy(vk::Device device) {
+    if (fence) {
+        auto wait_result =
+            device.waitForFences(fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+        if (wait_result != vk::Result::eSuccess) {
+            GOGGLES_LOG_WARN("Font upload fence wait failed: {}", vk::to_string(wait_result));
+        }
+    }
+    release_staging(device);
+    texture.destroy(device);
+}
+
+} // namespace goggles::ui
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <goggles/error.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace goggles::ui {
+
+/// @brief Sampled RGBA8 font atlas image owned by the overlay rather than the ImGui backend.
+struct FontTexture {
+    vk::Image image;
+    vk::DeviceMemory memory;
+    vk::ImageView view;
+    vk::Sampler sampler;
+
+    void destroy(vk::Device device);
+};
+
+/// @brief Records the graphics-queue half of a queue family ownership transfer of `texture`
+/// from `transfer_queue_family`; pairs with the release recorded by `FontTextureUpload::begin`.
+void record_font_texture_acquire(vk::CommandBuffer cmd, const FontTexture& texture,
+                                 uint32_t transfer_queue_family, uint32_t graphics_queue_family);
+
+/// @brief One-shot staging upload of a rasterized font atlas.
+///
+/// The copy is recorded on a transient command pool and submitted with its own fence, so the
+/// caller polls `is_complete()` once per frame instead of idling the device. The texture is
+/// left in `eShaderReadOnlyOptimal` once the fence signals. On a dedicated transfer family the
+/// upload ends with a release, and the first graphics use must record the matching acquire.
+struct FontTextureUpload {
+    FontTexture texture;
+    vk::Buffer staging_buffer;
+    vk::DeviceMemory staging_memory;
+    vk::CommandPool command_pool;
+    vk::Fence fence;
+    bool needs_acquire = false;
+
+    /// Copies `pixels` (tightly packed RGBA8) into staging memory and submits the transfer on
+    /// `transfer_queue`, which may belong to the graphics family itself.
+    [[nodiscard]] static auto begin(vk::Device device, vk::PhysicalDevice physical_device,
+                                    uint32_t transfer_queue_family, vk::Queue transfer_queue,
+                                    uint32_t graphics_queue_family, const unsigned char* pixels,
+                                    uint32_t width, uint32_t height) -> Result<FontTextureUpload>;
+
+    [[nodiscard]] auto is_complete(vk::Device device) const -> bool;
+    /// Frees the staging buffer, command pool, and fence. Call after `is_complete()`.
+    void release_staging(vk::Device device);
+    /// Waits for the transfer if it is still in flight, then frees everything including the
+    /// texture.
+    void destroy(vk::Device device);
+};
+
+} // namespace goggles::ui
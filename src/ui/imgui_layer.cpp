@@ -6,10 +6,12 @@
 #include <cmath>
 #include <compositor/compositor_server.hpp>
 #include <filesystem>
+#include <format>
 #include <goggles/profiling.hpp>
 #include <imgui.h>
 #include <imgui_impl_sdl3.h>
 #include <imgui_impl_vulkan.h>
+#include <util/job_system.hpp>
 #include <util/logging.hpp>
 #include <util/paths.hpp>
 #include <utility>
@@ -23,6 +25,14 @@ constexpr float K_MIN_FPS_PLOT_MAX = 120.0F;
 constexpr float K_UNCAPPED_FPS_PLOT_MAX = 240.0F;
 constexpr float K_MIN_LATENCY_PLOT_MAX_MS = 16.0F;
 constexpr float K_UNCAPPED_LATENCY_PLOT_MAX_MS = 25.0F;
+constexpr float K_UNCAPPED_GPU_FRAME_PLOT_MAX_MS = 8.0F;
+// Hover highlights, tooltips and collapse animations settle this long after the last input.
+constexpr auto K_INPUT_SETTLE_TIME = std::chrono::milliseconds(250);
+// A static overlay refreshes for metric-only changes at most this often.
+constexpr auto K_METRICS_REFRESH_INTERVAL = std::chrono::milliseconds(100);
+// Recorded overlay frames before a replaced font texture is destroyed; exceeds the renderer's
+// frames in flight, so no pending submission still samples it.
+constexpr uint64_t K_FONT_RETIRE_FRAMES = 3;
 
 struct PlotConfig {
     float uncapped_plot_max;
@@ -51,6 +61,29 @@ auto compute_game_fps_plot_max(uint32_t target_fps) -> float {
                                        .step = 10.0F});
 }
 
+auto compute_gpu_frame_plot_max_ms(uint32_t target_fps) -> float {
+    const float frame_budget_ms = target_fps == 0 ? 0.0F : 1000.0F / static_cast<float>(target_fps);
+    return compute_plot_max(target_fps,
+                            PlotConfig{.uncapped_plot_max = K_UNCAPPED_GPU_FRAME_PLOT_MAX_MS,
+                                       .capped_plot_max = frame_budget_ms,
+                                       .min_plot_max = K_UNCAPPED_GPU_FRAME_PLOT_MAX_MS,
+                                       .step = 1.0F});
+}
+
+auto gpu_timing_zone_label(util::GpuTimingZone zone) -> const char* {
+    switch (zone) {
+    case util::GpuTimingZone::import_barrier:
+        return "Import Barrier";
+    case util::GpuTimingZone::frame_interpolation:
+        return "Frame Interpolation";
+    case util::GpuTimingZone::filter_chain:
+        return "Filter Chain";
+    case util::GpuTimingZone::ui_overlay:
+        return "UI Overlay";
+    }
+    return "Unknown";
+}
+
 auto compute_compositor_latency_plot_max_ms(uint32_t target_fps) -> float {
     const float frame_budget_ms = target_fps == 0 ? 0.0F : 1000.0F / static_cast<float>(target_fps);
     return compute_plot_max(target_fps,
@@ -91,10 +124,8 @@ auto get_display_scale(SDL_Window* window) -> float {
     return scale;
 }
 
-void rebuild_fonts(const std::filesystem::path& font_path, float size_pixels, float display_scale) {
-    auto& io = ImGui::GetIO();
-    io.Fonts->Clear();
-
+auto add_overlay_font(ImFontAtlas& atlas, const std::filesystem::path& font_path,
+                      float size_pixels, float display_scale) -> ImFont* {
     ImFontConfig cfg{};
     cfg.RasterizerDensity = 1.0F;
 
@@ -102,8 +133,7 @@ void rebuild_fonts(const std::filesystem::path& font_path, float size_pixels, fl
     const float rasterized_size_pixels = size_pixels * display_scale;
     std::error_code ec;
     if (!font_path.empty() && std::filesystem::exists(font_path, ec) && !ec) {
-        font =
-            io.Fonts->AddFontFromFileTTF(font_path.string().c_str(), rasterized_size_pixels, &cfg);
+        font = atlas.AddFontFromFileTTF(font_path.string().c_str(), rasterized_size_pixels, &cfg);
         if (font == nullptr) {
             GOGGLES_LOG_WARN("Failed to load ImGui font from '{}', falling back to default",
                              font_path.string());
@@ -113,15 +143,56 @@ void rebuild_fonts(const std::filesystem::path& font_path, float size_pixels, fl
     if (font == nullptr) {
         ImFontConfig default_cfg = cfg;
         default_cfg.SizePixels = rasterized_size_pixels;
-        font = io.Fonts->AddFontDefault(&default_cfg);
+        font = atlas.AddFontDefault(&default_cfg);
     }
+    return font;
+}
 
-    io.FontDefault = font;
-    io.FontGlobalScale = 1.0F / display_scale;
+/// Rasterizes a standalone atlas off the main thread. The current ImGui context is thread-local
+/// (see `goggles_imconfig.h`), so `ImGui::MemAlloc` on a worker touches no context state.
+auto build_font_atlas(const std::filesystem::path& font_path, float size_pixels,
+                      float display_scale) -> FontAtlasPtr {
+    GOGGLES_PROFILE_SCOPE("BuildFontAtlas");
+    FontAtlasPtr atlas(IM_NEW(ImFontAtlas)());
+    add_overlay_font(*atlas, font_path, size_pixels, display_scale);
+
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+    return atlas;
+}
+
+void render_draw_data(vk::CommandBuffer cmd, vk::ImageView target_view, vk::Extent2D extent,
+                      ImDrawData* draw_data) {
+    vk::RenderingAttachmentInfo color_attachment{};
+    color_attachment.imageView = target_view;
+    color_attachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    color_attachment.loadOp = vk::AttachmentLoadOp::eLoad;
+    color_attachment.storeOp = vk::AttachmentStoreOp::eStore;
+
+    vk::RenderingInfo rendering_info{};
+    rendering_info.renderArea.offset = vk::Offset2D{0, 0};
+    rendering_info.renderArea.extent = extent;
+    rendering_info.layerCount = 1;
+    rendering_info.colorAttachmentCount = 1;
+    rendering_info.pColorAttachments = &color_attachment;
+
+    cmd.beginRendering(rendering_info);
+    ImGui_ImplVulkan_RenderDrawData(draw_data, cmd);
+    cmd.endRendering();
 }
 
 } // namespace
 
+void FontAtlasDeleter::operator()(ImFontAtlas* atlas) const {
+    IM_DELETE(atlas);
+}
+
+void DrawListDeleter::operator()(ImDrawList* draw_list) const {
+    IM_DELETE(draw_list);
+}
+
 auto ImGuiLayer::create(SDL_Window* window, const ImGuiConfig& config,
                         const util::AppDirs& app_dirs) -> ResultPtr<ImGuiLayer> {
     GOGGLES_PROFILE_FUNCTION();
@@ -132,6 +203,8 @@ auto ImGuiLayer::create(SDL_Window* window, const ImGuiConfig& config,
     layer->m_device = config.device;
     layer->m_queue_family = config.queue_family;
     layer->m_queue = config.queue;
+    layer->m_transfer_queue_family = config.transfer_queue_family;
+    layer->m_transfer_queue = config.transfer_queue;
     layer->m_swapchain_format = config.swapchain_format;
     layer->m_image_count = config.image_count;
     layer->m_font_path = util::resource_path(app_dirs, "assets/fonts/RobotoMono-Regular.ttf");
@@ -161,7 +234,9 @@ auto ImGuiLayer::create(SDL_Window* window, const ImGuiConfig& config,
 
     float display_scale = get_display_scale(window);
     layer->m_last_display_scale = display_scale;
-    rebuild_fonts(layer->m_font_path, layer->m_font_size_pixels, display_scale);
+    io.FontDefault =
+        add_overlay_font(*io.Fonts, layer->m_font_path, layer->m_font_size_pixels, display_scale);
+    io.FontGlobalScale = 1.0F / display_scale;
 
     if (!ImGui_ImplSDL3_InitForVulkan(window)) {
         return nonstd::make_unexpected(
@@ -242,6 +317,9 @@ void ImGuiLayer::shutdown() {
         if (wait_result != vk::Result::eSuccess) {
             GOGGLES_LOG_WARN("waitIdle failed in ImGui shutdown: {}", vk::to_string(wait_result));
         }
+        destroy_font_resources();
+        destroy_cursor_resources();
+        m_cursor_draw_list.reset();
         ImGui_ImplVulkan_Shutdown();
         ImGui_ImplSDL3_Shutdown();
         ImGui::DestroyContext();
@@ -255,85 +333,320 @@ void ImGuiLayer::shutdown() {
 }
 
 void ImGuiLayer::process_event(const SDL_Event& event) {
-    if (!m_initialized) {
+    if (!m_initialized || !m_global_visible) {
         return;
     }
     ImGui_ImplSDL3_ProcessEvent(&event);
+    m_settle_until = std::chrono::steady_clock::now() + K_INPUT_SETTLE_TIME;
+}
+
+void ImGuiLayer::set_global_visible(bool visible) {
+    if (visible == m_global_visible) {
+        return;
+    }
+    m_global_visible = visible;
+    if (visible && m_initialized) {
+        // Key releases were not forwarded while hidden; drop any keys ImGui still holds.
+        ImGui::GetIO().ClearInputKeys();
+    }
+    mark_dirty();
 }
 
 void ImGuiLayer::begin_frame() {
     GOGGLES_PROFILE_FUNCTION();
-    if (!m_initialized) {
+    if (m_frame_begun) {
+        // The previous frame was never recorded (e.g. acquire failed); close it out.
+        ImGui::EndFrame();
+        m_frame_begun = false;
+    }
+    if (!m_initialized || !m_global_visible) {
         return;
     }
 
-    if (m_window != nullptr) {
-        float display_scale = get_display_scale(m_window);
-        if (std::fabs(display_scale - m_last_display_scale) > 0.01F) {
-            auto wait_result = m_device.waitIdle();
-            if (wait_result != vk::Result::eSuccess) {
-                GOGGLES_LOG_WARN("waitIdle failed during ImGui DPI font rebuild: {}",
-                                 vk::to_string(wait_result));
-            }
-
-            rebuild_fonts(m_font_path, m_font_size_pixels, display_scale);
+    update_font_atlas();
 
-            ImGui_ImplVulkan_DestroyFontsTexture();
-            if (!ImGui_ImplVulkan_CreateFontsTexture()) {
-                GOGGLES_LOG_WARN(
-                    "ImGui_ImplVulkan_CreateFontsTexture failed after DPI change (scale={})",
-                    display_scale);
-            }
-
-            m_last_display_scale = display_scale;
-        }
+    const auto now = std::chrono::steady_clock::now();
+    const bool metrics_due =
+        m_metrics_pending && now - m_last_build_time >= K_METRICS_REFRESH_INTERVAL;
+    if (m_has_draw_data && !m_dirty && !metrics_due && now >= m_settle_until) {
+        return;
     }
+    m_dirty = false;
+    m_metrics_pending = false;
+    m_last_build_time = now;
 
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplSDL3_NewFrame();
     ImGui::NewFrame();
-
-    if (!m_global_visible) {
-        return;
-    }
+    m_frame_begun = true;
+    // NewFrame rebound the current font, so nothing references a swapped-out atlas anymore.
+    m_replaced_atlas.reset();
 
     draw_shader_controls();
     draw_app_management();
 }
 
 void ImGuiLayer::end_frame() {
-    if (!m_initialized) {
+    if (!m_frame_begun) {
         return;
     }
     ImGui::Render();
+    m_frame_begun = false;
+    m_has_draw_data = true;
 }
 
 void ImGuiLayer::record(vk::CommandBuffer cmd, vk::ImageView target_view, vk::Extent2D extent) {
     GOGGLES_PROFILE_FUNCTION();
+    if (!m_initialized || !m_global_visible || !m_has_draw_data) {
+        return;
+    }
+    if (m_font_acquire_pending) {
+        record_font_texture_acquire(cmd, m_font_texture, m_transfer_queue_family, m_queue_family);
+        m_font_acquire_pending = false;
+    }
+
+    render_draw_data(cmd, target_view, extent, ImGui::GetDrawData());
+    ++m_recorded_frames;
+}
+
+void ImGuiLayer::set_cursor_images(const std::vector<compositor::CursorImage>& images) {
+    GOGGLES_PROFILE_FUNCTION();
+    destroy_cursor_resources();
+
+    uint32_t atlas_width = 0;
+    uint32_t atlas_height = 0;
+    for (const auto& image : images) {
+        atlas_width += image.width;
+        atlas_height = std::max(atlas_height, image.height);
+    }
+    if (!m_device || atlas_width == 0 || atlas_height == 0) {
+        return;
+    }
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(atlas_width) * atlas_height * 4, 0);
+    uint32_t x_offset = 0;
+    for (const auto& image : images) {
+        const size_t row_bytes = static_cast<size_t>(image.width) * 4;
+        for (uint32_t y = 0; y < image.height; ++y) {
+            std::copy_n(image.rgba.data() + (y * row_bytes), row_bytes,
+                        pixels.data() + ((static_cast<size_t>(y) * atlas_width + x_offset) * 4));
+        }
+        m_cursor_frames.push_back({
+            .u_min = static_cast<float>(x_offset) / static_cast<float>(atlas_width),
+            .u_max = static_cast<float>(x_offset + image.width) / static_cast<float>(atlas_width),
+            .v_max = static_cast<float>(image.height) / static_cast<float>(atlas_height),
+            .width = image.width,
+            .height = image.height,
+            .hotspot_x = image.hotspot_x,
+            .hotspot_y = image.hotspot_y,
+        });
+        x_offset += image.width;
+    }
+
+    auto upload = FontTextureUpload::begin(m_device, m_physical_device, m_transfer_queue_family,
+                                           m_transfer_queue, m_queue_family, pixels.data(),
+                                           atlas_width, atlas_height);
+    if (!upload) {
+        GOGGLES_LOG_WARN("Cursor texture upload failed, cursor overlay disabled: {}",
+                         upload.error().message);
+        m_cursor_frames.clear();
+        return;
+    }
+    m_cursor_upload = std::move(*upload);
+}
+
+void ImGuiLayer::record_cursor(vk::CommandBuffer cmd, vk::ImageView target_view,
+                               vk::Extent2D extent, const CursorOverlay& cursor) {
+    GOGGLES_PROFILE_FUNCTION();
     if (!m_initialized) {
         return;
     }
-    vk::RenderingAttachmentInfo color_attachment{};
-    color_attachment.imageView = target_view;
-    color_attachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
-    color_attachment.loadOp = vk::AttachmentLoadOp::eLoad;
-    color_attachment.storeOp = vk::AttachmentStoreOp::eStore;
+    if (m_cursor_upload && m_cursor_upload->is_complete(m_device)) {
+        m_cursor_upload->release_staging(m_device);
+        m_cursor_texture = m_cursor_upload->texture;
+        m_cursor_acquire_pending = m_cursor_upload->needs_acquire;
+        m_cursor_upload.reset();
+    }
+    if (m_cursor_texture.view && !m_cursor_descriptor_set) {
+        m_cursor_descriptor_set =
+            ImGui_ImplVulkan_AddTexture(m_cursor_texture.sampler, m_cursor_texture.view,
+                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    if (!m_cursor_descriptor_set || cursor.image_index >= m_cursor_frames.size()) {
+        return;
+    }
+    if (m_cursor_acquire_pending) {
+        record_font_texture_acquire(cmd, m_cursor_texture, m_transfer_queue_family,
+                                    m_queue_family);
+        m_cursor_acquire_pending = false;
+    }
 
-    vk::RenderingInfo rendering_info{};
-    rendering_info.renderArea.offset = vk::Offset2D{0, 0};
-    rendering_info.renderArea.extent = extent;
-    rendering_info.layerCount = 1;
-    rendering_info.colorAttachmentCount = 1;
-    rendering_info.pColorAttachments = &color_attachment;
+    const auto& frame = m_cursor_frames[cursor.image_index];
+    const ImVec2 image_min(cursor.x - (static_cast<float>(frame.hotspot_x) * cursor.scale_x),
+                           cursor.y - (static_cast<float>(frame.hotspot_y) * cursor.scale_y));
+    const ImVec2 image_max(image_min.x + (static_cast<float>(frame.width) * cursor.scale_x),
+                           image_min.y + (static_cast<float>(frame.height) * cursor.scale_y));
+    const ImVec2 display_size(static_cast<float>(extent.width),
+                              static_cast<float>(extent.height));
+
+    // A standalone draw list keeps the cursor out of the UI's cached draw data and frame state.
+    if (!m_cursor_draw_list) {
+        m_cursor_draw_list.reset(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+    }
+    auto& draw_list = *m_cursor_draw_list;
+    draw_list._ResetForNewFrame();
+    draw_list.PushClipRect(ImVec2(0.0F, 0.0F), display_size);
+    draw_list.AddImage(reinterpret_cast<ImTextureID>(
+                           static_cast<VkDescriptorSet>(m_cursor_descriptor_set)),
+                       image_min, image_max, ImVec2(frame.u_min, 0.0F),
+                       ImVec2(frame.u_max, frame.v_max));
+    draw_list.PopClipRect();
+
+    ImDrawData draw_data;
+    draw_data.Valid = true;
+    draw_data.DisplayPos = ImVec2(0.0F, 0.0F);
+    draw_data.DisplaySize = display_size;
+    draw_data.FramebufferScale = ImVec2(1.0F, 1.0F);
+    draw_data.AddDrawList(&draw_list);
+    render_draw_data(cmd, target_view, extent, &draw_data);
+}
 
-    cmd.beginRendering(rendering_info);
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
-    cmd.endRendering();
+void ImGuiLayer::release_cursor_descriptor() {
+    if (m_cursor_descriptor_set) {
+        ImGui_ImplVulkan_RemoveTexture(static_cast<VkDescriptorSet>(m_cursor_descriptor_set));
+        m_cursor_descriptor_set = nullptr;
+    }
+}
+
+void ImGuiLayer::destroy_cursor_resources() {
+    // Like `destroy_font_resources()`: the device is idle and the ImGui backend still alive.
+    release_cursor_descriptor();
+    m_cursor_texture.destroy(m_device);
+    m_cursor_texture = {};
+    if (m_cursor_upload) {
+        m_cursor_upload->destroy(m_device);
+        m_cursor_upload.reset();
+    }
+    m_cursor_frames.clear();
+    m_cursor_acquire_pending = false;
+}
+
+void ImGuiLayer::update_font_atlas() {
+    GOGGLES_PROFILE_FUNCTION();
+    std::erase_if(m_retired_font_textures, [this](RetiredFontTexture& retired) {
+        if (m_recorded_frames < retired.destroy_after_frame) {
+            return false;
+        }
+        ImGui_ImplVulkan_RemoveTexture(static_cast<VkDescriptorSet>(retired.descriptor_set));
+        retired.texture.destroy(m_device);
+        return true;
+    });
+
+    if (m_font_upload && m_font_upload->is_complete(m_device)) {
+        swap_font_atlas();
+    }
+
+    if (m_font_job.valid() &&
+        m_font_job.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        auto atlas = m_font_job.get();
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+        auto upload = pixels != nullptr
+                          ? FontTextureUpload::begin(m_device, m_physical_device,
+                                                     m_transfer_queue_family, m_transfer_queue,
+                                                     m_queue_family, pixels,
+                                                     static_cast<uint32_t>(width),
+                                                     static_cast<uint32_t>(height))
+                          : make_error<FontTextureUpload>(ErrorCode::unknown_error,
+                                                          "Font atlas rasterization failed");
+        if (upload) {
+            m_font_upload = std::move(*upload);
+            m_uploading_atlas = std::move(atlas);
+        } else {
+            // Keep the current atlas rather than retrying the same scale every frame.
+            GOGGLES_LOG_WARN("Font atlas rebuild failed after DPI change (scale={}): {}",
+                             m_font_job_scale, upload.error().message);
+            m_last_display_scale = m_font_job_scale;
+        }
+    }
+
+    if (m_window == nullptr || m_font_job.valid() || m_font_upload) {
+        return;
+    }
+    const float display_scale = get_display_scale(m_window);
+    if (std::fabs(display_scale - m_last_display_scale) <= 0.01F) {
+        return;
+    }
+    m_font_job_scale = display_scale;
+    m_font_job = util::JobSystem::submit(
+        [font_path = m_font_path, size_pixels = m_font_size_pixels, display_scale] {
+            return build_font_atlas(font_path, size_pixels, display_scale);
+        });
+}
+
+void ImGuiLayer::swap_font_atlas() {
+    GOGGLES_PROFILE_FUNCTION();
+    FontTextureUpload upload = std::move(*m_font_upload);
+    m_font_upload.reset();
+    upload.release_staging(m_device);
+
+    VkDescriptorSet descriptor_set =
+        ImGui_ImplVulkan_AddTexture(upload.texture.sampler, upload.texture.view,
+                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    m_uploading_atlas->SetTexID(reinterpret_cast<ImTextureID>(descriptor_set));
+
+    retire_font_texture();
+    m_font_texture = upload.texture;
+    m_font_descriptor_set = descriptor_set;
+    m_font_acquire_pending = upload.needs_acquire;
+
+    // The old atlas stays alive until the next NewFrame rebinds the font stack.
+    auto& io = ImGui::GetIO();
+    m_replaced_atlas.reset(io.Fonts);
+    io.Fonts = m_uploading_atlas.release();
+    io.FontDefault = io.Fonts->Fonts.empty() ? nullptr : io.Fonts->Fonts.front();
+    io.FontGlobalScale = 1.0F / m_font_job_scale;
+    m_last_display_scale = m_font_job_scale;
+    mark_dirty();
+    GOGGLES_LOG_DEBUG("ImGui font atlas swapped for display scale {}", m_font_job_scale);
+}
+
+void ImGuiLayer::retire_font_texture() {
+    if (!m_font_descriptor_set) {
+        return;
+    }
+    m_retired_font_textures.push_back({
+        .texture = m_font_texture,
+        .descriptor_set = m_font_descriptor_set,
+        .destroy_after_frame = m_recorded_frames + K_FONT_RETIRE_FRAMES,
+    });
+    m_font_texture = {};
+    m_font_descriptor_set = nullptr;
+    m_font_acquire_pending = false;
+}
+
+void ImGuiLayer::destroy_font_resources() {
+    // Callers idle the device first and run this before ImGui_ImplVulkan_Shutdown, which
+    // RemoveTexture still needs.
+    retire_font_texture();
+    for (auto& retired : m_retired_font_textures) {
+        ImGui_ImplVulkan_RemoveTexture(static_cast<VkDescriptorSet>(retired.descriptor_set));
+        retired.texture.destroy(m_device);
+    }
+    m_retired_font_textures.clear();
+    if (m_font_upload) {
+        m_font_upload->destroy(m_device);
+        m_font_upload.reset();
+    }
+    m_uploading_atlas.reset();
 }
 
 void ImGuiLayer::set_preset_catalog(std::vector<std::filesystem::path> presets) {
     m_state.preset_catalog = std::move(presets);
     rebuild_preset_tree();
+    mark_dirty();
 }
 
 void ImGuiLayer::rebuild_preset_tree() {
@@ -394,10 +707,12 @@ void ImGuiLayer::set_current_preset(const std::filesystem::path& path) {
             break;
         }
     }
+    mark_dirty();
 }
 
 void ImGuiLayer::set_parameters(std::vector<ParameterState> params) {
     m_state.parameters = std::move(params);
+    mark_dirty();
 }
 
 void ImGuiLayer::set_parameter_change_callback(
@@ -420,6 +735,7 @@ void ImGuiLayer::set_prechain_state(vk::Extent2D resolution, ScaleMode scale_mod
     m_state.prechain.scale_mode = scale_mode;
     m_state.prechain.integer_scale = integer_scale;
     m_state.prechain.dirty = false;
+    mark_dirty();
 
     // Determine profile from height (width=0 means aspect-preserve)
     if (resolution.width == 0 && resolution.height == 0) {
@@ -441,6 +757,7 @@ void ImGuiLayer::set_prechain_state(vk::Extent2D resolution, ScaleMode scale_mod
 
 void ImGuiLayer::set_prechain_parameters(std::vector<goggles::fc::FilterControlDescriptor> params) {
     m_state.prechain.pass_parameters = std::move(params);
+    mark_dirty();
 }
 
 void ImGuiLayer::set_prechain_parameter_callback(
@@ -455,6 +772,17 @@ void ImGuiLayer::set_prechain_scale_mode_callback(
 
 void ImGuiLayer::set_runtime_metrics(util::CompositorRuntimeMetricsSnapshot metrics) {
     m_runtime_metrics = metrics;
+    m_metrics_pending = true;
+}
+
+void ImGuiLayer::set_gpu_timing(const util::GpuTimingSnapshot& timing) {
+    m_gpu_timing = timing;
+    m_metrics_pending = true;
+}
+
+void ImGuiLayer::set_gpu_memory(const util::GpuMemorySnapshot& memory) {
+    m_gpu_memory = memory;
+    m_metrics_pending = true;
 }
 
 void ImGuiLayer::set_target_fps(uint32_t target_fps) {
@@ -462,14 +790,28 @@ void ImGuiLayer::set_target_fps(uint32_t target_fps) {
     if (target_fps != 0) {
         m_last_capped_target_fps = target_fps;
     }
+    mark_dirty();
 }
 
 void ImGuiLayer::set_target_fps_change_callback(std::function<void(uint32_t)> callback) {
     m_on_target_fps_change = std::move(callback);
 }
 
+void ImGuiLayer::set_present_policy(PresentPolicy policy) {
+    m_present_policy = policy;
+    mark_dirty();
+}
+
+void ImGuiLayer::set_present_policy_change_callback(std::function<void(PresentPolicy)> callback) {
+    m_on_present_policy_change = std::move(callback);
+}
+
 void ImGuiLayer::set_surfaces(std::vector<compositor::SurfaceInfo> surfaces) {
+    if (surfaces == m_surfaces) {
+        return;
+    }
     m_surfaces = std::move(surfaces);
+    mark_dirty();
 }
 
 void ImGuiLayer::set_surface_select_callback(std::function<void(uint32_t)> callback) {
@@ -480,6 +822,15 @@ void ImGuiLayer::set_surface_filter_toggle_callback(std::function<void(uint32_t,
     m_on_surface_filter_toggle = std::move(callback);
 }
 
+void ImGuiLayer::set_surface_interpolation_toggle_callback(
+    std::function<void(uint32_t, bool)> callback) {
+    m_on_surface_interpolation_toggle = std::move(callback);
+}
+
+void ImGuiLayer::set_surface_tearing_toggle_callback(std::function<void(uint32_t, bool)> callback) {
+    m_on_surface_tearing_toggle = std::move(callback);
+}
+
 auto ImGuiLayer::wants_capture_keyboard() const -> bool {
     return ImGui::GetIO().WantCaptureKeyboard;
 }
@@ -805,6 +1156,79 @@ void ImGuiLayer::draw_parameter_controls() {
     }
 }
 
+void ImGuiLayer::draw_gpu_timing() {
+    if (!ImGui::CollapsingHeader("GPU Timing")) {
+        return;
+    }
+    if (!m_gpu_timing.available) {
+        ImGui::TextDisabled("GPU timestamps not supported on this queue");
+        return;
+    }
+
+    ImGui::Text("GPU Frame: %.3f ms", m_gpu_timing.frame_ms);
+    draw_runtime_metric_plot("##gpu_frame_plot", m_gpu_timing.frame_history_ms.data(),
+                             m_gpu_timing.frame_history_count, nullptr,
+                             compute_gpu_frame_plot_max_ms(m_target_fps));
+
+    if (ImGui::BeginTable("##gpu_zones", 2, ImGuiTableFlags_SizingStretchProp)) {
+        for (std::size_t i = 0; i < m_gpu_timing.zone_ms.size(); ++i) {
+            const float zone_ms = m_gpu_timing.zone_ms[i];
+            const float share = m_gpu_timing.frame_ms > 0.0F
+                                    ? std::clamp(zone_ms / m_gpu_timing.frame_ms, 0.0F, 1.0F)
+                                    : 0.0F;
+            const std::string overlay = std::format("{:.3f} ms", zone_ms);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(gpu_timing_zone_label(static_cast<util::GpuTimingZone>(i)));
+            ImGui::TableNextColumn();
+            ImGui::ProgressBar(share, ImVec2(-1.0F, 0.0F), overlay.c_str());
+        }
+        ImGui::EndTable();
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Smoothed GPU time per recorded segment. The filter chain covers "
+                          "pre-chain, effect passes and post-chain together.");
+    }
+}
+
+void ImGuiLayer::draw_gpu_memory() {
+    if (!ImGui::CollapsingHeader("GPU Memory")) {
+        return;
+    }
+
+    constexpr double MIB = 1024.0 * 1024.0;
+    ImGui::Text("Allocator: %.1f / %.1f MiB used",
+                static_cast<double>(m_gpu_memory.used_bytes) / MIB,
+                static_cast<double>(m_gpu_memory.allocated_bytes) / MIB);
+    ImGui::Text("Blocks: %u  Dedicated: %u", m_gpu_memory.block_count,
+                m_gpu_memory.dedicated_count);
+
+    if (!m_gpu_memory.budget_available) {
+        ImGui::TextDisabled("Heap budgets need VK_EXT_memory_budget");
+        return;
+    }
+    for (std::size_t i = 0; i < m_gpu_memory.heap_count; ++i) {
+        const auto& heap = m_gpu_memory.heaps[i];
+        if (heap.budget_bytes == 0) {
+            continue;
+        }
+        const float share =
+            std::clamp(static_cast<float>(static_cast<double>(heap.usage_bytes) /
+                                          static_cast<double>(heap.budget_bytes)),
+                       0.0F, 1.0F);
+        const std::string overlay =
+            std::format("{:.0f} / {:.0f} MiB", static_cast<double>(heap.usage_bytes) / MIB,
+                        static_cast<double>(heap.budget_bytes) / MIB);
+        ImGui::Text("Heap %zu%s", i, heap.device_local ? " (device)" : " (host)");
+        ImGui::ProgressBar(share, ImVec2(-1.0F, 0.0F), overlay.c_str());
+    }
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Process-wide usage against the driver's budget, including imported "
+                          "frames and filter chain resources.");
+    }
+}
+
 void ImGuiLayer::draw_app_management() {
     GOGGLES_PROFILE_FUNCTION();
     ImGui::SetNextWindowPos(ImVec2(370, 10), ImGuiCond_FirstUseEver);
@@ -857,8 +1281,45 @@ void ImGuiLayer::draw_app_management() {
                 ImGui::SetTooltip(
                     "Updates the live session pacing target for viewer and compositor");
             }
+
+            static constexpr std::array<const char*, 4> PRESENT_POLICY_LABELS = {
+                "Low Latency",
+                "Smooth",
+                "Adaptive",
+                "VRR",
+            };
+            static constexpr std::array<PresentPolicy, 4> PRESENT_POLICY_VALUES = {
+                PresentPolicy::low_latency,
+                PresentPolicy::smooth,
+                PresentPolicy::adaptive,
+                PresentPolicy::vrr,
+            };
+            int policy_index = 0;
+            for (size_t i = 0; i < PRESENT_POLICY_VALUES.size(); ++i) {
+                if (PRESENT_POLICY_VALUES[i] == m_present_policy) {
+                    policy_index = static_cast<int>(i);
+                    break;
+                }
+            }
+            ImGui::SetNextItemWidth(150);
+            if (ImGui::Combo("Present Policy", &policy_index, PRESENT_POLICY_LABELS.data(),
+                             static_cast<int>(PRESENT_POLICY_LABELS.size()))) {
+                m_present_policy = PRESENT_POLICY_VALUES[static_cast<size_t>(policy_index)];
+                if (m_on_present_policy_change) {
+                    m_on_present_policy_change(m_present_policy);
+                }
+            }
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("Low Latency: immediate or mailbox, tearing allowed\n"
+                                  "Smooth: FIFO with present-wait pacing\n"
+                                  "Adaptive: FIFO relaxed, tears only on late frames\n"
+                                  "VRR: present on frame arrival within the refresh range");
+            }
         }
 
+        draw_gpu_timing();
+        draw_gpu_memory();
+
         if (ImGui::CollapsingHeader("Window Management", ImGuiTreeNodeFlags_DefaultOpen)) {
             ImGui::Checkbox("Filter Chain (All Surfaces)", &m_state.window_filter_chain_enabled);
             if (ImGui::IsItemHovered()) {
@@ -887,6 +1348,30 @@ void ImGuiLayer::draw_app_management() {
                     }
                     ImGui::SameLine();
 
+                    bool interpolation_enabled = surface.frame_interpolation_enabled;
+                    if (ImGui::Checkbox("Interp", &interpolation_enabled)) {
+                        if (m_on_surface_interpolation_toggle) {
+                            m_on_surface_interpolation_toggle(surface.id, interpolation_enabled);
+                        }
+                    }
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("Synthesize frames between captured ones for each "
+                                          "present (adds one frame of latency)");
+                    }
+                    ImGui::SameLine();
+
+                    bool allow_tearing = surface.allow_tearing;
+                    if (ImGui::Checkbox("Tear", &allow_tearing)) {
+                        if (m_on_surface_tearing_toggle) {
+                            m_on_surface_tearing_toggle(surface.id, allow_tearing);
+                        }
+                    }
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("Honor this surface's async tearing hint: skip FPS "
+                                          "pacing and present each frame immediately");
+                    }
+                    ImGui::SameLine();
+
                     bool is_selected = surface.is_input_target;
                     std::string label;
                     if (!surface.title.empty()) {
@@ -944,6 +1429,14 @@ void ImGuiLayer::rebuild_for_format(vk::Format new_format) {
     }
 
     m_initialized = false;
+    // Cached draw data references the font descriptor the backend is about to destroy.
+    m_has_draw_data = false;
+    mark_dirty();
+    // The re-initialized backend uploads the current atlas itself, so the overlay-owned texture
+    // and any in-flight upload are dropped here; a pending rasterization job still lands later.
+    destroy_font_resources();
+    // The cursor texture is overlay-owned and survives; only its descriptor is re-created.
+    release_cursor_descriptor();
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplSDL3_Shutdown();
 
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "font_texture.hpp"
+
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <future>
 #include <goggles/error.hpp>
 #include <goggles/filter_chain/filter_controls.hpp>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <util/config.hpp>
 #include <util/runtime_metrics.hpp>
@@ -14,12 +20,15 @@
 
 struct SDL_Window;
 union SDL_Event;
+struct ImDrawList;
+struct ImFontAtlas;
 
 namespace goggles::util {
 struct AppDirs;
 }
 
 namespace goggles::compositor {
+struct CursorImage;
 struct SurfaceInfo;
 }
 
@@ -36,6 +45,9 @@ struct ImGuiConfig {
     vk::Device device;
     uint32_t queue_family;
     vk::Queue queue;
+    // Font atlas uploads; equal to `queue_family`/`queue` without a dedicated transfer family.
+    uint32_t transfer_queue_family;
+    vk::Queue transfer_queue;
     vk::Format swapchain_format;
     uint32_t image_count;
 };
@@ -79,6 +91,29 @@ struct ShaderControlState {
     PreChainState prechain;
 };
 
+/// @brief Compositor cursor placement over the filtered frame, in target pixels.
+struct CursorOverlay {
+    /// Where the cursor image's hotspot lands.
+    float x = 0.0F;
+    float y = 0.0F;
+    /// Cursor-image to target pixel scale, so the cursor keeps its size relative to the app.
+    float scale_x = 1.0F;
+    float scale_y = 1.0F;
+    uint32_t image_index = 0;
+
+    auto operator==(const CursorOverlay&) const -> bool = default;
+};
+
+struct FontAtlasDeleter {
+    void operator()(ImFontAtlas* atlas) const;
+};
+using FontAtlasPtr = std::unique_ptr<ImFontAtlas, FontAtlasDeleter>;
+
+struct DrawListDeleter {
+    void operator()(ImDrawList* draw_list) const;
+};
+using DrawListPtr = std::unique_ptr<ImDrawList, DrawListDeleter>;
+
 class ImGuiLayer {
 public:
     [[nodiscard]] static auto create(SDL_Window* window, const ImGuiConfig& config,
@@ -93,11 +128,23 @@ public:
 
     void shutdown();
 
+    /// Ignored while hidden, so a hidden overlay never queues ImGui input.
     void process_event(const SDL_Event& event);
+    /// Builds a new ImGui frame only when input, pushed state, or due metrics changed it;
+    /// otherwise the previous draw data is replayed by `record()`. No-op while hidden.
     void begin_frame();
     void end_frame();
+    /// Records nothing while hidden, so the caller may skip the overlay pass entirely.
     void record(vk::CommandBuffer cmd, vk::ImageView target_view, vk::Extent2D extent);
 
+    /// Uploads the compositor's cursor frames into one texture for `record_cursor()`. Call
+    /// before the first frame; the upload completes in the background.
+    void set_cursor_images(const std::vector<compositor::CursorImage>& images);
+    /// Draws only `cursor`, whether or not the overlay is visible. The ImGui backend reuses one
+    /// vertex buffer per draw call, so record either this or `record()` in a frame, not both.
+    void record_cursor(vk::CommandBuffer cmd, vk::ImageView target_view, vk::Extent2D extent,
+                       const CursorOverlay& cursor);
+
     void set_preset_catalog(std::vector<std::filesystem::path> presets);
     void set_current_preset(const std::filesystem::path& path);
     void set_parameters(std::vector<ParameterState> params);
@@ -112,24 +159,48 @@ public:
         std::function<void(goggles::fc::FilterControlId, float)> callback);
     void set_prechain_scale_mode_callback(std::function<void(ScaleMode, uint32_t)> callback);
     void set_runtime_metrics(util::CompositorRuntimeMetricsSnapshot metrics);
+    void set_gpu_timing(const util::GpuTimingSnapshot& timing);
+    void set_gpu_memory(const util::GpuMemorySnapshot& memory);
     void set_target_fps(uint32_t target_fps);
     void set_target_fps_change_callback(std::function<void(uint32_t)> callback);
+    void set_present_policy(PresentPolicy policy);
+    void set_present_policy_change_callback(std::function<void(PresentPolicy)> callback);
 
     [[nodiscard]] auto state() -> ShaderControlState& { return m_state; }
     [[nodiscard]] auto state() const -> const ShaderControlState& { return m_state; }
     [[nodiscard]] auto wants_capture_keyboard() const -> bool;
     [[nodiscard]] auto wants_capture_mouse() const -> bool;
 
-    void toggle_global_visibility() { m_global_visible = !m_global_visible; }
+    void toggle_global_visibility() { set_global_visible(!m_global_visible); }
+    void set_global_visible(bool visible);
     [[nodiscard]] auto is_globally_visible() const -> bool { return m_global_visible; }
 
     void set_surfaces(std::vector<compositor::SurfaceInfo> surfaces);
     void set_surface_select_callback(std::function<void(uint32_t)> callback);
     void set_surface_filter_toggle_callback(std::function<void(uint32_t, bool)> callback);
+    void set_surface_interpolation_toggle_callback(std::function<void(uint32_t, bool)> callback);
+    void set_surface_tearing_toggle_callback(std::function<void(uint32_t, bool)> callback);
 
     void rebuild_for_format(vk::Format new_format);
 
 private:
+    struct RetiredFontTexture {
+        FontTexture texture;
+        vk::DescriptorSet descriptor_set;
+        uint64_t destroy_after_frame = 0;
+    };
+
+    /// One cursor frame's cell in the cursor texture, which lays frames out left to right.
+    struct CursorAtlasFrame {
+        float u_min = 0.0F;
+        float u_max = 0.0F;
+        float v_max = 0.0F;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t hotspot_x = 0;
+        uint32_t hotspot_y = 0;
+    };
+
     ImGuiLayer() = default;
     void draw_shader_controls();
     void draw_prechain_stage_controls();
@@ -141,7 +212,16 @@ private:
     void draw_preset_tree(const PresetTreeNode& node);
     void draw_filtered_presets();
     void draw_app_management();
+    void draw_gpu_timing();
+    void draw_gpu_memory();
     void rebuild_preset_tree();
+    void update_font_atlas();
+    void swap_font_atlas();
+    void retire_font_texture();
+    void destroy_font_resources();
+    void release_cursor_descriptor();
+    void destroy_cursor_resources();
+    void mark_dirty() { m_dirty = true; }
     [[nodiscard]] auto matches_filter(const std::filesystem::path& path) const -> bool;
 
     std::filesystem::path m_font_path;
@@ -153,6 +233,8 @@ private:
     vk::Device m_device;
     uint32_t m_queue_family = 0;
     vk::Queue m_queue;
+    uint32_t m_transfer_queue_family = 0;
+    vk::Queue m_transfer_queue;
     vk::DescriptorPool m_descriptor_pool;
     vk::Format m_swapchain_format = vk::Format::eUndefined;
     uint32_t m_image_count = 0;
@@ -166,12 +248,42 @@ private:
     std::function<void(ScaleMode, uint32_t)> m_on_prechain_scale_mode;
     std::function<void(uint32_t)> m_on_surface_select;
     std::function<void(uint32_t, bool)> m_on_surface_filter_toggle;
+    std::function<void(uint32_t, bool)> m_on_surface_interpolation_toggle;
+    std::function<void(uint32_t, bool)> m_on_surface_tearing_toggle;
     std::function<void(uint32_t)> m_on_target_fps_change;
+    std::function<void(PresentPolicy)> m_on_present_policy_change;
     std::vector<compositor::SurfaceInfo> m_surfaces;
     util::CompositorRuntimeMetricsSnapshot m_runtime_metrics;
+    util::GpuTimingSnapshot m_gpu_timing;
+    util::GpuMemorySnapshot m_gpu_memory;
     uint32_t m_target_fps = 60;
     uint32_t m_last_capped_target_fps = 60;
+    PresentPolicy m_present_policy = PresentPolicy::smooth;
     float m_last_display_scale = 1.0F;
+    // DPI changes rasterize on the job system, upload behind a fence, and swap at a frame
+    // boundary; the replaced texture outlives the frames that may still sample it.
+    std::future<FontAtlasPtr> m_font_job;
+    float m_font_job_scale = 1.0F;
+    FontAtlasPtr m_uploading_atlas;
+    std::optional<FontTextureUpload> m_font_upload;
+    FontAtlasPtr m_replaced_atlas;
+    FontTexture m_font_texture;
+    vk::DescriptorSet m_font_descriptor_set;
+    bool m_font_acquire_pending = false;
+    std::vector<RetiredFontTexture> m_retired_font_textures;
+    std::vector<CursorAtlasFrame> m_cursor_frames;
+    std::optional<FontTextureUpload> m_cursor_upload;
+    FontTexture m_cursor_texture;
+    vk::DescriptorSet m_cursor_descriptor_set;
+    bool m_cursor_acquire_pending = false;
+    DrawListPtr m_cursor_draw_list;
+    uint64_t m_recorded_frames = 0;
+    std::chrono::steady_clock::time_point m_settle_until;
+    std::chrono::steady_clock::time_point m_last_build_time;
+    bool m_dirty = true;
+    bool m_metrics_pending = false;
+    bool m_frame_begun = false;
+    bool m_has_draw_data = false;
     bool m_global_visible = true;
     bool m_initialized = false;
 };
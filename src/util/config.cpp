@@ -83,6 +83,17 @@ auto parse_render(const toml::value& data, Config& config) -> Result<void> {
         if (render.contains("vsync")) {
             config.render.vsync = toml::find<bool>(render, "vsync");
         }
+        config.render.present_policy = present_policy_from_vsync(config.render.vsync);
+        if (render.contains("present_policy")) {
+            auto policy_str = toml::find<std::string>(render, "present_policy");
+            auto policy = parse_present_policy(policy_str);
+            if (!policy) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "Invalid present_policy: " + policy_str +
+                                            " (expected: low_latency, smooth, adaptive, vrr)");
+            }
+            config.render.present_policy = *policy;
+        }
         if (render.contains("target_fps")) {
             auto fps = toml::find<int64_t>(render, "target_fps");
             if (fps < 0 || fps > 1000) {
@@ -92,6 +103,37 @@ auto parse_render(const toml::value& data, Config& config) -> Result<void> {
             }
             config.render.target_fps = static_cast<uint32_t>(fps);
         }
+        if (render.contains("vrr_min_hz")) {
+            auto hz = toml::find<int64_t>(render, "vrr_min_hz");
+            if (hz < 1 || hz > 1000) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "Invalid vrr_min_hz: " + std::to_string(hz) +
+                                            " (expected: 1-1000)");
+            }
+            config.render.vrr_min_hz = static_cast<uint32_t>(hz);
+        }
+        if (render.contains("vrr_max_hz")) {
+            auto hz = toml::find<int64_t>(render, "vrr_max_hz");
+            if (hz < 1 || hz > 1000) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "Invalid vrr_max_hz: " + std::to_string(hz) +
+                                            " (expected: 1-1000)");
+            }
+            config.render.vrr_max_hz = static_cast<uint32_t>(hz);
+        }
+        if (config.render.vrr_min_hz > config.render.vrr_max_hz) {
+            return make_error<void>(ErrorCode::invalid_config,
+                                    "Invalid VRR range: vrr_min_hz " +
+                                        std::to_string(config.render.vrr_min_hz) +
+                                        " exceeds vrr_max_hz " +
+                                        std::to_string(config.render.vrr_max_hz));
+        }
+        if (render.contains("allow_tearing")) {
+            config.render.allow_tearing = toml::find<bool>(render, "allow_tearing");
+        }
+        if (render.contains("frame_interpolation")) {
+            config.render.frame_interpolation = toml::find<bool>(render, "frame_interpolation");
+        }
         if (render.contains("enable_validation")) {
             config.render.enable_validation = toml::find<bool>(render, "enable_validation");
         }
@@ -125,6 +167,28 @@ auto parse_render(const toml::value& data, Config& config) -> Result<void> {
         if (render.contains("gpu_selector")) {
             config.render.gpu_selector = toml::find<std::string>(render, "gpu_selector");
         }
+        if (render.contains("capture_all_surfaces")) {
+            config.render.capture_all_surfaces = toml::find<bool>(render, "capture_all_surfaces");
+        }
+        if (render.contains("cursor_plane")) {
+            auto plane_str = toml::find<std::string>(render, "cursor_plane");
+            auto plane = parse_cursor_plane(plane_str);
+            if (!plane) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "Invalid cursor_plane: " + plane_str +
+                                            " (expected: overlay, composited)");
+            }
+            config.render.cursor_plane = *plane;
+        }
+        if (render.contains("present_buffers")) {
+            auto count = toml::find<int64_t>(render, "present_buffers");
+            if (count < 2 || count > 8) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "Invalid present_buffers: " + std::to_string(count) +
+                                            " (expected: 2-8)");
+            }
+            config.render.present_buffers = static_cast<uint32_t>(count);
+        }
 
         return {};
     } catch (const std::exception& e) {
@@ -165,6 +229,96 @@ auto parse_logging(const toml::value& data, Config& config) -> Result<void> {
     }
 }
 
+auto parse_metrics(const toml::value& data, Config& config) -> Result<void> {
+    GOGGLES_PROFILE_FUNCTION();
+    try {
+        if (!data.contains("metrics")) {
+            return {};
+        }
+        const auto metrics = toml::find(data, "metrics");
+        if (metrics.contains("enabled")) {
+            config.metrics.enabled = toml::find<bool>(metrics, "enabled");
+        }
+        if (metrics.contains("socket")) {
+            config.metrics.socket = toml::find<std::string>(metrics, "socket");
+            if (config.metrics.socket.empty()) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "[metrics].socket must not be empty");
+            }
+        }
+        return {};
+    } catch (const std::exception& e) {
+        return make_error<void>(ErrorCode::invalid_config,
+                                "Invalid [metrics] configuration: " + std::string(e.what()));
+    }
+}
+
+auto parse_control(const toml::value& data, Config& config) -> Result<void> {
+    GOGGLES_PROFILE_FUNCTION();
+    try {
+        if (!data.contains("control")) {
+            return {};
+        }
+        const auto control = toml::find(data, "control");
+        if (control.contains("enabled")) {
+            config.control.enabled = toml::find<bool>(control, "enabled");
+        }
+        if (control.contains("socket")) {
+            config.control.socket = toml::find<std::string>(control, "socket");
+            if (config.control.socket.empty()) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "[control].socket must not be empty");
+            }
+        }
+        return {};
+    } catch (const std::exception& e) {
+        return make_error<void>(ErrorCode::invalid_config,
+                                "Invalid [control] configuration: " + std::string(e.what()));
+    }
+}
+
+auto parse_frame_export(const toml::value& data, Config& config) -> Result<void> {
+    GOGGLES_PROFILE_FUNCTION();
+    try {
+        if (!data.contains("frame_export")) {
+            return {};
+        }
+        const auto frame_export = toml::find(data, "frame_export");
+        if (frame_export.contains("enabled")) {
+            config.frame_export.enabled = toml::find<bool>(frame_export, "enabled");
+        }
+        if (frame_export.contains("socket")) {
+            config.frame_export.socket = toml::find<std::string>(frame_export, "socket");
+            if (config.frame_export.socket.empty()) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "[frame_export].socket must not be empty");
+            }
+        }
+        if (frame_export.contains("ring_size")) {
+            auto ring_size = toml::find<int64_t>(frame_export, "ring_size");
+            if (ring_size < 2 || ring_size > 8) {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "Invalid [frame_export].ring_size: " +
+                                            std::to_string(ring_size) + " (expected: 2-8)");
+            }
+            config.frame_export.ring_size = static_cast<uint32_t>(ring_size);
+        }
+        if (frame_export.contains("storage")) {
+            auto storage = toml::find<std::string>(frame_export, "storage");
+            if (storage != "auto" && storage != "memfd") {
+                return make_error<void>(ErrorCode::invalid_config,
+                                        "Invalid [frame_export].storage: " + storage +
+                                            " (expected: auto, memfd)");
+            }
+            config.frame_export.force_memfd = storage == "memfd";
+        }
+        return {};
+    } catch (const std::exception& e) {
+        return make_error<void>(ErrorCode::invalid_config,
+                                "Invalid [frame_export] configuration: " + std::string(e.what()));
+    }
+}
+
 } // namespace
 
 auto default_config() -> Config {
@@ -198,6 +352,9 @@ auto load_config(const std::filesystem::path& path) -> Result<Config> {
     GOGGLES_TRY(parse_shader(data, config));
     GOGGLES_TRY(parse_render(data, config));
     GOGGLES_TRY(parse_logging(data, config));
+    GOGGLES_TRY(parse_metrics(data, config));
+    GOGGLES_TRY(parse_control(data, config));
+    GOGGLES_TRY(parse_frame_export(data, config));
     return config;
 }
 
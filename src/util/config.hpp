@@ -1,5 +1,7 @@
 #pragma once
 
+#include "cursor_plane.hpp"
+#include "present_policy.hpp"
 #include "scale_mode.hpp"
 
 #include <cstdint>
@@ -25,14 +27,31 @@ struct Config {
 
     struct Render {
         bool vsync = true;
+        // Defaults to the policy implied by `vsync` when not set explicitly.
+        PresentPolicy present_policy = PresentPolicy::smooth;
         uint32_t target_fps = 60; // 0 = uncapped
+        // Refresh window of the display under the `vrr` present policy.
+        uint32_t vrr_min_hz = 48;
+        uint32_t vrr_max_hz = 165;
+        // Initial state of each surface's tearing toggle (honor its wp_tearing_control_v1 hint).
+        bool allow_tearing = false;
+        // Initial state of each surface's frame interpolation toggle.
+        bool frame_interpolation = false;
         bool enable_validation = false;
         ScaleMode scale_mode = ScaleMode::fill;
         uint32_t integer_scale = 0;
         std::string gpu_selector;
+        // Filter every filter-enabled surface, tiled into the viewer, not just the input target.
+        bool capture_all_surfaces = false;
+        // Headless runs always composite the cursor, since there is no viewer to draw it.
+        CursorPlane cursor_plane = CursorPlane::overlay;
+        // Compositor render buffers per captured size; the last few sizes stay pooled.
+        uint32_t present_buffers = 3;
         // Injected from CLI --app-width/--app-height; not parsed from TOML.
         uint32_t source_width = 0;
         uint32_t source_height = 0;
+        // Injected from CLI --lockstep; not parsed from TOML.
+        bool lockstep = false;
     } render;
 
     struct Logging {
@@ -40,6 +59,27 @@ struct Config {
         std::string file;
         bool timestamp = false;
     } logging;
+
+    struct Metrics {
+        bool enabled = false;
+        // Relative paths resolve against the runtime directory.
+        std::string socket = "metrics.sock";
+    } metrics;
+
+    struct Control {
+        bool enabled = false;
+        // Relative paths resolve against the runtime directory.
+        std::string socket = "control.sock";
+    } control;
+
+    struct FrameExport {
+        bool enabled = false;
+        // Relative paths resolve against the runtime directory.
+        std::string socket = "frames.sock";
+        uint32_t ring_size = 3;
+        // Skip DMA-BUF and always publish CPU-filled memfd buffers.
+        bool force_memfd = false;
+    } frame_export;
 };
 
 [[nodiscard]] auto load_config(const std::filesystem::path& path) -> Result<Config>;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace goggles {
+
+/// @brief Where the target app's pointer cursor is drawn.
+enum class CursorPlane : std::uint8_t {
+    /// Drawn by the viewer after the filter chain from state exported beside each frame; pointer
+    /// motion never re-renders the captured frame.
+    overlay,
+    /// Baked into captured frames by the compositor and filtered together with the app.
+    composited,
+};
+
+[[nodiscard]] constexpr auto to_string(CursorPlane plane) -> const char* {
+    switch (plane) {
+    case CursorPlane::overlay:
+        return "overlay";
+    case CursorPlane::composited:
+        return "composited";
+    }
+    return "unknown";
+}
+
+[[nodiscard]] constexpr auto parse_cursor_plane(std::string_view name)
+    -> std::optional<CursorPlane> {
+    if (name == "overlay") {
+        return CursorPlane::overlay;
+    }
+    if (name == "composited") {
+        return CursorPlane::composited;
+    }
+    return std::nullopt;
+}
+
+} // namespace goggles
@@ -19,7 +19,25 @@ struct ExternalImage {
 struct ExternalImageFrame {
     ExternalImage image;
     uint64_t frame_number = 0;
+    /// `CLOCK_MONOTONIC` nanoseconds of the client commit that produced the frame, or the
+    /// compositor's virtual clock when it runs in lockstep.
+    uint64_t commit_time_ns = 0;
     util::UniqueFd sync_fd;
 };
 
+/// @brief When the viewer's present of a captured frame completed, reported back to the client.
+struct PresentFeedback {
+    /// `ExternalImageFrame::frame_number` of the presented frame.
+    uint64_t frame_number = 0;
+    /// `CLOCK_MONOTONIC` nanoseconds the present completed.
+    uint64_t time_ns = 0;
+    /// Increments with every viewer present.
+    uint64_t sequence = 0;
+    /// Reported by `vkWaitForPresentKHR`. Otherwise `time_ns` is when the frame's render fence
+    /// was seen signaled: only an approximation, since the image may reach the display later.
+    bool hw_completion = false;
+    /// Presented in step with the display's vblank; only claimed for `hw_completion` reports.
+    bool vsync = false;
+};
+
 } // namespace goggles::util
@@ -0,0 +1,290 @@
+#include "frame_export.hpp"
+
+#include "logging.hpp"
+#include "metrics.hpp"
+#include "unix_socket.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <goggles/profiling.hpp>
+#include <poll.h>
+#include <span>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+namespace goggles::util {
+
+namespace {
+
+constexpr int K_POLL_INTERVAL_MS = 200;
+
+struct ExportClient {
+    UniqueFd fd;
+    bool ring_pending = false;
+    std::deque<std::shared_ptr<const FrameExportServer::Frame>> backlog;
+    uint32_t dropped = 0;
+};
+
+enum class SendStatus : std::uint8_t {
+    sent,
+    would_block,
+    failed,
+};
+
+auto send_message(int fd, const void* data, size_t size, std::span<const int> fds) -> SendStatus {
+    iovec iov{.iov_base = const_cast<void*>(data), .iov_len = size};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int) * FrameExportServer::MAX_RING_SIZE)>
+        control{};
+    if (!fds.empty()) {
+        msg.msg_control = control.data();
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+    }
+
+    while (true) {
+        if (::sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT) >= 0) {
+            return SendStatus::sent;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK ? SendStatus::would_block
+                                                       : SendStatus::failed;
+    }
+}
+
+/// Sends what the client's socket accepts without blocking.
+/// @return False if the client should be disconnected.
+auto flush_client(ExportClient& client, const FrameExportServer::Ring* ring) -> bool {
+    if (client.ring_pending && ring) {
+        std::array<int, FrameExportServer::MAX_RING_SIZE> fds{};
+        for (size_t i = 0; i < ring->buffers.size(); ++i) {
+            fds[i] = ring->buffers[i].get();
+        }
+        const auto status = send_message(client.fd.get(), &ring->info, sizeof(ring->info),
+                                         std::span{fds.data(), ring->buffers.size()});
+        if (status != SendStatus::sent) {
+            return status == SendStatus::would_block;
+        }
+        client.ring_pending = false;
+    }
+
+    while (!client.ring_pending && !client.backlog.empty()) {
+        const auto& frame = *client.backlog.front();
+        auto info = frame.info;
+        info.dropped = client.dropped;
+        const int sync_fd = frame.sync_fd.get();
+        const auto fds = info.has_sync_fd != 0 ? std::span{&sync_fd, 1} : std::span<const int>{};
+        const auto status = send_message(client.fd.get(), &info, sizeof(info), fds);
+        if (status != SendStatus::sent) {
+            return status == SendStatus::would_block;
+        }
+        client.dropped = 0;
+        client.backlog.pop_front();
+    }
+    return true;
+}
+
+auto has_unsent(const ExportClient& client) -> bool {
+    return client.ring_pending || !client.backlog.empty();
+}
+
+} // namespace
+
+auto FrameExportServer::create(const std::filesystem::path& socket_path)
+    -> ResultPtr<FrameExportServer> {
+    GOGGLES_PROFILE_FUNCTION();
+
+    auto listen_fd = GOGGLES_TRY(listen_unix_socket(socket_path, SOCK_SEQPACKET));
+    UniqueFd wake_fd{::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+    if (!wake_fd) {
+        std::error_code ec;
+        std::filesystem::remove(socket_path, ec);
+        return make_error<std::unique_ptr<FrameExportServer>>(
+            ErrorCode::unknown_error,
+            "Failed to create frame export eventfd: " + std::string(std::strerror(errno)));
+    }
+
+    auto server = std::unique_ptr<FrameExportServer>(new FrameExportServer());
+    server->m_socket_path = socket_path;
+    server->m_listen_fd = std::move(listen_fd);
+    server->m_wake_fd = std::move(wake_fd);
+    server->m_thread = std::jthread(
+        [self = server.get()](const std::stop_token& stop_token) { self->serve(stop_token); });
+
+    GOGGLES_LOG_INFO("Frame export socket listening on {}", socket_path.string());
+    return {std::move(server)};
+}
+
+FrameExportServer::~FrameExportServer() {
+    if (m_thread.joinable()) {
+        m_thread.request_stop();
+        wake();
+        m_thread.join();
+    }
+    m_listen_fd = UniqueFd{};
+    if (!m_socket_path.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(m_socket_path, ec);
+    }
+}
+
+auto FrameExportServer::publish_ring(FrameExportRingInfo info, std::vector<UniqueFd> buffers)
+    -> uint32_t {
+    if (buffers.size() > MAX_RING_SIZE) {
+        buffers.resize(MAX_RING_SIZE);
+    }
+    uint32_t generation = 0;
+    {
+        std::lock_guard lock(m_mutex);
+        generation = ++m_generation;
+        info.generation = generation;
+        info.buffer_count = static_cast<uint32_t>(buffers.size());
+        m_ring = std::make_shared<const Ring>(Ring{.info = info, .buffers = std::move(buffers)});
+        m_pending_frames.clear();
+        m_dropped_pending = 0;
+    }
+    wake();
+    return generation;
+}
+
+void FrameExportServer::publish_frame(const FrameExportFrameInfo& info, UniqueFd sync_fd) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_pending_frames.push_back(
+            std::make_shared<const Frame>(Frame{.info = info, .sync_fd = std::move(sync_fd)}));
+        // Only the newest slots of the ring are still intact; older announcements are stale.
+        while (m_pending_frames.size() > MAX_RING_SIZE) {
+            m_pending_frames.pop_front();
+            ++m_dropped_pending;
+            Metrics::increment(MetricCounter::frames_export_dropped);
+        }
+    }
+    Metrics::increment(MetricCounter::frames_exported);
+    wake();
+}
+
+void FrameExportServer::wake() {
+    const uint64_t one = 1;
+    static_cast<void>(::write(m_wake_fd.get(), &one, sizeof(one)));
+}
+
+void FrameExportServer::serve(const std::stop_token& stop_token) {
+    std::vector<ExportClient> clients;
+    std::vector<pollfd> pfds;
+    std::shared_ptr<const Ring> ring;
+    std::deque<std::shared_ptr<const Frame>> frames;
+    std::array<char, 256> discard{};
+
+    while (!stop_token.stop_requested()) {
+        pfds.clear();
+        pfds.push_back({.fd = m_listen_fd.get(), .events = POLLIN, .revents = 0});
+        pfds.push_back({.fd = m_wake_fd.get(), .events = POLLIN, .revents = 0});
+        for (const auto& client : clients) {
+            const short events = has_unsent(client) ? POLLIN | POLLOUT : POLLIN;
+            pfds.push_back({.fd = client.fd.get(), .events = events, .revents = 0});
+        }
+        if (::poll(pfds.data(), pfds.size(), K_POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        GOGGLES_PROFILE_SCOPE("FrameExportPoll");
+
+        if ((pfds[1].revents & POLLIN) != 0) {
+            uint64_t wake_count = 0;
+            static_cast<void>(::read(m_wake_fd.get(), &wake_count, sizeof(wake_count)));
+            uint32_t dropped_pending = 0;
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_ring != ring) {
+                    ring = m_ring;
+                    for (auto& client : clients) {
+                        client.ring_pending = true;
+                        client.backlog.clear();
+                        client.dropped = 0;
+                    }
+                }
+                frames.swap(m_pending_frames);
+                dropped_pending = std::exchange(m_dropped_pending, 0);
+            }
+            if (dropped_pending > 0) {
+                // Frames even older than the dropped ones point at slots already reused.
+                for (auto& client : clients) {
+                    Metrics::increment(MetricCounter::frames_export_dropped,
+                                       client.backlog.size());
+                    client.dropped += static_cast<uint32_t>(client.backlog.size()) +
+                                      dropped_pending;
+                    client.backlog.clear();
+                }
+            }
+
+            const size_t max_backlog =
+                ring ? std::max<size_t>(1, ring->info.buffer_count - 1) : size_t{1};
+            for (const auto& frame : frames) {
+                if (!ring || frame->info.generation != ring->info.generation) {
+                    continue;
+                }
+                for (auto& client : clients) {
+                    client.backlog.push_back(frame);
+                    if (client.backlog.size() > max_backlog) {
+                        client.backlog.pop_front();
+                        ++client.dropped;
+                        Metrics::increment(MetricCounter::frames_export_dropped);
+                    }
+                }
+            }
+            frames.clear();
+        }
+
+        // Client slots map to pfds[2..]; walk backwards so erasing keeps indices valid.
+        for (size_t i = clients.size(); i-- > 0;) {
+            auto& client = clients[i];
+            const auto revents = pfds[i + 2].revents;
+            bool keep = (revents & (POLLERR | POLLNVAL)) == 0;
+            if (keep && (revents & (POLLIN | POLLHUP)) != 0) {
+                // Consumers have nothing to say; reading only detects the hangup.
+                const auto received =
+                    ::recv(client.fd.get(), discard.data(), discard.size(), MSG_DONTWAIT);
+                if (received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR)) {
+                    keep = false;
+                }
+            }
+            if (keep) {
+                keep = flush_client(client, ring.get());
+            }
+            if (!keep) {
+                clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+
+        if ((pfds[0].revents & POLLIN) != 0) {
+            UniqueFd client{
+                ::accept4(m_listen_fd.get(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)};
+            if (client && clients.size() < MAX_CLIENTS) {
+                auto& added = clients.emplace_back();
+                added.fd = std::move(client);
+                added.ring_pending = ring != nullptr;
+                if (!flush_client(added, ring.get())) {
+                    clients.pop_back();
+                }
+            } else if (client) {
+                GOGGLES_LOG_WARN("Frame export client rejected: {} clients already connected",
+                                 MAX_CLIENTS);
+            }
+        }
+        m_client_count.store(clients.size(), std::memory_order_relaxed);
+    }
+}
+
+} // namespace goggles::util
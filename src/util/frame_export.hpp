@@ -0,0 +1,149 @@
+#pragma once
+
+#include "drm_fourcc.hpp"
+#include "unique_fd.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <goggles/error.hpp>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace goggles::util {
+
+constexpr uint32_t FRAME_EXPORT_MAGIC = fourcc_code('G', 'F', 'X', 'P');
+constexpr uint16_t FRAME_EXPORT_VERSION = 1;
+
+enum class FrameExportMessageType : std::uint16_t {
+    ring = 1,
+    frame = 2,
+};
+
+enum class FrameExportStorage : std::uint32_t {
+    /// Linear DMA-BUF written by the GPU; frames carry a sync_file to wait on before reading.
+    dmabuf = 0,
+    /// Sealed memfd filled by the CPU; the contents are complete when the frame is announced.
+    memfd = 1,
+};
+
+/// @brief Describes the export ring. Sent on connect and whenever the ring is rebuilt, with one
+/// buffer fd per slot attached as `SCM_RIGHTS`.
+struct FrameExportRingInfo {
+    uint32_t magic = FRAME_EXPORT_MAGIC;
+    uint16_t version = FRAME_EXPORT_VERSION;
+    uint16_t type = static_cast<uint16_t>(FrameExportMessageType::ring);
+    uint32_t generation = 0;
+    uint32_t buffer_count = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t drm_format = 0;
+    uint32_t storage = static_cast<uint32_t>(FrameExportStorage::dmabuf);
+    uint64_t modifier = DRM_FORMAT_MOD_LINEAR;
+    uint32_t stride = 0;
+    uint32_t offset = 0;
+    uint64_t size = 0;
+};
+
+/// @brief Announces that ring slot `slot` holds a new frame. A `dmabuf` ring attaches one
+/// sync_file fd when `has_sync_fd` is set; it only orders the producer's write before the
+/// consumer's read, never the other way around.
+struct FrameExportFrameInfo {
+    uint32_t magic = FRAME_EXPORT_MAGIC;
+    uint16_t version = FRAME_EXPORT_VERSION;
+    uint16_t type = static_cast<uint16_t>(FrameExportMessageType::frame);
+    uint32_t generation = 0;
+    uint32_t slot = 0;
+    uint64_t sequence = 0;
+    /// Compositor frame number of the source the frame was filtered from.
+    uint64_t source_frame_number = 0;
+    /// `CLOCK_MONOTONIC` time of the submission that produced the frame.
+    uint64_t timestamp_ns = 0;
+    uint32_t has_sync_fd = 0;
+    /// Announcements this client missed since its previous one, oldest first.
+    uint32_t dropped = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<FrameExportRingInfo>);
+static_assert(std::is_trivially_copyable_v<FrameExportFrameInfo>);
+
+/// @brief Publishes the viewer's filtered frames to local consumers on a `SOCK_SEQPACKET` Unix
+/// socket, passing buffer and sync fds instead of pixels.
+///
+/// Consumer contract: there is no release path. The ring is reused round-robin whether or not
+/// anyone still reads a slot, and a slot may be rewritten as soon as `buffer_count - 1` newer
+/// frames of the same ring have been announced. A consumer therefore holds at most
+/// `buffer_count - 1` frames, is done with the oldest before it reads the next announcement,
+/// and copies out anything it needs longer. Consumers that need more headroom ask for a
+/// larger `ring_size`, up to `MAX_RING_SIZE`.
+///
+/// A client that falls behind keeps at most `buffer_count - 1` unsent announcements; older
+/// ones point at slots that are already being overwritten and are dropped first, counted in
+/// the next announcement's `dropped`. Sends never block the render thread: `publish_*` only
+/// queue, and the server thread writes to each client as its socket drains.
+class FrameExportServer {
+public:
+    static constexpr size_t MAX_CLIENTS = 8;
+    static constexpr uint32_t MAX_RING_SIZE = 8;
+
+    /// Binds `socket_path`, replacing a stale socket file, and starts the server thread.
+    [[nodiscard]] static auto create(const std::filesystem::path& socket_path)
+        -> ResultPtr<FrameExportServer>;
+
+    ~FrameExportServer();
+
+    FrameExportServer(const FrameExportServer&) = delete;
+    FrameExportServer& operator=(const FrameExportServer&) = delete;
+    FrameExportServer(FrameExportServer&&) = delete;
+    FrameExportServer& operator=(FrameExportServer&&) = delete;
+
+    /// Replaces the advertised ring and drops frames queued for the old one. `info.generation`
+    /// and `info.buffer_count` are filled in here.
+    /// @return The new ring generation, to be stamped on its frames.
+    auto publish_ring(FrameExportRingInfo info, std::vector<UniqueFd> buffers) -> uint32_t;
+    void publish_frame(const FrameExportFrameInfo& info, UniqueFd sync_fd);
+
+    /// Lets the producer skip the export copy while nobody is listening.
+    [[nodiscard]] auto client_count() const -> size_t {
+        return m_client_count.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] auto socket_path() const -> const std::filesystem::path& {
+        return m_socket_path;
+    }
+
+    struct Ring {
+        FrameExportRingInfo info;
+        std::vector<UniqueFd> buffers;
+    };
+    struct Frame {
+        FrameExportFrameInfo info;
+        UniqueFd sync_fd;
+    };
+
+private:
+    FrameExportServer() = default;
+
+    void wake();
+    void serve(const std::stop_token& stop_token);
+
+    std::filesystem::path m_socket_path;
+    UniqueFd m_listen_fd;
+    UniqueFd m_wake_fd;
+    std::atomic<size_t> m_client_count{0};
+
+    std::mutex m_mutex;
+    std::shared_ptr<const Ring> m_ring;
+    std::deque<std::shared_ptr<const Frame>> m_pending_frames;
+    /// Frames dropped from `m_pending_frames` before the server thread saw them.
+    uint32_t m_dropped_pending = 0;
+    uint32_t m_generation = 0;
+
+    std::jthread m_thread;
+};
+
+} // namespace goggles::util
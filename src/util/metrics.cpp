@@ -0,0 +1,243 @@
+#include "metrics.hpp"
+
+#include <array>
+#include <atomic>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace goggles::util {
+
+namespace {
+
+struct CounterInfo {
+    std::string_view name;
+    std::string_view help;
+};
+
+struct GaugeInfo {
+    std::string_view name;
+    std::string_view help;
+    std::string_view unit;
+};
+
+struct HistogramInfo {
+    std::string_view name;
+    std::string_view help;
+    std::span<const double> bounds;
+};
+
+constexpr std::array<CounterInfo, Metrics::COUNTER_COUNT> K_COUNTERS = {{
+    {"goggles_frames_rendered", "Frames recorded and submitted by the viewer."},
+    {"goggles_frames_imported", "Source frames imported from the compositor."},
+    {"goggles_input_events_dropped", "Input events dropped because the queue was full."},
+    {"goggles_filter_chain_rebuilds", "Filter chain builds, including reloads and retargets."},
+    {"goggles_present_waits", "Present waits issued for frame pacing."},
+    {"goggles_frames_exported", "Filtered frames published on the frame export socket."},
+    {"goggles_frames_export_dropped",
+     "Frame export announcements dropped because a consumer fell behind the ring."},
+    {"goggles_frames_recorded", "Frames written by the headless recorder."},
+    {"goggles_frames_record_dropped",
+     "Frames the headless recorder skipped because its encoder fell behind."},
+    {"goggles_frames_skipped",
+     "Viewer frames skipped because the last present already showed the same output."},
+}};
+
+constexpr std::array<GaugeInfo, Metrics::GAUGE_COUNT> K_GAUGES = {{
+    {"goggles_game_fps", "Averaged commit rate of the captured surface.", ""},
+    {"goggles_compositor_latency_seconds",
+     "Averaged delay between surface commit and capture.", "seconds"},
+}};
+
+constexpr std::array K_FRAME_TIME_BOUNDS = {0.004, 0.00833, 0.0125, 0.01667, 0.025,
+                                            0.03333, 0.05,    0.1,    0.25};
+constexpr std::array K_GPU_FRAME_TIME_BOUNDS = {0.00025, 0.0005, 0.001,   0.002, 0.004,
+                                                0.00833, 0.01667, 0.03333, 0.1};
+
+constexpr std::array<HistogramInfo, Metrics::HISTOGRAM_COUNT> K_HISTOGRAMS = {{
+    {"goggles_frame_time_seconds", "Interval between submitted viewer frames.",
+     K_FRAME_TIME_BOUNDS},
+    {"goggles_gpu_frame_time_seconds", "GPU time of backend-recorded frame work.",
+     K_GPU_FRAME_TIME_BOUNDS},
+}};
+
+static_assert(K_FRAME_TIME_BOUNDS.size() < Metrics::MAX_HISTOGRAM_BUCKETS);
+static_assert(K_GPU_FRAME_TIME_BOUNDS.size() < Metrics::MAX_HISTOGRAM_BUCKETS);
+
+struct HistogramShard {
+    // Non-cumulative per-bucket counts; the last used slot is the +Inf bucket.
+    std::array<std::atomic<uint64_t>, Metrics::MAX_HISTOGRAM_BUCKETS> buckets{};
+    std::atomic<double> sum{0.0};
+};
+
+/// Written only by its owning thread; read by the scraper.
+struct ThreadShard {
+    std::array<std::atomic<uint64_t>, Metrics::COUNTER_COUNT> counters{};
+    std::array<HistogramShard, Metrics::HISTOGRAM_COUNT> histograms{};
+};
+
+struct Registry {
+    std::atomic<bool> enabled{false};
+    std::array<std::atomic<double>, Metrics::GAUGE_COUNT> gauges{};
+    std::mutex shards_mutex;
+    // Shards outlive their threads so totals stay monotonic.
+    std::vector<std::unique_ptr<ThreadShard>> shards;
+
+    auto register_shard() -> ThreadShard* {
+        std::scoped_lock lock(shards_mutex);
+        shards.push_back(std::make_unique<ThreadShard>());
+        return shards.back().get();
+    }
+};
+
+auto registry() -> Registry& {
+    static Registry instance;
+    return instance;
+}
+
+auto local_shard() -> ThreadShard& {
+    thread_local ThreadShard* shard = registry().register_shard();
+    return *shard;
+}
+
+void add_relaxed(std::atomic<uint64_t>& value, uint64_t delta) {
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+void append_number(std::string& out, double value) {
+    std::format_to(std::back_inserter(out), "{}", value);
+}
+
+} // namespace
+
+void Metrics::set_enabled(bool enabled) {
+    registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+auto Metrics::is_enabled() -> bool {
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void Metrics::increment(MetricCounter counter, uint64_t value) {
+    if (!is_enabled()) {
+        return;
+    }
+    add_relaxed(local_shard().counters[static_cast<std::size_t>(counter)], value);
+}
+
+void Metrics::set_gauge(MetricGauge gauge, double value) {
+    if (!is_enabled()) {
+        return;
+    }
+    registry().gauges[static_cast<std::size_t>(gauge)].store(value, std::memory_order_relaxed);
+}
+
+void Metrics::observe(MetricHistogram histogram, double value) {
+    if (!is_enabled()) {
+        return;
+    }
+    const auto index = static_cast<std::size_t>(histogram);
+    const auto bounds = K_HISTOGRAMS[index].bounds;
+    std::size_t bucket = 0;
+    while (bucket < bounds.size() && value > bounds[bucket]) {
+        ++bucket;
+    }
+
+    auto& shard = local_shard().histograms[index];
+    add_relaxed(shard.buckets[bucket], 1);
+    shard.sum.store(shard.sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+auto Metrics::render_openmetrics() -> std::string {
+    auto& reg = registry();
+
+    std::array<uint64_t, COUNTER_COUNT> counters{};
+    std::array<std::array<uint64_t, MAX_HISTOGRAM_BUCKETS>, HISTOGRAM_COUNT> buckets{};
+    std::array<double, HISTOGRAM_COUNT> sums{};
+    {
+        std::scoped_lock lock(reg.shards_mutex);
+        for (const auto& shard : reg.shards) {
+            for (std::size_t i = 0; i < COUNTER_COUNT; ++i) {
+                counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+            }
+            for (std::size_t h = 0; h < HISTOGRAM_COUNT; ++h) {
+                for (std::size_t b = 0; b < MAX_HISTOGRAM_BUCKETS; ++b) {
+                    buckets[h][b] +=
+                        shard->histograms[h].buckets[b].load(std::memory_order_relaxed);
+                }
+                sums[h] += shard->histograms[h].sum.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::string out;
+    out.reserve(4096);
+    auto append = [&out](std::string_view text) { out.append(text); };
+
+    for (std::size_t i = 0; i < COUNTER_COUNT; ++i) {
+        const auto& info = K_COUNTERS[i];
+        std::format_to(std::back_inserter(out),
+                       "# TYPE {0} counter\n# HELP {0} {1}\n{0}_total {2}\n", info.name, info.help,
+                       counters[i]);
+    }
+
+    for (std::size_t i = 0; i < GAUGE_COUNT; ++i) {
+        const auto& info = K_GAUGES[i];
+        std::format_to(std::back_inserter(out), "# TYPE {0} gauge\n", info.name);
+        if (!info.unit.empty()) {
+            std::format_to(std::back_inserter(out), "# UNIT {} {}\n", info.name, info.unit);
+        }
+        std::format_to(std::back_inserter(out), "# HELP {} {}\n{} ", info.name, info.help,
+                       info.name);
+        append_number(out, reg.gauges[i].load(std::memory_order_relaxed));
+        append("\n");
+    }
+
+    for (std::size_t h = 0; h < HISTOGRAM_COUNT; ++h) {
+        const auto& info = K_HISTOGRAMS[h];
+        std::format_to(std::back_inserter(out),
+                       "# TYPE {0} histogram\n# UNIT {0} seconds\n# HELP {0} {1}\n", info.name,
+                       info.help);
+        uint64_t cumulative = 0;
+        for (std::size_t b = 0; b < info.bounds.size(); ++b) {
+            cumulative += buckets[h][b];
+            std::format_to(std::back_inserter(out), "{}_bucket{{le=\"", info.name);
+            append_number(out, info.bounds[b]);
+            std::format_to(std::back_inserter(out), "\"}} {}\n", cumulative);
+        }
+        cumulative += buckets[h][info.bounds.size()];
+        std::format_to(std::back_inserter(out), "{0}_bucket{{le=\"+Inf\"}} {1}\n{0}_count {1}\n",
+                       info.name, cumulative);
+        std::format_to(std::back_inserter(out), "{}_sum ", info.name);
+        append_number(out, sums[h]);
+        append("\n");
+    }
+
+    append("# EOF\n");
+    return out;
+}
+
+void Metrics::reset() {
+    auto& reg = registry();
+    for (auto& gauge : reg.gauges) {
+        gauge.store(0.0, std::memory_order_relaxed);
+    }
+
+    std::scoped_lock lock(reg.shards_mutex);
+    for (auto& shard : reg.shards) {
+        for (auto& counter : shard->counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+        for (auto& histogram : shard->histograms) {
+            for (auto& bucket : histogram.buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            histogram.sum.store(0.0, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace goggles::util
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace goggles::util {
+
+enum class MetricCounter : std::uint8_t {
+    frames_rendered = 0,
+    frames_imported = 1,
+    input_events_dropped = 2,
+    filter_chain_rebuilds = 3,
+    present_waits = 4,
+    frames_exported = 5,
+    frames_export_dropped = 6,
+    frames_recorded = 7,
+    frames_record_dropped = 8,
+    frames_skipped = 9,
+};
+
+enum class MetricGauge : std::uint8_t {
+    game_fps = 0,
+    compositor_latency_seconds = 1,
+};
+
+enum class MetricHistogram : std::uint8_t {
+    frame_time_seconds = 0,
+    gpu_frame_time_seconds = 1,
+};
+
+/// @brief Process-wide counters, gauges and histograms for the OpenMetrics exporter.
+///
+/// Recording is a no-op until `set_enabled(true)`. Each recording thread writes to its own
+/// shard with relaxed atomics, so the hot path never takes a lock after a thread's first
+/// sample. `render_openmetrics()` merges all shards on scrape.
+class Metrics {
+public:
+    static constexpr std::size_t COUNTER_COUNT = 10;
+    static constexpr std::size_t GAUGE_COUNT = 2;
+    static constexpr std::size_t HISTOGRAM_COUNT = 2;
+    static constexpr std::size_t MAX_HISTOGRAM_BUCKETS = 10;
+
+    static void set_enabled(bool enabled);
+    [[nodiscard]] static auto is_enabled() -> bool;
+
+    static void increment(MetricCounter counter, uint64_t value = 1);
+    static void set_gauge(MetricGauge gauge, double value);
+    static void observe(MetricHistogram histogram, double value);
+
+    /// Merges all thread shards into an OpenMetrics text exposition, terminated by `# EOF`.
+    [[nodiscard]] static auto render_openmetrics() -> std::string;
+
+    /// Zeroes all recorded values. Intended for tests; concurrent recording may survive.
+    static void reset();
+
+    Metrics() = delete;
+    ~Metrics() = delete;
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+};
+
+} // namespace goggles::util
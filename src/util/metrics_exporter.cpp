@@ -0,0 +1,122 @@
+#include "metrics_exporter.hpp"
+
+#include "logging.hpp"
+#include "metrics.hpp"
+#include "unix_socket.hpp"
+
+#include <array>
+#include <cerrno>
+#include <goggles/profiling.hpp>
+#include <poll.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+
+namespace goggles::util {
+
+namespace {
+
+constexpr int K_ACCEPT_POLL_INTERVAL_MS = 200;
+constexpr int K_REQUEST_READ_TIMEOUT_MS = 100;
+constexpr std::string_view K_CONTENT_TYPE =
+    "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+auto send_all(int fd, std::string_view data) -> bool {
+    while (!data.empty()) {
+        const auto sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+/// Reads whatever request the client sends within a short window; silent clients get raw text.
+auto is_http_request(int fd) -> bool {
+    pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+    if (::poll(&pfd, 1, K_REQUEST_READ_TIMEOUT_MS) <= 0) {
+        return false;
+    }
+
+    std::array<char, 1024> request{};
+    const auto received = ::recv(fd, request.data(), request.size(), MSG_DONTWAIT);
+    if (received <= 0) {
+        return false;
+    }
+    return std::string_view(request.data(), static_cast<size_t>(received)).starts_with("GET ");
+}
+
+void serve_client(int fd) {
+    GOGGLES_PROFILE_FUNCTION();
+
+    timeval send_timeout{.tv_sec = 1, .tv_usec = 0};
+    static_cast<void>(
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout)));
+
+    const bool http = is_http_request(fd);
+    const auto body = Metrics::render_openmetrics();
+    if (http) {
+        const auto header = "HTTP/1.0 200 OK\r\nContent-Type: " + std::string(K_CONTENT_TYPE) +
+                            "\r\nContent-Length: " + std::to_string(body.size()) +
+                            "\r\nConnection: close\r\n\r\n";
+        if (!send_all(fd, header)) {
+            return;
+        }
+    }
+    if (!send_all(fd, body)) {
+        GOGGLES_LOG_DEBUG("Metrics client disconnected mid-response");
+    }
+}
+
+} // namespace
+
+auto MetricsExporter::create(const std::filesystem::path& socket_path)
+    -> ResultPtr<MetricsExporter> {
+    GOGGLES_PROFILE_FUNCTION();
+
+    auto listen_fd = GOGGLES_TRY(listen_unix_socket(socket_path));
+
+    auto exporter = std::unique_ptr<MetricsExporter>(new MetricsExporter());
+    exporter->m_socket_path = socket_path;
+    exporter->m_listen_fd = std::move(listen_fd);
+    Metrics::set_enabled(true);
+    exporter->m_thread = std::jthread(
+        [self = exporter.get()](const std::stop_token& stop_token) { self->serve(stop_token); });
+
+    GOGGLES_LOG_INFO("Metrics exporter listening on {}", socket_path.string());
+    return {std::move(exporter)};
+}
+
+MetricsExporter::~MetricsExporter() {
+    if (m_thread.joinable()) {
+        m_thread.request_stop();
+        m_thread.join();
+    }
+    Metrics::set_enabled(false);
+    m_listen_fd = UniqueFd{};
+    if (!m_socket_path.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(m_socket_path, ec);
+    }
+}
+
+void MetricsExporter::serve(const std::stop_token& stop_token) {
+    while (!stop_token.stop_requested()) {
+        pollfd pfd{.fd = m_listen_fd.get(), .events = POLLIN, .revents = 0};
+        if (::poll(&pfd, 1, K_ACCEPT_POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+
+        UniqueFd client{::accept4(m_listen_fd.get(), nullptr, nullptr, SOCK_CLOEXEC)};
+        if (!client) {
+            continue;
+        }
+        serve_client(client.get());
+    }
+}
+
+} // namespace goggles::util
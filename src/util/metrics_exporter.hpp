@@ -0,0 +1,44 @@
+#pragma once
+
+#include "unique_fd.hpp"
+
+#include <filesystem>
+#include <goggles/error.hpp>
+#include <stop_token>
+#include <thread>
+
+namespace goggles::util {
+
+/// @brief Serves `Metrics::render_openmetrics()` on a Unix domain socket.
+///
+/// Each connection receives one exposition and is closed. HTTP `GET` requests (e.g.
+/// `curl --unix-socket`) get an HTTP/1.0 response; any other client gets the raw text. Scrapes
+/// run on the exporter thread and never touch the render thread.
+class MetricsExporter {
+public:
+    /// Binds `socket_path`, replacing a stale socket file, and enables `Metrics` recording.
+    [[nodiscard]] static auto create(const std::filesystem::path& socket_path)
+        -> ResultPtr<MetricsExporter>;
+
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    MetricsExporter(MetricsExporter&&) = delete;
+    MetricsExporter& operator=(MetricsExporter&&) = delete;
+
+    [[nodiscard]] auto socket_path() const -> const std::filesystem::path& {
+        return m_socket_path;
+    }
+
+private:
+    MetricsExporter() = default;
+
+    void serve(const std::stop_token& stop_token);
+
+    std::filesystem::path m_socket_path;
+    UniqueFd m_listen_fd;
+    std::jthread m_thread;
+};
+
+} // namespace goggles::util
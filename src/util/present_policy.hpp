@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace goggles {
+
+/// @brief How the viewer trades latency against tearing and pacing when presenting.
+enum class PresentPolicy : std::uint8_t {
+    /// Immediate (tearing allowed), else mailbox; `target_fps` is paced on the CPU.
+    low_latency,
+    /// FIFO; `target_fps` is paced with `VK_KHR_present_wait` when available.
+    smooth,
+    /// FIFO_RELAXED: syncs to vblank but tears instead of stalling on a late frame.
+    adaptive,
+    /// FIFO on a variable-refresh display: presents each new frame as it arrives within the
+    /// configured refresh window and repeats frames below it; `target_fps` is ignored.
+    vrr,
+};
+
+[[nodiscard]] constexpr auto to_string(PresentPolicy policy) -> const char* {
+    switch (policy) {
+    case PresentPolicy::low_latency:
+        return "low_latency";
+    case PresentPolicy::smooth:
+        return "smooth";
+    case PresentPolicy::adaptive:
+        return "adaptive";
+    case PresentPolicy::vrr:
+        return "vrr";
+    }
+    return "unknown";
+}
+
+[[nodiscard]] constexpr auto parse_present_policy(std::string_view name)
+    -> std::optional<PresentPolicy> {
+    if (name == "low_latency") {
+        return PresentPolicy::low_latency;
+    }
+    if (name == "smooth") {
+        return PresentPolicy::smooth;
+    }
+    if (name == "adaptive") {
+        return PresentPolicy::adaptive;
+    }
+    if (name == "vrr") {
+        return PresentPolicy::vrr;
+    }
+    return std::nullopt;
+}
+
+/// Policy implied by the legacy `vsync` switch when no policy is configured explicitly.
+[[nodiscard]] constexpr auto present_policy_from_vsync(bool vsync) -> PresentPolicy {
+    return vsync ? PresentPolicy::smooth : PresentPolicy::low_latency;
+}
+
+} // namespace goggles
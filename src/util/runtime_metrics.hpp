@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 
 namespace goggles::util {
 
@@ -16,4 +17,48 @@ struct CompositorRuntimeMetricsSnapshot {
     std::size_t compositor_latency_history_count = 0;
 };
 
+/// @brief Backend-recorded GPU segments of one presented frame, in submission order.
+enum class GpuTimingZone : std::uint8_t {
+    import_barrier = 0,
+    frame_interpolation = 1,
+    filter_chain = 2,
+    ui_overlay = 3,
+};
+
+struct GpuTimingSnapshot {
+    static constexpr std::size_t K_ZONE_COUNT = 4;
+    static constexpr std::size_t K_HISTORY_WINDOW =
+        CompositorRuntimeMetricsSnapshot::K_HISTORY_WINDOW;
+
+    /// False when the graphics queue does not support timestamps.
+    bool available = false;
+    std::array<float, K_ZONE_COUNT> zone_ms{};
+    float frame_ms = 0.0F;
+    std::array<float, K_HISTORY_WINDOW> frame_history_ms{};
+    std::size_t frame_history_count = 0;
+};
+
+/// @brief Backend allocator usage and, with `VK_EXT_memory_budget`, per-heap driver budgets.
+struct GpuMemorySnapshot {
+    static constexpr std::size_t K_MAX_HEAPS = 16; // VK_MAX_MEMORY_HEAPS
+
+    struct Heap {
+        std::uint64_t size_bytes = 0;
+        std::uint64_t budget_bytes = 0;
+        std::uint64_t usage_bytes = 0;
+        bool device_local = false;
+    };
+
+    /// False when the device lacks `VK_EXT_memory_budget`; heap budget and usage stay zero.
+    bool budget_available = false;
+    std::array<Heap, K_MAX_HEAPS> heaps{};
+    std::size_t heap_count = 0;
+    /// Device memory the backend allocator holds from the driver.
+    std::uint64_t allocated_bytes = 0;
+    /// Portion of `allocated_bytes` bound to live resources.
+    std::uint64_t used_bytes = 0;
+    std::uint32_t block_count = 0;
+    std::uint32_t dedicated_count = 0;
+};
+
 } // namespace goggles::util
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 
 #ifndef GOGGLES_SCALE_MODE_DEFINED
@@ -34,3 +35,55 @@ enum class ScaleMode : std::uint8_t {
 } // namespace goggles
 
 #endif // GOGGLES_SCALE_MODE_DEFINED
+
+namespace goggles {
+
+/// @brief Placement of scaled content inside a viewport, in viewport pixels.
+struct ScaledRect {
+    float x = 0.0F;
+    float y = 0.0F;
+    float width = 0.0F;
+    float height = 0.0F;
+};
+
+/// Where the filter chain places a `source`-sized image inside a `target`-sized viewport under
+/// `mode`, centered. An `integer_scale` of 0 picks the largest whole scale that fits.
+[[nodiscard]] constexpr auto compute_scaled_rect(ScaleMode mode, uint32_t integer_scale,
+                                                 uint32_t source_width, uint32_t source_height,
+                                                 uint32_t target_width, uint32_t target_height)
+    -> ScaledRect {
+    const auto target_w = static_cast<float>(target_width);
+    const auto target_h = static_cast<float>(target_height);
+    if (source_width == 0 || source_height == 0 || mode == ScaleMode::stretch) {
+        return {.width = target_w, .height = target_h};
+    }
+
+    const auto source_w = static_cast<float>(source_width);
+    const auto source_h = static_cast<float>(source_height);
+    float scale = 1.0F;
+    switch (mode) {
+    case ScaleMode::integer: {
+        const uint32_t fitting_scale =
+            std::max(1U, std::min(target_width / source_width, target_height / source_height));
+        scale = static_cast<float>(integer_scale > 0 ? integer_scale : fitting_scale);
+        break;
+    }
+    case ScaleMode::fill:
+        scale = std::max(target_w / source_w, target_h / source_h);
+        break;
+    case ScaleMode::fit:
+    case ScaleMode::dynamic:
+    case ScaleMode::stretch:
+        scale = std::min(target_w / source_w, target_h / source_h);
+        break;
+    }
+
+    const float width = source_w * scale;
+    const float height = source_h * scale;
+    return {.x = (target_w - width) * 0.5F,
+            .y = (target_h - height) * 0.5F,
+            .width = width,
+            .height = height};
+}
+
+} // namespace goggles
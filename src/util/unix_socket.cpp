@@ -0,0 +1,52 @@
+#include "unix_socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace goggles::util {
+
+auto listen_unix_socket(const std::filesystem::path& socket_path, int socket_type)
+    -> Result<UniqueFd> {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    const auto path_string = socket_path.string();
+    if (path_string.empty() || path_string.size() >= sizeof(addr.sun_path)) {
+        return make_error<UniqueFd>(ErrorCode::invalid_config,
+                                    "Socket path is empty or too long: " + path_string);
+    }
+    std::memcpy(addr.sun_path, path_string.c_str(), path_string.size() + 1);
+
+    std::error_code ec;
+    std::filesystem::create_directories(socket_path.parent_path(), ec);
+    if (ec) {
+        return make_error<UniqueFd>(ErrorCode::file_write_failed,
+                                    "Failed to create socket directory: " + ec.message());
+    }
+    if (std::filesystem::is_socket(socket_path, ec)) {
+        std::filesystem::remove(socket_path, ec);
+    }
+
+    UniqueFd listen_fd{::socket(AF_UNIX, socket_type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)};
+    if (!listen_fd) {
+        return make_error<UniqueFd>(ErrorCode::unknown_error, "Failed to create socket: " +
+                                                                  std::string(std::strerror(errno)));
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (::bind(listen_fd.get(), reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        return make_error<UniqueFd>(ErrorCode::unknown_error,
+                                    "Failed to bind socket '" + path_string +
+                                        "': " + std::string(std::strerror(errno)));
+    }
+    if (::listen(listen_fd.get(), SOMAXCONN) != 0) {
+        const std::string reason = std::strerror(errno);
+        std::filesystem::remove(socket_path, ec);
+        return make_error<UniqueFd>(ErrorCode::unknown_error,
+                                    "Failed to listen on socket '" + path_string + "': " + reason);
+    }
+    return listen_fd;
+}
+
+} // namespace goggles::util
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "unique_fd.hpp"
+
+#include <filesystem>
+#include <goggles/error.hpp>
+#include <sys/socket.h>
+
+namespace goggles::util {
+
+/// @brief Binds and listens on a non-blocking `AF_UNIX` socket at `socket_path`.
+///
+/// Creates the parent directory and replaces a stale socket file left by a previous run.
+/// `socket_type` is `SOCK_STREAM` or `SOCK_SEQPACKET`.
+[[nodiscard]] auto listen_unix_socket(const std::filesystem::path& socket_path,
+                                      int socket_type = SOCK_STREAM) -> Result<UniqueFd>;
+
+} // namespace goggles::util
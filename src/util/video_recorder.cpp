@@ -0,0 +1,266 @@
+#include "video_recorder.hpp"
+
+#include "logging.hpp"
+#include "metrics.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <goggles/profiling.hpp>
+#include <string>
+
+namespace goggles::util {
+
+namespace {
+
+constexpr size_t RGBA_BYTES = 4;
+constexpr std::string_view INDEX_HEADER = "timestamp_ns,source_frame_number,byte_offset";
+
+auto parse_index_field(std::string_view& line, uint64_t& value) -> bool {
+    const auto end = line.find(',');
+    const auto field = line.substr(0, end);
+    const auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    line = end == std::string_view::npos ? std::string_view{} : line.substr(end + 1);
+    return ec == std::errc{} && ptr == field.data() + field.size();
+}
+
+/// BT.601 limited-range RGB to Y'CbCr, the default YUV4MPEG2 readers assume.
+void convert_rgba_to_yuv444(const uint8_t* rgba, size_t pixel_count, uint8_t* y_plane,
+                            uint8_t* u_plane, uint8_t* v_plane) {
+    for (size_t i = 0; i < pixel_count; ++i) {
+        const int r = rgba[(i * RGBA_BYTES) + 0];
+        const int g = rgba[(i * RGBA_BYTES) + 1];
+        const int b = rgba[(i * RGBA_BYTES) + 2];
+        y_plane[i] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        u_plane[i] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        v_plane[i] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+}
+
+} // namespace
+
+auto record_index_path(const std::filesystem::path& recording_path) -> std::filesystem::path {
+    auto path = recording_path;
+    path += ".index.csv";
+    return path;
+}
+
+auto read_record_index(const std::filesystem::path& index_path)
+    -> Result<std::vector<RecordIndexEntry>> {
+    std::ifstream file(index_path);
+    if (!file) {
+        return make_error<std::vector<RecordIndexEntry>>(
+            ErrorCode::file_not_found, "Failed to open recording index: " + index_path.string());
+    }
+    std::string line;
+    if (!std::getline(file, line) || line != INDEX_HEADER) {
+        return make_error<std::vector<RecordIndexEntry>>(
+            ErrorCode::parse_error, "Missing recording index header: " + index_path.string());
+    }
+
+    std::vector<RecordIndexEntry> entries;
+    while (std::getline(file, line)) {
+        std::string_view fields = line;
+        RecordIndexEntry entry;
+        if (!parse_index_field(fields, entry.timestamp_ns) ||
+            !parse_index_field(fields, entry.source_frame_number) ||
+            !parse_index_field(fields, entry.byte_offset) || !fields.empty()) {
+            return make_error<std::vector<RecordIndexEntry>>(
+                ErrorCode::parse_error,
+                std::format("Malformed recording index line {}: {}", entries.size() + 2,
+                            index_path.string()));
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+auto VideoRecorder::create(const std::filesystem::path& path, const Options& options)
+    -> ResultPtr<VideoRecorder> {
+    GOGGLES_PROFILE_FUNCTION();
+
+    if (options.width == 0 || options.height == 0) {
+        return make_error<std::unique_ptr<VideoRecorder>>(ErrorCode::invalid_config,
+                                                          "Recording size must be non-zero");
+    }
+    if (options.pool_size == 0) {
+        return make_error<std::unique_ptr<VideoRecorder>>(ErrorCode::invalid_config,
+                                                          "Recording pool must not be empty");
+    }
+
+    auto recorder = std::unique_ptr<VideoRecorder>(new VideoRecorder());
+    recorder->m_path = path;
+    recorder->m_options = options;
+    recorder->m_options.fps = options.fps == 0 ? 60 : options.fps;
+    recorder->m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!recorder->m_file) {
+        return make_error<std::unique_ptr<VideoRecorder>>(
+            ErrorCode::file_write_failed, "Failed to open recording file: " + path.string());
+    }
+    if (options.format == RecordFormat::y4m) {
+        recorder->m_file << std::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C444\n", options.width,
+                                        options.height, recorder->m_options.fps);
+    } else {
+        const auto index_path = record_index_path(path);
+        recorder->m_index.open(index_path, std::ios::trunc);
+        if (!recorder->m_index) {
+            return make_error<std::unique_ptr<VideoRecorder>>(
+                ErrorCode::file_write_failed,
+                "Failed to open recording index: " + index_path.string());
+        }
+        recorder->m_index << INDEX_HEADER << '\n';
+    }
+
+    const size_t frame_bytes = static_cast<size_t>(options.width) * options.height * RGBA_BYTES;
+    recorder->m_pool.reserve(options.pool_size);
+    recorder->m_free.reserve(options.pool_size);
+    for (uint32_t i = 0; i < options.pool_size; ++i) {
+        auto frame = std::make_unique<Frame>();
+        frame->rgba.resize(frame_bytes);
+        recorder->m_free.push_back(frame.get());
+        recorder->m_pool.push_back(std::move(frame));
+    }
+    if (options.format == RecordFormat::y4m) {
+        recorder->m_planes.resize(static_cast<size_t>(options.width) * options.height * 3);
+    }
+
+    recorder->m_thread = std::jthread(
+        [self = recorder.get()](const std::stop_token& stop_token) { self->encode(stop_token); });
+
+    GOGGLES_LOG_INFO("Recording {}x{} {} to {} ({} backpressure)", options.width,
+                     options.height, options.format == RecordFormat::y4m ? "y4m" : "rgba",
+                     path.string(),
+                     options.backpressure == RecordBackpressure::block ? "block" : "drop");
+    return {std::move(recorder)};
+}
+
+VideoRecorder::~VideoRecorder() {
+    if (m_thread.joinable()) {
+        static_cast<void>(finish());
+    }
+}
+
+auto VideoRecorder::acquire_frame() -> Frame* {
+    std::unique_lock lock(m_mutex);
+    if (m_finished) {
+        return nullptr;
+    }
+    if (m_free.empty()) {
+        if (m_options.backpressure == RecordBackpressure::drop) {
+            ++m_frames_dropped;
+            Metrics::increment(MetricCounter::frames_record_dropped);
+            return nullptr;
+        }
+        GOGGLES_PROFILE_SCOPE("RecorderBackpressure");
+        m_free_cv.wait(lock, [this]() { return !m_free.empty(); });
+    }
+    Frame* frame = m_free.back();
+    m_free.pop_back();
+    return frame;
+}
+
+void VideoRecorder::submit_frame(Frame* frame) {
+    if (frame == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_queued.push_back(frame);
+    }
+    m_queued_cv.notify_one();
+}
+
+auto VideoRecorder::finish() -> Result<void> {
+    if (m_thread.joinable()) {
+        m_thread.request_stop();
+        m_thread.join();
+    }
+
+    std::lock_guard lock(m_mutex);
+    if (!m_finished) {
+        m_finished = true;
+        m_file.flush();
+        if (m_index.is_open()) {
+            m_index.flush();
+        }
+        if ((!m_file || !m_index) && !m_write_error) {
+            m_write_error = Error{ErrorCode::file_write_failed,
+                                  "Failed to flush recording: " + m_path.string()};
+        }
+        m_file.close();
+        if (m_index.is_open()) {
+            m_index.close();
+        }
+        GOGGLES_LOG_INFO("Recording finished: {} frames written, {} dropped", m_frames_written,
+                         m_frames_dropped);
+    }
+    if (m_write_error) {
+        return make_error<void>(m_write_error->code, m_write_error->message);
+    }
+    return {};
+}
+
+auto VideoRecorder::frames_written() const -> uint64_t {
+    std::lock_guard lock(m_mutex);
+    return m_frames_written;
+}
+
+auto VideoRecorder::frames_dropped() const -> uint64_t {
+    std::lock_guard lock(m_mutex);
+    return m_frames_dropped;
+}
+
+void VideoRecorder::encode(const std::stop_token& stop_token) {
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        // Once stopped, keep going until the queue is drained so `finish()` loses nothing.
+        m_queued_cv.wait(lock, stop_token, [this]() { return !m_queued.empty(); });
+        if (m_queued.empty()) {
+            return;
+        }
+        Frame* frame = m_queued.front();
+        m_queued.pop_front();
+        const bool failed = m_write_error.has_value();
+
+        lock.unlock();
+        if (!failed) {
+            write_frame(*frame);
+        }
+        lock.lock();
+
+        // An unopened index (y4m) stays good, so this only trips on real write errors.
+        if (!failed && m_file && m_index) {
+            ++m_frames_written;
+            Metrics::increment(MetricCounter::frames_recorded);
+        } else if (!m_write_error) {
+            m_write_error = Error{ErrorCode::file_write_failed,
+                                  "Failed to write recording: " + m_path.string()};
+            GOGGLES_LOG_ERROR("{}", m_write_error->message);
+        }
+        m_free.push_back(frame);
+        m_free_cv.notify_one();
+    }
+}
+
+void VideoRecorder::write_frame(const Frame& frame) {
+    GOGGLES_PROFILE_FUNCTION();
+    if (m_options.format == RecordFormat::rgba) {
+        m_index << std::format("{},{},{}\n", frame.timestamp_ns, frame.source_frame_number,
+                               m_bytes_written);
+        m_file.write(reinterpret_cast<const char*>(frame.rgba.data()),
+                     static_cast<std::streamsize>(frame.rgba.size()));
+        m_bytes_written += frame.rgba.size();
+        return;
+    }
+
+    const size_t pixel_count = static_cast<size_t>(m_options.width) * m_options.height;
+    uint8_t* y_plane = m_planes.data();
+    convert_rgba_to_yuv444(frame.rgba.data(), pixel_count, y_plane, y_plane + pixel_count,
+                           y_plane + (2 * pixel_count));
+
+    m_file << std::format("FRAME XT={} XF={}\n", frame.timestamp_ns, frame.source_frame_number);
+    m_file.write(reinterpret_cast<const char*>(m_planes.data()),
+                 static_cast<std::streamsize>(m_planes.size()));
+}
+
+} // namespace goggles::util
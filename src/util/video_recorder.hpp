@@ -0,0 +1,155 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <goggles/error.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace goggles::util {
+
+/// @brief What the render thread does when every recorder buffer is still queued for encoding.
+enum class RecordBackpressure : std::uint8_t {
+    /// Wait for the encoder; every rendered frame is recorded, at the cost of render pacing.
+    block,
+    /// Skip the frame and count it; render pacing is never affected.
+    drop,
+};
+
+[[nodiscard]] constexpr auto parse_record_backpressure(std::string_view name)
+    -> std::optional<RecordBackpressure> {
+    if (name == "block") {
+        return RecordBackpressure::block;
+    }
+    if (name == "drop") {
+        return RecordBackpressure::drop;
+    }
+    return std::nullopt;
+}
+
+/// @brief On-disk layout of a recording.
+enum class RecordFormat : std::uint8_t {
+    /// YUV4MPEG2 4:4:4, BT.601 limited range. Plays anywhere, but the RGB to Y'CbCr conversion
+    /// is lossy: it cannot reproduce the rendered pixels bit for bit.
+    y4m,
+    /// Headerless, tightly packed RGBA8 frames (`ffmpeg -f rawvideo -pix_fmt rgba -s WxH`).
+    /// Lossless, for golden captures. Per-frame timestamps go to a sidecar index at
+    /// `record_index_path()`.
+    rgba,
+};
+
+[[nodiscard]] constexpr auto parse_record_format(std::string_view name)
+    -> std::optional<RecordFormat> {
+    if (name == "y4m") {
+        return RecordFormat::y4m;
+    }
+    if (name == "rgba") {
+        return RecordFormat::rgba;
+    }
+    return std::nullopt;
+}
+
+/// @brief One frame of an `rgba` recording, as listed in its sidecar index.
+struct RecordIndexEntry {
+    uint64_t timestamp_ns = 0;
+    uint64_t source_frame_number = 0;
+    /// Offset of the frame's first byte in the recording.
+    uint64_t byte_offset = 0;
+};
+
+/// Sidecar index of an `rgba` recording: a CSV header followed by one
+/// `timestamp_ns,source_frame_number,byte_offset` line per frame.
+[[nodiscard]] auto record_index_path(const std::filesystem::path& recording_path)
+    -> std::filesystem::path;
+[[nodiscard]] auto read_record_index(const std::filesystem::path& index_path)
+    -> Result<std::vector<RecordIndexEntry>>;
+
+/// @brief Writes RGBA8 frames to an uncompressed video file on a background thread.
+///
+/// Frames are filled into buffers from a fixed pool and queued to the encoder thread, which
+/// converts and writes them out before returning the buffer to the pool. In `y4m` format each
+/// `FRAME` header carries the frame's capture time and source frame number as `XT=` and `XF=`
+/// parameters, which standard readers ignore; in `rgba` format they go to the sidecar index.
+class VideoRecorder {
+public:
+    static constexpr uint32_t DEFAULT_POOL_SIZE = 8;
+
+    struct Options {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        /// Nominal rate for the stream header; actual timing is in the per-frame timestamps.
+        uint32_t fps = 60;
+        uint32_t pool_size = DEFAULT_POOL_SIZE;
+        RecordFormat format = RecordFormat::y4m;
+        RecordBackpressure backpressure = RecordBackpressure::block;
+    };
+
+    struct Frame {
+        /// Tightly packed `width * height` RGBA8 pixels.
+        std::vector<uint8_t> rgba;
+        /// Nanoseconds on the source frame's clock (see `ExternalImageFrame::commit_time_ns`).
+        uint64_t timestamp_ns = 0;
+        uint64_t source_frame_number = 0;
+    };
+
+    /// Creates `path` (and for `rgba` its index), writes the stream header and starts the
+    /// encoder thread.
+    [[nodiscard]] static auto create(const std::filesystem::path& path, const Options& options)
+        -> ResultPtr<VideoRecorder>;
+
+    ~VideoRecorder();
+
+    VideoRecorder(const VideoRecorder&) = delete;
+    VideoRecorder& operator=(const VideoRecorder&) = delete;
+    VideoRecorder(VideoRecorder&&) = delete;
+    VideoRecorder& operator=(VideoRecorder&&) = delete;
+
+    /// Takes a free pool buffer to fill. Under `drop` returns null (and counts the frame as
+    /// dropped) when none is free; under `block` waits for the encoder instead.
+    [[nodiscard]] auto acquire_frame() -> Frame*;
+    /// Queues a buffer from `acquire_frame()` for encoding.
+    void submit_frame(Frame* frame);
+    /// Encodes everything queued, closes the file and stops the encoder thread.
+    /// @return The first write error, if any.
+    [[nodiscard]] auto finish() -> Result<void>;
+
+    [[nodiscard]] auto options() const -> const Options& { return m_options; }
+    [[nodiscard]] auto frames_written() const -> uint64_t;
+    [[nodiscard]] auto frames_dropped() const -> uint64_t;
+
+private:
+    VideoRecorder() = default;
+
+    void encode(const std::stop_token& stop_token);
+    void write_frame(const Frame& frame);
+
+    std::filesystem::path m_path;
+    Options m_options;
+    std::ofstream m_file;
+    std::ofstream m_index;
+    uint64_t m_bytes_written = 0;
+    std::vector<std::unique_ptr<Frame>> m_pool;
+    std::vector<uint8_t> m_planes;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_free_cv;
+    std::condition_variable_any m_queued_cv;
+    std::vector<Frame*> m_free;
+    std::deque<Frame*> m_queued;
+    uint64_t m_frames_written = 0;
+    uint64_t m_frames_dropped = 0;
+    std::optional<Error> m_write_error;
+    bool m_finished = false;
+
+    std::jthread m_thread;
+};
+
+} // namespace goggles::util
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace goggles::util {
+
+/// @brief Refresh window of a variable-refresh display, in Hz.
+struct RefreshRange {
+    uint32_t min_hz = 48;
+    uint32_t max_hz = 165;
+};
+
+/// Shortest interval between presents the display can show.
+[[nodiscard]] constexpr auto min_present_interval(RefreshRange range)
+    -> std::chrono::steady_clock::duration {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::nanoseconds(1'000'000'000ULL / std::max<uint32_t>(range.max_hz, 1)));
+}
+
+/// Longest interval between presents before the display leaves its VRR window.
+[[nodiscard]] constexpr auto max_present_interval(RefreshRange range)
+    -> std::chrono::steady_clock::duration {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::nanoseconds(1'000'000'000ULL / std::max<uint32_t>(range.min_hz, 1)));
+}
+
+/// @brief Decides when a VRR viewer repeats its last frame.
+///
+/// New source frames are presented as they arrive. When none arrives within the display's max
+/// interval, the last frame is repeated at a whole fraction of the measured source interval
+/// (low framerate compensation), so a 30 FPS source on a 48-165 Hz display is shown at an even
+/// 60 Hz instead of stuttering between 48 Hz repeats and new frames.
+class VrrPacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void set_range(RefreshRange range) { m_range = range; }
+    [[nodiscard]] auto range() const -> RefreshRange { return m_range; }
+
+    /// Forgets the measured source cadence, e.g. after the capture target changed.
+    void reset() {
+        m_last_source = {};
+        m_last_present = {};
+        m_source_interval = {};
+    }
+
+    /// Records a new source frame arriving at `time`.
+    void on_source_frame(Clock::time_point time) {
+        if (m_last_source != Clock::time_point{}) {
+            const auto delta = time - m_last_source;
+            if (delta > SOURCE_PAUSE) {
+                // The source stalled; its old cadence says nothing about the next frames.
+                m_source_interval = {};
+            } else if (m_source_interval == Clock::duration::zero()) {
+                m_source_interval = delta;
+            } else {
+                m_source_interval += (delta - m_source_interval) / SOURCE_SMOOTHING;
+            }
+        }
+        m_last_source = time;
+    }
+
+    /// Records a present, new or repeated, at `time`.
+    void on_present(Clock::time_point time) { m_last_present = time; }
+
+    /// Smoothed interval between source frames; zero until two frames arrived.
+    [[nodiscard]] auto source_interval() const -> Clock::duration { return m_source_interval; }
+
+    /// Interval at which the last frame is repeated while no new one arrives.
+    [[nodiscard]] auto repeat_interval() const -> Clock::duration {
+        const auto min_interval = min_present_interval(m_range);
+        const auto max_interval = max_present_interval(m_range);
+        if (m_source_interval <= max_interval) {
+            return max_interval;
+        }
+        const auto repeats = (m_source_interval + max_interval - Clock::duration(1)) / max_interval;
+        return std::max(m_source_interval / repeats, min_interval);
+    }
+
+    /// When the last frame must be presented again; the epoch before the first present.
+    [[nodiscard]] auto repeat_deadline() const -> Clock::time_point {
+        if (m_last_present == Clock::time_point{}) {
+            return {};
+        }
+        return m_last_present + repeat_interval();
+    }
+
+private:
+    static constexpr auto SOURCE_PAUSE = std::chrono::seconds(1);
+    static constexpr int SOURCE_SMOOTHING = 8;
+
+    RefreshRange m_range{};
+    Clock::time_point m_last_source{};
+    Clock::time_point m_last_present{};
+    Clock::duration m_source_interval{};
+};
+
+} // namespace goggles::util
@@ -115,6 +115,51 @@ TEST_CASE("parse_cli: headless mode parses all flags", "[cli]") {
     REQUIRE(result->options.app_command[0] == "vkcube");
 }
 
+TEST_CASE("parse_cli: metrics flag opts into the exporter", "[cli]") {
+    auto cfg = default_config_path();
+    ArgvBuilder args({"goggles", "--config", cfg, "--metrics", "--", "vkcube"});
+
+    auto result = goggles::app::parse_cli(args.argc(), args.argv.data());
+    REQUIRE(result);
+    REQUIRE(result->options.metrics);
+}
+
+TEST_CASE("parse_cli: control flag opts into the control socket", "[cli]") {
+    auto cfg = default_config_path();
+    ArgvBuilder args({"goggles", "--config", cfg, "--control", "--", "vkcube"});
+
+    auto result = goggles::app::parse_cli(args.argc(), args.argv.data());
+    REQUIRE(result);
+    REQUIRE(result->options.control);
+    REQUIRE_FALSE(result->options.metrics);
+}
+
+TEST_CASE("parse_cli: present policy override", "[cli]") {
+    auto cfg = default_config_path();
+
+    SECTION("Known policy is parsed") {
+        ArgvBuilder args(
+            {"goggles", "--config", cfg, "--present-policy", "low_latency", "--", "vkcube"});
+        auto result = goggles::app::parse_cli(args.argc(), args.argv.data());
+        REQUIRE(result);
+        REQUIRE(result->options.present_policy == PresentPolicy::low_latency);
+    }
+
+    SECTION("Unset policy keeps the configured one") {
+        ArgvBuilder args({"goggles", "--config", cfg, "--", "vkcube"});
+        auto result = goggles::app::parse_cli(args.argc(), args.argv.data());
+        REQUIRE(result);
+        REQUIRE_FALSE(result->options.present_policy.has_value());
+    }
+
+    SECTION("Unknown policy is rejected") {
+        ArgvBuilder args({"goggles", "--config", cfg, "--present-policy", "fast", "--", "vkcube"});
+        auto result = goggles::app::parse_cli(args.argc(), args.argv.data());
+        REQUIRE(!result);
+        REQUIRE(result.error().code == ErrorCode::parse_error);
+    }
+}
+
 TEST_CASE("parse_cli: headless mode requires --frames", "[cli]") {
     auto cfg = default_config_path();
     ArgvBuilder args(
@@ -134,6 +179,43 @@ TEST_CASE("parse_cli: headless mode requires --output", "[cli]") {
     REQUIRE(result.error().code == ErrorCode::parse_error);
 }
 
+TEST_CASE("parse_cli: headless recording replaces --output", "[cli]") {
+    auto cfg = default_config_path();
+    ArgvBuilder args({"goggles", "--config", cfg, "--headless", "--frames", "10", "--record",
+                      "/tmp/test.y4m", "--record-policy", "drop", "--", "vkcube"});
+
+    auto result = goggles::app::parse_cli(args.argc(), args.argv.data());
+    REQUIRE(result);
+    REQUIRE(result->options.output_path.empty());
+    REQUIRE(result->options.record_path == "/tmp/test.y4m");
+    REQUIRE(result->options.record_backpressure == goggles::util::RecordBackpressure::drop);
+    REQUIRE_FALSE(result->options.record_format.has_value());
+}
+
+TEST_CASE("parse_cli: --record-format selects the lossless raw format", "[cli]") {
+    auto cfg = default_config_path();
+    ArgvBuilder args({"goggles", "--config", cfg, "--headless", "--frames", "10", "--record",
+                      "/tmp/test.rgba", "--record-format", "rgba", "--", "vkcube"});
+
+    auto result = goggles::app::parse_cli(args.argc(), args.argv.data());
+    REQUIRE(result);
+    REQUIRE(result->options.record_format == goggles::util::RecordFormat::rgba);
+}
+
+TEST_CASE("parse_cli: --lockstep requires headless mode", "[cli]") {
+    auto cfg = default_config_path();
+    ArgvBuilder headless({"goggles", "--config", cfg, "--headless", "--frames", "10", "--output",
+                          "/tmp/test.png", "--lockstep", "--", "vkcube"});
+    auto headless_result = goggles::app::parse_cli(headless.argc(), headless.argv.data());
+    REQUIRE(headless_result);
+    REQUIRE(headless_result->options.lockstep);
+
+    ArgvBuilder windowed({"goggles", "--config", cfg, "--lockstep", "--", "vkcube"});
+    auto windowed_result = goggles::app::parse_cli(windowed.argc(), windowed.argv.data());
+    REQUIRE(!windowed_result);
+    REQUIRE(windowed_result.error().code == ErrorCode::parse_error);
+}
+
 TEST_CASE("parse_cli: headless mode rejects --frames 0", "[cli]") {
     auto cfg = default_config_path();
     ArgvBuilder args({"goggles", "--config", cfg, "--headless", "--frames", "0", "--output",
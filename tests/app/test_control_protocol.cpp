@@ -0,0 +1,147 @@
+#include "app/control_protocol.hpp"
+#include "app/control_server.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace goggles::app;
+
+TEST_CASE("parse_control_command: set_params collects named values", "[control]") {
+    auto result =
+        parse_control_command(R"({"cmd":"set_params","params":{"CRT_GAMMA":2.4,"MASK":-1e-1}})");
+    REQUIRE(result);
+    REQUIRE(result->type == ControlCommandType::set_params);
+    REQUIRE(result->params.size() == 2);
+    REQUIRE(result->params[0].name == "CRT_GAMMA");
+    REQUIRE(result->params[0].value == 2.4F);
+    REQUIRE(result->params[1].name == "MASK");
+    REQUIRE(result->params[1].value == -0.1F);
+}
+
+TEST_CASE("parse_control_command: scalar commands", "[control]") {
+    SECTION("load_preset") {
+        auto result = parse_control_command(R"({ "cmd": "load_preset", "path": "a\/b.slangp" })");
+        REQUIRE(result);
+        REQUIRE(result->type == ControlCommandType::load_preset);
+        REQUIRE(result->preset_path == "a/b.slangp");
+    }
+
+    SECTION("set_target_fps") {
+        auto result = parse_control_command(R"({"cmd":"set_target_fps","fps":144})");
+        REQUIRE(result);
+        REQUIRE(result->target_fps == 144);
+    }
+
+    SECTION("set_prechain_resolution") {
+        auto result =
+            parse_control_command(R"({"cmd":"set_prechain_resolution","width":320,"height":240})");
+        REQUIRE(result);
+        REQUIRE(result->width == 320);
+        REQUIRE(result->height == 240);
+    }
+
+    SECTION("select_surface") {
+        auto result = parse_control_command(R"({"cmd":"select_surface","id":7})");
+        REQUIRE(result);
+        REQUIRE(result->surface_id == 7);
+    }
+}
+
+TEST_CASE("parse_control_command: rejects malformed requests", "[control]") {
+    const char* invalid[] = {
+        "",
+        "not json",
+        R"({"cmd":"set_params","params":{"A":1})",
+        R"({"cmd":"set_params","params":{"A":"x"}})",
+        R"({"cmd":"set_target_fps"})",
+        R"({"cmd":"set_target_fps","fps":-1})",
+        R"({"cmd":"set_target_fps","fps":1.5})",
+        R"({"cmd":"select_surface","id":[1]})",
+        R"({"cmd":"reset_params","params":{"A":1}})",
+        R"({"cmd":"explode"})",
+        R"({"cmd":"reset_params"} trailing)",
+    };
+    for (const char* line : invalid) {
+        INFO(line);
+        auto result = parse_control_command(line);
+        REQUIRE_FALSE(result);
+        REQUIRE(result.error().code == goggles::ErrorCode::parse_error);
+    }
+}
+
+TEST_CASE("ControlBatch coalesces commands between frames", "[control]") {
+    ControlBatch batch;
+    REQUIRE(batch.empty());
+
+    batch.merge(*parse_control_command(R"({"cmd":"set_params","params":{"A":1,"B":2}})"));
+    batch.merge(*parse_control_command(R"({"cmd":"set_params","params":{"A":3}})"));
+    REQUIRE(batch.params.size() == 2);
+    REQUIRE(batch.params.at("A") == 3.0F);
+
+    SECTION("Reset drops earlier values and keeps later ones") {
+        batch.merge(*parse_control_command(R"({"cmd":"reset_params"})"));
+        batch.merge(*parse_control_command(R"({"cmd":"set_params","params":{"B":5}})"));
+        REQUIRE(batch.reset_params);
+        REQUIRE(batch.params.size() == 1);
+        REQUIRE(batch.params.at("B") == 5.0F);
+    }
+
+    SECTION("Scalar settings keep the last value") {
+        batch.merge(*parse_control_command(R"({"cmd":"set_target_fps","fps":30})"));
+        batch.merge(*parse_control_command(R"({"cmd":"set_target_fps","fps":0})"));
+        REQUIRE(batch.target_fps == 0U);
+        REQUIRE_FALSE(batch.preset_path);
+    }
+}
+
+TEST_CASE("ControlServer queues socket requests for the main loop", "[control]") {
+    const auto socket_path = std::filesystem::temp_directory_path() /
+                             ("goggles_control_test_" + std::to_string(::getpid()) + ".sock");
+    auto server_result = ControlServer::create(socket_path);
+    REQUIRE(server_result);
+    auto& server = **server_result;
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    REQUIRE(fd >= 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    REQUIRE(::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    const std::string requests = R"({"cmd":"set_params","params":{"A":1}})"
+                                 "\n"
+                                 R"({"cmd":"bogus"})"
+                                 "\n"
+                                 R"({"cmd":"set_params","params":{"A":2}})"
+                                 "\n";
+    REQUIRE(::send(fd, requests.data(), requests.size(), MSG_NOSIGNAL) ==
+            static_cast<ssize_t>(requests.size()));
+
+    std::string replies;
+    char buffer[512];
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::count(replies.begin(), replies.end(), '\n') < 3 &&
+           std::chrono::steady_clock::now() < deadline) {
+        const auto received = ::recv(fd, buffer, sizeof(buffer), 0);
+        REQUIRE(received > 0);
+        replies.append(buffer, static_cast<size_t>(received));
+    }
+    ::close(fd);
+
+    REQUIRE(replies.starts_with("{\"ok\":true}\n{\"ok\":false,\"error\":"));
+    REQUIRE(replies.ends_with("{\"ok\":true}\n"));
+
+    ControlBatch batch;
+    REQUIRE(server.drain(batch) == 2);
+    REQUIRE(batch.params.at("A") == 2.0F);
+
+    server_result->reset();
+    REQUIRE_FALSE(std::filesystem::exists(socket_path));
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace {
+
+auto source_path(const char* relative) -> std::filesystem::path {
+    return std::filesystem::path(__FILE__).parent_path().parent_path().parent_path() / relative;
+}
+
+auto read_text_file(const std::filesystem::path& path) -> std::optional<std::string> {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+TEST_CASE("Compositor reports socket readiness before backend and output setup",
+          "[app][startup_contract]") {
+    auto server_text = read_text_file(source_path("src/compositor/compositor_server.cpp"));
+    REQUIRE(server_text.has_value());
+
+    const auto start_pos = server_text->find("auto CompositorServer::start(");
+    const auto socket_pos = server_text->find("state.bind_wayland_socket()", start_pos);
+    const auto xwayland_pos = server_text->find("state.setup_xwayland()", socket_pos);
+    const auto ready_pos = server_text->find("on_socket_ready(*this);", xwayland_pos);
+    const auto backend_pos = server_text->find("state.start_backend()", ready_pos);
+    const auto output_pos = server_text->find("state.setup_output()", backend_pos);
+    const auto present_pos = server_text->find("state.initialize_present_output()", output_pos);
+    const auto thread_pos = server_text->find("state.start_compositor_thread();", present_pos);
+
+    REQUIRE(start_pos != std::string::npos);
+    REQUIRE(socket_pos != std::string::npos);
+    REQUIRE(xwayland_pos != std::string::npos);
+    REQUIRE(ready_pos != std::string::npos);
+    REQUIRE(backend_pos != std::string::npos);
+    REQUIRE(output_pos != std::string::npos);
+    REQUIRE(present_pos != std::string::npos);
+    REQUIRE(thread_pos != std::string::npos);
+}
+
+TEST_CASE("Xwayland is forked during setup rather than on the compositor thread",
+          "[app][startup_contract]") {
+    auto xwayland_text = read_text_file(source_path("src/compositor/compositor_xwayland.cpp"));
+    REQUIRE(xwayland_text.has_value());
+
+    const auto setup_pos = xwayland_text->find("auto CompositorState::setup_xwayland()");
+    const auto create_pos = xwayland_text->find("wlr_xwayland_create(", setup_pos);
+    const auto dispatch_pos = xwayland_text->find("wl_event_loop_dispatch_idle(", create_pos);
+    const auto setup_end_pos = xwayland_text->find("auto CompositorState::x11_display_name()");
+
+    REQUIRE(setup_pos != std::string::npos);
+    REQUIRE(create_pos != std::string::npos);
+    REQUIRE(dispatch_pos != std::string::npos);
+    REQUIRE(dispatch_pos < setup_end_pos);
+}
+
+TEST_CASE("Target app is launched from the socket-ready hook", "[app][startup_contract]") {
+    auto main_text = read_text_file(source_path("src/app/main.cpp"));
+    REQUIRE(main_text.has_value());
+
+    const auto launcher_pos = main_text->find("auto launch_target = [&]");
+    const auto spawn_pos = main_text->find("spawn_target_app(", launcher_pos);
+    const auto create_pos = main_text->find("Application::create_headless(", launcher_pos);
+    REQUIRE(launcher_pos != std::string::npos);
+    REQUIRE(spawn_pos < create_pos);
+
+    // The run loops only receive the pid; spawning there would wait for the full start-up.
+    const auto headless_pos = main_text->find("static auto run_headless_mode(");
+    const auto run_app_pos = main_text->find("static auto run_app(");
+    REQUIRE(headless_pos != std::string::npos);
+    REQUIRE(main_text->find("spawn_target_app(", headless_pos) > run_app_pos);
+    REQUIRE(main_text->find("app.xwayland_ready()", headless_pos) < run_app_pos);
+
+    auto app_text = read_text_file(source_path("src/app/application.cpp"));
+    REQUIRE(app_text.has_value());
+
+    // Lockstep must be armed before the target can submit its first frame.
+    const auto headless_init_pos =
+        app_text->find("auto Application::init_compositor_server_headless(");
+    const auto lockstep_pos = app_text->find("server.set_lockstep(", headless_init_pos);
+    const auto launch_pos = app_text->find("launch_target(server.x11_display()", lockstep_pos);
+    REQUIRE(headless_init_pos != std::string::npos);
+    REQUIRE(lockstep_pos != std::string::npos);
+    REQUIRE(launch_pos != std::string::npos);
+}
@@ -0,0 +1,139 @@
+#include "compositor/compositor_protocol_hooks.hpp"
+#include "compositor/compositor_targets.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+extern "C" {
+#include <wlr/types/wlr_compositor.h>
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wkeyword-macro"
+#endif
+// xwayland.h contains 'char *class' which conflicts with C++ keyword
+#define class class_
+#include <wlr/xwayland/xwayland.h>
+#undef class
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+}
+
+using namespace goggles::compositor;
+
+namespace {
+
+auto same_box(const wlr_box& lhs, const wlr_box& rhs) -> bool {
+    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.width == rhs.width &&
+           lhs.height == rhs.height;
+}
+
+} // namespace
+
+TEST_CASE("union_box covers both boxes and ignores empty ones", "[compositor][popup]") {
+    const wlr_box menu{.x = 10, .y = 20, .width = 30, .height = 40};
+    const wlr_box empty{};
+
+    REQUIRE(same_box(union_box(empty, menu), menu));
+    REQUIRE(same_box(union_box(menu, empty), menu));
+    REQUIRE(same_box(union_box(menu, {.x = 100, .y = 5, .width = 10, .height = 10}),
+                     {.x = 10, .y = 5, .width = 100, .height = 55}));
+    // A popup that moved by a few pixels damages both its old and its new area.
+    REQUIRE(same_box(union_box(menu, {.x = 15, .y = 25, .width = 30, .height = 40}),
+                     {.x = 10, .y = 20, .width = 35, .height = 45}));
+}
+
+TEST_CASE("get_xwayland_popup_box grows the X11 geometry to the buffer size",
+          "[compositor][popup]") {
+    wlr_xwayland_surface popup{};
+    popup.x = -4;
+    popup.y = 12;
+    popup.width = 80;
+    popup.height = 60;
+    REQUIRE(same_box(get_xwayland_popup_box(popup),
+                     {.x = -4, .y = 12, .width = 80, .height = 60}));
+
+    wlr_surface surface{};
+    surface.current.width = 96;
+    surface.current.height = 48;
+    popup.surface = &surface;
+    REQUIRE(same_box(get_xwayland_popup_box(popup),
+                     {.x = -4, .y = 12, .width = 96, .height = 60}));
+}
+
+TEST_CASE("get_damage_frame_box maps root damage to whole frame pixels", "[compositor][popup]") {
+    constexpr int ROOT_X = 100;
+    constexpr int ROOT_Y = 200;
+    constexpr int FRAME_WIDTH = 640;
+    constexpr int FRAME_HEIGHT = 480;
+
+    SECTION("offsets by the root position at scale 1") {
+        auto box = get_damage_frame_box({.x = 110, .y = 220, .width = 30, .height = 20}, ROOT_X,
+                                        ROOT_Y, 1.0, FRAME_WIDTH, FRAME_HEIGHT);
+        REQUIRE(box.has_value());
+        REQUIRE(same_box(*box, {.x = 10, .y = 20, .width = 30, .height = 20}));
+    }
+
+    SECTION("grows fractional edges outward") {
+        // 1..4 at scale 1.5 is 1.5..6 in frame pixels.
+        auto box = get_damage_frame_box({.x = 101, .y = 201, .width = 3, .height = 3}, ROOT_X,
+                                        ROOT_Y, 1.5, FRAME_WIDTH, FRAME_HEIGHT);
+        REQUIRE(box.has_value());
+        REQUIRE(same_box(*box, {.x = 1, .y = 1, .width = 5, .height = 5}));
+    }
+
+    SECTION("clips to the frame") {
+        auto box = get_damage_frame_box({.x = 90, .y = 190, .width = 20, .height = 20}, ROOT_X,
+                                        ROOT_Y, 1.0, FRAME_WIDTH, FRAME_HEIGHT);
+        REQUIRE(box.has_value());
+        REQUIRE(same_box(*box, {.x = 0, .y = 0, .width = 10, .height = 10}));
+
+        box = get_damage_frame_box({.x = 99, .y = 200, .width = 2, .height = 2}, ROOT_X, ROOT_Y,
+                                   1.5, FRAME_WIDTH, FRAME_HEIGHT);
+        REQUIRE(box.has_value());
+        REQUIRE(same_box(*box, {.x = 0, .y = 0, .width = 2, .height = 3}));
+    }
+
+    SECTION("is empty when the damage lies off-frame") {
+        REQUIRE_FALSE(get_damage_frame_box({.x = 100 + FRAME_WIDTH, .y = 200, .width = 10,
+                                            .height = 10},
+                                           ROOT_X, ROOT_Y, 1.0, FRAME_WIDTH, FRAME_HEIGHT)
+                          .has_value());
+        REQUIRE_FALSE(get_damage_frame_box({.x = 0, .y = 0, .width = 50, .height = 50}, ROOT_X,
+                                           ROOT_Y, 1.0, FRAME_WIDTH, FRAME_HEIGHT)
+                          .has_value());
+    }
+}
+
+TEST_CASE("Popup parent cache matches popups to their root", "[compositor][popup]") {
+    wlr_xwayland_surface root{};
+    wlr_xwayland_surface other_root{};
+    wlr_xwayland_surface menu{};
+    wlr_xwayland_surface submenu{};
+    menu.parent = &root;
+    submenu.parent = &menu;
+
+    XWaylandSurfaceHooks hooks;
+    hooks.xsurface = &submenu;
+    cache_xwayland_popup_parents(hooks);
+    REQUIRE(hooks.popup_parents.size() == 2U);
+    REQUIRE(hooks.popup_parents[0] == &menu);
+    REQUIRE(hooks.popup_parents[1] == &root);
+    REQUIRE(xwayland_popup_belongs_to_root(hooks, &root));
+    REQUIRE_FALSE(xwayland_popup_belongs_to_root(hooks, &other_root));
+
+    // Reparenting refreshes the cache rather than appending to it.
+    submenu.parent = &other_root;
+    cache_xwayland_popup_parents(hooks);
+    REQUIRE(hooks.popup_parents.size() == 1U);
+    REQUIRE(xwayland_popup_belongs_to_root(hooks, &other_root));
+    REQUIRE_FALSE(xwayland_popup_belongs_to_root(hooks, &root));
+
+    // Parentless popups draw over whichever root is captured.
+    XWaylandSurfaceHooks orphan;
+    orphan.xsurface = &menu;
+    menu.parent = nullptr;
+    cache_xwayland_popup_parents(orphan);
+    REQUIRE(orphan.popup_parents.empty());
+    REQUIRE(xwayland_popup_belongs_to_root(orphan, &root));
+}
@@ -0,0 +1,180 @@
+#include "preset_report.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <map>
+#include <string_view>
+#include <system_error>
+
+namespace goggles::test {
+
+namespace {
+
+// Directories under the slang-shaders root that hold shared includes or test fixtures rather
+// than user-facing presets.
+constexpr std::array<std::string_view, 3> SKIPPED_CATEGORIES = {"include", "spec", "test"};
+
+struct CategoryTally {
+    uint32_t passed = 0;
+    uint32_t total = 0;
+};
+
+auto is_skipped_category(std::string_view name) -> bool {
+    return std::find(SKIPPED_CATEGORIES.begin(), SKIPPED_CATEGORIES.end(), name) !=
+           SKIPPED_CATEGORIES.end();
+}
+
+auto status_cell(PresetStatus status) -> const char* {
+    switch (status) {
+    case PresetStatus::passed:
+        return "✅";
+    case PresetStatus::compile_failed:
+        return "❌";
+    case PresetStatus::render_failed:
+        return "❌ (render)";
+    case PresetStatus::golden_mismatch:
+        return "⚠️ (golden)";
+    case PresetStatus::golden_write_failed:
+        return "❌ (golden write)";
+    }
+    return "❌";
+}
+
+} // namespace
+
+auto discover_presets(const std::filesystem::path& shader_dir, const std::string& category_filter)
+    -> std::vector<PresetEntry> {
+    std::vector<PresetEntry> presets;
+    std::error_code ec;
+    if (!std::filesystem::is_directory(shader_dir, ec)) {
+        return presets;
+    }
+
+    for (const auto& category_dir : std::filesystem::directory_iterator(shader_dir, ec)) {
+        if (!category_dir.is_directory(ec)) {
+            continue;
+        }
+        const auto category = category_dir.path().filename().string();
+        if (is_skipped_category(category) || category.starts_with('.')) {
+            continue;
+        }
+        if (!category_filter.empty() && category != category_filter) {
+            continue;
+        }
+
+        for (const auto& file : std::filesystem::recursive_directory_iterator(
+                 category_dir.path(),
+                 std::filesystem::directory_options::skip_permission_denied, ec)) {
+            if (!file.is_regular_file(ec) || file.path().extension() != ".slangp") {
+                continue;
+            }
+            presets.push_back(PresetEntry{
+                .path = file.path(),
+                .category = category,
+                .relative_path = file.path().lexically_relative(category_dir.path()).string(),
+            });
+        }
+    }
+
+    std::sort(presets.begin(), presets.end(), [](const PresetEntry& a, const PresetEntry& b) {
+        if (a.category != b.category) {
+            return a.category < b.category;
+        }
+        return a.relative_path < b.relative_path;
+    });
+    return presets;
+}
+
+auto to_string(PresetStatus status) -> const char* {
+    switch (status) {
+    case PresetStatus::passed:
+        return "passed";
+    case PresetStatus::compile_failed:
+        return "compile_failed";
+    case PresetStatus::render_failed:
+        return "render_failed";
+    case PresetStatus::golden_mismatch:
+        return "golden_mismatch";
+    case PresetStatus::golden_write_failed:
+        return "golden_write_failed";
+    }
+    return "unknown";
+}
+
+auto format_compatibility_report(std::vector<PresetResult> results, const ReportInfo& info)
+    -> std::string {
+    std::sort(results.begin(), results.end(), [](const PresetResult& a, const PresetResult& b) {
+        if (a.entry.category != b.entry.category) {
+            return a.entry.category < b.entry.category;
+        }
+        return a.entry.relative_path < b.entry.relative_path;
+    });
+
+    std::map<std::string, CategoryTally> tallies;
+    CategoryTally overall;
+    for (const auto& result : results) {
+        auto& tally = tallies[result.entry.category];
+        ++tally.total;
+        ++overall.total;
+        if (result.status == PresetStatus::passed) {
+            ++tally.passed;
+            ++overall.passed;
+        }
+    }
+
+    std::string out;
+    out += "# Shader Compatibility Report\n\n";
+    out += "RetroArch shader preset compatibility with Goggles filter chain.\n\n";
+    if (info.rendered) {
+        out += "> **Note:** This report covers **compilation and rendering** of a fixed\n";
+        out += "> synthetic input through each chain";
+        out += info.golden_compared ? ", plus golden-image comparison where a reference exists.\n"
+                                    : ".\n";
+        out += "> Passing does not guarantee visual correctness for real content.\n\n";
+    } else {
+        out += "> **Note:** This report only covers **compilation status** (parse + preprocess).\n";
+        out += "> Passing compilation does not guarantee visual correctness.\n\n";
+    }
+
+    if (!info.shaders_version.empty()) {
+        out += std::format("**Tested versions:** Goggles `{}` / slang-shaders `{}`\n\n",
+                           info.goggles_version, info.shaders_version);
+    } else {
+        out += std::format("**Tested version:** Goggles `{}`\n\n", info.goggles_version);
+    }
+
+    const uint32_t percent = overall.total > 0 ? overall.passed * 100 / overall.total : 0;
+    out += "## Overview\n\n";
+    out += std::format("**Total:** {}/{} presets {} ({}%)\n\n", overall.passed, overall.total,
+                       info.rendered ? "pass" : "compile", percent);
+
+    out += "## By Category\n\n";
+    out += "| Category | Pass Rate | Status |\n";
+    out += "|----------|-----------|--------|\n";
+    for (const auto& [category, tally] : tallies) {
+        out += std::format("| {} | {}/{} | {} |\n", category, tally.passed, tally.total,
+                           tally.passed == tally.total ? "✅" : "⚠️");
+    }
+    out += "\n";
+
+    out += "## Details\n\n";
+    auto it = results.begin();
+    for (const auto& [category, tally] : tallies) {
+        out += "<details>\n";
+        out += std::format("<summary><strong>{}</strong> ({}/{})</summary>\n\n", category,
+                           tally.passed, tally.total);
+        out += "| Preset | Status |\n";
+        out += "|--------|--------|\n";
+        for (; it != results.end() && it->entry.category == category; ++it) {
+            out += std::format("| `{}` | {} |\n", it->entry.relative_path, status_cell(it->status));
+        }
+        out += "\n</details>\n\n";
+    }
+
+    out += "---\n";
+    out += std::format("**Run:** `{}`\n", info.command_line);
+    return out;
+}
+
+} // namespace goggles::test
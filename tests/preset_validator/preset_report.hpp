@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace goggles::test {
+
+enum class PresetStatus : std::uint8_t {
+    passed,
+    compile_failed,
+    render_failed,
+    golden_mismatch,
+    golden_write_failed,
+};
+
+struct PresetEntry {
+    std::filesystem::path path;
+    std::string category;
+    /// Path relative to the category directory (e.g. `koko-aio/koko-aio-ng.slangp`).
+    std::string relative_path;
+};
+
+struct PresetResult {
+    PresetEntry entry;
+    PresetStatus status = PresetStatus::passed;
+    std::string detail;
+    double elapsed_ms = 0.0;
+};
+
+struct ReportInfo {
+    std::string goggles_version;
+    std::string shaders_version;
+    bool rendered = false;
+    bool golden_compared = false;
+    std::string command_line;
+};
+
+/// Enumerates `*.slangp` presets grouped by top-level category, sorted by category then path.
+/// An empty `category_filter` selects every category.
+[[nodiscard]] auto discover_presets(const std::filesystem::path& shader_dir,
+                                    const std::string& category_filter = {})
+    -> std::vector<PresetEntry>;
+
+[[nodiscard]] auto to_string(PresetStatus status) -> const char*;
+
+/// Renders results in the `docs/shader_compatibility.md` layout.
+[[nodiscard]] auto format_compatibility_report(std::vector<PresetResult> results,
+                                               const ReportInfo& info) -> std::string;
+
+} // namespace goggles::test
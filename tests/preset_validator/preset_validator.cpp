@@ -0,0 +1,651 @@
+#include "preset_validator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <goggles/filter_chain.h>
+#include <goggles/filter_chain.hpp>
+#include <mutex>
+#include <render/backend/gpu_allocator.hpp>
+#include <render/backend/vulkan_error.hpp>
+#include <stb_image_write.h>
+#include <system_error>
+#include <util/logging.hpp>
+#include <utility>
+#include <vector>
+
+namespace goggles::test {
+
+namespace {
+
+constexpr vk::Format TARGET_FORMAT = vk::Format::eR8G8B8A8Unorm;
+constexpr uint32_t CHANNELS = 4;
+
+struct ImageAllocation {
+    vk::Image image;
+    vk::DeviceMemory memory;
+    vk::ImageView view;
+};
+
+struct BufferAllocation {
+    vk::Buffer buffer;
+    vk::DeviceMemory memory;
+    bool is_coherent = false;
+};
+
+struct ValidationChain {
+    goggles::filter_chain::Instance instance;
+    goggles::filter_chain::Device device;
+    goggles::filter_chain::Program program;
+    goggles::filter_chain::Chain chain;
+};
+
+struct CommandContext {
+    vk::CommandPool pool;
+    vk::CommandBuffer cmd;
+    vk::Fence fence;
+};
+
+void destroy_image(vk::Device device, ImageAllocation& allocation) {
+    if (allocation.view) {
+        device.destroyImageView(allocation.view);
+    }
+    if (allocation.image) {
+        device.destroyImage(allocation.image);
+    }
+    if (allocation.memory) {
+        device.freeMemory(allocation.memory);
+    }
+    allocation = {};
+}
+
+void destroy_buffer(vk::Device device, BufferAllocation& allocation) {
+    if (allocation.buffer) {
+        device.destroyBuffer(allocation.buffer);
+    }
+    if (allocation.memory) {
+        device.freeMemory(allocation.memory);
+    }
+    allocation = {};
+}
+
+void destroy_command_context(vk::Device device, CommandContext& context) {
+    if (context.fence) {
+        device.destroyFence(context.fence);
+    }
+    if (context.pool) {
+        device.destroyCommandPool(context.pool);
+    }
+    context = {};
+}
+
+auto create_image(const render::backend_internal::VulkanContext& context, vk::Extent2D extent,
+                  vk::ImageUsageFlags usage) -> Result<ImageAllocation> {
+    auto device = context.device;
+    ImageAllocation allocation;
+
+    vk::ImageCreateInfo image_info{};
+    image_info.imageType = vk::ImageType::e2D;
+    image_info.format = TARGET_FORMAT;
+    image_info.extent = vk::Extent3D{extent.width, extent.height, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = vk::SampleCountFlagBits::e1;
+    image_info.tiling = vk::ImageTiling::eOptimal;
+    image_info.usage = usage;
+    image_info.sharingMode = vk::SharingMode::eExclusive;
+    image_info.initialLayout = vk::ImageLayout::eUndefined;
+
+    auto [image_result, image] = device.createImage(image_info);
+    if (image_result != vk::Result::eSuccess) {
+        return make_error<ImageAllocation>(ErrorCode::vulkan_init_failed,
+                                           "Failed to create image: " +
+                                               vk::to_string(image_result));
+    }
+    allocation.image = image;
+
+    const auto requirements = device.getImageMemoryRequirements(image);
+    const auto mem_type = render::backend_internal::select_memory_type(
+        context.physical_device.getMemoryProperties(), requirements.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eDeviceLocal, {});
+    if (!mem_type) {
+        destroy_image(device, allocation);
+        return make_error<ImageAllocation>(ErrorCode::vulkan_init_failed,
+                                           "No device-local memory type for image");
+    }
+
+    vk::MemoryAllocateInfo alloc_info{};
+    alloc_info.allocationSize = requirements.size;
+    alloc_info.memoryTypeIndex = *mem_type;
+    auto [alloc_result, memory] = device.allocateMemory(alloc_info);
+    if (alloc_result != vk::Result::eSuccess) {
+        destroy_image(device, allocation);
+        return make_error<ImageAllocation>(ErrorCode::vulkan_init_failed,
+                                           "Failed to allocate image memory: " +
+                                               vk::to_string(alloc_result));
+    }
+    allocation.memory = memory;
+
+    auto bind_result = device.bindImageMemory(image, memory, 0);
+    if (bind_result != vk::Result::eSuccess) {
+        destroy_image(device, allocation);
+        return make_error<ImageAllocation>(ErrorCode::vulkan_init_failed,
+                                           "Failed to bind image memory: " +
+                                               vk::to_string(bind_result));
+    }
+
+    vk::ImageViewCreateInfo view_info{};
+    view_info.image = image;
+    view_info.viewType = vk::ImageViewType::e2D;
+    view_info.format = TARGET_FORMAT;
+    view_info.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.layerCount = 1;
+    auto [view_result, view] = device.createImageView(view_info);
+    if (view_result != vk::Result::eSuccess) {
+        destroy_image(device, allocation);
+        return make_error<ImageAllocation>(ErrorCode::vulkan_init_failed,
+                                           "Failed to create image view: " +
+                                               vk::to_string(view_result));
+    }
+    allocation.view = view;
+    return allocation;
+}
+
+auto create_host_buffer(const render::backend_internal::VulkanContext& context,
+                        vk::DeviceSize size, vk::BufferUsageFlags usage)
+    -> Result<BufferAllocation> {
+    auto device = context.device;
+    BufferAllocation allocation;
+
+    vk::BufferCreateInfo buffer_info{};
+    buffer_info.size = size;
+    buffer_info.usage = usage;
+    buffer_info.sharingMode = vk::SharingMode::eExclusive;
+    auto [buffer_result, buffer] = device.createBuffer(buffer_info);
+    if (buffer_result != vk::Result::eSuccess) {
+        return make_error<BufferAllocation>(ErrorCode::vulkan_init_failed,
+                                            "Failed to create buffer: " +
+                                                vk::to_string(buffer_result));
+    }
+    allocation.buffer = buffer;
+
+    const auto requirements = device.getBufferMemoryRequirements(buffer);
+    const auto mem_props = context.physical_device.getMemoryProperties();
+    const auto mem_type = render::backend_internal::select_memory_type(
+        mem_props, requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible,
+        vk::MemoryPropertyFlagBits::eHostCoherent);
+    if (!mem_type) {
+        destroy_buffer(device, allocation);
+        return make_error<BufferAllocation>(ErrorCode::vulkan_init_failed,
+                                            "No host-visible memory type for buffer");
+    }
+
+    vk::MemoryAllocateInfo alloc_info{};
+    alloc_info.allocationSize = requirements.size;
+    alloc_info.memoryTypeIndex = *mem_type;
+    auto [alloc_result, memory] = device.allocateMemory(alloc_info);
+    if (alloc_result != vk::Result::eSuccess) {
+        destroy_buffer(device, allocation);
+        return make_error<BufferAllocation>(ErrorCode::vulkan_init_failed,
+                                            "Failed to allocate buffer memory: " +
+                                                vk::to_string(alloc_result));
+    }
+    allocation.memory = memory;
+    allocation.is_coherent = (mem_props.memoryTypes[*mem_type].propertyFlags &
+                              vk::MemoryPropertyFlagBits::eHostCoherent) !=
+                             vk::MemoryPropertyFlags{};
+
+    auto bind_result = device.bindBufferMemory(buffer, memory, 0);
+    if (bind_result != vk::Result::eSuccess) {
+        destroy_buffer(device, allocation);
+        return make_error<BufferAllocation>(ErrorCode::vulkan_init_failed,
+                                            "Failed to bind buffer memory: " +
+                                                vk::to_string(bind_result));
+    }
+    return allocation;
+}
+
+auto create_command_context(const render::backend_internal::VulkanContext& context)
+    -> Result<CommandContext> {
+    auto device = context.device;
+    CommandContext command_context;
+
+    vk::CommandPoolCreateInfo pool_info{};
+    pool_info.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+    pool_info.queueFamilyIndex = context.graphics_queue_family;
+    auto [pool_result, pool] = device.createCommandPool(pool_info);
+    if (pool_result != vk::Result::eSuccess) {
+        return make_error<CommandContext>(ErrorCode::vulkan_init_failed,
+                                          "Failed to create command pool");
+    }
+    command_context.pool = pool;
+
+    vk::CommandBufferAllocateInfo alloc_info{};
+    alloc_info.commandPool = pool;
+    alloc_info.level = vk::CommandBufferLevel::ePrimary;
+    alloc_info.commandBufferCount = 1;
+    auto [alloc_result, buffers] = device.allocateCommandBuffers(alloc_info);
+    if (alloc_result != vk::Result::eSuccess) {
+        destroy_command_context(device, command_context);
+        return make_error<CommandContext>(ErrorCode::vulkan_init_failed,
+                                          "Failed to allocate command buffer");
+    }
+    command_context.cmd = buffers[0];
+
+    auto [fence_result, fence] = device.createFence(vk::FenceCreateInfo{});
+    if (fence_result != vk::Result::eSuccess) {
+        destroy_command_context(device, command_context);
+        return make_error<CommandContext>(ErrorCode::vulkan_init_failed, "Failed to create fence");
+    }
+    command_context.fence = fence;
+    return command_context;
+}
+
+auto make_layout_barrier(vk::Image image, vk::ImageLayout old_layout, vk::ImageLayout new_layout,
+                         vk::AccessFlags src_access, vk::AccessFlags dst_access)
+    -> vk::ImageMemoryBarrier {
+    vk::ImageMemoryBarrier barrier{};
+    barrier.srcAccessMask = src_access;
+    barrier.dstAccessMask = dst_access;
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    return barrier;
+}
+
+// Quadrant test card (red, green, blue, white) with a luminance ramp along the bottom edge and a
+// one-pixel grid, so scaling, color, and gamma regressions all show up in a single capture.
+auto make_synthetic_pattern(vk::Extent2D extent) -> std::vector<uint8_t> {
+    std::vector<uint8_t> pixels(static_cast<size_t>(extent.width) * extent.height * CHANNELS);
+    const uint32_t half_w = extent.width / 2;
+    const uint32_t half_h = extent.height / 2;
+    const uint32_t ramp_start = extent.height - extent.height / 8;
+
+    for (uint32_t y = 0; y < extent.height; ++y) {
+        for (uint32_t x = 0; x < extent.width; ++x) {
+            std::array<uint8_t, CHANNELS> rgba{0, 0, 0, 255};
+            if (y >= ramp_start) {
+                const auto level = static_cast<uint8_t>((x * 255) / std::max(1u, extent.width - 1));
+                rgba = {level, level, level, 255};
+            } else if (x % 16 == 0 || y % 16 == 0) {
+                rgba = {32, 32, 32, 255};
+            } else if (x < half_w && y < half_h) {
+                rgba = {255, 0, 0, 255};
+            } else if (y < half_h) {
+                rgba = {0, 255, 0, 255};
+            } else if (x < half_w) {
+                rgba = {0, 0, 255, 255};
+            } else {
+                rgba = {255, 255, 255, 255};
+            }
+            std::memcpy(&pixels[(static_cast<size_t>(y) * extent.width + x) * CHANNELS],
+                        rgba.data(), CHANNELS);
+        }
+    }
+    return pixels;
+}
+
+auto create_validation_chain(const render::backend_internal::VulkanContext& context,
+                             const ValidatorOptions& options, const std::filesystem::path& preset)
+    -> Result<ValidationChain> {
+    ValidationChain slot;
+
+    auto instance_info = goggles_fc_instance_create_info_init();
+    slot.instance = GOGGLES_TRY(goggles::filter_chain::Instance::create(&instance_info));
+
+    const auto cache_dir = options.cache_dir.string();
+    auto dev_info = goggles_fc_vk_device_create_info_init();
+    dev_info.physical_device = context.physical_device;
+    dev_info.device = context.device;
+    dev_info.graphics_queue = context.graphics_queue;
+    dev_info.graphics_queue_family_index = context.graphics_queue_family;
+    if (!cache_dir.empty()) {
+        dev_info.cache_dir.data = cache_dir.c_str();
+        dev_info.cache_dir.size = cache_dir.size();
+    }
+    slot.device = GOGGLES_TRY(goggles::filter_chain::Device::create(slot.instance, &dev_info));
+
+    const auto utf8 = preset.u8string();
+    auto source = goggles_fc_preset_source_init();
+    source.kind = GOGGLES_FC_PRESET_SOURCE_FILE;
+    source.path.data = reinterpret_cast<const char*>(utf8.c_str());
+    source.path.size = utf8.size();
+    slot.program = GOGGLES_TRY(goggles::filter_chain::Program::create(slot.device, &source));
+
+    auto chain_info = goggles_fc_chain_create_info_init();
+    chain_info.target_format = static_cast<VkFormat>(TARGET_FORMAT);
+    chain_info.frames_in_flight = 1;
+    chain_info.initial_stage_mask = GOGGLES_FC_STAGE_MASK_ALL;
+    slot.chain =
+        GOGGLES_TRY(goggles::filter_chain::Chain::create(slot.device, slot.program, &chain_info));
+
+    goggles_fc_extent_2d_t extent{.width = options.target_extent.width,
+                                  .height = options.target_extent.height};
+    GOGGLES_TRY(slot.chain.resize(&extent));
+    return slot;
+}
+
+} // namespace
+
+auto PresetValidator::create(const ValidatorOptions& options) -> ResultPtr<PresetValidator> {
+    auto validator = std::unique_ptr<PresetValidator>(new PresetValidator());
+    validator->m_options = options;
+
+    auto context_result = render::backend_internal::VulkanContext::create_headless(
+        options.enable_validation, options.gpu_selector);
+    if (!context_result) {
+        return nonstd::make_unexpected(context_result.error());
+    }
+    validator->m_context = std::move(context_result.value());
+    validator->m_device_name =
+        validator->m_context.physical_device.getProperties().deviceName.data();
+
+    if (!options.compile_only) {
+        GOGGLES_TRY(validator->create_synthetic_source());
+    }
+    return {std::move(validator)};
+}
+
+PresetValidator::~PresetValidator() {
+    if (!m_context.initialized()) {
+        return;
+    }
+    auto wait_result = m_context.device.waitIdle();
+    if (wait_result != vk::Result::eSuccess) {
+        GOGGLES_LOG_WARN("waitIdle failed during validator shutdown: {}",
+                         vk::to_string(wait_result));
+    }
+    ImageAllocation source{m_source_image, m_source_memory, m_source_view};
+    destroy_image(m_context.device, source);
+    m_context.destroy();
+}
+
+auto PresetValidator::create_synthetic_source() -> Result<void> {
+    const auto extent = m_options.source_extent;
+    auto source = GOGGLES_TRY(
+        create_image(m_context, extent,
+                     vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst));
+    m_source_image = source.image;
+    m_source_memory = source.memory;
+    m_source_view = source.view;
+
+    const auto pixels = make_synthetic_pattern(extent);
+    auto staging = GOGGLES_TRY(
+        create_host_buffer(m_context, pixels.size(), vk::BufferUsageFlagBits::eTransferSrc));
+    auto command_context = create_command_context(m_context);
+    if (!command_context) {
+        destroy_buffer(m_context.device, staging);
+        return nonstd::make_unexpected(command_context.error());
+    }
+
+    const auto cleanup = [&]() {
+        destroy_command_context(m_context.device, *command_context);
+        destroy_buffer(m_context.device, staging);
+    };
+
+    auto [map_result, mapped] = m_context.device.mapMemory(staging.memory, 0, pixels.size());
+    if (map_result != vk::Result::eSuccess) {
+        cleanup();
+        return make_error<void>(ErrorCode::vulkan_init_failed, "Failed to map staging memory");
+    }
+    std::memcpy(mapped, pixels.data(), pixels.size());
+    if (!staging.is_coherent) {
+        vk::MappedMemoryRange range{};
+        range.memory = staging.memory;
+        range.size = VK_WHOLE_SIZE;
+        (void)m_context.device.flushMappedMemoryRanges(range);
+    }
+    m_context.device.unmapMemory(staging.memory);
+
+    auto cmd = command_context->cmd;
+    vk::CommandBufferBeginInfo begin_info{};
+    begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    if (cmd.begin(begin_info) != vk::Result::eSuccess) {
+        cleanup();
+        return make_error<void>(ErrorCode::vulkan_device_lost, "Command buffer begin failed");
+    }
+
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                        vk::PipelineStageFlagBits::eTransfer, {}, {}, {},
+                        make_layout_barrier(m_source_image, vk::ImageLayout::eUndefined,
+                                            vk::ImageLayout::eTransferDstOptimal,
+                                            vk::AccessFlagBits::eNone,
+                                            vk::AccessFlagBits::eTransferWrite));
+    vk::BufferImageCopy region{};
+    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = vk::Extent3D{extent.width, extent.height, 1};
+    cmd.copyBufferToImage(staging.buffer, m_source_image, vk::ImageLayout::eTransferDstOptimal,
+                          region);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                        vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {},
+                        make_layout_barrier(m_source_image, vk::ImageLayout::eTransferDstOptimal,
+                                            vk::ImageLayout::eShaderReadOnlyOptimal,
+                                            vk::AccessFlagBits::eTransferWrite,
+                                            vk::AccessFlagBits::eShaderRead));
+    if (cmd.end() != vk::Result::eSuccess) {
+        cleanup();
+        return make_error<void>(ErrorCode::vulkan_device_lost, "Command buffer end failed");
+    }
+
+    auto submit_result = submit_and_wait(cmd, command_context->fence);
+    cleanup();
+    return submit_result;
+}
+
+auto PresetValidator::submit_and_wait(vk::CommandBuffer cmd, vk::Fence fence) -> Result<void> {
+    VK_TRY(m_context.device.resetFences(fence), ErrorCode::vulkan_device_lost,
+           "Fence reset failed");
+
+    vk::SubmitInfo submit_info{};
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &cmd;
+    {
+        // vkQueueSubmit requires external synchronization of the queue.
+        std::lock_guard lock(m_queue_mutex);
+        VK_TRY(m_context.graphics_queue.submit(submit_info, fence), ErrorCode::vulkan_device_lost,
+               "Queue submit failed");
+    }
+
+    VK_TRY(m_context.device.waitForFences(fence, VK_TRUE, UINT64_MAX),
+           ErrorCode::vulkan_device_lost, "Fence wait failed");
+    return {};
+}
+
+auto PresetValidator::render_preset(goggles::filter_chain::Chain& chain) -> Result<Image> {
+    auto device = m_context.device;
+    const auto target_extent = m_options.target_extent;
+
+    auto target = GOGGLES_TRY(create_image(m_context, target_extent,
+                                           vk::ImageUsageFlagBits::eColorAttachment |
+                                               vk::ImageUsageFlagBits::eTransferSrc));
+    const vk::DeviceSize readback_size =
+        static_cast<vk::DeviceSize>(target_extent.width) * target_extent.height * CHANNELS;
+    auto readback = create_host_buffer(m_context, readback_size,
+                                       vk::BufferUsageFlagBits::eTransferDst);
+    auto command_context = create_command_context(m_context);
+    const auto cleanup = [&]() {
+        if (command_context) {
+            destroy_command_context(device, *command_context);
+        }
+        if (readback) {
+            destroy_buffer(device, *readback);
+        }
+        destroy_image(device, target);
+    };
+    if (!readback || !command_context) {
+        auto error = !readback ? readback.error() : command_context.error();
+        cleanup();
+        return nonstd::make_unexpected(error);
+    }
+
+    auto cmd = command_context->cmd;
+    const uint32_t frames = std::max(1u, m_options.frames);
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        const bool last_frame = frame + 1 == frames;
+        auto record = [&]() -> Result<void> {
+            VK_TRY(cmd.reset(), ErrorCode::vulkan_device_lost, "Command buffer reset failed");
+            vk::CommandBufferBeginInfo begin_info{};
+            begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+            VK_TRY(cmd.begin(begin_info), ErrorCode::vulkan_device_lost,
+                   "Command buffer begin failed");
+
+            cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                vk::PipelineStageFlagBits::eColorAttachmentOutput, {}, {}, {},
+                                make_layout_barrier(target.image, vk::ImageLayout::eUndefined,
+                                                    vk::ImageLayout::eColorAttachmentOptimal,
+                                                    vk::AccessFlagBits::eNone,
+                                                    vk::AccessFlagBits::eColorAttachmentWrite));
+
+            auto info = goggles_fc_record_info_vk_init();
+            info.command_buffer = cmd;
+            info.source_image = m_source_image;
+            info.source_view = m_source_view;
+            info.source_extent.width = m_options.source_extent.width;
+            info.source_extent.height = m_options.source_extent.height;
+            info.target_view = target.view;
+            info.target_extent.width = target_extent.width;
+            info.target_extent.height = target_extent.height;
+            info.frame_index = 0;
+            info.scale_mode = GOGGLES_FC_SCALE_MODE_STRETCH;
+            info.integer_scale = 1;
+            GOGGLES_TRY(chain.record_vk(&info));
+
+            if (last_frame) {
+                cmd.pipelineBarrier(
+                    vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                    vk::PipelineStageFlagBits::eTransfer, {}, {}, {},
+                    make_layout_barrier(target.image, vk::ImageLayout::eColorAttachmentOptimal,
+                                        vk::ImageLayout::eTransferSrcOptimal,
+                                        vk::AccessFlagBits::eColorAttachmentWrite,
+                                        vk::AccessFlagBits::eTransferRead));
+                vk::BufferImageCopy region{};
+                region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+                region.imageSubresource.layerCount = 1;
+                region.imageExtent = vk::Extent3D{target_extent.width, target_extent.height, 1};
+                cmd.copyImageToBuffer(target.image, vk::ImageLayout::eTransferSrcOptimal,
+                                      readback->buffer, region);
+            }
+
+            VK_TRY(cmd.end(), ErrorCode::vulkan_device_lost, "Command buffer end failed");
+            return submit_and_wait(cmd, command_context->fence);
+        };
+
+        auto frame_result = record();
+        if (!frame_result) {
+            cleanup();
+            return nonstd::make_unexpected(frame_result.error());
+        }
+    }
+
+    Image image;
+    image.width = static_cast<int>(target_extent.width);
+    image.height = static_cast<int>(target_extent.height);
+    image.channels = static_cast<int>(CHANNELS);
+    image.data.resize(readback_size);
+
+    auto [map_result, mapped] = device.mapMemory(readback->memory, 0, readback_size);
+    if (map_result != vk::Result::eSuccess) {
+        cleanup();
+        return make_error<Image>(ErrorCode::vulkan_device_lost, "Failed to map readback memory");
+    }
+    if (!readback->is_coherent) {
+        vk::MappedMemoryRange range{};
+        range.memory = readback->memory;
+        range.size = VK_WHOLE_SIZE;
+        (void)device.invalidateMappedMemoryRanges(range);
+    }
+    std::memcpy(image.data.data(), mapped, readback_size);
+    device.unmapMemory(readback->memory);
+
+    cleanup();
+    return image;
+}
+
+auto PresetValidator::golden_path(const PresetEntry& entry) const -> std::filesystem::path {
+    auto path = m_options.golden_dir / entry.category / entry.relative_path;
+    path.replace_extension(".png");
+    return path;
+}
+
+auto PresetValidator::validate(const PresetEntry& entry) -> PresetResult {
+    const auto start = std::chrono::steady_clock::now();
+    PresetResult result{.entry = entry};
+    const auto finish = [&]() {
+        result.elapsed_ms = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+        return result;
+    };
+
+    // Parsing, Slang compilation and pipeline creation run concurrently across workers.
+    auto chain_result = create_validation_chain(m_context, m_options, entry.path);
+    if (!chain_result) {
+        result.status = PresetStatus::compile_failed;
+        result.detail = chain_result.error().message;
+        return finish();
+    }
+    if (m_options.compile_only) {
+        return finish();
+    }
+
+    auto image_result = render_preset(chain_result->chain);
+    if (!image_result) {
+        result.status = PresetStatus::render_failed;
+        result.detail = image_result.error().message;
+        return finish();
+    }
+
+    if (m_options.golden_dir.empty()) {
+        return finish();
+    }
+
+    const auto reference_path = golden_path(entry);
+    std::error_code ec;
+    if (m_options.write_golden) {
+        std::filesystem::create_directories(reference_path.parent_path(), ec);
+        if (stbi_write_png(reference_path.c_str(), image_result->width, image_result->height,
+                           image_result->channels, image_result->data.data(),
+                           image_result->width * image_result->channels) == 0) {
+            result.status = PresetStatus::golden_write_failed;
+            result.detail = "failed to write golden image: " + reference_path.string();
+        }
+        return finish();
+    }
+
+    if (!std::filesystem::exists(reference_path, ec)) {
+        return finish();
+    }
+
+    auto reference = load_png(reference_path);
+    if (!reference) {
+        result.status = PresetStatus::golden_mismatch;
+        result.detail = reference.error().message;
+        return finish();
+    }
+
+    std::filesystem::path diff_out;
+    if (!m_options.failure_dir.empty()) {
+        diff_out = m_options.failure_dir / entry.category / entry.relative_path;
+        diff_out.replace_extension(".diff.png");
+        std::filesystem::create_directories(diff_out.parent_path(), ec);
+    }
+
+    const auto compare = compare_images(*image_result, *reference, m_options.tolerance, diff_out);
+    if (compare.failing_percentage > m_options.max_failing_percentage) {
+        result.status = PresetStatus::golden_mismatch;
+        result.detail = compare.error_message.empty()
+                            ? std::to_string(compare.failing_percentage) + "% pixels differ"
+                            : compare.error_message;
+    }
+    return finish();
+}
+
+} // namespace goggles::test
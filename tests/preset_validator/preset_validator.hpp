@@ -0,0 +1,72 @@
+#pragma once
+
+#include "image_compare.hpp"
+#include "preset_report.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <goggles/error.hpp>
+#include <goggles/filter_chain.hpp>
+#include <memory>
+#include <mutex>
+#include <render/backend/vulkan_context.hpp>
+#include <string>
+#include <vulkan/vulkan.hpp>
+
+namespace goggles::test {
+
+struct ValidatorOptions {
+    std::string gpu_selector;
+    std::filesystem::path cache_dir;
+    std::filesystem::path golden_dir;
+    std::filesystem::path failure_dir;
+    vk::Extent2D source_extent{320, 240};
+    vk::Extent2D target_extent{640, 480};
+    uint32_t frames = 3;
+    double tolerance = 0.02;
+    double max_failing_percentage = 1.0;
+    bool compile_only = false;
+    bool write_golden = false;
+    bool enable_validation = false;
+};
+
+/// @brief Compiles and renders presets against one shared headless Vulkan device.
+///
+/// `validate()` is safe to call concurrently from `util::JobSystem` workers: each call owns its
+/// filter-chain instance, command pool and target image. Only submits to the shared graphics
+/// queue are serialized, so chain creation runs in parallel.
+class PresetValidator {
+public:
+    [[nodiscard]] static auto create(const ValidatorOptions& options)
+        -> ResultPtr<PresetValidator>;
+
+    ~PresetValidator();
+
+    PresetValidator(const PresetValidator&) = delete;
+    PresetValidator& operator=(const PresetValidator&) = delete;
+    PresetValidator(PresetValidator&&) = delete;
+    PresetValidator& operator=(PresetValidator&&) = delete;
+
+    [[nodiscard]] auto validate(const PresetEntry& entry) -> PresetResult;
+
+    [[nodiscard]] auto device_name() const -> const std::string& { return m_device_name; }
+
+private:
+    PresetValidator() = default;
+
+    [[nodiscard]] auto create_synthetic_source() -> Result<void>;
+    [[nodiscard]] auto render_preset(goggles::filter_chain::Chain& chain) -> Result<Image>;
+    [[nodiscard]] auto submit_and_wait(vk::CommandBuffer cmd, vk::Fence fence) -> Result<void>;
+    [[nodiscard]] auto golden_path(const PresetEntry& entry) const -> std::filesystem::path;
+
+    ValidatorOptions m_options;
+    render::backend_internal::VulkanContext m_context;
+    std::mutex m_queue_mutex;
+    std::string m_device_name;
+
+    vk::Image m_source_image;
+    vk::DeviceMemory m_source_memory;
+    vk::ImageView m_source_view;
+};
+
+} // namespace goggles::test
@@ -0,0 +1,160 @@
+#include "preset_report.hpp"
+#include "preset_validator.hpp"
+
+#include <CLI/CLI.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <string>
+#include <util/job_system.hpp>
+#include <util/logging.hpp>
+#include <vector>
+
+namespace {
+
+struct ValidatorCli {
+    std::filesystem::path shader_dir = "shaders/retroarch";
+    std::filesystem::path output;
+    std::string category;
+    std::string goggles_version = "unknown";
+    std::string shaders_version;
+    uint32_t jobs = 0;
+    uint32_t source_width = 320;
+    uint32_t source_height = 240;
+    uint32_t target_width = 640;
+    uint32_t target_height = 480;
+    bool verbose = false;
+};
+
+auto join_args(int argc, char** argv) -> std::string {
+    std::string command_line;
+    for (int i = 0; i < argc; ++i) {
+        if (i > 0) {
+            command_line += ' ';
+        }
+        command_line += argv[i];
+    }
+    return command_line;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    goggles::initialize_logger("goggles_preset_validator");
+    goggles::set_log_level(spdlog::level::warn);
+
+    ValidatorCli cli;
+    goggles::test::ValidatorOptions options;
+
+    CLI::App app{"goggles_preset_validator - batch compile/render validation of shader presets"};
+    app.add_option("--shader-dir", cli.shader_dir, "RetroArch slang-shaders root")
+        ->check(CLI::ExistingDirectory);
+    app.add_option("--category", cli.category, "Only validate one category (e.g. crt)");
+    app.add_option("-o,--output", cli.output,
+                   "Write the compatibility report (docs/shader_compatibility.md layout)");
+    app.add_option("-j,--jobs", cli.jobs, "Worker threads (0 = hardware concurrency)");
+    app.add_option("--gpu", options.gpu_selector, "Select GPU by index or name substring");
+    app.add_option("--cache-dir", options.cache_dir, "Shader cache directory");
+    app.add_flag("--compile-only", options.compile_only,
+                 "Only parse and compile presets (skip rendering)");
+    app.add_option("--frames", options.frames, "Frames to render per preset before readback")
+        ->check(CLI::Range(1u, 1000u));
+    app.add_option("--source-width", cli.source_width, "Synthetic input width")
+        ->check(CLI::Range(1u, 16384u));
+    app.add_option("--source-height", cli.source_height, "Synthetic input height")
+        ->check(CLI::Range(1u, 16384u));
+    app.add_option("--target-width", cli.target_width, "Render target width")
+        ->check(CLI::Range(1u, 16384u));
+    app.add_option("--target-height", cli.target_height, "Render target height")
+        ->check(CLI::Range(1u, 16384u));
+    app.add_option("--golden-dir", options.golden_dir,
+                   "Compare output against <dir>/<category>/<preset>.png when present");
+    app.add_flag("--update-golden", options.write_golden,
+                 "Write rendered output into --golden-dir instead of comparing");
+    app.add_option("--tolerance", options.tolerance, "Per-channel tolerance (0-1)")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--max-failing-pct", options.max_failing_percentage,
+                   "Allowed percentage of pixels outside tolerance")
+        ->check(CLI::Range(0.0, 100.0));
+    app.add_option("--failure-dir", options.failure_dir, "Write diff heatmaps for mismatches");
+    app.add_option("--goggles-version", cli.goggles_version, "Goggles revision for the report");
+    app.add_option("--shaders-version", cli.shaders_version,
+                   "slang-shaders revision for the report");
+    app.add_flag("--validation", options.enable_validation, "Enable Vulkan validation layers");
+    app.add_flag("-v,--verbose", cli.verbose, "Print failure details");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (options.write_golden && options.golden_dir.empty()) {
+        std::cerr << "--update-golden requires --golden-dir\n";
+        return EXIT_FAILURE;
+    }
+    options.source_extent = vk::Extent2D{cli.source_width, cli.source_height};
+    options.target_extent = vk::Extent2D{cli.target_width, cli.target_height};
+
+    const auto presets = goggles::test::discover_presets(cli.shader_dir, cli.category);
+    if (presets.empty()) {
+        std::cerr << "No presets found under " << cli.shader_dir << '\n';
+        return EXIT_FAILURE;
+    }
+
+    auto validator_result = goggles::test::PresetValidator::create(options);
+    if (!validator_result) {
+        std::cerr << "Failed to create validator: " << validator_result.error().message << '\n';
+        return EXIT_FAILURE;
+    }
+    auto& validator = *validator_result.value();
+
+    goggles::util::JobSystem::initialize(cli.jobs);
+    std::cout << "Validating " << presets.size() << " presets on " << validator.device_name()
+              << " with " << goggles::util::JobSystem::thread_count() << " workers\n";
+
+    std::vector<std::future<goggles::test::PresetResult>> pending;
+    pending.reserve(presets.size());
+    for (const auto& preset : presets) {
+        pending.push_back(goggles::util::JobSystem::submit(
+            [&validator, preset]() { return validator.validate(preset); }));
+    }
+
+    std::vector<goggles::test::PresetResult> results;
+    results.reserve(pending.size());
+    size_t failures = 0;
+    for (auto& future : pending) {
+        auto result = future.get();
+        if (result.status != goggles::test::PresetStatus::passed) {
+            ++failures;
+            std::cout << result.entry.category << "/" << result.entry.relative_path << ": "
+                      << goggles::test::to_string(result.status);
+            if (cli.verbose && !result.detail.empty()) {
+                std::cout << " - " << result.detail;
+            }
+            std::cout << '\n';
+        }
+        results.push_back(std::move(result));
+    }
+    goggles::util::JobSystem::shutdown();
+
+    std::cout << (results.size() - failures) << "/" << results.size() << " presets passed\n";
+
+    if (!cli.output.empty()) {
+        const auto report = goggles::test::format_compatibility_report(
+            results, goggles::test::ReportInfo{
+                         .goggles_version = cli.goggles_version,
+                         .shaders_version = cli.shaders_version,
+                         .rendered = !options.compile_only,
+                         .golden_compared = !options.golden_dir.empty() && !options.write_golden,
+                         .command_line = join_args(argc, argv),
+                     });
+        std::ofstream out(cli.output);
+        if (!out) {
+            std::cerr << "Failed to open " << cli.output << " for writing\n";
+            return EXIT_FAILURE;
+        }
+        out << report;
+        std::cout << "Report saved to " << cli.output << '\n';
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
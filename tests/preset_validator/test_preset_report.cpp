@@ -0,0 +1,126 @@
+#include "preset_report.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+class TempShaderTree {
+public:
+    TempShaderTree()
+        : m_root(std::filesystem::temp_directory_path() /
+                 ("goggles_preset_report_" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(m_root);
+        std::filesystem::create_directories(m_root);
+    }
+
+    ~TempShaderTree() {
+        std::error_code ec;
+        std::filesystem::remove_all(m_root, ec);
+    }
+
+    TempShaderTree(const TempShaderTree&) = delete;
+    TempShaderTree& operator=(const TempShaderTree&) = delete;
+
+    void touch(const std::filesystem::path& relative) const {
+        const auto path = m_root / relative;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << "shaders = 0\n";
+    }
+
+    [[nodiscard]] auto root() const -> const std::filesystem::path& { return m_root; }
+
+private:
+    std::filesystem::path m_root;
+};
+
+auto make_result(std::string category, std::string relative_path,
+                 goggles::test::PresetStatus status) -> goggles::test::PresetResult {
+    return goggles::test::PresetResult{
+        .entry = {.path = {},
+                  .category = std::move(category),
+                  .relative_path = std::move(relative_path)},
+        .status = status,
+    };
+}
+
+} // namespace
+
+TEST_CASE("discover_presets groups by category and skips support directories",
+          "[preset_validator]") {
+    TempShaderTree tree;
+    tree.touch("crt/zfast-crt.slangp");
+    tree.touch("crt/shaders/zfast-crt.slang");
+    tree.touch("bezel/koko-aio/koko-aio-ng.slangp");
+    tree.touch("include/helper.slangp");
+    tree.touch("test/format.slangp");
+
+    const auto presets = goggles::test::discover_presets(tree.root());
+    REQUIRE(presets.size() == 2);
+    CHECK(presets[0].category == "bezel");
+    CHECK(presets[0].relative_path == "koko-aio/koko-aio-ng.slangp");
+    CHECK(presets[1].category == "crt");
+    CHECK(presets[1].relative_path == "zfast-crt.slangp");
+
+    const auto crt_only = goggles::test::discover_presets(tree.root(), "crt");
+    REQUIRE(crt_only.size() == 1);
+    CHECK(crt_only[0].category == "crt");
+}
+
+TEST_CASE("discover_presets tolerates a missing shader directory", "[preset_validator]") {
+    CHECK(goggles::test::discover_presets("/nonexistent/goggles/shaders").empty());
+}
+
+TEST_CASE("compatibility report keeps the docs table layout", "[preset_validator]") {
+    std::vector<goggles::test::PresetResult> results = {
+        make_result("crt", "zfast-crt.slangp", goggles::test::PresetStatus::passed),
+        make_result("crt", "crt-royale.slangp", goggles::test::PresetStatus::render_failed),
+        make_result("anamorphic", "anamorphic.slangp", goggles::test::PresetStatus::passed),
+    };
+
+    const auto report = goggles::test::format_compatibility_report(
+        results, goggles::test::ReportInfo{.goggles_version = "abc1234",
+                                           .shaders_version = "def5678",
+                                           .rendered = true,
+                                           .golden_compared = false,
+                                           .command_line = "goggles_preset_validator"});
+
+    CHECK(report.starts_with("# Shader Compatibility Report\n"));
+    CHECK(report.find("**Tested versions:** Goggles `abc1234` / slang-shaders `def5678`") !=
+          std::string::npos);
+    CHECK(report.find("**Total:** 2/3 presets pass (66%)") != std::string::npos);
+    CHECK(report.find("| anamorphic | 1/1 | ✅ |") != std::string::npos);
+    CHECK(report.find("| crt | 1/2 | ⚠️ |") != std::string::npos);
+    CHECK(report.find("| `crt-royale.slangp` | ❌ (render) |") != std::string::npos);
+
+    // Categories and presets are sorted regardless of completion order.
+    CHECK(report.find("<strong>anamorphic</strong>") < report.find("<strong>crt</strong>"));
+    CHECK(report.find("`crt-royale.slangp`") < report.find("`zfast-crt.slangp`"));
+    CHECK(report.ends_with("**Run:** `goggles_preset_validator`\n"));
+}
+
+TEST_CASE("compile-only report keeps the compilation note", "[preset_validator]") {
+    const auto report = goggles::test::format_compatibility_report(
+        {make_result("crt", "zfast-crt.slangp", goggles::test::PresetStatus::passed)},
+        goggles::test::ReportInfo{.goggles_version = "abc1234"});
+
+    CHECK(report.find("only covers **compilation status**") != std::string::npos);
+    CHECK(report.find("**Tested version:** Goggles `abc1234`") != std::string::npos);
+    CHECK(report.find("**Total:** 1/1 presets compile (100%)") != std::string::npos);
+}
+
+TEST_CASE("golden write failures are reported as failures", "[preset_validator]") {
+    CHECK(std::string(goggles::test::to_string(
+              goggles::test::PresetStatus::golden_write_failed)) == "golden_write_failed");
+
+    const auto report = goggles::test::format_compatibility_report(
+        {make_result("crt", "zfast-crt.slangp", goggles::test::PresetStatus::golden_write_failed)},
+        goggles::test::ReportInfo{.goggles_version = "abc1234", .rendered = true});
+
+    CHECK(report.find("**Total:** 0/1 presets pass (0%)") != std::string::npos);
+    CHECK(report.find("| `zfast-crt.slangp` | ❌ (golden write) |") != std::string::npos);
+}
@@ -76,6 +76,7 @@ TEST_CASE("Filter chain boundary control contract coverage", "[filter_chain][bou
     using ListStageSig = std::vector<FilterControlDescriptor> (FCC::*)(FilterControlStage) const;
     using SetSig = bool (FCC::*)(FilterControlId, float);
     using ResetSig = bool (FCC::*)(FilterControlId);
+    using QueueSig = void (FCC::*)(FilterControlId, float);
 
     static_assert(
         std::is_same_v<decltype(static_cast<ListAllSig>(&FCC::list_filter_controls)), ListAllSig>);
@@ -83,6 +84,7 @@ TEST_CASE("Filter chain boundary control contract coverage", "[filter_chain][bou
                                  ListStageSig>);
     static_assert(std::is_same_v<decltype(&FCC::set_filter_control_value), SetSig>);
     static_assert(std::is_same_v<decltype(&FCC::reset_filter_control_value), ResetSig>);
+    static_assert(std::is_same_v<decltype(&FCC::queue_filter_control_value), QueueSig>);
 
     static_assert(std::is_same_v<decltype(goggles::ui::ParameterState{}.descriptor),
                                  FilterControlDescriptor>);
@@ -105,7 +107,8 @@ TEST_CASE("Filter chain boundary control contract coverage", "[filter_chain][bou
     auto app_text = read_text_file(app_path);
     REQUIRE(app_text.has_value());
     REQUIRE(app_text->find("list_filter_controls(") != std::string::npos);
-    REQUIRE(app_text->find("set_filter_control_value(") != std::string::npos);
+    // UI and control-socket edits are batched and flushed once per frame by the backend.
+    REQUIRE(app_text->find("queue_filter_control_value(") != std::string::npos);
     REQUIRE((app_text->find("reset_filter_control_value(") != std::string::npos ||
              app_text->find("reset_filter_controls(") != std::string::npos));
     REQUIRE(app_text->find("m_filter_chain_controller.") == std::string::npos);
@@ -237,6 +240,20 @@ TEST_CASE("Async swap and resize safety contract coverage", "[filter_chain][asyn
     REQUIRE(failure_clear_ready_pos < failure_return_pos);
     REQUIRE(failure_return_pos < success_signal_pos);
 
+    // The frame-dependence scan reads preset files; it belongs to the async job, not the swap.
+    const auto swap_end_pos =
+        controller_text->find("void FilterChainController::cleanup_retired_adapters(");
+    const auto swap_body = controller_text->substr(check_swap_pos, swap_end_pos - check_swap_pos);
+    REQUIRE(swap_end_pos != std::string::npos);
+    REQUIRE(swap_body.find("preset_is_frame_dependent(") == std::string::npos);
+    REQUIRE(swap_body.find("frame_dependent = pending_frame_dependent;") != std::string::npos);
+    const auto async_scan_pos =
+        controller_text->find("pending_frame_dependent = preset_is_frame_dependent(");
+    const auto async_ready_pos =
+        controller_text->find("pending_chain_ready.store(true", async_scan_pos);
+    REQUIRE(async_scan_pos != std::string::npos);
+    REQUIRE(async_ready_pos != std::string::npos);
+
     const auto swap_controls_decl_pos =
         controller_text->find("auto controls_result =", check_swap_pos);
     const auto swap_apply_controls_pos =
@@ -781,3 +798,33 @@ TEST_CASE("filter_chain controller uses standalone API boundary",
     static_assert(!std::is_copy_constructible_v<Controller>, "controller must be move-only");
     static_assert(!std::is_copy_assignable_v<Controller>, "controller must be move-only");
 }
+
+TEST_CASE("Overlay DPI font rebuild never idles the device mid-stream", "[ui][async_contract]") {
+    const auto imgui_cpp = std::filesystem::path(GOGGLES_SOURCE_DIR) / "src/ui/imgui_layer.cpp";
+    auto imgui_text = read_text_file(imgui_cpp);
+    REQUIRE(imgui_text.has_value());
+
+    const auto begin_frame_pos = imgui_text->find("void ImGuiLayer::begin_frame()");
+    const auto end_frame_pos = imgui_text->find("void ImGuiLayer::end_frame()");
+    const auto update_pos = imgui_text->find("void ImGuiLayer::update_font_atlas()");
+    const auto swap_pos = imgui_text->find("void ImGuiLayer::swap_font_atlas()");
+    const auto retire_pos = imgui_text->find("void ImGuiLayer::retire_font_texture()");
+    REQUIRE(begin_frame_pos != std::string::npos);
+    REQUIRE(end_frame_pos != std::string::npos);
+    REQUIRE(update_pos != std::string::npos);
+    REQUIRE(swap_pos != std::string::npos);
+    REQUIRE(retire_pos != std::string::npos);
+
+    const auto begin_frame_body =
+        std::string_view(*imgui_text).substr(begin_frame_pos, end_frame_pos - begin_frame_pos);
+    REQUIRE(begin_frame_body.find("update_font_atlas();") != std::string_view::npos);
+    REQUIRE(begin_frame_body.find("waitIdle") == std::string_view::npos);
+    REQUIRE(begin_frame_body.find("CreateFontsTexture") == std::string_view::npos);
+
+    const auto font_path_body =
+        std::string_view(*imgui_text).substr(update_pos, retire_pos - update_pos);
+    REQUIRE(font_path_body.find("util::JobSystem::submit(") != std::string_view::npos);
+    REQUIRE(font_path_body.find("FontTextureUpload::begin(") != std::string_view::npos);
+    REQUIRE(font_path_body.find("retire_font_texture();") != std::string_view::npos);
+    REQUIRE(font_path_body.find("waitIdle") == std::string_view::npos);
+}
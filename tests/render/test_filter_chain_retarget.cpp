@@ -401,6 +401,55 @@ TEST_CASE("Explicit reload failure preserves the previous runtime",
     controller.shutdown([&fixture]() { vkDeviceWaitIdle(fixture.device_info().device); });
 }
 
+TEST_CASE("Queued control updates collapse to one write per control at flush",
+          "[filter_chain][controls][runtime]") {
+    VulkanRuntimeFixture fixture;
+    if (!fixture.available()) {
+        SKIP("Skipping Vulkan-backed control batch test because no Vulkan graphics device is "
+             "available");
+    }
+
+    CacheDirGuard cache_dir_guard(make_cache_dir());
+    auto controller = goggles::render::backend_internal::FilterChainController{};
+    auto build_config = make_adapter_build_config(fixture, cache_dir_guard.dir);
+    REQUIRE(controller.recreate_filter_chain(build_config.device_info, build_config.chain_config)
+                .has_value());
+
+    const auto controls =
+        controller.list_filter_controls(goggles::fc::FilterControlStage::prechain);
+    const auto* filter_type = find_filter_control(controls, "filter_type");
+    REQUIRE(filter_type != nullptr);
+
+    controller.queue_filter_control_value(filter_type->control_id, 1.0F);
+    controller.queue_filter_control_value(filter_type->control_id, 2.0F);
+    REQUIRE(controller.pending_control_updates.size() == 1);
+
+    // Nothing reaches the chain until the frame-boundary flush.
+    const auto before_controls = controller.list_filter_controls();
+    const auto* before_flush = find_filter_control(before_controls, "filter_type");
+    REQUIRE(before_flush != nullptr);
+    REQUIRE(before_flush->current_value == Catch::Approx(filter_type->current_value));
+
+    REQUIRE(controller.flush_filter_control_updates() == 1);
+    REQUIRE(controller.pending_control_updates.empty());
+    REQUIRE(controller.flush_filter_control_updates() == 0);
+
+    const auto after_flush = controller.list_filter_controls();
+    const auto* flushed = find_filter_control(after_flush, "filter_type");
+    REQUIRE(flushed != nullptr);
+    REQUIRE(flushed->current_value == Catch::Approx(2.0F));
+    REQUIRE(controller.authoritative_control_overrides.at(filter_type->control_id) ==
+            Catch::Approx(2.0F));
+
+    SECTION("Reset discards queued values") {
+        controller.queue_filter_control_value(filter_type->control_id, 1.0F);
+        controller.reset_filter_controls();
+        REQUIRE(controller.flush_filter_control_updates() == 0);
+    }
+
+    controller.shutdown([&fixture]() { vkDeviceWaitIdle(fixture.device_info().device); });
+}
+
 TEST_CASE("Reload across different control surfaces skips stale restore warnings",
           "[filter_chain][retarget][runtime]") {
     VulkanRuntimeFixture fixture;
@@ -435,8 +484,8 @@ TEST_CASE("Reload across different control surfaces skips stale restore warnings
     const auto* filter_type_before = find_filter_control(prechain_controls_before, "filter_type");
     REQUIRE(filter_type_before != nullptr);
     REQUIRE(controller.set_filter_control_value(filter_type_before->control_id, 2.0F));
-    controller.authoritative_control_overrides.push_back(
-        {.control_id = std::numeric_limits<goggles::fc::FilterControlId>::max(), .value = 1.0F});
+    controller.authoritative_control_overrides.insert_or_assign(
+        std::numeric_limits<goggles::fc::FilterControlId>::max(), 1.0F);
 
     REQUIRE(controller.reload_shader_preset({}, build_config.device_info, build_config.chain_config)
                 .has_value());
@@ -525,3 +574,38 @@ TEST_CASE("Structural live updates rebuild the active adapter contract",
                 controller_text->find("auto FilterChainController::reload_shader_preset(")) !=
             std::string::npos);
 }
+
+TEST_CASE("Preset frame dependence follows shaders, references and includes",
+          "[filter_chain][frame_dependence]") {
+    using goggles::render::backend_internal::preset_is_frame_dependent;
+
+    CacheDirGuard dir_guard(make_cache_dir());
+    const auto& dir = dir_guard.dir;
+    const auto write = [&dir](const std::string& name, const std::string& text) {
+        std::ofstream(dir / name) << text;
+        return dir / name;
+    };
+    write("static.slang", "#include \"common.inc\"\nvoid main() { FragColor = Source; }\n");
+    write("common.inc", "layout(push_constant) uniform Push { vec4 OutputSize; } params;\n");
+    write("animated.inc", "layout(push_constant) uniform Push { uint FrameCount; } params;\n");
+    write("animated.slang", "#include \"animated.inc\"\nvoid main() {}\n");
+    write("history.slang", "uniform sampler2D OriginalHistory1;\n");
+
+    REQUIRE_FALSE(preset_is_frame_dependent({}));
+    REQUIRE_FALSE(preset_is_frame_dependent(write(
+        "static.slangp", "shaders = 1\nshader0 = \"static.slang\"\nfilter_linear0 = true\n")));
+    REQUIRE(preset_is_frame_dependent(write(
+        "animated.slangp", "shaders = 2\nshader0 = static.slang\nshader1 = animated.slang\n")));
+    REQUIRE(preset_is_frame_dependent(
+        write("history.slangp", "shaders = 1\nshader0 = history.slang\n")));
+    REQUIRE(preset_is_frame_dependent(
+        write("feedback.slangp", "shaders = 1\nshader0 = static.slang\nfeedback_pass = 0\n")));
+    REQUIRE(preset_is_frame_dependent(
+        write("reference.slangp", "#reference \"animated.slangp\"\n")));
+    REQUIRE_FALSE(preset_is_frame_dependent(
+        write("static_ref.slangp", "#reference \"static.slangp\"\n")));
+    // Anything that cannot be read is assumed to animate.
+    REQUIRE(preset_is_frame_dependent(
+        write("missing.slangp", "shaders = 1\nshader0 = missing.slang\n")));
+    REQUIRE(preset_is_frame_dependent(dir / "absent.slangp"));
+}
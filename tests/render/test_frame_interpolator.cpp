@@ -0,0 +1,315 @@
+#include "render/backend/frame_interpolator.hpp"
+#include "render/backend/vulkan_context.hpp"
+
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace {
+
+namespace backend_internal = goggles::render::backend_internal;
+
+constexpr uint32_t SIZE = 128;
+constexpr uint32_t CELL = 8;
+constexpr uint64_t FRAME_INTERVAL_NS = 16'000'000;
+
+// Non-repeating grey cells, so every block has exactly one best match.
+auto pattern(int32_t x, int32_t y) -> uint8_t {
+    auto hash = static_cast<uint32_t>((x + 64) / static_cast<int32_t>(CELL)) * 73856093U ^
+                static_cast<uint32_t>((y + 64) / static_cast<int32_t>(CELL)) * 19349663U;
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995U;
+    hash ^= hash >> 15;
+    return static_cast<uint8_t>(hash & 0xFFU);
+}
+
+auto half_to_float(uint16_t half) -> float {
+    const int exponent = (half >> 10) & 0x1F;
+    const float mantissa = static_cast<float>(half & 0x3FF);
+    float value = exponent == 0 ? std::ldexp(mantissa, -24)
+                                : std::ldexp(mantissa + 1024.0F, exponent - 25);
+    return (half & 0x8000) != 0 ? -value : value;
+}
+
+struct TestImage {
+    vk::Image image;
+    vk::ImageView view;
+    backend_internal::GpuAllocation allocation;
+};
+
+struct TestBuffer {
+    vk::Buffer buffer;
+    backend_internal::GpuAllocation allocation;
+};
+
+auto create_source(backend_internal::VulkanContext& context) -> TestImage {
+    TestImage result;
+    vk::ImageCreateInfo image_info{};
+    image_info.imageType = vk::ImageType::e2D;
+    image_info.format = vk::Format::eR8G8B8A8Unorm;
+    image_info.extent = vk::Extent3D{SIZE, SIZE, 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = vk::SampleCountFlagBits::e1;
+    image_info.tiling = vk::ImageTiling::eOptimal;
+    image_info.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+    auto [image_result, image] = context.device.createImage(image_info);
+    REQUIRE(image_result == vk::Result::eSuccess);
+    result.image = image;
+
+    auto allocation = context.allocator.allocate_image(context.device, result.image, {},
+                                                       vk::MemoryPropertyFlagBits::eDeviceLocal);
+    REQUIRE(allocation.has_value());
+    result.allocation = *allocation;
+
+    vk::ImageViewCreateInfo view_info{};
+    view_info.image = result.image;
+    view_info.viewType = vk::ImageViewType::e2D;
+    view_info.format = image_info.format;
+    view_info.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.layerCount = 1;
+    auto [view_result, view] = context.device.createImageView(view_info);
+    REQUIRE(view_result == vk::Result::eSuccess);
+    result.view = view;
+    return result;
+}
+
+auto create_host_buffer(backend_internal::VulkanContext& context, vk::DeviceSize size,
+                        vk::BufferUsageFlags usage) -> TestBuffer {
+    TestBuffer result;
+    vk::BufferCreateInfo buffer_info{};
+    buffer_info.size = size;
+    buffer_info.usage = usage;
+    auto [buffer_result, buffer] = context.device.createBuffer(buffer_info);
+    REQUIRE(buffer_result == vk::Result::eSuccess);
+    result.buffer = buffer;
+
+    auto allocation = context.allocator.allocate_buffer(
+        context.device, result.buffer,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    REQUIRE(allocation.has_value());
+    REQUIRE(allocation->mapped != nullptr);
+    result.allocation = *allocation;
+    return result;
+}
+
+auto color_barrier(vk::Image image, vk::ImageLayout old_layout, vk::ImageLayout new_layout,
+                   vk::AccessFlags src_access, vk::AccessFlags dst_access)
+    -> vk::ImageMemoryBarrier {
+    vk::ImageMemoryBarrier barrier{};
+    barrier.srcAccessMask = src_access;
+    barrier.dstAccessMask = dst_access;
+    barrier.oldLayout = old_layout;
+    barrier.newLayout = new_layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    return barrier;
+}
+
+} // namespace
+
+TEST_CASE("Frame interpolation synthesizes the midpoint of a translated frame",
+          "[vulkan-backend-interpolation]") {
+    auto context_result = backend_internal::VulkanContext::create_headless(false, "");
+    if (!context_result) {
+        SKIP("Skipping frame interpolation test because no Vulkan device is available: " +
+             context_result.error().message);
+    }
+    auto context = std::move(context_result.value());
+    auto& device = context.device;
+
+    backend_internal::FrameInterpolationPipelines pipelines;
+    const auto shader_dir = std::filesystem::path(GOGGLES_SOURCE_DIR) / "shaders/internal";
+    auto pipelines_result = pipelines.create(context, shader_dir);
+    INFO((pipelines_result ? std::string{} : pipelines_result.error().message));
+    REQUIRE(pipelines_result.has_value());
+    REQUIRE(pipelines.ready());
+
+    // The second frame moves the pattern right by one cell.
+    constexpr uint32_t SHIFT = CELL;
+    constexpr vk::DeviceSize FRAME_BYTES = vk::DeviceSize{SIZE} * SIZE * 4;
+    std::array<TestImage, 2> sources = {create_source(context), create_source(context)};
+    auto upload = create_host_buffer(context, 2 * FRAME_BYTES,
+                                     vk::BufferUsageFlagBits::eTransferSrc);
+    auto readback =
+        create_host_buffer(context, vk::DeviceSize{SIZE} * SIZE * 8,
+                           vk::BufferUsageFlagBits::eTransferDst);
+    auto* texels = static_cast<uint8_t*>(upload.allocation.mapped);
+    for (uint32_t frame = 0; frame < 2; ++frame) {
+        const auto offset = static_cast<int32_t>(frame * SHIFT);
+        for (uint32_t y = 0; y < SIZE; ++y) {
+            for (uint32_t x = 0; x < SIZE; ++x) {
+                const uint8_t value =
+                    pattern(static_cast<int32_t>(x) - offset, static_cast<int32_t>(y));
+                auto* texel = texels + (frame * FRAME_BYTES) + (((y * SIZE) + x) * 4);
+                texel[0] = texel[1] = texel[2] = value;
+                texel[3] = 0xFF;
+            }
+        }
+    }
+
+    backend_internal::FrameInterpolator interpolator;
+    REQUIRE(interpolator.ensure(context, pipelines, {SIZE, SIZE}, nullptr).has_value());
+    REQUIRE(interpolator.allocated());
+
+    vk::CommandPoolCreateInfo pool_info{};
+    pool_info.queueFamilyIndex = context.graphics_queue_family;
+    pool_info.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+    auto [pool_result, command_pool] = device.createCommandPool(pool_info);
+    REQUIRE(pool_result == vk::Result::eSuccess);
+    vk::CommandBufferAllocateInfo cmd_info{};
+    cmd_info.commandPool = command_pool;
+    cmd_info.level = vk::CommandBufferLevel::ePrimary;
+    cmd_info.commandBufferCount = 1;
+    auto [cmd_result, cmds] = device.allocateCommandBuffers(cmd_info);
+    REQUIRE(cmd_result == vk::Result::eSuccess);
+    auto cmd = cmds.front();
+
+    REQUIRE(cmd.begin(vk::CommandBufferBeginInfo{}) == vk::Result::eSuccess);
+    std::array<vk::ImageMemoryBarrier, 2> barriers{};
+    for (uint32_t i = 0; i < 2; ++i) {
+        barriers[i] = color_barrier(sources[i].image, vk::ImageLayout::eUndefined,
+                                    vk::ImageLayout::eTransferDstOptimal,
+                                    vk::AccessFlagBits::eNone, vk::AccessFlagBits::eTransferWrite);
+    }
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                        vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, barriers);
+    for (uint32_t i = 0; i < 2; ++i) {
+        vk::BufferImageCopy region{};
+        region.bufferOffset = i * FRAME_BYTES;
+        region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = vk::Extent3D{SIZE, SIZE, 1};
+        cmd.copyBufferToImage(upload.buffer, sources[i].image,
+                              vk::ImageLayout::eTransferDstOptimal, region);
+        barriers[i] = color_barrier(sources[i].image, vk::ImageLayout::eTransferDstOptimal,
+                                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                                    vk::AccessFlagBits::eTransferWrite,
+                                    vk::AccessFlagBits::eShaderRead);
+    }
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                        vk::PipelineStageFlagBits::eComputeShader, {}, {}, {}, barriers);
+
+    constexpr uint64_t FIRST_COMMIT_NS = 1'000'000'000;
+    constexpr uint64_t SECOND_COMMIT_NS = FIRST_COMMIT_NS + FRAME_INTERVAL_NS;
+    const auto frame_source = [&sources](uint32_t i) {
+        return backend_internal::ExternalFrameImporter::ImportedSource{
+            .image = sources[i].image,
+            .view = sources[i].view,
+            .extent = {SIZE, SIZE},
+            .format = vk::Format::eR8G8B8A8Unorm,
+        };
+    };
+
+    // One frame is not enough to interpolate; the source passes through.
+    REQUIRE_FALSE(interpolator
+                      .record(context, pipelines, cmd,
+                              {.image = frame_source(0),
+                               .frame_number = 1,
+                               .commit_time_ns = FIRST_COMMIT_NS},
+                              0, SECOND_COMMIT_NS)
+                      .has_value());
+    REQUIRE(interpolator.settled());
+
+    // Halfway through the interval after the second frame arrived.
+    auto interpolated = interpolator.record(
+        context, pipelines, cmd,
+        {.image = frame_source(1), .frame_number = 2, .commit_time_ns = SECOND_COMMIT_NS}, 1,
+        SECOND_COMMIT_NS + (FRAME_INTERVAL_NS / 2));
+    REQUIRE(interpolated.has_value());
+    REQUIRE_FALSE(interpolator.settled());
+    REQUIRE(interpolated->extent == vk::Extent2D{SIZE, SIZE});
+
+    auto to_copy = color_barrier(interpolated->image, vk::ImageLayout::eShaderReadOnlyOptimal,
+                                 vk::ImageLayout::eTransferSrcOptimal,
+                                 vk::AccessFlagBits::eShaderWrite,
+                                 vk::AccessFlagBits::eTransferRead);
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                        vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, to_copy);
+    vk::BufferImageCopy readback_region{};
+    readback_region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    readback_region.imageSubresource.layerCount = 1;
+    readback_region.imageExtent = vk::Extent3D{SIZE, SIZE, 1};
+    cmd.copyImageToBuffer(interpolated->image, vk::ImageLayout::eTransferSrcOptimal,
+                          readback.buffer, readback_region);
+    REQUIRE(cmd.end() == vk::Result::eSuccess);
+
+    vk::SubmitInfo submit{};
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers = &cmd;
+    REQUIRE(context.graphics_queue.submit(submit) == vk::Result::eSuccess);
+    REQUIRE(device.waitIdle() == vk::Result::eSuccess);
+
+    // Away from the borders, where blocks match partly outside the frame, the result is the
+    // pattern moved by half the shift. A cross-fade would blend two different cells instead.
+    std::vector<uint16_t> halves(static_cast<size_t>(SIZE) * SIZE * 4);
+    std::memcpy(halves.data(), readback.allocation.mapped, halves.size() * sizeof(uint16_t));
+    float max_error = 0.0F;
+    for (uint32_t y = 32; y < SIZE - 32; ++y) {
+        for (uint32_t x = 32; x < SIZE - 32; ++x) {
+            const float expected =
+                static_cast<float>(pattern(static_cast<int32_t>(x - (SHIFT / 2)),
+                                           static_cast<int32_t>(y))) /
+                255.0F;
+            const float actual = half_to_float(halves[((y * SIZE) + x) * 4]);
+            max_error = std::max(max_error, std::abs(actual - expected));
+        }
+    }
+    REQUIRE(max_error < 0.01F);
+
+    // Once a full interval has passed the newest frame is shown as is.
+    REQUIRE(cmd.reset() == vk::Result::eSuccess);
+    REQUIRE(cmd.begin(vk::CommandBufferBeginInfo{}) == vk::Result::eSuccess);
+    REQUIRE_FALSE(interpolator
+                      .record(context, pipelines, cmd,
+                              {.image = frame_source(1),
+                               .frame_number = 2,
+                               .commit_time_ns = SECOND_COMMIT_NS},
+                              0, SECOND_COMMIT_NS + FRAME_INTERVAL_NS)
+                      .has_value());
+    REQUIRE(interpolator.settled());
+
+    // A surface switch resets the history. The new surface's first frame arrives well within
+    // the frame interval, yet it must not be blended with the old surface's held frame.
+    constexpr uint64_t SWITCH_COMMIT_NS = SECOND_COMMIT_NS + FRAME_INTERVAL_NS;
+    interpolator.reset();
+    REQUIRE(interpolator.settled());
+    REQUIRE_FALSE(interpolator
+                      .record(context, pipelines, cmd,
+                              {.image = frame_source(0),
+                               .frame_number = 1,
+                               .commit_time_ns = SWITCH_COMMIT_NS},
+                              1, SWITCH_COMMIT_NS + (FRAME_INTERVAL_NS / 2))
+                      .has_value());
+    REQUIRE(interpolator.held_frames == 1U);
+    REQUIRE(interpolator.settled());
+    REQUIRE(cmd.end() == vk::Result::eSuccess);
+
+    interpolator.destroy(context);
+    REQUIRE_FALSE(interpolator.allocated());
+    pipelines.destroy(context);
+    device.destroyCommandPool(command_pool);
+    for (auto* buffer : {&upload, &readback}) {
+        device.destroyBuffer(buffer->buffer);
+        context.allocator.free(device, buffer->allocation);
+    }
+    for (auto& source : sources) {
+        device.destroyImageView(source.view);
+        device.destroyImage(source.image);
+        context.allocator.free(device, source.allocation);
+    }
+    context.destroy();
+}
@@ -1,6 +1,9 @@
 #include "render/backend/external_frame_importer.hpp"
 #include "render/backend/filter_chain_controller.hpp"
+#include "render/backend/gpu_allocator.hpp"
+#include "render/backend/gpu_timer.hpp"
 #include "render/backend/render_output.hpp"
+#include "render/backend/surface_compositor.hpp"
 #include "render/backend/vulkan_context.hpp"
 
 #include <catch2/catch_test_macros.hpp>
@@ -12,6 +15,7 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace {
 
@@ -46,6 +50,8 @@ TEST_CASE("Vulkan backend seam declarations stay compile-safe", "[vulkan-backend
     const auto boundary_context = context.boundary_context();
 
     REQUIRE(context.graphics_queue_family == UINT32_MAX);
+    REQUIRE(context.transfer_queue_family == UINT32_MAX);
+    REQUIRE(context.compute_queue_family == UINT32_MAX);
     REQUIRE(output.command_pool == vk::CommandPool{});
     REQUIRE(output.current_frame == 0u);
     REQUIRE(output.target_fps == 0u);
@@ -102,6 +108,108 @@ TEST_CASE("Vulkan backend dependency edge audits stay explicit", "[vulkan-backen
     REQUIRE(find_text(*backend_header_text, "MAX_FRAMES_IN_FLIGHT =") == std::string::npos);
 }
 
+TEST_CASE("GPU timer stays inert until timestamp pools exist", "[vulkan-backend-gpu-timing]") {
+    namespace backend_internal = goggles::render::backend_internal;
+
+    static_assert(backend_internal::GpuTimer::QUERY_COUNT ==
+                  goggles::util::GpuTimingSnapshot::K_ZONE_COUNT + 1u);
+    static_assert(backend_internal::GpuTimer::ZONE_COUNT ==
+                  static_cast<uint32_t>(goggles::util::GpuTimingZone::ui_overlay) + 1u);
+
+    backend_internal::VulkanContext context{};
+    backend_internal::GpuTimer timer{};
+    REQUIRE_FALSE(timer.enabled);
+    REQUIRE_FALSE(timer.snapshot().available);
+
+    // Without pools begin_frame records nothing, so submission leaves nothing to collect.
+    timer.begin_frame(vk::CommandBuffer{}, 0);
+    timer.end_zone(vk::CommandBuffer{}, 0, goggles::util::GpuTimingZone::import_barrier);
+    timer.mark_submitted(0);
+    REQUIRE_FALSE(timer.frames[0].pending);
+
+    timer.collect(context, 0);
+    REQUIRE(timer.snapshot().frame_history_count == 0u);
+
+    timer.destroy(context);
+    REQUIRE(timer.frames[0].pool == vk::QueryPool{});
+}
+
+TEST_CASE("Present policy maps onto available present modes", "[vulkan-backend-present]") {
+    namespace backend_internal = goggles::render::backend_internal;
+    using goggles::PresentPolicy;
+    using Mode = vk::PresentModeKHR;
+
+    const std::vector<Mode> all_modes = {Mode::eFifo, Mode::eFifoRelaxed, Mode::eMailbox,
+                                         Mode::eImmediate};
+    const std::vector<Mode> mailbox_only = {Mode::eFifo, Mode::eMailbox};
+    const std::vector<Mode> fifo_only = {Mode::eFifo};
+
+    REQUIRE(backend_internal::select_present_mode(PresentPolicy::low_latency, all_modes) ==
+            Mode::eImmediate);
+    REQUIRE(backend_internal::select_present_mode(PresentPolicy::low_latency, mailbox_only) ==
+            Mode::eMailbox);
+    REQUIRE(backend_internal::select_present_mode(PresentPolicy::smooth, all_modes) ==
+            Mode::eFifo);
+    REQUIRE(backend_internal::select_present_mode(PresentPolicy::adaptive, all_modes) ==
+            Mode::eFifoRelaxed);
+    REQUIRE(backend_internal::select_present_mode(PresentPolicy::vrr, all_modes) == Mode::eFifo);
+    for (auto policy : {PresentPolicy::low_latency, PresentPolicy::smooth, PresentPolicy::adaptive,
+                        PresentPolicy::vrr}) {
+        REQUIRE(backend_internal::select_present_mode(policy, fifo_only) == Mode::eFifo);
+        REQUIRE(backend_internal::select_present_mode(policy, {}) == Mode::eFifo);
+    }
+
+    backend_internal::RenderOutput output{};
+    REQUIRE(output.present_policy == PresentPolicy::smooth);
+    output.set_present_policy(PresentPolicy::low_latency);
+    REQUIRE(output.present_policy == PresentPolicy::low_latency);
+    // Without a swapchain the policy only takes effect at the next creation.
+    REQUIRE_FALSE(output.needs_resize);
+    REQUIRE(output.switchable_present_modes.empty());
+}
+
+TEST_CASE("Dedicated queue families are found or fall back to graphics",
+          "[vulkan-backend-queues]") {
+    namespace backend_internal = goggles::render::backend_internal;
+    using Flag = vk::QueueFlagBits;
+
+    auto family = [](vk::QueueFlags flags) {
+        vk::QueueFamilyProperties props{};
+        props.queueFlags = flags;
+        props.queueCount = 1;
+        return props;
+    };
+    const auto transfer_only = Flag::eTransfer;
+    const auto not_graphics_or_compute = Flag::eGraphics | Flag::eCompute;
+
+    // Discrete-style layout: universal, async compute, and a DMA-only family.
+    const std::vector<vk::QueueFamilyProperties> discrete = {
+        family(Flag::eGraphics | Flag::eCompute | Flag::eTransfer),
+        family(Flag::eCompute | Flag::eTransfer),
+        family(Flag::eTransfer | Flag::eSparseBinding),
+    };
+    REQUIRE(backend_internal::find_dedicated_queue_family(discrete, transfer_only,
+                                                          not_graphics_or_compute) == 2U);
+    REQUIRE(backend_internal::find_dedicated_queue_family(discrete, Flag::eCompute,
+                                                          Flag::eGraphics) == 1U);
+
+    // Single-family devices such as lavapipe keep everything on the graphics queue.
+    const std::vector<vk::QueueFamilyProperties> single = {
+        family(Flag::eGraphics | Flag::eCompute | Flag::eTransfer),
+    };
+    REQUIRE_FALSE(backend_internal::find_dedicated_queue_family(single, transfer_only,
+                                                                not_graphics_or_compute));
+    REQUIRE_FALSE(
+        backend_internal::find_dedicated_queue_family(single, Flag::eCompute, Flag::eGraphics));
+
+    backend_internal::VulkanContext context{};
+    context.graphics_queue_family = 0;
+    context.transfer_queue_family = 0;
+    REQUIRE_FALSE(context.has_dedicated_transfer_queue());
+    context.transfer_queue_family = 2;
+    REQUIRE(context.has_dedicated_transfer_queue());
+}
+
 TEST_CASE("Vulkan backend teardown audit hooks stay aligned with shutdown order",
           "[vulkan-backend-lifetime]") {
     const auto backend_cpp =
@@ -128,8 +236,10 @@ TEST_CASE("Vulkan backend teardown audit hooks stay aligned with shutdown order"
     const auto importer_cleanup_pos =
         find_text(*backend_text, "m_external_frame_importer.destroy(m_vulkan_context);",
                   controller_shutdown_pos);
+    const auto gpu_timer_cleanup_pos = find_text(
+        *backend_text, "m_gpu_timer.destroy(m_vulkan_context);", importer_cleanup_pos);
     const auto output_cleanup_pos = find_text(
-        *backend_text, "m_render_output.destroy(m_vulkan_context);", importer_cleanup_pos);
+        *backend_text, "m_render_output.destroy(m_vulkan_context);", gpu_timer_cleanup_pos);
     const auto context_destroy_pos =
         find_text(*backend_text, "m_vulkan_context.destroy();", output_cleanup_pos);
 
@@ -189,6 +299,7 @@ TEST_CASE("Vulkan backend teardown audit hooks stay aligned with shutdown order"
     REQUIRE(retired_reset_pos != std::string::npos);
     REQUIRE(retired_count_reset_pos != std::string::npos);
     REQUIRE(importer_cleanup_pos != std::string::npos);
+    REQUIRE(gpu_timer_cleanup_pos != std::string::npos);
     REQUIRE(output_cleanup_pos != std::string::npos);
     REQUIRE(context_destroy_pos != std::string::npos);
     REQUIRE(output_shutdown_pos != std::string::npos);
@@ -210,7 +321,8 @@ TEST_CASE("Vulkan backend teardown audit hooks stay aligned with shutdown order"
     REQUIRE(retired_helper_pos < retired_adapter_shutdown_pos);
     REQUIRE(retired_adapter_shutdown_pos < retired_reset_pos);
     REQUIRE(retired_reset_pos < retired_count_reset_pos);
-    REQUIRE(importer_cleanup_pos < output_cleanup_pos);
+    REQUIRE(importer_cleanup_pos < gpu_timer_cleanup_pos);
+    REQUIRE(gpu_timer_cleanup_pos < output_cleanup_pos);
     REQUIRE(output_cleanup_pos < context_destroy_pos);
     REQUIRE(offscreen_destroy_pos < frame_destroy_pos);
     REQUIRE(frame_destroy_pos < swapchain_destroy_pos);
@@ -259,3 +371,89 @@ TEST_CASE("Vulkan backend teardown audit hooks stay aligned with shutdown order"
     REQUIRE(policy_controller_pos < policy_wait_lambda_pos);
     REQUIRE(prechain_controller_pos < prechain_wait_lambda_pos);
 }
+
+TEST_CASE("Allocator free ranges align, split, and coalesce", "[vulkan-backend-allocator]") {
+    goggles::render::backend_internal::FreeRangeList list;
+    list.reset(1024);
+    REQUIRE(list.is_empty(1024));
+
+    REQUIRE(list.allocate(100, 1) == 0U);
+    // Padding before the aligned offset stays free and is reused by smaller requests.
+    REQUIRE(list.allocate(200, 256) == 256U);
+    REQUIRE(list.free_bytes() == 1024U - 300U);
+    REQUIRE(list.allocate(100, 4) == 100U);
+    REQUIRE_FALSE(list.allocate(1024, 1));
+
+    list.release(256, 200);
+    list.release(0, 100);
+    list.release(100, 100);
+    REQUIRE(list.is_empty(1024));
+    REQUIRE(list.ranges.size() == 1U);
+}
+
+TEST_CASE("Allocator memory type selection honors required and preferred flags",
+          "[vulkan-backend-allocator]") {
+    namespace backend_internal = goggles::render::backend_internal;
+    using Flag = vk::MemoryPropertyFlagBits;
+
+    vk::PhysicalDeviceMemoryProperties props{};
+    props.memoryTypeCount = 3;
+    props.memoryTypes[0].propertyFlags = Flag::eDeviceLocal;
+    props.memoryTypes[1].propertyFlags = Flag::eHostVisible | Flag::eHostCoherent;
+    props.memoryTypes[2].propertyFlags =
+        Flag::eHostVisible | Flag::eHostCoherent | Flag::eHostCached;
+
+    REQUIRE(backend_internal::select_memory_type(props, 0b111, {}, Flag::eDeviceLocal) == 0U);
+    REQUIRE(backend_internal::select_memory_type(props, 0b111, Flag::eHostVisible,
+                                                 Flag::eHostCoherent | Flag::eHostCached) == 2U);
+    // `type_bits` wins over preference; a missing required flag is a failure, not a fallback.
+    REQUIRE(backend_internal::select_memory_type(props, 0b011, Flag::eHostVisible,
+                                                 Flag::eHostCached) == 1U);
+    REQUIRE_FALSE(backend_internal::select_memory_type(props, 0b001, Flag::eHostVisible, {}));
+}
+
+TEST_CASE("Backend-owned render output memory goes through the allocator",
+          "[vulkan-backend-allocator]") {
+    const auto source_root = std::filesystem::path(GOGGLES_SOURCE_DIR);
+    const auto render_output = read_text_file(source_root / "src/render/backend/render_output.cpp");
+    REQUIRE(render_output.has_value());
+    REQUIRE(find_text(*render_output, "allocator.allocate_image(") != std::string::npos);
+    REQUIRE(find_text(*render_output, "allocator.allocate_buffer(") != std::string::npos);
+    REQUIRE(find_text(*render_output, "allocateMemory(") == std::string::npos);
+}
+
+TEST_CASE("Surface tiles split the longer axis and absorb the remainder",
+          "[vulkan-backend-surfaces]") {
+    using goggles::render::backend_internal::compute_surface_tiles;
+
+    const auto wide = compute_surface_tiles(vk::Extent2D{1000, 480}, 3);
+    REQUIRE(wide.size() == 3U);
+    REQUIRE(wide[0].offset.x == 0);
+    REQUIRE(wide[1].offset.x == 333);
+    REQUIRE(wide[2].offset.x == 666);
+    REQUIRE(wide[2].extent.width == 334U);
+    REQUIRE(wide[1].extent.height == 480U);
+
+    const auto tall = compute_surface_tiles(vk::Extent2D{256, 384}, 2);
+    REQUIRE(tall.size() == 2U);
+    REQUIRE(tall[1].offset.x == 0);
+    REQUIRE(tall[1].offset.y == 192);
+    REQUIRE(tall[1].extent == vk::Extent2D{256, 192});
+
+    REQUIRE(compute_surface_tiles(vk::Extent2D{1000, 480}, 0).empty());
+    REQUIRE(compute_surface_tiles(vk::Extent2D{2, 1}, 8).size() == 2U);
+}
+
+TEST_CASE("Multi-surface frames share one submission", "[vulkan-backend-surfaces]") {
+    const auto source_root = std::filesystem::path(GOGGLES_SOURCE_DIR);
+    const auto backend = read_text_file(source_root / "src/render/backend/vulkan_backend.cpp");
+    REQUIRE(backend.has_value());
+
+    const auto render_surfaces_pos = find_text(*backend, "VulkanBackend::render_surfaces(");
+    const auto companion_pos = find_text(*backend, "record_companion(", render_surfaces_pos);
+    const auto submit_pos = find_text(*backend, "submit_and_present(", render_surfaces_pos);
+    REQUIRE(render_surfaces_pos != std::string::npos);
+    REQUIRE(companion_pos != std::string::npos);
+    REQUIRE(submit_pos != std::string::npos);
+    REQUIRE(find_text(*backend, "submit_and_present(", submit_pos + 1) == std::string::npos);
+}
@@ -15,14 +15,39 @@ TEST_CASE("default_config returns expected values", "[config]") {
 
     SECTION("Render defaults") {
         REQUIRE(config.render.vsync == true);
+        REQUIRE(config.render.present_policy == PresentPolicy::smooth);
         REQUIRE(config.render.target_fps == 60);
+        REQUIRE_FALSE(config.render.allow_tearing);
+        REQUIRE_FALSE(config.render.frame_interpolation);
+        REQUIRE(config.render.vrr_min_hz == 48U);
+        REQUIRE(config.render.vrr_max_hz == 165U);
         REQUIRE(config.render.gpu_selector.empty());
+        REQUIRE_FALSE(config.render.capture_all_surfaces);
+        REQUIRE(config.render.cursor_plane == CursorPlane::overlay);
+        REQUIRE(config.render.present_buffers == 3U);
     }
 
     SECTION("Logging defaults") {
         REQUIRE(config.logging.level == "info");
         REQUIRE(config.logging.file.empty());
     }
+
+    SECTION("Metrics defaults") {
+        REQUIRE_FALSE(config.metrics.enabled);
+        REQUIRE(config.metrics.socket == "metrics.sock");
+    }
+
+    SECTION("Control defaults") {
+        REQUIRE_FALSE(config.control.enabled);
+        REQUIRE(config.control.socket == "control.sock");
+    }
+
+    SECTION("Frame export defaults") {
+        REQUIRE_FALSE(config.frame_export.enabled);
+        REQUIRE(config.frame_export.socket == "frames.sock");
+        REQUIRE(config.frame_export.ring_size == 3U);
+        REQUIRE_FALSE(config.frame_export.force_memfd);
+    }
 }
 
 TEST_CASE("load_config handles missing file", "[config]") {
@@ -47,8 +72,12 @@ TEST_CASE("load_config parses valid configuration", "[config]") {
 
     SECTION("Render section") {
         REQUIRE(config.render.vsync == false);
+        REQUIRE(config.render.present_policy == PresentPolicy::low_latency); // from vsync
         REQUIRE(config.render.target_fps == 120);
+        REQUIRE(config.render.allow_tearing);
+        REQUIRE(config.render.frame_interpolation);
         REQUIRE(config.render.gpu_selector == "AMD");
+        REQUIRE(config.render.capture_all_surfaces);
     }
 
     SECTION("Logging section") {
@@ -151,6 +180,186 @@ TEST_CASE("load_config accepts all valid log levels", "[config]") {
     }
 }
 
+TEST_CASE("load_config parses present_policy", "[config]") {
+    const std::string temp_config = "util/test_data/present_policy.toml";
+
+    SECTION("Explicit policy overrides vsync") {
+        std::ofstream file(temp_config);
+        file << "[render]\nvsync = true\npresent_policy = \"adaptive\"\n";
+        file.close();
+
+        auto result = load_config(temp_config);
+        REQUIRE(result.has_value());
+        REQUIRE(result->render.present_policy == PresentPolicy::adaptive);
+    }
+
+    SECTION("VRR policy with its refresh range") {
+        std::ofstream file(temp_config);
+        file << "[render]\npresent_policy = \"vrr\"\nvrr_min_hz = 40\nvrr_max_hz = 144\n";
+        file.close();
+
+        auto result = load_config(temp_config);
+        REQUIRE(result.has_value());
+        REQUIRE(result->render.present_policy == PresentPolicy::vrr);
+        REQUIRE(result->render.vrr_min_hz == 40U);
+        REQUIRE(result->render.vrr_max_hz == 144U);
+    }
+
+    SECTION("Inverted VRR range is rejected") {
+        std::ofstream file(temp_config);
+        file << "[render]\nvrr_min_hz = 165\nvrr_max_hz = 48\n";
+        file.close();
+
+        auto result = load_config(temp_config);
+        REQUIRE(!result.has_value());
+        REQUIRE(result.error().code == ErrorCode::invalid_config);
+        REQUIRE(result.error().message.find("Invalid VRR range") != std::string::npos);
+    }
+
+    SECTION("Unknown policy is rejected") {
+        std::ofstream file(temp_config);
+        file << "[render]\npresent_policy = \"fast\"\n";
+        file.close();
+
+        auto result = load_config(temp_config);
+        REQUIRE(!result.has_value());
+        REQUIRE(result.error().code == ErrorCode::invalid_config);
+        REQUIRE(result.error().message.find("Invalid present_policy") != std::string::npos);
+        REQUIRE(result.error().message.find("low_latency, smooth, adaptive") !=
+                std::string::npos);
+    }
+
+    std::filesystem::remove(temp_config);
+}
+
+TEST_CASE("load_config parses cursor_plane", "[config]") {
+    const std::string temp_config = "util/test_data/cursor_plane.toml";
+
+    SECTION("Composited plane") {
+        std::ofstream file(temp_config);
+        file << "[render]\ncursor_plane = \"composited\"\n";
+        file.close();
+
+        auto result = load_config(temp_config);
+        REQUIRE(result.has_value());
+        REQUIRE(result->render.cursor_plane == CursorPlane::composited);
+    }
+
+    SECTION("Unknown plane is rejected") {
+        std::ofstream file(temp_config);
+        file << "[render]\ncursor_plane = \"hardware\"\n";
+        file.close();
+
+        auto result = load_config(temp_config);
+        REQUIRE(!result.has_value());
+        REQUIRE(result.error().code == ErrorCode::invalid_config);
+        REQUIRE(result.error().message.find("Invalid cursor_plane") != std::string::npos);
+    }
+
+    std::filesystem::remove(temp_config);
+}
+
+TEST_CASE("load_config validates present_buffers", "[config]") {
+    const std::string temp_config = "util/test_data/present_buffers.toml";
+
+    SECTION("Valid count") {
+        std::ofstream file(temp_config);
+        file << "[render]\npresent_buffers = 5\n";
+        file.close();
+
+        auto result = load_config(temp_config);
+        REQUIRE(result.has_value());
+        REQUIRE(result->render.present_buffers == 5U);
+    }
+
+    SECTION("Single buffer is rejected") {
+        std::ofstream file(temp_config);
+        file << "[render]\npresent_buffers = 1\n";
+        file.close();
+
+        auto result = load_config(temp_config);
+        REQUIRE(!result.has_value());
+        REQUIRE(result.error().code == ErrorCode::invalid_config);
+        REQUIRE(result.error().message.find("Invalid present_buffers") != std::string::npos);
+    }
+
+    std::filesystem::remove(temp_config);
+}
+
+TEST_CASE("load_config parses metrics section", "[config]") {
+    const std::string temp_config = "util/test_data/metrics_config.toml";
+    std::ofstream file(temp_config);
+    file << "[metrics]\nenabled = true\nsocket = \"/run/goggles/metrics.sock\"\n";
+    file.close();
+
+    auto result = load_config(temp_config);
+
+    REQUIRE(result.has_value());
+    REQUIRE(result->metrics.enabled);
+    REQUIRE(result->metrics.socket == "/run/goggles/metrics.sock");
+
+    std::filesystem::remove(temp_config);
+}
+
+TEST_CASE("load_config rejects empty metrics socket", "[config]") {
+    const std::string temp_config = "util/test_data/empty_metrics_socket.toml";
+    std::ofstream file(temp_config);
+    file << "[metrics]\nsocket = \"\"\n";
+    file.close();
+
+    auto result = load_config(temp_config);
+
+    REQUIRE(!result.has_value());
+    REQUIRE(result.error().code == ErrorCode::invalid_config);
+
+    std::filesystem::remove(temp_config);
+}
+
+TEST_CASE("load_config parses control section", "[config]") {
+    const std::string temp_config = "util/test_data/control_config.toml";
+    std::ofstream file(temp_config);
+    file << "[control]\nenabled = true\nsocket = \"sweep.sock\"\n";
+    file.close();
+
+    auto result = load_config(temp_config);
+
+    REQUIRE(result.has_value());
+    REQUIRE(result->control.enabled);
+    REQUIRE(result->control.socket == "sweep.sock");
+
+    std::filesystem::remove(temp_config);
+}
+
+TEST_CASE("load_config parses frame_export section", "[config]") {
+    const std::string temp_config = "util/test_data/frame_export_config.toml";
+    std::ofstream file(temp_config);
+    file << "[frame_export]\nenabled = true\nring_size = 4\nstorage = \"memfd\"\n";
+    file.close();
+
+    auto result = load_config(temp_config);
+
+    REQUIRE(result.has_value());
+    REQUIRE(result->frame_export.enabled);
+    REQUIRE(result->frame_export.ring_size == 4U);
+    REQUIRE(result->frame_export.force_memfd);
+
+    std::filesystem::remove(temp_config);
+}
+
+TEST_CASE("load_config rejects invalid frame_export ring_size", "[config]") {
+    const std::string temp_config = "util/test_data/frame_export_ring_size.toml";
+    std::ofstream file(temp_config);
+    file << "[frame_export]\nring_size = 1\n";
+    file.close();
+
+    auto result = load_config(temp_config);
+
+    REQUIRE(!result.has_value());
+    REQUIRE(result.error().code == ErrorCode::invalid_config);
+
+    std::filesystem::remove(temp_config);
+}
+
 TEST_CASE("load_config handles TOML parse errors", "[config]") {
     auto result = load_config("util/test_data/malformed_config.toml");
 
@@ -0,0 +1,201 @@
+#include "../../src/util/frame_export.hpp"
+
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <poll.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace goggles::util;
+
+namespace {
+
+constexpr int K_RECEIVE_TIMEOUT_MS = 2000;
+
+struct ReceivedMessage {
+    std::vector<char> data;
+    std::vector<UniqueFd> fds;
+};
+
+auto connect_consumer(const std::filesystem::path& socket_path) -> UniqueFd {
+    UniqueFd fd{::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)};
+    REQUIRE(fd);
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    REQUIRE(::connect(fd.get(), reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+auto receive_message(int fd) -> std::optional<ReceivedMessage> {
+    pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+    if (::poll(&pfd, 1, K_RECEIVE_TIMEOUT_MS) <= 0) {
+        return std::nullopt;
+    }
+
+    ReceivedMessage message;
+    message.data.resize(256);
+    iovec iov{.iov_base = message.data.data(), .iov_len = message.data.size()};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int) * FrameExportServer::MAX_RING_SIZE)>
+        control{};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    const auto received = ::recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+    if (received <= 0) {
+        return std::nullopt;
+    }
+    message.data.resize(static_cast<size_t>(received));
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        const size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; ++i) {
+            int received_fd = -1;
+            std::memcpy(&received_fd, CMSG_DATA(cmsg) + (i * sizeof(int)), sizeof(int));
+            message.fds.emplace_back(received_fd);
+        }
+    }
+    return message;
+}
+
+template <typename T>
+auto decode(const ReceivedMessage& message) -> T {
+    REQUIRE(message.data.size() == sizeof(T));
+    T value{};
+    std::memcpy(&value, message.data.data(), sizeof(T));
+    return value;
+}
+
+} // namespace
+
+TEST_CASE("FrameExportServer passes ring buffers and frame sync fds", "[frame_export]") {
+    const auto socket_path = std::filesystem::temp_directory_path() /
+                             ("goggles_frame_export_test_" + std::to_string(::getpid()) + ".sock");
+    auto server_result = FrameExportServer::create(socket_path);
+    REQUIRE(server_result.has_value());
+    auto& server = *server_result.value();
+
+    constexpr uint32_t BUFFER_SIZE = 32 * 32 * 4;
+    std::vector<UniqueFd> buffers;
+    for (int i = 0; i < 2; ++i) {
+        UniqueFd memfd{::memfd_create("goggles-frame-export-test", MFD_CLOEXEC)};
+        REQUIRE(memfd);
+        REQUIRE(::ftruncate(memfd.get(), BUFFER_SIZE) == 0);
+        buffers.push_back(std::move(memfd));
+    }
+
+    FrameExportRingInfo ring_info{};
+    ring_info.width = 32;
+    ring_info.height = 32;
+    ring_info.drm_format = DRM_FORMAT_ARGB8888;
+    ring_info.storage = static_cast<uint32_t>(FrameExportStorage::memfd);
+    ring_info.stride = 32 * 4;
+    ring_info.size = BUFFER_SIZE;
+    const uint32_t generation = server.publish_ring(ring_info, std::move(buffers));
+
+    auto consumer = connect_consumer(socket_path);
+
+    SECTION("Consumers receive the ring on connect") {
+        auto message = receive_message(consumer.get());
+        REQUIRE(message.has_value());
+        const auto ring = decode<FrameExportRingInfo>(*message);
+        REQUIRE(ring.magic == FRAME_EXPORT_MAGIC);
+        REQUIRE(ring.type == static_cast<uint16_t>(FrameExportMessageType::ring));
+        REQUIRE(ring.generation == generation);
+        REQUIRE(ring.buffer_count == 2U);
+        REQUIRE(ring.width == 32U);
+        REQUIRE(message->fds.size() == 2U);
+
+        struct stat buffer_stat{};
+        REQUIRE(::fstat(message->fds[1].get(), &buffer_stat) == 0);
+        REQUIRE(buffer_stat.st_size == BUFFER_SIZE);
+    }
+
+    SECTION("Frames carry metadata and their sync fd") {
+        REQUIRE(receive_message(consumer.get()).has_value());
+
+        FrameExportFrameInfo frame{};
+        frame.generation = generation;
+        frame.slot = 1;
+        frame.sequence = 7;
+        frame.source_frame_number = 42;
+        frame.has_sync_fd = 1;
+        server.publish_frame(frame, UniqueFd{::eventfd(0, EFD_CLOEXEC)});
+
+        auto message = receive_message(consumer.get());
+        REQUIRE(message.has_value());
+        const auto received = decode<FrameExportFrameInfo>(*message);
+        REQUIRE(received.type == static_cast<uint16_t>(FrameExportMessageType::frame));
+        REQUIRE(received.slot == 1U);
+        REQUIRE(received.sequence == 7U);
+        REQUIRE(received.source_frame_number == 42U);
+        REQUIRE(received.dropped == 0U);
+        REQUIRE(message->fds.size() == 1U);
+    }
+
+    SECTION("Frames for another ring are not announced") {
+        REQUIRE(receive_message(consumer.get()).has_value());
+
+        FrameExportFrameInfo stale{};
+        stale.generation = generation + 100;
+        server.publish_frame(stale, UniqueFd{});
+        const uint32_t next_generation = server.publish_ring(ring_info, {});
+
+        auto message = receive_message(consumer.get());
+        REQUIRE(message.has_value());
+        const auto ring = decode<FrameExportRingInfo>(*message);
+        REQUIRE(ring.type == static_cast<uint16_t>(FrameExportMessageType::ring));
+        REQUIRE(ring.generation == next_generation);
+        REQUIRE(ring.buffer_count == 0U);
+    }
+
+    SECTION("A consumer that falls behind loses the oldest announcements") {
+        REQUIRE(receive_message(consumer.get()).has_value());
+
+        // Far more than the socket queues for an idle reader, so the server must drop.
+        constexpr uint64_t FRAME_COUNT = 4096;
+        for (uint64_t sequence = 1; sequence <= FRAME_COUNT; ++sequence) {
+            FrameExportFrameInfo frame{};
+            frame.generation = generation;
+            frame.slot = static_cast<uint32_t>(sequence % 2);
+            frame.sequence = sequence;
+            server.publish_frame(frame, UniqueFd{});
+        }
+
+        uint64_t received_count = 0;
+        uint64_t dropped_count = 0;
+        uint64_t last_sequence = 0;
+        while (last_sequence < FRAME_COUNT) {
+            auto message = receive_message(consumer.get());
+            REQUIRE(message.has_value());
+            const auto received = decode<FrameExportFrameInfo>(*message);
+            REQUIRE(received.sequence > last_sequence);
+            // Every skipped announcement is reported, so sequences never jump silently.
+            REQUIRE(received.sequence == last_sequence + received.dropped + 1);
+            last_sequence = received.sequence;
+            dropped_count += received.dropped;
+            ++received_count;
+        }
+        REQUIRE(dropped_count > 0U);
+        REQUIRE(received_count + dropped_count == FRAME_COUNT);
+    }
+
+    consumer = UniqueFd{};
+    server_result->reset();
+    REQUIRE_FALSE(std::filesystem::exists(socket_path));
+}
@@ -0,0 +1,157 @@
+#include "../../src/util/metrics.hpp"
+#include "../../src/util/metrics_exporter.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace goggles::util;
+
+namespace {
+
+class MetricsScope {
+public:
+    MetricsScope() {
+        Metrics::reset();
+        Metrics::set_enabled(true);
+    }
+    ~MetricsScope() {
+        Metrics::set_enabled(false);
+        Metrics::reset();
+    }
+
+    MetricsScope(const MetricsScope&) = delete;
+    MetricsScope& operator=(const MetricsScope&) = delete;
+};
+
+auto contains(const std::string& text, const std::string& needle) -> bool {
+    return text.find(needle) != std::string::npos;
+}
+
+auto scrape(const std::filesystem::path& socket_path, const std::string& request) -> std::string {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    REQUIRE(fd >= 0);
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    REQUIRE(::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+    if (!request.empty()) {
+        REQUIRE(::send(fd, request.data(), request.size(), MSG_NOSIGNAL) ==
+                static_cast<ssize_t>(request.size()));
+    }
+
+    std::string response;
+    char buffer[4096];
+    ssize_t received = 0;
+    while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(received));
+    }
+    ::close(fd);
+    return response;
+}
+
+} // namespace
+
+TEST_CASE("Metrics recording is disabled by default", "[metrics]") {
+    Metrics::reset();
+    Metrics::set_enabled(false);
+    Metrics::increment(MetricCounter::frames_rendered);
+
+    const auto text = Metrics::render_openmetrics();
+    REQUIRE(contains(text, "goggles_frames_rendered_total 0\n"));
+}
+
+TEST_CASE("Metrics merges per-thread counters on scrape", "[metrics]") {
+    MetricsScope scope;
+
+    constexpr int K_THREADS = 4;
+    constexpr int K_INCREMENTS = 1000;
+    std::vector<std::thread> threads;
+    threads.reserve(K_THREADS);
+    for (int t = 0; t < K_THREADS; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < K_INCREMENTS; ++i) {
+                Metrics::increment(MetricCounter::frames_imported);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto text = Metrics::render_openmetrics();
+    REQUIRE(contains(text, "goggles_frames_imported_total 4000\n"));
+}
+
+TEST_CASE("Metrics renders OpenMetrics families", "[metrics]") {
+    MetricsScope scope;
+
+    Metrics::increment(MetricCounter::input_events_dropped, 3);
+    Metrics::set_gauge(MetricGauge::game_fps, 59.5);
+    Metrics::observe(MetricHistogram::frame_time_seconds, 0.016);
+    Metrics::observe(MetricHistogram::frame_time_seconds, 0.5);
+
+    const auto text = Metrics::render_openmetrics();
+
+    SECTION("Counters use the _total suffix") {
+        REQUIRE(contains(text, "# TYPE goggles_input_events_dropped counter\n"));
+        REQUIRE(contains(text, "goggles_input_events_dropped_total 3\n"));
+    }
+
+    SECTION("Gauges report the last value") {
+        REQUIRE(contains(text, "# TYPE goggles_game_fps gauge\n"));
+        REQUIRE(contains(text, "goggles_game_fps 59.5\n"));
+    }
+
+    SECTION("Histogram buckets are cumulative") {
+        REQUIRE(contains(text, "# UNIT goggles_frame_time_seconds seconds\n"));
+        REQUIRE(contains(text, "goggles_frame_time_seconds_bucket{le=\"0.0125\"} 0\n"));
+        REQUIRE(contains(text, "goggles_frame_time_seconds_bucket{le=\"0.01667\"} 1\n"));
+        REQUIRE(contains(text, "goggles_frame_time_seconds_bucket{le=\"0.25\"} 1\n"));
+        REQUIRE(contains(text, "goggles_frame_time_seconds_bucket{le=\"+Inf\"} 2\n"));
+        REQUIRE(contains(text, "goggles_frame_time_seconds_count 2\n"));
+        REQUIRE(contains(text, "goggles_frame_time_seconds_sum 0.516\n"));
+    }
+
+    SECTION("Exposition is terminated") {
+        REQUIRE(text.ends_with("# EOF\n"));
+    }
+}
+
+TEST_CASE("MetricsExporter serves scrapes over a Unix socket", "[metrics]") {
+    Metrics::reset();
+    const auto socket_path = std::filesystem::temp_directory_path() /
+                             ("goggles_metrics_test_" + std::to_string(::getpid()) + ".sock");
+
+    auto exporter_result = MetricsExporter::create(socket_path);
+    REQUIRE(exporter_result.has_value());
+    REQUIRE(Metrics::is_enabled());
+    REQUIRE(std::filesystem::is_socket(socket_path));
+
+    Metrics::increment(MetricCounter::filter_chain_rebuilds);
+
+    SECTION("HTTP clients get an HTTP response") {
+        const auto response = scrape(socket_path, "GET /metrics HTTP/1.0\r\n\r\n");
+        REQUIRE(response.starts_with("HTTP/1.0 200 OK\r\n"));
+        REQUIRE(contains(response, "Content-Type: application/openmetrics-text"));
+        REQUIRE(contains(response, "goggles_filter_chain_rebuilds_total 1\n"));
+    }
+
+    SECTION("Silent clients get the raw exposition") {
+        const auto response = scrape(socket_path, "");
+        REQUIRE(response.starts_with("# TYPE"));
+        REQUIRE(response.ends_with("# EOF\n"));
+    }
+
+    exporter_result->reset();
+    REQUIRE_FALSE(Metrics::is_enabled());
+    REQUIRE_FALSE(std::filesystem::exists(socket_path));
+    Metrics::reset();
+}
@@ -0,0 +1,40 @@
+#include "../../src/util/scale_mode.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace goggles;
+
+TEST_CASE("compute_scaled_rect places content per scale mode", "[scale_mode]") {
+    SECTION("Fit letterboxes and centers") {
+        const auto rect = compute_scaled_rect(ScaleMode::fit, 0, 640, 480, 1920, 1080);
+        REQUIRE(rect.width == 1440.0F);
+        REQUIRE(rect.height == 1080.0F);
+        REQUIRE(rect.x == 240.0F);
+        REQUIRE(rect.y == 0.0F);
+    }
+
+    SECTION("Fill crops past the target") {
+        const auto rect = compute_scaled_rect(ScaleMode::fill, 0, 640, 480, 1920, 1080);
+        REQUIRE(rect.width == 1920.0F);
+        REQUIRE(rect.height == 1440.0F);
+        REQUIRE(rect.y == -180.0F);
+    }
+
+    SECTION("Stretch covers the whole target") {
+        const auto rect = compute_scaled_rect(ScaleMode::stretch, 0, 640, 480, 1920, 1080);
+        REQUIRE(rect.x == 0.0F);
+        REQUIRE(rect.width == 1920.0F);
+        REQUIRE(rect.height == 1080.0F);
+    }
+
+    SECTION("Integer uses the largest whole scale unless one is set") {
+        const auto automatic = compute_scaled_rect(ScaleMode::integer, 0, 640, 480, 1920, 1080);
+        REQUIRE(automatic.width == 1280.0F);
+        REQUIRE(automatic.x == 320.0F);
+
+        const auto fixed = compute_scaled_rect(ScaleMode::integer, 1, 640, 480, 1920, 1080);
+        REQUIRE(fixed.width == 640.0F);
+        REQUIRE(fixed.x == 640.0F);
+        REQUIRE(fixed.y == 300.0F);
+    }
+}
@@ -0,0 +1,179 @@
+#include "../../src/util/video_recorder.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace goggles::util;
+
+namespace {
+
+auto temp_recording_path(const std::string& name) -> std::filesystem::path {
+    return std::filesystem::temp_directory_path() /
+           ("goggles_" + name + "_" + std::to_string(::getpid()) + ".y4m");
+}
+
+auto read_file(const std::filesystem::path& path) -> std::string {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void fill_rgba(VideoRecorder::Frame& frame, uint8_t r, uint8_t g, uint8_t b) {
+    for (size_t i = 0; i + 3 < frame.rgba.size(); i += 4) {
+        frame.rgba[i + 0] = r;
+        frame.rgba[i + 1] = g;
+        frame.rgba[i + 2] = b;
+        frame.rgba[i + 3] = 0xFF;
+    }
+}
+
+} // namespace
+
+TEST_CASE("VideoRecorder writes timestamped YUV4MPEG2 frames", "[video_recorder]") {
+    const auto path = temp_recording_path("video_recorder");
+    auto recorder_result = VideoRecorder::create(path, {.width = 2, .height = 2, .fps = 30});
+    REQUIRE(recorder_result.has_value());
+    auto& recorder = *recorder_result.value();
+
+    auto* white = recorder.acquire_frame();
+    REQUIRE(white != nullptr);
+    REQUIRE(white->rgba.size() == 2U * 2U * 4U);
+    fill_rgba(*white, 0xFF, 0xFF, 0xFF);
+    white->timestamp_ns = 1000;
+    white->source_frame_number = 7;
+    recorder.submit_frame(white);
+
+    auto* black = recorder.acquire_frame();
+    REQUIRE(black != nullptr);
+    fill_rgba(*black, 0, 0, 0);
+    black->timestamp_ns = 17667;
+    black->source_frame_number = 8;
+    recorder.submit_frame(black);
+
+    REQUIRE(recorder.finish().has_value());
+    REQUIRE(recorder.frames_written() == 2U);
+
+    const std::string header = "YUV4MPEG2 W2 H2 F30:1 Ip A1:1 C444\n";
+    const std::string first_frame = "FRAME XT=1000 XF=7\n";
+    const std::string second_frame = "FRAME XT=17667 XF=8\n";
+    const auto data = read_file(path);
+    REQUIRE(data.size() == header.size() + first_frame.size() + second_frame.size() + (2 * 12));
+    REQUIRE(data.starts_with(header));
+
+    const size_t first = header.size();
+    REQUIRE(data.compare(first, first_frame.size(), first_frame) == 0);
+    // Limited range: white is Y=235, black is Y=16, both with neutral chroma.
+    REQUIRE(static_cast<uint8_t>(data[first + first_frame.size()]) == 235);
+    REQUIRE(static_cast<uint8_t>(data[first + first_frame.size() + 4]) == 128);
+
+    const size_t second = first + first_frame.size() + 12;
+    REQUIRE(data.compare(second, second_frame.size(), second_frame) == 0);
+    REQUIRE(static_cast<uint8_t>(data[second + second_frame.size()]) == 16);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("VideoRecorder rgba format writes frames losslessly", "[video_recorder]") {
+    const auto path = temp_recording_path("video_recorder_rgba");
+    auto recorder_result =
+        VideoRecorder::create(path, {.width = 2, .height = 1, .format = RecordFormat::rgba});
+    REQUIRE(recorder_result.has_value());
+    auto& recorder = *recorder_result.value();
+
+    // Values a limited-range Y'CbCr round trip would not reproduce.
+    const std::vector<uint8_t> pixels = {1, 2, 3, 4, 254, 128, 0, 255};
+    auto* frame = recorder.acquire_frame();
+    REQUIRE(frame != nullptr);
+    frame->rgba = pixels;
+    recorder.submit_frame(frame);
+
+    REQUIRE(recorder.finish().has_value());
+    REQUIRE(recorder.frames_written() == 1U);
+    REQUIRE(read_file(path) == std::string(pixels.begin(), pixels.end()));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(record_index_path(path));
+}
+
+TEST_CASE("VideoRecorder rgba index round-trips frame timestamps", "[video_recorder]") {
+    const auto path = temp_recording_path("video_recorder_index");
+    auto recorder_result =
+        VideoRecorder::create(path, {.width = 1, .height = 1, .format = RecordFormat::rgba});
+    REQUIRE(recorder_result.has_value());
+    auto& recorder = *recorder_result.value();
+
+    // Lockstep timestamps are far past 32 bits; frame numbers may skip when frames are dropped.
+    const std::vector<RecordIndexEntry> expected = {
+        {.timestamp_ns = 16'666'667, .source_frame_number = 1, .byte_offset = 0},
+        {.timestamp_ns = 5'000'000'033'333'333, .source_frame_number = 3, .byte_offset = 4},
+    };
+    for (const auto& entry : expected) {
+        auto* frame = recorder.acquire_frame();
+        REQUIRE(frame != nullptr);
+        frame->timestamp_ns = entry.timestamp_ns;
+        frame->source_frame_number = entry.source_frame_number;
+        recorder.submit_frame(frame);
+    }
+    REQUIRE(recorder.finish().has_value());
+
+    auto index = read_record_index(record_index_path(path));
+    REQUIRE(index.has_value());
+    REQUIRE(index->size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE((*index)[i].timestamp_ns == expected[i].timestamp_ns);
+        REQUIRE((*index)[i].source_frame_number == expected[i].source_frame_number);
+        REQUIRE((*index)[i].byte_offset == expected[i].byte_offset);
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(record_index_path(path));
+}
+
+TEST_CASE("read_record_index rejects malformed indexes", "[video_recorder]") {
+    const auto path = temp_recording_path("video_recorder_bad_index");
+    std::ofstream(path) << "timestamp_ns,source_frame_number,byte_offset\n1,2\n";
+    REQUIRE_FALSE(read_record_index(path).has_value());
+
+    std::ofstream(path) << "1,2,3\n";
+    REQUIRE_FALSE(read_record_index(path).has_value());
+    REQUIRE_FALSE(read_record_index(path.string() + ".missing").has_value());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("VideoRecorder drop policy skips frames when the pool is exhausted",
+          "[video_recorder]") {
+    const auto path = temp_recording_path("video_recorder_drop");
+    auto recorder_result = VideoRecorder::create(
+        path, {.width = 2, .height = 2, .pool_size = 1, .backpressure = RecordBackpressure::drop});
+    REQUIRE(recorder_result.has_value());
+    auto& recorder = *recorder_result.value();
+
+    auto* held = recorder.acquire_frame();
+    REQUIRE(held != nullptr);
+    REQUIRE(recorder.acquire_frame() == nullptr);
+    REQUIRE(recorder.frames_dropped() == 1U);
+
+    recorder.submit_frame(held);
+    REQUIRE(recorder.finish().has_value());
+    REQUIRE(recorder.frames_written() == 1U);
+    REQUIRE(recorder.acquire_frame() == nullptr);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("parse_record_backpressure accepts known policies", "[video_recorder]") {
+    REQUIRE(parse_record_backpressure("block") == RecordBackpressure::block);
+    REQUIRE(parse_record_backpressure("drop") == RecordBackpressure::drop);
+    REQUIRE_FALSE(parse_record_backpressure("wait").has_value());
+}
+
+TEST_CASE("parse_record_format accepts known formats", "[video_recorder]") {
+    REQUIRE(parse_record_format("y4m") == RecordFormat::y4m);
+    REQUIRE(parse_record_format("rgba") == RecordFormat::rgba);
+    REQUIRE_FALSE(parse_record_format("png").has_value());
+}
@@ -0,0 +1,65 @@
+#include "../../src/util/vrr_pacing.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace goggles::util;
+using namespace std::chrono_literals;
+
+TEST_CASE("VRR present intervals follow the refresh range", "[vrr_pacing]") {
+    const RefreshRange range{.min_hz = 48, .max_hz = 165};
+    REQUIRE(min_present_interval(range) == std::chrono::nanoseconds(6'060'606));
+    REQUIRE(max_present_interval(range) == std::chrono::nanoseconds(20'833'333));
+}
+
+TEST_CASE("VrrPacer repeats frames within the refresh range", "[vrr_pacing]") {
+    using Clock = VrrPacer::Clock;
+    VrrPacer pacer;
+    pacer.set_range({.min_hz = 48, .max_hz = 165});
+    const auto start = Clock::time_point{} + 1h;
+
+    SECTION("No deadline before the first present") {
+        REQUIRE(pacer.repeat_deadline() == Clock::time_point{});
+    }
+
+    SECTION("Sources inside the range repeat only at the max interval") {
+        for (int i = 0; i < 8; ++i) {
+            pacer.on_source_frame(start + (i * 10ms));
+        }
+        REQUIRE(pacer.source_interval() == 10ms);
+        REQUIRE(pacer.repeat_interval() == max_present_interval(pacer.range()));
+
+        pacer.on_present(start + 70ms);
+        REQUIRE(pacer.repeat_deadline() == start + 70ms + max_present_interval(pacer.range()));
+    }
+
+    SECTION("Slow sources repeat at an even fraction of their interval") {
+        for (int i = 0; i < 8; ++i) {
+            pacer.on_source_frame(start + (i * 40ms));
+        }
+        // 25 FPS on a 48 Hz floor: each frame is shown twice, at 50 Hz.
+        REQUIRE(pacer.repeat_interval() == 20ms);
+
+        for (int i = 8; i < 64; ++i) {
+            pacer.on_source_frame(start + (i * 100ms));
+        }
+        // 10 FPS: five presents per frame, at 50 Hz.
+        REQUIRE(pacer.repeat_interval() > 19ms);
+        REQUIRE(pacer.repeat_interval() <= max_present_interval(pacer.range()));
+    }
+
+    SECTION("A stalled source forgets its cadence") {
+        pacer.on_source_frame(start);
+        pacer.on_source_frame(start + 40ms);
+        REQUIRE(pacer.source_interval() == 40ms);
+        pacer.on_source_frame(start + 5s);
+        REQUIRE(pacer.source_interval() == Clock::duration::zero());
+        REQUIRE(pacer.repeat_interval() == max_present_interval(pacer.range()));
+    }
+
+    SECTION("Repeats never exceed the max refresh") {
+        pacer.set_range({.min_hz = 100, .max_hz = 120});
+        pacer.on_source_frame(start);
+        pacer.on_source_frame(start + 11ms);
+        REQUIRE(pacer.repeat_interval() >= min_present_interval(pacer.range()));
+    }
+}